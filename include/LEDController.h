@@ -10,6 +10,9 @@
 
 #include <Arduino.h>
 #include <FastLED.h>
+#include <pixelKernels.h>
+#include <hsvConvert.h>
+#include <ledOutput.h>
 
 #define FRAMES_PER_SECOND 100
 #define COOLING 70 // default: 55
@@ -33,10 +36,13 @@ enum Mode
 };
 
 // globals
-CRGB leds[NUM_LEDS];
+CRGB leds[NUM_LEDS] __attribute__((aligned(4))); // word aligned for the pixelKernels.h fixed-size paths
 int gLeds[NUM_LEDS];
 uint8_t g_briteValue = 255; // used to inform loop of new brightness value.
 CHSV g_chsvColor(0, 0, 0);  // used to inform loop of new solid color.
+Mode g_mode = Off;          // current mode, persisted with the scene.
+int8_t g_animation = -1;    // current animation ID as sent by the web UI, -1 = off.
+uint8_t g_paletteId = 0;    // current palette ID, 0 = effect default.
 
 // prototypes
 int *getLtrTransform(int leds[], int rows, int cols);
@@ -49,6 +55,12 @@ int currentLEDNum = 0;
 CRGBPalette16 gPal;
 bool gReverseDirection = false;
 
+// HSV canvas, for effects that draw every pixel in HSV. See hsvCanvasRender().
+CHSV hsvCanvas[NUM_LEDS];
+sHsvTables hsvTables;
+bool hsvTablesReady = false;
+static_assert(sizeof(CHSV) == 3 && sizeof(CRGB) == 3, "hsvConvert.h needs packed 3 byte pixels");
+
 // pallettes
 CRGBPalette16 currentPalette;
 CRGBPalette16 targetPalette;
@@ -57,6 +69,81 @@ TBlendType currentBlending;
 void clearLeds()
 {
     FastLED.clear(true);
+    ledOutputInvalidate(); // the strip went black behind ledOutput's back
+}
+
+/*--------------------------------------------------------------------
+   Effect clock and randomness. FastLED's timing (beatsin8, EVERY_N_*)
+   reads get_millisecond_timer() (USE_GET_MILLISECOND_TIMER in
+   globalConfig.h) and effects draw from random16(), so
+   effectCheck.h can replay them from a fixed seed on a fake clock.
+---------------------------------------------------------------------*/
+
+bool effectClockFake = false; // set while effectCheck.h drives the clock.
+uint32_t effectClockMs = 0;
+
+uint32_t get_millisecond_timer()
+{
+    return effectClockFake ? effectClockMs : millis();
+}
+
+// delay() for effects, keepShowing = FastLED.delay() (refreshes dithering while waiting).
+// A frame boundary: whatever the effect asked to show goes out first.
+void effectDelay(uint32_t ms, bool keepShowing = false)
+{
+    ledFlush();
+    if (effectClockFake)
+    {
+        effectClockMs += ms;
+    }
+    else if (keepShowing)
+    {
+        FastLED.delay(ms);
+    }
+    else
+    {
+        delay(ms);
+    }
+}
+
+// Arduino random() semantics on FastLED's seedable generator.
+long effectRandom(long howBig)
+{
+    if (howBig <= 0)
+    {
+        return 0;
+    }
+    uint32_t r = (uint32_t)random16() << 16 | random16();
+    return r % howBig;
+}
+
+long effectRandom(long howSmall, long howBig)
+{
+    return howSmall >= howBig ? howSmall : howSmall + effectRandom(howBig - howSmall);
+}
+
+// Convert the whole HSV canvas into leds[] in one pass, same colours as assigning CHSV pixel by pixel.
+void hsvCanvasRender(CRGB leds[])
+{
+    if (!hsvTablesReady)
+    {
+        hsvTablesInit(hsvTables);
+        hsvTablesReady = true;
+    }
+    hsvToRgbBatch(hsvTables, hsvCanvas[0].raw, (uint8_t *)leds, NUM_LEDS);
+}
+
+// Strip-wide fade through the kernel the profile picked (fixedKernels in installProfile.h).
+void ledFade(CRGB leds[], uint8_t fadeBy)
+{
+    if (g_profile.fixedKernels)
+    {
+        pixelFadeFixed<NUM_LEDS>((uint8_t *)leds, fadeBy);
+    }
+    else
+    {
+        pixelFade((uint8_t *)leds, NUM_LEDS, fadeBy);
+    }
 }
 
 /*--------------------------------------------------------------------
@@ -69,11 +156,10 @@ void fireLED(CRGB leds[])
 {
     if (firedLEDCount < NUM_LEDS)
     {
-        firedLEDCount++;
-        leds[firedLEDCount] = CRGB(240, 0, 0);
-        FastLED.show();
-        fadeToBlackBy(leds, NUM_LEDS, 50);
-        Serial.println("Firing LED: " + String(firedLEDCount));
+        leds[firedLEDCount++] = CRGB(240, 0, 0);
+        ledShow();
+        ledFade(leds, 50);
+        logEvent(LOG_FIRE, firedLEDCount);
     }
     else
     {
@@ -84,20 +170,20 @@ void fireLED(CRGB leds[])
 
 void randomDots2(CRGB leds[])
 {
-    currentLEDNum = random(NUM_LEDS - 1);
+    currentLEDNum = effectRandom(NUM_LEDS - 1);
     sLED currentLED;
     currentLED.index = currentLEDNum;
-    currentLED.H = random(255);
-    currentLED.S = random(255);
+    currentLED.H = effectRandom(255);
+    currentLED.S = effectRandom(255);
     currentLED.V = 120;
     leds[currentLED.index] = CRGB(currentLED.H, currentLED.S, currentLED.V);
-    FastLED.show();
-    delay(20);
+    ledShow();
+    effectDelay(20);
     leds[currentLEDNum] = CRGB::CornflowerBlue;
-    leds[random(NUM_LEDS - 1)] = CRGB::Red;
-    FastLED.show();
+    leds[effectRandom(NUM_LEDS - 1)] = CRGB::Red;
+    ledShow();
     leds[currentLED.index] = CHSV(0, 0, 0);
-    fadeToBlackBy(leds, NUM_LEDS, 10);
+    ledFade(leds, 10);
 }
 
 int leds_done = 0;
@@ -108,53 +194,52 @@ void randomDots(CRGB leds[])
     {
         CRGB Halloween_color;
 
-        // shift pixels
-        for (int i = NUM_LEDS - 1; i > 0; i--)
-        {
-            leds[i] = leds[i - 1];
-        }
+        // shift pixels, the first one stays put
+        CRGB first = leds[0];
+        pixelShift((uint8_t *)leds, NUM_LEDS, 1);
+        leds[0] = first;
 
-        for (int i = random(int(NUM_LEDS / 2)); i < random(int(NUM_LEDS / 2), NUM_LEDS); i++)
+        for (int i = effectRandom(int(NUM_LEDS / 2)); i < effectRandom(int(NUM_LEDS / 2), NUM_LEDS); i++)
         {
-            leds[i] = CHSV(random(128, 255), 255, random(0, 70));
+            leds[i] = CHSV(effectRandom(128, 255), 255, effectRandom(0, 70));
         }
-        FastLED.show();
+        ledShow();
 
         if (leds_done < NUM_LEDS)
         {
-            Halloween_color = CRGB(random(20, 200), 0, random(255));
+            Halloween_color = CRGB(effectRandom(20, 200), 0, effectRandom(255));
             leds[leds_done] = Halloween_color;
             leds_done = leds_done + 1;
         }
         else
         {
-            leds[leds_done] = CRGB::Black;
             leds_done = 0;
         }
 
-        EVERY_N_MILLISECONDS(random(100, 1000))
+        EVERY_N_MILLISECONDS(effectRandom(100, 1000))
         {
-            leds[random(NUM_LEDS - 1)] = CRGB::CornflowerBlue;
-            FastLED.show();
+            leds[effectRandom(NUM_LEDS - 1)] = CRGB::CornflowerBlue;
+            ledShow();
         }
 
-        EVERY_N_MILLISECONDS(random(223, 531))
+        EVERY_N_MILLISECONDS(effectRandom(223, 531))
         {
-            leds[random(NUM_LEDS - 1)] = CRGB(random(255), random(255), random(255));
+            leds[effectRandom(NUM_LEDS - 1)] = CRGB(effectRandom(255), effectRandom(255), effectRandom(255));
         }
     }
-    leds[random(NUM_LEDS - 1)] = CRGB::Purple;
-    fadeToBlackBy(leds, NUM_LEDS, 20);
-    FastLED.show();
+    leds[effectRandom(NUM_LEDS - 1)] = CRGB::Purple;
+    ledFade(leds, 20);
+    ledShow();
 }
 
 void randomNoise(CRGB leds[])
 {
     for (int i = 0; i < NUM_LEDS; i++)
     {
-        leds[i] = CHSV(random(255), random(120, 255), random(0, 255));
+        hsvCanvas[i] = CHSV(effectRandom(255), effectRandom(120, 255), effectRandom(0, 255));
     }
-    FastLED.show();
+    hsvCanvasRender(leds);
+    ledShow();
     FastLED.clear();
     return;
 }
@@ -163,10 +248,11 @@ void randomBlueJumper(CRGB leds[])
 {
     for (int i = 0; i < NUM_LEDS; i++)
     {
-        leds[i] = CHSV(random(86, 172), random(140, 255), random(1, 130));
+        hsvCanvas[i] = CHSV(effectRandom(86, 172), effectRandom(140, 255), effectRandom(1, 130));
     }
-    leds[random(NUM_LEDS)] = CRGB(255, 255, 255);
-    FastLED.show();
+    hsvCanvasRender(leds);
+    leds[effectRandom(NUM_LEDS)] = CRGB(255, 255, 255);
+    ledShow();
     FastLED.clear();
     return;
 }
@@ -178,17 +264,15 @@ void randomBlueJumper(CRGB leds[])
 void flashColor(CRGB leds[], int color)
 {
     // forcing color random for now
-    color = random(0, 255);
+    color = effectRandom(0, 255);
     EVERY_N_MILLISECONDS(200)
     {
-        for (int i = 0; i < NUM_LEDS; i++)
-        {
-            leds[i] = CHSV(color, 255, 255);
-        }
-        FastLED.show();
-        delay(10);
+        CRGB flash = CHSV(color, 255, 255);
+        pixelFill((uint8_t *)leds, NUM_LEDS, flash.r, flash.g, flash.b);
+        ledShow();
+        effectDelay(10);
         FastLED.clear();
-        FastLED.show();
+        ledShow();
     }
 }
 
@@ -202,7 +286,7 @@ void starTwinkle(CRGB leds[])
     {
         static uint8_t position;
         static uint8_t direction;
-        int rand = random(NUM_LEDS);
+        int rand = effectRandom(NUM_LEDS);
         leds[rand] = CHSV(0, 0, 255);
 
         if (rand % 3 == 0)
@@ -236,7 +320,7 @@ void starTwinkle(CRGB leds[])
 
         EVERY_N_SECONDS(10)
         {
-            leds[random(NUM_LEDS)] = CRGB::Red;
+            leds[effectRandom(NUM_LEDS)] = CRGB::Red;
         }
 
         EVERY_N_MILLISECONDS_I(duration, 1000)
@@ -245,8 +329,8 @@ void starTwinkle(CRGB leds[])
             duration.setPeriod(random16(100, 3000));
         }
 
-        fadeToBlackBy(leds, NUM_LEDS, 8);
-        FastLED.show();
+        ledFade(leds, 8);
+        ledShow();
     }
 }
 /*--------------------------------------------------------------------
@@ -258,6 +342,18 @@ void beatWaver(CRGB leds[])
     currentBlending = LINEARBLEND;
     beatwave();
 
+#if USE_AUDIO_INPUT
+    // Kick the palette toward a new target on every beat instead of waiting out the timer.
+    static uint16_t lastBeatCount;
+    sAudioFrame audio;
+    audioRead(audio);
+    if (audio.beatCount != lastBeatCount)
+    {
+        lastBeatCount = audio.beatCount;
+        targetPalette = CRGBPalette16(CHSV(random8(), 255, 255), CHSV(random8(), 255, 200), CHSV(random8(), 192, 255), CHSV(random8(), 255, 200));
+    }
+#endif
+
     EVERY_N_MILLISECONDS(100)
     {
         uint8_t maxChanges = 24;
@@ -269,7 +365,7 @@ void beatWaver(CRGB leds[])
         targetPalette = CRGBPalette16(CHSV(random8(), 255, random8(128, 255)), CHSV(random8(), 255, random8(128, 255)), CHSV(random8(), 192, random8(128, 255)), CHSV(random8(), 255, random8(128, 255)));
     }
 
-    FastLED.show();
+    ledShow();
 }
 
 void dotScrollRandomColor(CRGB leds[], int gTransform[])
@@ -278,10 +374,10 @@ void dotScrollRandomColor(CRGB leds[], int gTransform[])
     {
         if (i < NUM_LEDS) // cuz 3
         {
-            leds[gTransform[i]] = CHSV(random(0, 255), 255, 255);
-            leds[random(NUM_LEDS)] = CHSV(128, 150, 100);
-            FastLED.show();
-            delay(22);
+            leds[gTransform[i]] = CHSV(effectRandom(0, 255), 255, 255);
+            leds[effectRandom(NUM_LEDS)] = CHSV(128, 150, 100);
+            ledShow();
+            effectDelay(22);
             FastLED.clear();
         }
     }
@@ -296,7 +392,7 @@ void ltrDot(CRGB leds[], int gTransform[])
     EVERY_N_MILLISECONDS(30)
     {
         leds[gTransform[ledIndex]] = CHSV(randomColor, 255, 255);
-        FastLED.show();
+        ledShow();
         ledIndex += 3;
         if (ledIndex >= NUM_LEDS)
         {
@@ -306,11 +402,11 @@ void ltrDot(CRGB leds[], int gTransform[])
 
     EVERY_N_MILLISECONDS(2)
     {
-        fadeToBlackBy(leds, NUM_LEDS, 10);
+        ledFade(leds, 10);
     }
 
     if (ledIndex == 0)
-        randomColor = random(0, 255);
+        randomColor = effectRandom(0, 255);
 }
 
 void Fire2012WithPalette(CRGB leds[])
@@ -356,8 +452,65 @@ void Fire2012WithPalette(CRGB leds[])
         leds[pixelnumber] = color;
     }
 
-    FastLED.delay(1000 / FRAMES_PER_SECOND);
+    effectDelay(1000 / FRAMES_PER_SECOND, true);
 }
+
+/*--------------------------------------------------------------------
+   Animation dispatch: web UI animation IDs (htmlStrings.h buttons)
+   to the effect each one draws. Effects the profile leaves out
+   compile to empty entries, so nothing references them and the
+   linker drops them. Purple Ocean (5) and Red Ocean (11) have no
+   effect yet.
+---------------------------------------------------------------------*/
+
+struct sAnimation
+{
+    int8_t id;
+    uint32_t effect; // EFX_* bit
+    void (*step)();  // one frame
+};
+
+const sAnimation animationTable[] = {
+    {1, EFX_RANDOM_DOTS, [] { if (profileHasEffect(EFX_RANDOM_DOTS)) randomDots(leds); }},                    // Color Streams
+    {2, EFX_RANDOM_DOTS2, [] { if (profileHasEffect(EFX_RANDOM_DOTS2)) randomDots2(leds); }},                 // Red Raindrops
+    {3, EFX_RANDOM_NOISE, [] { if (profileHasEffect(EFX_RANDOM_NOISE)) randomNoise(leds); }},                 // Analog Noise
+    {4, EFX_RANDOM_BLUE_JUMPER, [] { if (profileHasEffect(EFX_RANDOM_BLUE_JUMPER)) randomBlueJumper(leds); }}, // Blue Ocean
+    {6, EFX_DOT_SCROLL, [] { if (profileHasEffect(EFX_DOT_SCROLL)) dotScrollRandomColor(leds, gLeds); }},     // Scroll Color
+    {7, EFX_FLASH_COLOR, [] { if (profileHasEffect(EFX_FLASH_COLOR)) flashColor(leds, 0); }},                 // Color Strobe
+    {8, EFX_LTR_DOT, [] { if (profileHasEffect(EFX_LTR_DOT)) ltrDot(leds, gLeds); }},                         // Left to Right
+    {9, EFX_FIRE2012, [] { if (profileHasEffect(EFX_FIRE2012)) Fire2012WithPalette(leds); }},                 // Campfire
+    {10, EFX_BEAT_WAVER, [] { if (profileHasEffect(EFX_BEAT_WAVER)) beatWaver(leds); }},                      // Color Waves
+    {12, EFX_NOISE_MOVER, [] { if (profileHasEffect(EFX_NOISE_MOVER)) inoise8_mover(); }},                    // Inchworm
+    {13, EFX_STAR_TWINKLE, [] { if (profileHasEffect(EFX_STAR_TWINKLE)) starTwinkle(leds); }},                // Twinkle Stars
+};
+
+// True for -1 (off) and every ID in the table, built into this profile or not.
+bool animationKnown(int id)
+{
+    for (const sAnimation &animation : animationTable)
+    {
+        if (animation.id == id)
+        {
+            return true;
+        }
+    }
+    return id == -1;
+}
+
+// Draws one frame of animation id. False if the ID has no effect in this build.
+bool animationStep(int8_t id)
+{
+    for (const sAnimation &animation : animationTable)
+    {
+        if (animation.id == id && profileHasEffect(animation.effect))
+        {
+            animation.step();
+            return true;
+        }
+    }
+    return false;
+}
+
 /*--------------------------------------------------------------------
                          Utility functions
 ---------------------------------------------------------------------*/
@@ -434,10 +587,19 @@ void beatwave()
     uint8_t wave2 = beatsin8(8, 0, 255);
     uint8_t wave3 = beatsin8(7, 0, 255);
     uint8_t wave4 = beatsin8(6, 0, 255);
+    uint8_t brightness = 255;
+
+#if USE_AUDIO_INPUT
+    // Bass pushes the wave along, overall level drives brightness.
+    sAudioFrame audio;
+    audioRead(audio);
+    wave4 += audio.bands[1];
+    brightness = max(audio.level, (uint8_t)64);
+#endif
 
     for (int i = 0; i < NUM_LEDS; i++)
     {
-        leds[i] = ColorFromPalette(currentPalette, i + wave1 + wave2 + wave3 + wave4, 255, currentBlending);
+        leds[i] = ColorFromPalette(currentPalette, i + wave1 + wave2 + wave3 + wave4, brightness, currentBlending);
     }
 }
 
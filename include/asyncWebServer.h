@@ -1,9 +1,8 @@
 /*+===================================================================
   File:      asyncWebServer dot h
 
-  Summary:   Provides an Async HTTP server and HTTPUploader for OTA
-             updates, manual only via Elegant OTA:
-             https://github.com/ayushsharma82/ElegantOTA
+  Summary:   Provides an Async HTTP server. Firmware updates go
+             through the streaming POST /api/ota in otaUpdate.h.
              
              Now includes websocket support.
              https://randomnerdtutorials.com/esp32-websocket-server-arduino/
@@ -13,7 +12,6 @@
 
 #include <AsyncTCP.h>
 #include <ESPAsyncWebServer.h>
-#include <AsyncElegantOTA.h>
 #include <htmlStrings.h>
 
 // externs
@@ -30,6 +28,11 @@ extern const int activityLED;
 void handleAbout(AsyncWebServerRequest *request);
 void bangLED(int);
 void handleRestart(AsyncWebServerRequest *request);
+void handleControl(AsyncWebServerRequest *request);
+void handlePreset(AsyncWebServerRequest *request);
+void handleShow(AsyncWebServerRequest *request);
+void handleClip(AsyncWebServerRequest *request);
+void handleMem(AsyncWebServerRequest *request);
 void listAllFiles();
 String getControlPanelHTML();
 
@@ -46,16 +49,28 @@ const char *MY_PARAM = "myParam";
 //-------------------------------------------------------------------
 //                          Web Sockets Setup
 //-------------------------------------------------------------------
+// Cue notices go to the cues topic only (see wsSessions.h).
 void notifyClients(String msg) {
-  ws.textAll(msg);
+  wsPublish(TOPIC_CUES, msg.c_str());
 }
 
-void handleWebSocketMessage(void *arg, uint8_t *data, size_t len) {
+void notifyClients(const char *msg) {
+  wsPublish(TOPIC_CUES, msg);
+}
+
+void handleWebSocketMessage(AsyncWebSocketClient *client, void *arg, uint8_t *data, size_t len) {
+  sHealthScope health(HEALTH_HTTP, "/ws");
   AwsFrameInfo *info = (AwsFrameInfo*)arg;
   if (info->final && info->index == 0 && info->len == len && info->opcode == WS_TEXT) {
     data[len] = 0;
+    if (sessionCommand(client, (char*)data)) {
+      return;
+    }
+    if (fireCommand(client, (char*)data, sessionIsMaster(client->id()))) {
+      return;
+    }
     if (strcmp((char*)data, "test") == 0) { // our test message
-      notifyClients("Hello from server!");
+      client->text("Hello from server!");
     }
   }
 }
@@ -64,19 +79,20 @@ void onEvent(AsyncWebSocket *server, AsyncWebSocketClient *client, AwsEventType
              void *arg, uint8_t *data, size_t len) {
   switch (type) {
     case WS_EVT_CONNECT:
-      Serial.printf("WebSocket client #%u connected from %s\n", client->id(), client->remoteIP().toString().c_str());
+      logEvent(LOG_WS_CONNECT, client->id(), (uint32_t)client->remoteIP());
+      sessionOpen(client);
       break;
     case WS_EVT_DISCONNECT:
-      Serial.printf("WebSocket client #%u disconnected\n", client->id());
+      logEvent(LOG_WS_DISCONNECT, client->id());
+      sessionClose(client->id());
       break;
     case WS_EVT_DATA:
-      handleWebSocketMessage(arg, data, len);
+      handleWebSocketMessage(client, arg, data, len);
       break;
     case WS_EVT_PONG:
-          Serial.printf("WebSocket pinged.");
       break;
     case WS_EVT_ERROR:
-    Serial.printf("WebSocket error - see asyncWebServer.h @line 76: %s\n", (char*)arg);
+    logEvent(LOG_WS_ERROR, client->id(), arg ? *(uint16_t*)arg : 0); // arg is the close reason code
       break;
   }
 }
@@ -114,25 +130,84 @@ void startWebServer()
     Serial.println("mDNS responder started");
 
     server.on("/", HTTP_GET, [](AsyncWebServerRequest *request)
-              {request->send(200, "text/plain", "Default Page");});
+              {sHealthScope health(HEALTH_HTTP, "/"); handleControl(request);});
+
+    server.on("/preset", HTTP_GET, [](AsyncWebServerRequest *request)
+            {sHealthScope health(HEALTH_HTTP, "/preset"); handlePreset(request);});
+
+    server.on("/show", HTTP_GET, [](AsyncWebServerRequest *request)
+            {sHealthScope health(HEALTH_HTTP, "/show"); handleShow(request);});
+
+    server.on("/clip", HTTP_GET, [](AsyncWebServerRequest *request)
+            {sHealthScope health(HEALTH_HTTP, "/clip"); handleClip(request);});
+
+    server.on("/api/v1/state", HTTP_GET, [](AsyncWebServerRequest *request)
+            {sHealthScope health(HEALTH_HTTP, "/api/v1/state"); handleState(request);});
+
+    server.on("/api/v1/state", HTTP_POST, [](AsyncWebServerRequest *request)
+            {sHealthScope health(HEALTH_HTTP, "/api/v1/state"); handleState(request);}, nullptr, handleStateBody);
+
+    server.on("/api/ota", HTTP_GET, [](AsyncWebServerRequest *request)
+            {sHealthScope health(HEALTH_HTTP, "/api/ota"); request->send(200, "application/json", getOtaStatusJson());});
+
+    server.on("/api/ota", HTTP_POST, [](AsyncWebServerRequest *request)
+            {sHealthScope health(HEALTH_HTTP, "/api/ota"); handleOtaRequest(request);}, nullptr, handleOtaBody);
+
+    server.on("/api/cues", HTTP_GET, [](AsyncWebServerRequest *request)
+            {sHealthScope health(HEALTH_HTTP, "/api/cues"); handleCues(request);});
+
+    server.on("/api/mem", HTTP_GET, [](AsyncWebServerRequest *request)
+            {sHealthScope health(HEALTH_HTTP, "/api/mem"); handleMem(request);});
+
+    server.on("/api/dmx", HTTP_GET, [](AsyncWebServerRequest *request)
+            {sHealthScope health(HEALTH_HTTP, "/api/dmx"); handleDmx(request);});
+
+    server.on("/api/thermal", HTTP_GET, [](AsyncWebServerRequest *request)
+            {sHealthScope health(HEALTH_HTTP, "/api/thermal"); handleThermal(request);});
+
+    server.on("/api/i2c", HTTP_GET, [](AsyncWebServerRequest *request)
+            {sHealthScope health(HEALTH_HTTP, "/api/i2c"); handleI2c(request);});
+
+    server.on("/api/boot", HTTP_GET, [](AsyncWebServerRequest *request)
+            {sHealthScope health(HEALTH_HTTP, "/api/boot"); handleBoot(request);});
+
+    server.on("/api/roster", HTTP_GET, [](AsyncWebServerRequest *request)
+            {sHealthScope health(HEALTH_HTTP, "/api/roster"); handleRoster(request);});
+
+    server.on("/api/roster/config", HTTP_POST, [](AsyncWebServerRequest *request)
+            {sHealthScope health(HEALTH_HTTP, "/api/roster/config"); handleRosterConfig(request);});
+
+    server.on("/api/fire", HTTP_GET, [](AsyncWebServerRequest *request)
+            {sHealthScope health(HEALTH_HTTP, "/api/fire"); handleFire(request);});
+
+    server.on("/api/log", HTTP_GET, [](AsyncWebServerRequest *request)
+            {sHealthScope health(HEALTH_HTTP, "/api/log"); handleLog(request);});
+
+    server.on("/api/health", HTTP_GET, [](AsyncWebServerRequest *request)
+            {sHealthScope health(HEALTH_HTTP, "/api/health"); handleHealth(request);});
+
+    server.on("/api/output", HTTP_GET, [](AsyncWebServerRequest *request)
+            {sHealthScope health(HEALTH_HTTP, "/api/output"); handleOutput(request);});
+
+    server.on("/api/effects/check", HTTP_POST, [](AsyncWebServerRequest *request)
+            {sHealthScope health(HEALTH_HTTP, "/api/effects/check"); handleEffectCheck(request);});
+
+    server.on("/api/effects", HTTP_GET, [](AsyncWebServerRequest *request)
+            {sHealthScope health(HEALTH_HTTP, "/api/effects"); handleEffects(request);});
 
     server.on("/restart", HTTP_GET, [](AsyncWebServerRequest *request)
-            {handleRestart(request);});
+            {sHealthScope health(HEALTH_HTTP, "/restart"); handleRestart(request);});
 
     server.on("/about", HTTP_GET, [](AsyncWebServerRequest *request)
-            {handleAbout(request); });
+            {sHealthScope health(HEALTH_HTTP, "/about"); handleAbout(request); });
 
     server.onNotFound([](AsyncWebServerRequest *request)
             {request->send(404, "text/plain", "404 - Not found"); });
 
 
    //----------------------------------------------------------------------------------------------------------------------
-   // Start ElegantOTA update server and web server
+   // Start web server. Updates are POST /api/ota only, so every restart goes through scheduleRestart().
    //----------------------------------------------------------------------------------------------------------------------
-    AsyncElegantOTA.begin(&server); 
-    Serial.println("Update server started! Open your browser and go to http://" + globalIP + "/update");
-    Serial.println("or http://" + hostName + "/update");
-
     server.begin(); 
     Serial.println("HTTP server started! Open your browser and go to http://" + globalIP);
     Serial.println("or http://" + hostName);
@@ -142,10 +217,124 @@ void startWebServer()
 
 void handleRestart(AsyncWebServerRequest *request)
 {
-    Serial.println("Restarting in 5 seconds...");
+    // Never block the AsyncTCP task, loop() restarts once it's safe.
     request->send(200, "text/html", metaRedirect);
-    delay(5000);
-    ESP.restart();
+    scheduleRestart(5000);
+}
+
+// Control panel requests: ?animation=, ?swat=h,s,v, ?hue=, ?sat=, ?bri=
+void handleControl(AsyncWebServerRequest *request)
+{
+    if (request->params() == 0)
+    {
+        request->send(200, "text/plain", "Default Page");
+        return;
+    }
+
+    if (request->hasParam("animation"))
+    {
+        int animation = request->getParam("animation")->value().toInt();
+        if (!animationKnown(animation))
+        {
+            request->send(400, "text/plain", "Unknown animation");
+            return;
+        }
+        g_animation = animation;
+        g_mode = (g_animation < 0) ? Off : Animation;
+    }
+    if (request->hasParam("swat"))
+    {
+        String swat = request->getParam("swat")->value();
+        int firstComma = swat.indexOf(',');
+        int secondComma = swat.indexOf(',', firstComma + 1);
+        if (firstComma > 0 && secondComma > firstComma)
+        {
+            g_chsvColor = CHSV(swat.substring(0, firstComma).toInt(),
+                               swat.substring(firstComma + 1, secondComma).toInt(),
+                               swat.substring(secondComma + 1).toInt());
+            g_mode = SolidColor;
+        }
+    }
+    if (request->hasParam("hue"))
+    {
+        g_chsvColor.hue = request->getParam("hue")->value().toInt();
+    }
+    if (request->hasParam("sat"))
+    {
+        g_chsvColor.sat = request->getParam("sat")->value().toInt();
+    }
+    if (request->hasParam("bri"))
+    {
+        g_briteValue = request->getParam("bri")->value().toInt();
+        FastLED.setBrightness(g_briteValue);
+    }
+
+    presetTouch();
+    request->send(200, "text/plain", "OK");
+}
+
+// Presets: /preset?save=n stores the current scene, /preset?recall=n applies it.
+void handlePreset(AsyncWebServerRequest *request)
+{
+    bool ok = false;
+    if (request->hasParam("save"))
+    {
+        ok = presetSave(request->getParam("save")->value().toInt());
+    }
+    else if (request->hasParam("recall"))
+    {
+        ok = presetRecall(request->getParam("recall")->value().toInt());
+    }
+    request->send(ok ? 200 : 400, "text/plain", ok ? "OK" : "Bad preset slot");
+}
+
+// Show transport: /show?play=ms, /show?pause, /show?resume, /show?stop
+void handleShow(AsyncWebServerRequest *request)
+{
+    if (!g_showLoaded)
+    {
+        request->send(404, "text/plain", "No show loaded");
+        return;
+    }
+
+    if (request->hasParam("play"))
+    {
+        showPlay(request->getParam("play")->value().toInt());
+    }
+    else if (request->hasParam("pause"))
+    {
+        showPause();
+    }
+    else if (request->hasParam("resume"))
+    {
+        showResume();
+    }
+    else if (request->hasParam("stop"))
+    {
+        showStop();
+    }
+
+    request->send(200, "text/plain", String(g_showRunning ? "Playing " : "Stopped ") + String(showPosition()) + " ms");
+}
+
+// Baked clips: /clip?record=name&seconds=n, /clip?play=name, /clip?stop
+void handleClip(AsyncWebServerRequest *request)
+{
+    bool ok = true;
+    if (request->hasParam("record"))
+    {
+        int seconds = request->hasParam("seconds") ? request->getParam("seconds")->value().toInt() : 10;
+        ok = clipCaptureBegin(request->getParam("record")->value(), seconds);
+    }
+    else if (request->hasParam("play"))
+    {
+        ok = clipPlay(request->getParam("play")->value());
+    }
+    else if (request->hasParam("stop"))
+    {
+        clipStop();
+    }
+    request->send(ok ? 200 : 400, "text/plain", ok ? clipStatus() : "Failed");
 }
 
 void bangLED(int state)
@@ -168,6 +357,10 @@ void handleAbout(AsyncWebServerRequest *request)
                            String(ESP.getCpuFreqMHz()) + "<br>"
                                                          "<b>Free Heap Mem:</b> " +
                            String(ESP.getFreeHeap()) + "<br>"
+                                                       "<b>Largest Free Block:</b> " +
+                           String(heap_caps_get_largest_free_block(MALLOC_CAP_8BIT)) + "<br>"
+                                                       "<b>Min Free Heap:</b> " +
+                           String(ESP.getMinFreeHeap()) + "<br>"
                                                        "<b>Flash Mem Size:</b> " +
                            String(ESP.getFlashChipSize() / 1024 / 1024) + " MB<br>"
                                                                           "<b>Chip ID: </b>" +
@@ -187,13 +380,15 @@ void handleAbout(AsyncWebServerRequest *request)
                                              "<b>Description:</b> " +
                            description + "<br>"
                                          "<b>Uptime:</b> " +
-                           zUtils::getMidTime() + "<br>"
+                           zUtils::getMidTime().c_str() + "<br>"
                                                   "<b>Temperature:</b> " +
                            g_temperature + "<br>"
-                                           "<b>Update:</b> http://" +
-                           hostName + ".ra.local/update<br><br>"
+                                           "<b>Last Stall:</b> " +
+                           healthLastStallText() + "<br>"
+                                                   "<b>Update:</b> POST http://" +
+                           hostName + ".ra.local/api/ota?sha256=&lt;hex&gt;<br><br>"
                                       "<button class=\"button\" style=\"width:100px;height:30px;border:0;background-color:#3c5168;color:#dddddd\" onclick=\"window.location.href='/restart'\">Restart</button></body>"
-                                      "&nbsp;&nbsp;<button class=\"button\" style=\"width:100px;height:30px;border:0;background-color:#3c5168;color:#dddddd\" onclick=\"window.location.href='/update'\">Update</button></body>";
+                                      "&nbsp;&nbsp;<button class=\"button\" style=\"width:100px;height:30px;border:0;background-color:#3c5168;color:#dddddd\" onclick=\"window.location.href='/api/ota'\">Update</button></body>";
     request->send(200, "text/html", aboutResponse);
     bangLED(LOW);
 }
\ No newline at end of file
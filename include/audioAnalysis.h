@@ -0,0 +1,174 @@
+/*+===================================================================
+  File:      audioAnalysis.h
+
+  Summary:   Fixed-point audio analysis: a 16 band Goertzel bank
+             plus spectral-flux onset (beat) detection.
+
+             No Arduino dependencies so the same code runs on the
+             host (tools/audiobench.cpp) and in the I2S task on
+             the device (audioReactive.h).
+
+             Bands are log spaced between AUDIO_MIN_HZ and
+             AUDIO_MAX_HZ. Goertzel coefficients are Q14, state is
+             int32 with a 64 bit multiply so full scale 16 bit input
+             over a 512 sample block can't overflow. Band energies
+             come out as 0-255 log values (8 steps per octave of
+             power), which is what effects want anyway.
+
+             Each block is Hann windowed (Q15) before the bank. On a
+             rectangular block a tone between bins leaks into its
+             neighbours by an amount that depends on its phase, so
+             steady input made the band energies, and the flux,
+             swing from block to block. A beat also needs the level
+             to rise, so flux from a steady or decaying sound can't
+             fire one.
+
+  10/19/2026.
+===================================================================+*/
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#define AUDIO_BANDS 16
+#define AUDIO_SAMPLE_RATE 16000
+#define AUDIO_BLOCK_SIZE 512  // samples per analysis block, 32ms @ 16kHz
+#define AUDIO_MIN_HZ 60
+#define AUDIO_MAX_HZ 6000
+#define AUDIO_BEAT_HOLDOFF_MS 180 // minimum time between beats
+#define AUDIO_BEAT_MIN_LEVEL 40   // quieter blocks never beat
+#define AUDIO_FLUX_RANGE 40       // bands this far below the loudest add no flux, ~15 dB
+#define AUDIO_FLUX_FLOOR 56       // nor do bands below this, mic and I2S noise
+
+// One analysed block, published on the parameter bus.
+struct sAudioFrame
+{
+    uint8_t bands[AUDIO_BANDS]; // log energy per band, 0-255.
+    uint8_t level;              // overall loudness, 0-255.
+    uint8_t flux;               // spectral flux (onset strength), 0-255.
+    uint16_t beatCount;         // increments on every detected beat.
+    uint32_t seq;               // block sequence number.
+};
+
+struct sAudioAnalyzer
+{
+    int32_t coeff[AUDIO_BANDS]; // 2cos(w) in Q14.
+    int16_t window[AUDIO_BLOCK_SIZE];   // Hann, Q15.
+    int16_t windowed[AUDIO_BLOCK_SIZE]; // this block, kept off the task stack
+    uint8_t previous[AUDIO_BANDS];
+    uint8_t previousLevel;
+    uint32_t fluxAverage;       // EMA of flux, Q4.
+    uint32_t msSinceBeat;
+    sAudioFrame frame;
+};
+
+// 8 * log2(x), integer only. 0 for x == 0.
+uint8_t audioLog8(uint64_t x)
+{
+    if (x == 0)
+    {
+        return 0;
+    }
+    int msb = 63 - __builtin_clzll(x);
+    uint8_t frac = (msb >= 3) ? (uint8_t)((x >> (msb - 3)) & 0x07) : (uint8_t)((x << (3 - msb)) & 0x07);
+    int value = msb * 8 + frac;
+    return (uint8_t)(value > 255 ? 255 : value);
+}
+
+void audioAnalyzerInit(sAudioAnalyzer &a)
+{
+    memset(&a, 0, sizeof(a));
+    a.msSinceBeat = AUDIO_BEAT_HOLDOFF_MS; // the first block may beat
+    double ratio = pow((double)AUDIO_MAX_HZ / AUDIO_MIN_HZ, 1.0 / (AUDIO_BANDS - 1));
+    double hz = AUDIO_MIN_HZ;
+    for (int b = 0; b < AUDIO_BANDS; b++)
+    {
+        // Snap to the nearest bin so each band is a true Goertzel bin.
+        int k = (int)(0.5 + (AUDIO_BLOCK_SIZE * hz) / AUDIO_SAMPLE_RATE);
+        if (k < 1)
+        {
+            k = 1;
+        }
+        a.coeff[b] = (int32_t)lround(2.0 * cos(2.0 * M_PI * k / AUDIO_BLOCK_SIZE) * 16384.0);
+        hz *= ratio;
+    }
+    for (int n = 0; n < AUDIO_BLOCK_SIZE; n++)
+    {
+        a.window[n] = (int16_t)lround((0.5 - 0.5 * cos(2.0 * M_PI * n / AUDIO_BLOCK_SIZE)) * 32767.0);
+    }
+}
+
+// Analyse one block of AUDIO_BLOCK_SIZE signed 16 bit samples.
+// Returns true if the block contained a beat.
+bool audioAnalyzeBlock(sAudioAnalyzer &a, const int16_t *samples)
+{
+    const uint32_t blockMs = (AUDIO_BLOCK_SIZE * 1000) / AUDIO_SAMPLE_RATE;
+    uint64_t total = 0;
+    uint32_t flux = 0;
+    uint8_t loudest = 0;
+    for (int n = 0; n < AUDIO_BLOCK_SIZE; n++)
+    {
+        a.windowed[n] = (int16_t)(((int32_t)samples[n] * a.window[n]) >> 15);
+    }
+
+    for (int b = 0; b < AUDIO_BANDS; b++)
+    {
+        const int32_t coeff = a.coeff[b];
+        int32_t s1 = 0;
+        int32_t s2 = 0;
+        for (int n = 0; n < AUDIO_BLOCK_SIZE; n++)
+        {
+            int32_t s0 = a.windowed[n] + (int32_t)(((int64_t)coeff * s1) >> 14) - s2;
+            s2 = s1;
+            s1 = s0;
+        }
+
+        // |X(k)|^2 = s1^2 + s2^2 - coeff*s1*s2, scaled down to keep it in range.
+        int64_t power = (int64_t)s1 * s1 + (int64_t)s2 * s2 - ((((int64_t)coeff * s1) >> 14) * s2);
+        if (power < 0)
+        {
+            power = 0;
+        }
+        power <<= 2; // undo the window's coherent gain of 1/2, levels keep their old scale
+        total += (uint64_t)power >> 4; // average over the 16 bands
+
+        uint8_t energy = audioLog8((uint64_t)power >> 16);
+        loudest = energy > loudest ? energy : loudest;
+        a.frame.bands[b] = energy;
+    }
+
+    // Flux over the bands within AUDIO_FLUX_RANGE of the loudest and above the
+    // noise floor: the log of a near empty band jumps around with the noise
+    // and would swamp the rest.
+    uint8_t floor = loudest > AUDIO_FLUX_FLOOR + AUDIO_FLUX_RANGE ? loudest - AUDIO_FLUX_RANGE : AUDIO_FLUX_FLOOR;
+    for (int b = 0; b < AUDIO_BANDS; b++)
+    {
+        uint8_t energy = a.frame.bands[b] > floor ? a.frame.bands[b] : floor;
+        uint8_t previous = a.previous[b] > floor ? a.previous[b] : floor;
+        if (energy > previous)
+        {
+            flux += energy - previous;
+        }
+        a.previous[b] = a.frame.bands[b];
+    }
+
+    a.frame.level = audioLog8(total >> 16);
+    a.frame.flux = (uint8_t)(flux > 255 ? 255 : flux);
+    a.frame.seq++;
+
+    // Onset: flux well above its running average, on a rising level that's
+    // not near silence, and outside the hold-off window.
+    bool beat = false;
+    a.msSinceBeat += blockMs;
+    uint32_t flux4 = flux << 4;
+    bool rising = a.frame.level > a.previousLevel && a.frame.level >= AUDIO_BEAT_MIN_LEVEL;
+    a.previousLevel = a.frame.level;
+    if (rising && flux4 > (a.fluxAverage * 3) / 2 + (8 << 4) && a.msSinceBeat >= AUDIO_BEAT_HOLDOFF_MS)
+    {
+        beat = true;
+        a.msSinceBeat = 0;
+        a.frame.beatCount++;
+    }
+    a.fluxAverage = a.fluxAverage - (a.fluxAverage >> 3) + (flux4 >> 3);
+    return beat;
+}
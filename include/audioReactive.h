@@ -0,0 +1,109 @@
+/*+===================================================================
+  File:      audioReactive.h
+
+  Summary:   I2S microphone / line-in capture feeding the Goertzel
+             bank in audioAnalysis.h. Enable with USE_AUDIO_INPUT.
+
+             Capture and analysis run in their own task pinned to
+             core 0, the Arduino loop (and so rendering) stays on
+             core 1. Results go out on a small parameter bus: the
+             task fills one of two frames and flips an index, effects
+             call audioRead() to get the latest complete frame
+             without locking.
+
+             Wiring (INMP441 or similar): SCK=I2S_BCK_PIN,
+             WS=I2S_WS_PIN, SD=I2S_SD_PIN, L/R=GND.
+
+  10/19/2026.
+===================================================================+*/
+
+#include <Arduino.h>
+#include <audioAnalysis.h>
+
+#if USE_AUDIO_INPUT
+#include <driver/i2s.h>
+
+#define AUDIO_I2S_PORT I2S_NUM_0
+#define AUDIO_TASK_CORE 0
+
+// locals
+sAudioAnalyzer audioAnalyzer;
+sAudioFrame audioFrames[2];
+volatile uint8_t audioFront = 0; // index of the frame readers should use.
+int32_t audioRaw[AUDIO_BLOCK_SIZE];
+int16_t audioSamples[AUDIO_BLOCK_SIZE];
+TaskHandle_t audioTaskHandle = nullptr;
+
+void audioTask(void *param)
+{
+    for (;;)
+    {
+        size_t bytesRead = 0;
+        size_t wanted = sizeof(audioRaw);
+        uint8_t *dst = (uint8_t *)audioRaw;
+        while (wanted > 0)
+        {
+            i2s_read(AUDIO_I2S_PORT, dst, wanted, &bytesRead, portMAX_DELAY);
+            dst += bytesRead;
+            wanted -= bytesRead;
+        }
+
+        // 24 bit left-justified mic data down to 16 bits.
+        for (int i = 0; i < AUDIO_BLOCK_SIZE; i++)
+        {
+            audioSamples[i] = (int16_t)(audioRaw[i] >> 16);
+        }
+
+        audioAnalyzeBlock(audioAnalyzer, audioSamples);
+
+        uint8_t back = audioFront ^ 1;
+        audioFrames[back] = audioAnalyzer.frame;
+        audioFront = back;
+    }
+}
+
+void audioBegin()
+{
+    i2s_config_t config = {};
+    config.mode = (i2s_mode_t)(I2S_MODE_MASTER | I2S_MODE_RX);
+    config.sample_rate = AUDIO_SAMPLE_RATE;
+    config.bits_per_sample = I2S_BITS_PER_SAMPLE_32BIT;
+    config.channel_format = I2S_CHANNEL_FMT_ONLY_LEFT;
+    config.communication_format = I2S_COMM_FORMAT_STAND_I2S;
+    config.intr_alloc_flags = ESP_INTR_FLAG_LEVEL1;
+    config.dma_buf_count = 4;
+    config.dma_buf_len = AUDIO_BLOCK_SIZE / 2;
+
+    i2s_pin_config_t pins = {};
+    pins.bck_io_num = I2S_BCK_PIN;
+    pins.ws_io_num = I2S_WS_PIN;
+    pins.data_out_num = I2S_PIN_NO_CHANGE;
+    pins.data_in_num = I2S_SD_PIN;
+
+    if (i2s_driver_install(AUDIO_I2S_PORT, &config, 0, nullptr) != ESP_OK || i2s_set_pin(AUDIO_I2S_PORT, &pins) != ESP_OK)
+    {
+        Serial.println("Audio: I2S init failed.");
+        return;
+    }
+
+    audioAnalyzerInit(audioAnalyzer);
+    xTaskCreatePinnedToCore(audioTask, "audio", 4096, nullptr, 2, &audioTaskHandle, AUDIO_TASK_CORE);
+    Serial.println("Audio: I2S capture started.");
+}
+
+// Latest complete analysis frame. Safe to call from the render loop.
+void audioRead(sAudioFrame &frame)
+{
+    frame = audioFrames[audioFront];
+}
+
+#else
+
+void audioBegin() {}
+
+void audioRead(sAudioFrame &frame)
+{
+    memset(&frame, 0, sizeof(frame));
+}
+
+#endif
@@ -0,0 +1,361 @@
+/*+===================================================================
+  File:      bakedClip.h
+
+  Summary:   "Baked" animations. Capture records leds[] for N
+             seconds into a compressed, indexed clip on SPIFFS,
+             playback streams it back so an expensive effect costs
+             a memcpy and a show() per frame.
+
+             Clip layout:
+
+                frame records   variable size, see below
+                index           uint32_t offset per frame
+                sClipFooter     at the very end of the file
+
+             Each frame is XOR'd against the previous one and the
+             result run-length coded (clipCodec.h). Every
+             CLIP_KEYFRAME_EVERY frames is coded against black so
+             playback can start or loop from there.
+
+             Playback decodes on core 0 into a small ring of frame
+             buffers while the loop shows the current one, so the
+             next frame is always ready before it's due.
+
+             /clip runs on the AsyncTCP task, so clipStop() and a
+             clipPlay() that has to stop something first only post
+             the request. clipService() on the loop closes the
+             capture, or waits for the decoder to exit, closes the
+             file and starts any clip that was queued behind it.
+
+  10/19/2026.
+===================================================================+*/
+
+#include <Arduino.h>
+#include "SPIFFS.h"
+#include <clipCodec.h>
+
+#define CLIP_MAGIC 0x4C435742 // "BWCL"
+#define CLIP_VERSION 1
+#define CLIP_DIR "/clips/"
+#define CLIP_FRAME_MS 20         // capture rate, 50 fps
+#define CLIP_KEYFRAME_EVERY 64   // frames between keyframes
+#define CLIP_MAX_SECONDS 60
+#define CLIP_RING_SIZE 3         // decoded frames in flight
+#define CLIP_FRAME_BYTES (NUM_LEDS * sizeof(CRGB))
+
+struct sClipFooter
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t numLeds;
+    uint32_t frameCount;
+    uint16_t frameMs;
+    uint16_t keyframeEvery;
+    uint32_t indexOffset;
+};
+
+// globals
+bool g_clipCapturing = false;
+bool g_clipPlaying = false;
+
+// locals
+File clipFile;
+CRGB clipPrevious[NUM_LEDS];           // capture reference frame
+uint8_t clipScratch[CLIP_ENCODED_MAX(CLIP_FRAME_BYTES)];
+uint32_t *clipIndex = nullptr;
+uint32_t clipFrameCount = 0;
+uint32_t clipMaxFrames = 0;
+unsigned long clipLastFrameAt = 0;
+
+CRGB clipRing[CLIP_RING_SIZE][NUM_LEDS];
+QueueHandle_t clipFreeSlots = nullptr;
+QueueHandle_t clipReadySlots = nullptr;
+TaskHandle_t clipDecoderTask = nullptr;
+sClipFooter clipFooter;
+volatile bool clipStopRequested = false;     // decoder exits, loop finishes the stop
+volatile bool clipCaptureEndRequested = false;
+volatile bool clipPlayPending = false;       // start clipPendingName once stopped
+char clipPendingName[32];
+portMUX_TYPE clipPendingLock = portMUX_INITIALIZER_UNLOCKED;
+
+/*--------------------------------------------------------------------
+   Capture
+---------------------------------------------------------------------*/
+
+bool clipCaptureBegin(const String &name, int seconds)
+{
+    if (g_clipCapturing || g_clipPlaying)
+    {
+        return false;
+    }
+
+    seconds = constrain(seconds, 1, CLIP_MAX_SECONDS);
+    clipMaxFrames = (seconds * 1000) / CLIP_FRAME_MS;
+    clipIndex = (uint32_t *)malloc(clipMaxFrames * sizeof(uint32_t));
+    clipFile = SPIFFS.open(CLIP_DIR + name, FILE_WRITE);
+    if (!clipIndex || !clipFile)
+    {
+        free(clipIndex);
+        clipIndex = nullptr;
+        Serial.println("Clip: unable to start capture.");
+        return false;
+    }
+
+    clipFrameCount = 0;
+    clipLastFrameAt = millis();
+    clipCaptureEndRequested = false;
+    g_clipCapturing = true;
+    Serial.println("Clip: capturing " + name);
+    return true;
+}
+
+void clipCaptureEnd()
+{
+    if (!g_clipCapturing)
+    {
+        return;
+    }
+
+    sClipFooter footer;
+    footer.magic = CLIP_MAGIC;
+    footer.version = CLIP_VERSION;
+    footer.numLeds = NUM_LEDS;
+    footer.frameCount = clipFrameCount;
+    footer.frameMs = CLIP_FRAME_MS;
+    footer.keyframeEvery = CLIP_KEYFRAME_EVERY;
+    footer.indexOffset = clipFile.position();
+    clipFile.write((const uint8_t *)clipIndex, clipFrameCount * sizeof(uint32_t));
+    clipFile.write((const uint8_t *)&footer, sizeof(footer));
+    clipFile.close();
+
+    free(clipIndex);
+    clipIndex = nullptr;
+    g_clipCapturing = false;
+    logEvent(LOG_CLIP_CAPTURED, clipFrameCount);
+}
+
+void clipCaptureFrame()
+{
+    if (clipFrameCount % CLIP_KEYFRAME_EVERY == 0)
+    {
+        fill_solid(clipPrevious, NUM_LEDS, CRGB::Black);
+    }
+
+    size_t size = clipEncode((const uint8_t *)leds, (const uint8_t *)clipPrevious, clipScratch, CLIP_FRAME_BYTES);
+    clipIndex[clipFrameCount++] = clipFile.position();
+    clipFile.write(clipScratch, size);
+    memcpy(clipPrevious, leds, sizeof(clipPrevious));
+
+    if (clipFrameCount >= clipMaxFrames)
+    {
+        clipCaptureEnd();
+    }
+}
+
+/*--------------------------------------------------------------------
+   Playback
+---------------------------------------------------------------------*/
+
+// Decoder task: fills ring slots in order, each frame decoded on top of the previous one.
+void clipDecoderLoop(void *param)
+{
+    uint32_t frame = 0;
+    uint8_t previousSlot = CLIP_RING_SIZE - 1;
+    uint32_t offset;
+    uint32_t nextOffset;
+
+    while (!clipStopRequested)
+    {
+        uint8_t slot;
+        if (xQueueReceive(clipFreeSlots, &slot, pdMS_TO_TICKS(100)) != pdTRUE)
+        {
+            continue;
+        }
+
+        if (frame % clipFooter.keyframeEvery == 0)
+        {
+            fill_solid(clipRing[slot], NUM_LEDS, CRGB::Black);
+        }
+        else
+        {
+            memcpy(clipRing[slot], clipRing[previousSlot], CLIP_FRAME_BYTES);
+        }
+
+        // Frame size comes from the next index entry (or the index itself for the last frame).
+        clipFile.seek(clipFooter.indexOffset + frame * sizeof(uint32_t));
+        clipFile.read((uint8_t *)&offset, sizeof(offset));
+        if (frame + 1 < clipFooter.frameCount)
+        {
+            clipFile.read((uint8_t *)&nextOffset, sizeof(nextOffset));
+        }
+        else
+        {
+            nextOffset = clipFooter.indexOffset;
+        }
+
+        size_t size = min((size_t)(nextOffset - offset), sizeof(clipScratch));
+        clipFile.seek(offset);
+        clipFile.read(clipScratch, size);
+        clipDecode(clipScratch, size, (uint8_t *)clipRing[slot], CLIP_FRAME_BYTES);
+
+        xQueueSend(clipReadySlots, &slot, portMAX_DELAY);
+        previousSlot = slot;
+        frame = (frame + 1) % clipFooter.frameCount; // loop the clip
+    }
+
+    clipDecoderTask = nullptr;
+    vTaskDelete(nullptr);
+}
+
+// Safe from any task: asks the loop to end capture or playback and returns.
+// Also drops a clip queued by clipPlay().
+void clipStop()
+{
+    clipPlayPending = false;
+    if (g_clipCapturing)
+    {
+        clipCaptureEndRequested = true;
+    }
+    if (g_clipPlaying)
+    {
+        clipStopRequested = true;
+    }
+}
+
+bool clipStart(const char *name)
+{
+    if (g_clipCapturing || g_clipPlaying)
+    {
+        return false;
+    }
+
+    clipFile = SPIFFS.open(String(CLIP_DIR) + name, FILE_READ);
+    if (!clipFile || clipFile.size() < sizeof(sClipFooter))
+    {
+        logEvent(LOG_CLIP_BAD);
+        return false;
+    }
+
+    clipFile.seek(clipFile.size() - sizeof(sClipFooter));
+    clipFile.read((uint8_t *)&clipFooter, sizeof(clipFooter));
+    if (clipFooter.magic != CLIP_MAGIC || clipFooter.version != CLIP_VERSION ||
+        clipFooter.numLeds != NUM_LEDS || clipFooter.frameCount == 0)
+    {
+        logEvent(LOG_CLIP_BAD);
+        clipFile.close();
+        return false;
+    }
+
+    if (clipFreeSlots == nullptr)
+    {
+        clipFreeSlots = xQueueCreate(CLIP_RING_SIZE, sizeof(uint8_t));
+        clipReadySlots = xQueueCreate(CLIP_RING_SIZE, sizeof(uint8_t));
+    }
+    xQueueReset(clipFreeSlots);
+    xQueueReset(clipReadySlots);
+    for (uint8_t slot = 0; slot < CLIP_RING_SIZE; slot++)
+    {
+        xQueueSend(clipFreeSlots, &slot, 0);
+    }
+
+    clipStopRequested = false;
+    clipLastFrameAt = millis();
+    g_clipPlaying = true;
+    xTaskCreatePinnedToCore(clipDecoderLoop, "clip", 3072, nullptr, 1, &clipDecoderTask, 0);
+    logEvent(LOG_CLIP_PLAY, clipFooter.frameCount);
+    return true;
+}
+
+// Starts now if nothing is running, otherwise stops what is and queues
+// the name for clipService() to start once the stop has finished.
+bool clipPlay(const String &name)
+{
+    if (name.length() == 0 || name.length() >= sizeof(clipPendingName))
+    {
+        return false;
+    }
+    if (!g_clipCapturing && !g_clipPlaying && !clipPlayPending)
+    {
+        return clipStart(name.c_str());
+    }
+
+    clipStop();
+    portENTER_CRITICAL(&clipPendingLock);
+    strcpy(clipPendingName, name.c_str());
+    clipPlayPending = true;
+    portEXIT_CRITICAL(&clipPendingLock);
+    return true;
+}
+
+const char *clipStatus()
+{
+    if (clipPlayPending)
+    {
+        return "Starting";
+    }
+    if ((g_clipCapturing && clipCaptureEndRequested) || (g_clipPlaying && clipStopRequested))
+    {
+        return "Stopping";
+    }
+    return g_clipCapturing ? "Capturing" : (g_clipPlaying ? "Playing" : "Stopped");
+}
+
+// Loop side of clipStop(): true while a stop is still in progress.
+bool clipFinishStop()
+{
+    if (g_clipCapturing && clipCaptureEndRequested)
+    {
+        clipCaptureEnd();
+        clipCaptureEndRequested = false;
+    }
+    if (g_clipPlaying && clipStopRequested)
+    {
+        if (clipDecoderTask != nullptr)
+        {
+            return true; // decoder notices within one queue timeout
+        }
+        clipFile.close();
+        g_clipPlaying = false;
+    }
+
+    if (clipPlayPending && !g_clipCapturing && !g_clipPlaying)
+    {
+        char name[sizeof(clipPendingName)];
+        portENTER_CRITICAL(&clipPendingLock);
+        strcpy(name, clipPendingName);
+        clipPlayPending = false;
+        portEXIT_CRITICAL(&clipPendingLock);
+        clipStart(name);
+    }
+    return false;
+}
+
+// Called from loop(), captures or plays back one frame when it's due.
+void clipService()
+{
+    if (clipFinishStop() || (!g_clipCapturing && !g_clipPlaying))
+    {
+        return;
+    }
+
+    uint16_t frameMs = g_clipPlaying ? clipFooter.frameMs : CLIP_FRAME_MS;
+    if (millis() - clipLastFrameAt < frameMs)
+    {
+        return;
+    }
+    clipLastFrameAt += frameMs;
+
+    if (g_clipCapturing)
+    {
+        clipCaptureFrame();
+        return;
+    }
+
+    uint8_t slot;
+    if (xQueueReceive(clipReadySlots, &slot, 0) == pdTRUE)
+    {
+        memcpy(leds, clipRing[slot], CLIP_FRAME_BYTES);
+        xQueueSend(clipFreeSlots, &slot, 0);
+        ledShow();
+    }
+}
@@ -0,0 +1,140 @@
+/*+===================================================================
+  File:      bootSequencer.h
+
+  Summary:   Boot order and boot timing. setup() brings the strip up
+             first: FastLED, the scene saved in NVS, and the first
+             frame out to the LEDs (first light). Only then does it
+             do the display and the local inputs. The network goes
+             last, to a "net" task on core 0, so a slow WiFi join
+             (up to 45 s before startWifi() gives up and restarts)
+             never keeps the strip dark:
+
+                setup()    leds, scene, first light, display, inputs
+                net task   chip info, SPIFFS, WiFi + mDNS, HTTP, ws
+                loop()     UDP fast path and DMX listeners, once the
+                           net task is done, so they start on the
+                           loop task (they take its handle) with a
+                           network under them
+
+             Each stage is timed with esp_timer, which counts from
+             app start (the ROM and second stage bootloader before
+             it aren't included, typically ~250 ms on the ESP32).
+             The goal is first light within BOOT_FIRST_LIGHT_GOAL_MS.
+
+                GET /api/boot    stages, first light, network up
+
+  10/19/2026.
+===================================================================+*/
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include <esp_timer.h>
+
+#define BOOT_STAGES_MAX 16
+#define BOOT_FIRST_LIGHT_GOAL_MS 300
+#define BOOT_NET_STACK 8192
+
+struct sBootStage
+{
+    const char *name;
+    const char *task;
+    int64_t startUs;
+    int64_t endUs; // 0 while running
+};
+
+// externs
+extern volatile uint32_t g_statusVersion;
+
+// locals
+sBootStage bootStages[BOOT_STAGES_MAX];
+int bootStageCount = 0;
+portMUX_TYPE bootLock = portMUX_INITIALIZER_UNLOCKED;
+int64_t bootFirstLightUs = 0;
+int64_t bootNetworkUpUs = 0;
+volatile bool bootNetworkDone = false;
+bool bootNetworkServiced = false;
+void (*bootNetworkFinish)() = nullptr; // the loop task's half of the network start
+
+// Start a timed stage, returns its handle for bootEnd(). Any task.
+int bootBegin(const char *name)
+{
+    portENTER_CRITICAL(&bootLock);
+    int stage = bootStageCount < BOOT_STAGES_MAX ? bootStageCount++ : -1;
+    portEXIT_CRITICAL(&bootLock);
+    if (stage >= 0)
+    {
+        bootStages[stage].name = name;
+        bootStages[stage].task = pcTaskGetTaskName(nullptr);
+        bootStages[stage].startUs = esp_timer_get_time();
+        bootStages[stage].endUs = 0;
+    }
+    return stage;
+}
+
+void bootEnd(int stage)
+{
+    if (stage >= 0)
+    {
+        bootStages[stage].endUs = esp_timer_get_time();
+    }
+}
+
+// The first frame is on the strip.
+void bootFirstLight()
+{
+    bootFirstLightUs = esp_timer_get_time();
+    Serial.printf("Boot: first light at %lld ms%s\n", bootFirstLightUs / 1000,
+                  bootFirstLightUs / 1000 > BOOT_FIRST_LIGHT_GOAL_MS ? ", over the goal" : "");
+}
+
+bool bootNetworkUp()
+{
+    return bootNetworkDone;
+}
+
+void bootNetTask(void *param)
+{
+    ((void (*)())param)();
+    bootNetworkUpUs = esp_timer_get_time();
+    bootNetworkDone = true;
+    g_statusVersion++; // the status line has something to show now
+    vTaskDelete(nullptr);
+}
+
+// From setup(): runs start on the net task, then finish on the loop task once it's done.
+void bootNetworkStart(void (*start)(), void (*finish)())
+{
+    bootNetworkFinish = finish;
+    xTaskCreatePinnedToCore(bootNetTask, "net", BOOT_NET_STACK, (void *)start, 1, nullptr, 0);
+}
+
+// Called from loop().
+void bootService()
+{
+    if (bootNetworkServiced || !bootNetworkDone)
+    {
+        return;
+    }
+    bootNetworkServiced = true;
+    if (bootNetworkFinish != nullptr)
+    {
+        bootNetworkFinish();
+    }
+    Serial.printf("Boot: network up at %lld ms\n", bootNetworkUpUs / 1000);
+}
+
+void handleBoot(AsyncWebServerRequest *request)
+{
+    AsyncResponseStream *response = request->beginResponseStream("application/json");
+    response->printf("{\"firstLightMs\":%lld,\"goalMs\":%d,\"networkUpMs\":%lld,\"stages\":[", bootFirstLightUs / 1000,
+                     BOOT_FIRST_LIGHT_GOAL_MS, bootNetworkUpUs / 1000);
+    for (int i = 0; i < bootStageCount; i++)
+    {
+        const sBootStage &stage = bootStages[i];
+        response->printf("%s{\"name\":\"%s\",\"task\":\"%s\",\"startMs\":%.1f,\"ms\":%.1f}", i ? "," : "", stage.name,
+                         stage.task, stage.startUs / 1000.0,
+                         stage.endUs ? (stage.endUs - stage.startUs) / 1000.0 : -1.0);
+    }
+    response->print("]}");
+    request->send(response);
+}
@@ -0,0 +1,81 @@
+/*+===================================================================
+  File:      clipCodec.h
+
+  Summary:   Frame codec for baked clips (bakedClip.h). A frame is
+             XOR'd against a reference frame and the result run-
+             length coded: a token byte with the high bit set skips
+             (n & 0x7F) + 1 unchanged bytes, otherwise n + 1 literal
+             bytes follow. Decoding applies the tokens on top of a
+             copy of the reference.
+
+             Encoded output never exceeds CLIP_ENCODED_MAX(bytes),
+             which is what the capture scratch buffer is sized to.
+
+             No Arduino dependencies so tools/clipbench.cpp can
+             round trip frames on the host.
+
+  10/19/2026.
+===================================================================+*/
+
+#include <stdint.h>
+#include <stddef.h>
+
+// One token per 128 bytes of input at worst, plus a partial block.
+#define CLIP_ENCODED_MAX(bytes) ((bytes) + (bytes) / 128 + 2)
+
+// XOR cur against ref and run-length code the result. Returns encoded size.
+size_t clipEncode(const uint8_t *cur, const uint8_t *ref, uint8_t *out, size_t bytes)
+{
+    size_t n = 0;
+    size_t i = 0;
+    while (i < bytes)
+    {
+        size_t run = 0;
+        while (i + run < bytes && run < 128 && cur[i + run] == ref[i + run])
+        {
+            run++;
+        }
+        // Single unchanged bytes go out as literals, which keeps the
+        // worst case output at one token per 128 bytes of input.
+        if (run >= 2 || (run == 1 && i + 1 == bytes))
+        {
+            out[n++] = 0x80 | (run - 1);
+            i += run;
+            continue;
+        }
+
+        size_t start = i;
+        while (i < bytes && i - start < 128 && !(cur[i] == ref[i] && i + 1 < bytes && cur[i + 1] == ref[i + 1]))
+        {
+            i++;
+        }
+        out[n++] = (uint8_t)(i - start - 1);
+        for (size_t k = start; k < i; k++)
+        {
+            out[n++] = cur[k] ^ ref[k];
+        }
+    }
+    return n;
+}
+
+// Apply an encoded frame on top of frame, which holds the reference.
+// A short or damaged record stops at whichever end comes first.
+void clipDecode(const uint8_t *in, size_t len, uint8_t *frame, size_t bytes)
+{
+    size_t i = 0;
+    size_t pos = 0;
+    while (pos < len && i < bytes)
+    {
+        uint8_t token = in[pos++];
+        size_t count = (token & 0x7F) + 1;
+        if (token & 0x80)
+        {
+            i += count;
+            continue;
+        }
+        for (size_t k = 0; k < count && i < bytes && pos < len; k++)
+        {
+            frame[i++] ^= in[pos++];
+        }
+    }
+}
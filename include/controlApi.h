@@ -0,0 +1,184 @@
+/*+===================================================================
+  File:      controlApi.h
+
+  Summary:   /api/v1/state, the control panel's API. One POST
+             carries every change the UI has queued since its last
+             request and the response is the state after applying
+             them, so the page never has to ask twice:
+
+                GET  /api/v1/state    current state
+                POST /api/v1/state    {"hue":20,"bri":180,...}, see
+                                      controlRequest.h for the keys
+
+             The body is parsed chunk by chunk as the server receives
+             it; the parser lives in the request's _tempObject and
+             the server frees it with the request. Changes apply in
+             one go once the body is complete: a preset recall first,
+             then animation, swat, hue, sat, val, bri and palette in
+             the same order the old query string handler used, then
+             a preset save. Slots and the animation are checked
+             (controlCheck()) before any of it is applied, so a bad
+             body changes nothing and returns 400 with the error,
+             its byte offset and the unchanged state.
+
+             The / query string handler (handleControl) still works
+             for anything scripted against it.
+
+  10/19/2026.
+===================================================================+*/
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include <controlRequest.h>
+
+// externs
+extern uint8_t g_briteValue;
+extern CHSV g_chsvColor;
+extern Mode g_mode;
+extern int8_t g_animation;
+extern uint8_t g_paletteId;
+
+// prototypes
+bool presetSave(int slot);
+bool presetRecall(int slot);
+uint32_t presetUsable();
+void presetTouch();
+
+const char *modeName(Mode mode)
+{
+    switch (mode)
+    {
+    case Bright:
+        return "bright";
+    case Animation:
+        return "animation";
+    case SolidColor:
+        return "solid";
+    default:
+        return "off";
+    }
+}
+
+void printState(AsyncResponseStream *response)
+{
+    response->printf("\"mode\":\"%s\",\"animation\":%d,\"hue\":%u,\"sat\":%u,\"val\":%u,\"bri\":%u,\"palette\":%u",
+                     modeName(g_mode), g_animation, g_chsvColor.hue, g_chsvColor.sat, g_chsvColor.val, g_briteValue,
+                     g_paletteId);
+}
+
+// Checks the whole change first, a change that fails leaves everything as it was.
+bool applyControlChange(const sControlChange &change, const char *&error)
+{
+    sControlLimits limits = {PRESET_COUNT, presetUsable(), animationKnown};
+    error = controlCheck(change, limits);
+    if (error != nullptr)
+    {
+        return false;
+    }
+
+    if (controlHas(change, CK_PRESET))
+    {
+        presetRecall(change.value[CK_PRESET]);
+    }
+    if (controlHas(change, CK_ANIMATION))
+    {
+        g_animation = change.value[CK_ANIMATION];
+        g_mode = (g_animation < 0) ? Off : Animation;
+    }
+    if (controlHas(change, CK_SWAT))
+    {
+        g_chsvColor = CHSV(change.swat[0], change.swat[1], change.swat[2]);
+        g_mode = SolidColor;
+    }
+    if (controlHas(change, CK_HUE))
+    {
+        g_chsvColor.hue = change.value[CK_HUE];
+    }
+    if (controlHas(change, CK_SAT))
+    {
+        g_chsvColor.sat = change.value[CK_SAT];
+    }
+    if (controlHas(change, CK_VAL))
+    {
+        g_chsvColor.val = change.value[CK_VAL];
+    }
+    if (controlHas(change, CK_BRI))
+    {
+        g_briteValue = change.value[CK_BRI];
+        FastLED.setBrightness(g_briteValue);
+    }
+    if (controlHas(change, CK_PALETTE))
+    {
+        g_paletteId = change.value[CK_PALETTE];
+    }
+    if (change.set & ~((1u << CK_PRESET) | (1u << CK_SAVE)))
+    {
+        presetTouch();
+    }
+    if (controlHas(change, CK_SAVE))
+    {
+        presetSave(change.value[CK_SAVE]);
+    }
+    return true;
+}
+
+void handleStateBody(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total)
+{
+    if (index == 0)
+    {
+        request->_tempObject = malloc(sizeof(sControlParser));
+        if (request->_tempObject == nullptr)
+        {
+            return;
+        }
+        controlParseBegin(*(sControlParser *)request->_tempObject);
+    }
+    if (request->_tempObject != nullptr)
+    {
+        controlParse(*(sControlParser *)request->_tempObject, data, len);
+    }
+}
+
+// GET, or a POST once its body is in.
+void handleState(AsyncWebServerRequest *request)
+{
+    int status = 200;
+    const char *error = nullptr;
+    uint32_t errorAt = 0;
+    uint16_t applied = 0;
+    uint16_t ignored = 0;
+
+    if (request->method() == HTTP_POST)
+    {
+        sControlParser *parser = (sControlParser *)request->_tempObject;
+        if (parser == nullptr)
+        {
+            error = request->contentLength() ? "out of memory" : "empty body";
+            status = request->contentLength() ? 503 : 400;
+        }
+        else if (!controlParseEnd(*parser))
+        {
+            error = parser->error;
+            errorAt = parser->offset;
+            status = 400;
+        }
+        else
+        {
+            applied = parser->change.fields - parser->change.ignored;
+            ignored = parser->change.ignored;
+            status = applyControlChange(parser->change, error) ? 200 : 400;
+        }
+    }
+
+    AsyncResponseStream *response = request->beginResponseStream("application/json");
+    response->setCode(status);
+    response->printf("{\"ok\":%s,", error ? "false" : "true");
+    if (error)
+    {
+        response->printf("\"error\":\"%s\",\"at\":%u,", error, errorAt);
+    }
+    response->printf("\"applied\":%u,\"ignored\":%u,", applied, ignored);
+    printState(response);
+    response->print("}");
+    request->send(response);
+}
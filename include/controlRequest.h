@@ -0,0 +1,463 @@
+/*+===================================================================
+  File:      controlRequest.h
+
+  Summary:   Parser for POST /api/v1/state bodies: one flat JSON
+             object carrying any number of control changes at once.
+
+                {"animation":3,"bri":180}
+                {"swat":[29,170,216],"bri":255,"save":4}
+
+             Keys: animation (-1..127), hue, sat, val, bri, palette
+             (0..255), swat ([h,s,v]), preset (recall a slot) and
+             save (store to a slot). A key given twice keeps the last
+             value. Unknown keys are skipped if their value is a
+             number or array of numbers, and counted.
+
+             The body is parsed as it arrives, straight out of each
+             chunk the server hands over: the parser keeps a few
+             bytes of state (at most CONTROL_KEY_MAX of the current
+             key), never the body, so a body of any size split
+             anywhere costs the same. Strings, nesting, fractions and
+             out of range values are errors, reported with the byte
+             offset they were found at.
+
+             controlCheck() then does the checks that need the
+             device's state (preset slots in use, animations built
+             in), so the caller can refuse a change before applying
+             any of it.
+
+             No Arduino dependencies, tools/controlbench.cpp runs it
+             on the host.
+
+  10/19/2026.
+===================================================================+*/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#define CONTROL_KEY_MAX 12
+#define CONTROL_NUMBER_MAX 100000 // clamp while reading, anything near it is out of range anyway
+
+enum ControlKey
+{
+    CK_ANIMATION,
+    CK_HUE,
+    CK_SAT,
+    CK_VAL,
+    CK_BRI,
+    CK_PALETTE,
+    CK_PRESET,
+    CK_SAVE,
+    CK_SWAT,
+    CK_COUNT,
+    CK_UNKNOWN = CK_COUNT
+};
+
+struct sControlKeyInfo
+{
+    const char *name;
+    int32_t min;
+    int32_t max;
+};
+
+const sControlKeyInfo controlKeys[CK_COUNT] = {
+    {"animation", -1, 127},
+    {"hue", 0, 255},
+    {"sat", 0, 255},
+    {"val", 0, 255},
+    {"bri", 0, 255},
+    {"palette", 0, 255},
+    {"preset", 0, 255}, // slot range is checked by controlCheck()
+    {"save", 0, 255},
+    {"swat", 0, 255},   // each of h, s, v
+};
+
+enum ControlParseState
+{
+    CP_START,
+    CP_KEY_OR_END,
+    CP_KEY_START,
+    CP_KEY,
+    CP_COLON,
+    CP_VALUE,
+    CP_NUMBER,
+    CP_ARRAY_VALUE,
+    CP_ARRAY_NUMBER,
+    CP_ARRAY_NEXT,
+    CP_NEXT,
+    CP_DONE,
+    CP_ERROR
+};
+
+struct sControlChange
+{
+    uint32_t set;           // bit per ControlKey
+    int32_t value[CK_COUNT];
+    uint8_t swat[3];
+    uint16_t fields;        // key/value pairs read, including unknown ones
+    uint16_t ignored;       // unknown keys
+};
+
+struct sControlParser
+{
+    sControlChange change;
+    uint8_t state;
+    uint8_t keyLen;
+    uint8_t key;            // ControlKey being read
+    uint8_t arrayIndex;
+    bool negative;
+    bool digits;
+    int32_t number;
+    uint32_t offset;        // bytes consumed so far
+    const char *error;
+    char keyText[CONTROL_KEY_MAX + 1];
+};
+
+void controlParseBegin(sControlParser &parser)
+{
+    memset(&parser, 0, sizeof(parser));
+    parser.state = CP_START;
+}
+
+bool controlParseFail(sControlParser &parser, const char *error)
+{
+    parser.error = error;
+    parser.state = CP_ERROR;
+    return false;
+}
+
+bool controlIsSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+uint8_t controlLookupKey(const char *text)
+{
+    for (int k = 0; k < CK_COUNT; k++)
+    {
+        if (strcmp(controlKeys[k].name, text) == 0)
+        {
+            return k;
+        }
+    }
+    return CK_UNKNOWN;
+}
+
+void controlNumberBegin(sControlParser &parser, char c)
+{
+    parser.negative = c == '-';
+    parser.digits = !parser.negative;
+    parser.number = parser.negative ? 0 : c - '0';
+}
+
+// Another digit, false when c ends the number.
+bool controlNumberFeed(sControlParser &parser, char c)
+{
+    if (c < '0' || c > '9')
+    {
+        return false;
+    }
+    parser.digits = true;
+    if (parser.number < CONTROL_NUMBER_MAX)
+    {
+        parser.number = parser.number * 10 + (c - '0');
+    }
+    return true;
+}
+
+bool controlNumberEnd(sControlParser &parser, int32_t &value)
+{
+    if (!parser.digits)
+    {
+        return controlParseFail(parser, "bad number");
+    }
+    value = parser.negative ? -parser.number : parser.number;
+    if (parser.key != CK_UNKNOWN && (value < controlKeys[parser.key].min || value > controlKeys[parser.key].max))
+    {
+        return controlParseFail(parser, "value out of range");
+    }
+    return true;
+}
+
+bool controlStoreNumber(sControlParser &parser)
+{
+    int32_t value;
+    if (!controlNumberEnd(parser, value))
+    {
+        return false;
+    }
+    if (parser.key == CK_SWAT)
+    {
+        return controlParseFail(parser, "swat takes [h,s,v]");
+    }
+    if (parser.key != CK_UNKNOWN)
+    {
+        parser.change.value[parser.key] = value;
+        parser.change.set |= 1u << parser.key;
+    }
+    return true;
+}
+
+bool controlStoreArrayNumber(sControlParser &parser)
+{
+    int32_t value;
+    if (!controlNumberEnd(parser, value))
+    {
+        return false;
+    }
+    if (parser.key == CK_SWAT && parser.arrayIndex < 3)
+    {
+        parser.change.swat[parser.arrayIndex] = value;
+    }
+    else if (parser.key != CK_UNKNOWN)
+    {
+        return controlParseFail(parser, "array where a number was expected");
+    }
+    parser.arrayIndex++;
+    return true;
+}
+
+bool controlStoreArrayEnd(sControlParser &parser)
+{
+    if (parser.key == CK_SWAT)
+    {
+        if (parser.arrayIndex != 3)
+        {
+            return controlParseFail(parser, "swat takes [h,s,v]");
+        }
+        parser.change.set |= 1u << CK_SWAT;
+    }
+    return true;
+}
+
+// Feed the next piece of the body, as many times as it takes. False once the body is bad.
+bool controlParse(sControlParser &parser, const uint8_t *data, size_t len)
+{
+    for (size_t i = 0; i < len; i++, parser.offset++)
+    {
+        char c = data[i];
+        switch (parser.state)
+        {
+        case CP_START:
+            if (c == '{')
+            {
+                parser.state = CP_KEY_OR_END;
+            }
+            else if (!controlIsSpace(c))
+            {
+                return controlParseFail(parser, "expected {");
+            }
+            break;
+
+        case CP_KEY_OR_END:
+        case CP_KEY_START:
+            if (c == '"')
+            {
+                parser.keyLen = 0;
+                parser.state = CP_KEY;
+            }
+            else if (c == '}' && parser.state == CP_KEY_OR_END)
+            {
+                parser.state = CP_DONE;
+            }
+            else if (!controlIsSpace(c))
+            {
+                return controlParseFail(parser, "expected a key");
+            }
+            break;
+
+        case CP_KEY:
+            if (c == '"')
+            {
+                parser.keyText[parser.keyLen <= CONTROL_KEY_MAX ? parser.keyLen : CONTROL_KEY_MAX] = 0;
+                parser.key = parser.keyLen <= CONTROL_KEY_MAX ? controlLookupKey(parser.keyText) : (uint8_t)CK_UNKNOWN;
+                parser.state = CP_COLON;
+            }
+            else if (c == '\\' || (uint8_t)c < 0x20)
+            {
+                return controlParseFail(parser, "bad key");
+            }
+            else if (parser.keyLen <= CONTROL_KEY_MAX)
+            {
+                // Counting one past the limit marks it too long, no known key is.
+                if (parser.keyLen < CONTROL_KEY_MAX)
+                {
+                    parser.keyText[parser.keyLen] = c;
+                }
+                parser.keyLen++;
+            }
+            break;
+
+        case CP_COLON:
+            if (c == ':')
+            {
+                parser.state = CP_VALUE;
+            }
+            else if (!controlIsSpace(c))
+            {
+                return controlParseFail(parser, "expected :");
+            }
+            break;
+
+        case CP_VALUE:
+            if (c == '-' || (c >= '0' && c <= '9'))
+            {
+                controlNumberBegin(parser, c);
+                parser.state = CP_NUMBER;
+            }
+            else if (c == '[')
+            {
+                parser.arrayIndex = 0;
+                parser.state = CP_ARRAY_VALUE;
+            }
+            else if (!controlIsSpace(c))
+            {
+                return controlParseFail(parser, "values are numbers or [numbers]");
+            }
+            break;
+
+        case CP_NUMBER:
+            if (controlNumberFeed(parser, c))
+            {
+                break;
+            }
+            if (!controlStoreNumber(parser))
+            {
+                return false;
+            }
+            parser.change.fields++;
+            parser.change.ignored += parser.key == CK_UNKNOWN;
+            parser.state = CP_NEXT;
+            i--; // c belongs to what follows the value
+            parser.offset--;
+            break;
+
+        case CP_ARRAY_VALUE:
+            if (c == '-' || (c >= '0' && c <= '9'))
+            {
+                controlNumberBegin(parser, c);
+                parser.state = CP_ARRAY_NUMBER;
+            }
+            else if (c == ']' && parser.arrayIndex == 0)
+            {
+                i--;
+                parser.offset--;
+                parser.state = CP_ARRAY_NEXT;
+            }
+            else if (!controlIsSpace(c))
+            {
+                return controlParseFail(parser, "arrays hold numbers");
+            }
+            break;
+
+        case CP_ARRAY_NUMBER:
+            if (controlNumberFeed(parser, c))
+            {
+                break;
+            }
+            if (!controlStoreArrayNumber(parser))
+            {
+                return false;
+            }
+            parser.state = CP_ARRAY_NEXT;
+            i--;
+            parser.offset--;
+            break;
+
+        case CP_ARRAY_NEXT:
+            if (c == ',')
+            {
+                parser.state = CP_ARRAY_VALUE;
+            }
+            else if (c == ']')
+            {
+                if (!controlStoreArrayEnd(parser))
+                {
+                    return false;
+                }
+                parser.change.fields++;
+                parser.change.ignored += parser.key == CK_UNKNOWN;
+                parser.state = CP_NEXT;
+            }
+            else if (!controlIsSpace(c))
+            {
+                return controlParseFail(parser, "expected , or ]");
+            }
+            break;
+
+        case CP_NEXT:
+            if (c == ',')
+            {
+                parser.state = CP_KEY_START;
+            }
+            else if (c == '}')
+            {
+                parser.state = CP_DONE;
+            }
+            else if (!controlIsSpace(c))
+            {
+                return controlParseFail(parser, "expected , or }");
+            }
+            break;
+
+        case CP_DONE:
+            if (!controlIsSpace(c))
+            {
+                return controlParseFail(parser, "data after }");
+            }
+            break;
+
+        default:
+            return false;
+        }
+    }
+    return true;
+}
+
+// After the last chunk: true if the body was one complete object.
+bool controlParseEnd(sControlParser &parser)
+{
+    if (parser.state == CP_ERROR)
+    {
+        return false;
+    }
+    if (parser.state != CP_DONE)
+    {
+        return controlParseFail(parser, "body ended early");
+    }
+    return true;
+}
+
+bool controlHas(const sControlChange &change, ControlKey key)
+{
+    return (change.set & (1u << key)) != 0;
+}
+
+// What controlCheck() needs to know about the device.
+struct sControlLimits
+{
+    int presetCount;               // at most 32
+    uint32_t presetsUsable;        // bit per slot holding a scene that recalls
+    bool (*animationKnown)(int id);
+};
+
+// The checks a parsed change can only fail against the device. Returns the
+// error, or nullptr if every part of the change will apply.
+const char *controlCheck(const sControlChange &change, const sControlLimits &limits)
+{
+    if (controlHas(change, CK_PRESET) &&
+        (change.value[CK_PRESET] >= limits.presetCount || !((limits.presetsUsable >> change.value[CK_PRESET]) & 1)))
+    {
+        return "empty or bad preset slot";
+    }
+    if (controlHas(change, CK_ANIMATION) && !limits.animationKnown(change.value[CK_ANIMATION]))
+    {
+        return "unknown animation";
+    }
+    if (controlHas(change, CK_SAVE) && change.value[CK_SAVE] >= limits.presetCount)
+    {
+        return "bad preset slot to save";
+    }
+    return nullptr;
+}
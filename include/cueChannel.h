@@ -0,0 +1,144 @@
+/*+===================================================================
+  File:      cueChannel.h
+
+  Summary:   Reliable fire cues to sub-controllers over WebSocket,
+             using reliableCue.h. Sessions that send role:sub are
+             attached as receivers and get cue:<epoch>:<seq>:<payload>
+             until they ack; everyone else subscribed to the cues topic
+             still gets the plain "Push Notice: ..." line.
+
+             Acks and role changes arrive on the AsyncTCP task, so
+             they are queued and applied from loop() along with the
+             retransmits. The sender state is only touched from loop.
+
+                GET /api/cues    per-sub latency and retry stats
+
+  10/19/2026.
+===================================================================+*/
+
+#include <Arduino.h>
+#include <reliableCue.h>
+#include <esp_system.h>
+
+#define CUE_EVENT_QUEUE 32
+
+enum CueEventType
+{
+    CUE_EVT_ATTACH,
+    CUE_EVT_DETACH,
+    CUE_EVT_ACK
+};
+
+struct sCueEvent
+{
+    uint8_t type;
+    uint8_t slot;
+    uint16_t seq;
+    uint64_t seen;
+};
+
+// locals
+sCueSender cueSender;
+QueueHandle_t cueEvents = nullptr;
+
+// Sender transport: to the session's client by id, a full queue is just a lost packet. ws looks the id
+// up each time, a client that has disconnected (and been freed by AsyncTCP) is simply not found.
+void cueWsSend(uint8_t slot, const char *msg, void *ctx)
+{
+    uint32_t id = wsSessions[slot].id;
+    if (ws.availableForWrite(id))
+    {
+        ws.text(id, msg);
+    }
+}
+
+void cueChannelBegin()
+{
+    cueSenderInit(cueSender, cueWsSend, nullptr, esp_random()); // new epoch every boot, see reliableCue.h
+    cueEvents = xQueueCreate(CUE_EVENT_QUEUE, sizeof(sCueEvent));
+}
+
+// Any task. Queues an attach/detach for loop().
+void cueChannelAttach(uint8_t slot, bool attach)
+{
+    sCueEvent event = {(uint8_t)(attach ? CUE_EVT_ATTACH : CUE_EVT_DETACH), slot, 0, 0};
+    xQueueSend(cueEvents, &event, 0);
+}
+
+// AsyncTCP task. Returns false if text isn't an ack.
+bool cueChannelAck(uint8_t slot, const char *text)
+{
+    uint16_t seq;
+    const char *mask;
+    sCueEvent event = {CUE_EVT_ACK, slot, 0, 1};
+    if (cueParse(text, "ack:", seq, &mask))
+    {
+        event.seen = strtoull(mask, nullptr, 16) | 1;
+    }
+    else if (!cueParse(text, "ack:", seq, nullptr))
+    {
+        return false;
+    }
+    event.seq = seq;
+    xQueueSend(cueEvents, &event, 0);
+    return true;
+}
+
+// Fire a cue: reliable to subs, best effort notice to UI clients.
+void cueFire(const char *payload)
+{
+    cueSend(cueSender, payload, millis());
+
+    FixedString<CUE_PAYLOAD + 16> notice("Push Notice: ");
+    wsPublish(TOPIC_CUES, notice.append(payload).c_str());
+}
+
+bool cueChannelBusy()
+{
+    return cuePending(cueSender);
+}
+
+// Called from loop(): apply queued acks and role changes, then resend what's due.
+void cueChannelService()
+{
+    sCueEvent event;
+    while (xQueueReceive(cueEvents, &event, 0) == pdTRUE)
+    {
+        switch (event.type)
+        {
+        case CUE_EVT_ATTACH:
+            cueSubAttach(cueSender, event.slot);
+            break;
+        case CUE_EVT_DETACH:
+            cueSubDetach(cueSender, event.slot);
+            break;
+        case CUE_EVT_ACK:
+            cueOnAck(cueSender, event.slot, event.seq, event.seen, millis());
+            break;
+        }
+    }
+    cueSenderService(cueSender, millis());
+}
+
+void handleCues(AsyncWebServerRequest *request)
+{
+    AsyncResponseStream *response = request->beginResponseStream("application/json");
+    response->printf("{\"epoch\":\"%08x\",\"nextSeq\":%u,\"subs\":[", cueSender.epoch, cueSender.nextSeq);
+    bool first = true;
+    for (uint8_t slot = 0; slot < CUE_MAX_SUBS; slot++)
+    {
+        if (!(cueSender.attached & (1 << slot)))
+        {
+            continue;
+        }
+        const sCueSub &sub = cueSender.subs[slot];
+        response->printf("%s{\"slot\":%u,\"id\":%u,\"sent\":%u,\"retransmits\":%u,\"acked\":%u,\"expired\":%u,"
+                         "\"pending\":%u,\"rttMs\":%u,\"latencyAvgMs\":%u,\"latencyMaxMs\":%u}",
+                         first ? "" : ",", slot, wsSessions[slot].id, sub.stats.sent, sub.stats.retransmits,
+                         sub.stats.acked, sub.stats.expired, __builtin_popcountll(sub.pending), sub.rttMs,
+                         sub.stats.latencyAvgMs, sub.stats.latencyMaxMs);
+        first = false;
+    }
+    response->print("]}");
+    request->send(response);
+}
@@ -0,0 +1,299 @@
+/*+===================================================================
+  File:      dmxProtocol.h
+
+  Summary:   sACN (E1.31) and Art-Net packet parsing and the frame
+             assembler behind dmxReceiver.h, so a lighting desk can
+             drive the strip.
+
+             Pixels are 3 channels each, DMX_PIXELS_PER_UNIVERSE to a
+             universe, universes numbered from DMX_START_UNIVERSE in
+             sACN terms (Art-Net port-address 0 is sACN universe 1, as
+             most desks number them). Pixel n of the stream lands on
+             leds[transform[n]], the getLtrTransform() layout.
+
+             The DMX slots are written straight from the received
+             datagram into the pixel buffer, there's no staging copy.
+             A frame is ready when:
+
+                - a sync packet arrives (E1.31 universe sync or
+                  ArtSync), once a desk has sent one it is waited for
+                  until DMX_SYNC_TIMEOUT_MS passes without one, or
+                - without sync, every expected universe has arrived,
+                  or one arrives a second time (the desk sends fewer
+                  universes than we have pixels for).
+
+             No Arduino dependencies so tools/dmxbench.cpp can run it
+             on the host.
+
+  10/19/2026.
+===================================================================+*/
+
+#include <stdint.h>
+#include <string.h>
+
+#define E131_PORT 5568
+#define ARTNET_PORT 6454
+#define DMX_START_UNIVERSE 1
+#define DMX_PIXELS_PER_UNIVERSE 170 // 510 of the 512 slots
+#define DMX_MAX_UNIVERSES 32        // seen-mask width, 5440 pixels
+#define DMX_SYNC_TIMEOUT_MS 4000    // back to free running after this long without sync
+#define DMX_MAX_PACKET 638          // E1.31 data packet with 512 slots
+
+#define E131_ROOT_DATA 0x00000004
+#define E131_ROOT_EXTENDED 0x00000008
+#define E131_FRAMING_DATA 0x00000002
+#define E131_FRAMING_SYNC 0x00000001
+#define E131_DATA_OFFSET 126
+#define E131_SYNC_LENGTH 49
+#define E131_OPT_TERMINATED 0x40
+
+#define ARTNET_OP_DMX 0x5000
+#define ARTNET_OP_SYNC 0x5200
+#define ARTNET_DATA_OFFSET 18
+#define ARTNET_PROTOCOL 14
+
+enum DmxPacketKind
+{
+    DMX_NONE = 0,
+    DMX_DATA = 1,
+    DMX_SYNC = 2
+};
+
+enum DmxSource
+{
+    DMX_E131 = 0,
+    DMX_ARTNET = 1
+};
+
+struct sDmxPacket
+{
+    uint8_t kind;          // DmxPacketKind.
+    uint8_t source;        // DmxSource.
+    uint8_t sequence;      // 0 = not sequenced (Art-Net).
+    uint16_t universe;     // sACN numbering.
+    uint16_t syncUniverse; // E1.31 only, 0 = desk doesn't sync this universe.
+    const uint8_t *data;   // DMX slots, points into the datagram.
+    uint16_t length;       // slot count.
+};
+
+struct sDmxStats
+{
+    uint32_t packets;
+    uint32_t frames;
+    uint32_t syncs;
+    uint32_t outOfOrder; // late E1.31 packets dropped.
+    uint32_t ignored;    // unparsable, wrong universe or non-zero start code.
+};
+
+struct sDmxFrame
+{
+    uint32_t seenMask; // universes written since the last frame.
+    uint32_t fullMask; // every universe we have pixels for.
+    uint8_t universes;
+    uint16_t syncUniverse; // E1.31 sync address our data packets name, 0 = any.
+    uint8_t lastSequence[DMX_MAX_UNIVERSES];
+    bool syncMode;
+    uint32_t lastSyncMs;
+    uint32_t lastPacketMs;
+    sDmxStats stats;
+};
+
+static_assert(DMX_MAX_UNIVERSES <= 32, "seen mask is 32 bits");
+
+uint16_t dmxRead16(const uint8_t *p)
+{
+    return (p[0] << 8) | p[1];
+}
+
+uint32_t dmxRead32(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | (p[2] << 8) | p[3];
+}
+
+// Root and framing layers of an E1.31 data or sync packet.
+bool e131Parse(const uint8_t *buf, size_t len, sDmxPacket &packet)
+{
+    static const uint8_t acnId[12] = {'A', 'S', 'C', '-', 'E', '1', '.', '1', '7', 0, 0, 0};
+    if (len < E131_SYNC_LENGTH || dmxRead16(buf) != 0x0010 || memcmp(buf + 4, acnId, sizeof(acnId)) != 0)
+    {
+        return false;
+    }
+
+    uint32_t rootVector = dmxRead32(buf + 18);
+    uint32_t framingVector = dmxRead32(buf + 40);
+    packet.source = DMX_E131;
+    if (rootVector == E131_ROOT_EXTENDED && framingVector == E131_FRAMING_SYNC)
+    {
+        packet.kind = DMX_SYNC;
+        packet.sequence = buf[44];
+        packet.syncUniverse = dmxRead16(buf + 45);
+        packet.universe = packet.syncUniverse;
+        packet.data = nullptr;
+        packet.length = 0;
+        return true;
+    }
+
+    if (rootVector != E131_ROOT_DATA || framingVector != E131_FRAMING_DATA || len <= E131_DATA_OFFSET ||
+        buf[117] != 0x02 || (buf[112] & E131_OPT_TERMINATED))
+    {
+        return false;
+    }
+
+    // Property value count includes the start code.
+    uint16_t count = dmxRead16(buf + 123);
+    if (count < 1 || (size_t)E131_DATA_OFFSET + count - 1 > len || buf[125] != 0)
+    {
+        return false;
+    }
+    packet.kind = DMX_DATA;
+    packet.syncUniverse = dmxRead16(buf + 109);
+    packet.sequence = buf[111];
+    packet.universe = dmxRead16(buf + 113);
+    packet.data = buf + E131_DATA_OFFSET;
+    packet.length = count - 1;
+    return true;
+}
+
+// ArtDmx and ArtSync. Every other OpCode (polls, etc.) is ignored.
+bool artnetParse(const uint8_t *buf, size_t len, sDmxPacket &packet)
+{
+    if (len < 14 || memcmp(buf, "Art-Net", 8) != 0 || dmxRead16(buf + 10) < ARTNET_PROTOCOL)
+    {
+        return false;
+    }
+
+    uint16_t opCode = buf[8] | (buf[9] << 8); // the one little endian field
+    packet.source = DMX_ARTNET;
+    packet.syncUniverse = 0;
+    if (opCode == ARTNET_OP_SYNC)
+    {
+        packet.kind = DMX_SYNC;
+        packet.sequence = 0;
+        packet.universe = 0;
+        packet.data = nullptr;
+        packet.length = 0;
+        return true;
+    }
+
+    if (opCode != ARTNET_OP_DMX || len <= ARTNET_DATA_OFFSET)
+    {
+        return false;
+    }
+    uint16_t count = dmxRead16(buf + 16);
+    if (count > 512 || (size_t)ARTNET_DATA_OFFSET + count > len)
+    {
+        return false;
+    }
+    packet.kind = DMX_DATA;
+    packet.sequence = buf[12];
+    packet.universe = (((buf[15] & 0x7F) << 8) | buf[14]) + 1;
+    packet.data = buf + ARTNET_DATA_OFFSET;
+    packet.length = count;
+    return true;
+}
+
+void dmxFrameInit(sDmxFrame &frame, int numLeds)
+{
+    memset(&frame, 0, sizeof(frame));
+    int universes = (numLeds + DMX_PIXELS_PER_UNIVERSE - 1) / DMX_PIXELS_PER_UNIVERSE;
+    frame.universes = universes > DMX_MAX_UNIVERSES ? DMX_MAX_UNIVERSES : universes;
+    frame.fullMask = frame.universes == 32 ? 0xFFFFFFFF : (1u << frame.universes) - 1;
+}
+
+// E1.31 receivers drop a packet up to 20 behind the last one, anything further back is a new source or a restart.
+bool dmxInSequence(uint8_t last, uint8_t sequence)
+{
+    int8_t delta = (int8_t)(sequence - last);
+    return delta > 0 || delta <= -20;
+}
+
+// Write one universe of RGB slots into rgb (3 bytes a pixel) through the layout transform.
+void dmxWritePixels(uint8_t *rgb, const int *transform, int numLeds, int firstPixel, const uint8_t *data,
+                    uint16_t length)
+{
+    int count = length / 3;
+    if (firstPixel + count > numLeds)
+    {
+        count = numLeds - firstPixel;
+    }
+    for (int i = 0; i < count; i++)
+    {
+        uint8_t *pixel = rgb + transform[firstPixel + i] * 3;
+        pixel[0] = data[0];
+        pixel[1] = data[1];
+        pixel[2] = data[2];
+        data += 3;
+    }
+}
+
+// Apply one parsed packet. Returns true when a complete frame is in rgb and should be shown.
+bool dmxHandle(sDmxFrame &frame, const sDmxPacket &packet, uint32_t nowMs, uint8_t *rgb, const int *transform,
+               int numLeds)
+{
+    frame.stats.packets++;
+    frame.lastPacketMs = nowMs;
+    if (frame.syncMode && nowMs - frame.lastSyncMs > DMX_SYNC_TIMEOUT_MS)
+    {
+        frame.syncMode = false;
+    }
+
+    if (packet.kind == DMX_SYNC)
+    {
+        if (packet.source == DMX_E131 && frame.syncUniverse != 0 && packet.syncUniverse != frame.syncUniverse)
+        {
+            frame.stats.ignored++;
+            return false;
+        }
+        frame.stats.syncs++;
+        frame.syncMode = true;
+        frame.lastSyncMs = nowMs;
+        if (frame.seenMask == 0)
+        {
+            return false;
+        }
+        frame.seenMask = 0;
+        frame.stats.frames++;
+        return true;
+    }
+
+    int index = packet.universe - DMX_START_UNIVERSE;
+    if (index < 0 || index >= frame.universes)
+    {
+        frame.stats.ignored++;
+        return false;
+    }
+    if (packet.sequence != 0 && frame.lastSequence[index] != 0 &&
+        !dmxInSequence(frame.lastSequence[index], packet.sequence))
+    {
+        frame.stats.outOfOrder++;
+        return false;
+    }
+    frame.lastSequence[index] = packet.sequence;
+    if (packet.syncUniverse != 0)
+    {
+        frame.syncUniverse = packet.syncUniverse;
+    }
+
+    dmxWritePixels(rgb, transform, numLeds, index * DMX_PIXELS_PER_UNIVERSE, packet.data, packet.length);
+    uint32_t bit = 1u << index;
+    bool repeat = frame.seenMask & bit;
+    frame.seenMask |= bit;
+
+    if (frame.syncMode)
+    {
+        return false;
+    }
+    if (repeat || frame.seenMask == frame.fullMask)
+    {
+        frame.seenMask = 0;
+        frame.stats.frames++;
+        return true;
+    }
+    return false;
+}
+
+// Parse whichever protocol the port carries. Returns false for anything that isn't DMX.
+bool dmxParse(uint16_t port, const uint8_t *buf, size_t len, sDmxPacket &packet)
+{
+    return port == ARTNET_PORT ? artnetParse(buf, len, packet) : e131Parse(buf, len, packet);
+}
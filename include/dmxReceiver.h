@@ -0,0 +1,131 @@
+/*+===================================================================
+  File:      dmxReceiver.h
+
+  Summary:   Lighting desk input (USE_DMX_INPUT): sACN on 5568 and
+             Art-Net on 6454, parsed and assembled by dmxProtocol.h.
+
+             Both listeners run on the AsyncUDP task, which writes
+             each universe from the datagram straight into leds[]
+             through gLeds (getLtrTransform) and wakes loop() when a
+             frame is complete; loop() only asks for ledShow(). A
+             universe arriving while the previous frame is still
+             going out on the data pin can show in it, the price of
+             not double buffering.
+
+             While a desk is sending, the local effects and the test
+             fire stay off the strip (dmxActive()).
+
+             sACN is received unicast, and multicast for the first
+             universe (239.255.0.1); desks driving more universes
+             than that should send unicast.
+
+                GET /api/dmx    packet, frame and sync counters
+
+  10/19/2026.
+===================================================================+*/
+
+#include <Arduino.h>
+#include <dmxProtocol.h>
+
+#define DMX_ACTIVE_MS 2000 // a desk counts as gone after this long without a packet
+
+// externs
+extern CRGB leds[];
+extern int gLeds[];
+
+#if USE_DMX_INPUT
+#include <AsyncUDP.h>
+
+static_assert(sizeof(CRGB) == 3, "leds[] is written as packed RGB");
+
+// globals
+volatile bool g_dmxFrameReady = false;
+
+// locals
+AsyncUDP dmxE131;
+AsyncUDP dmxArtnet;
+sDmxFrame dmxFrame;
+TaskHandle_t dmxLoopTask = nullptr;
+uint32_t dmxShownFrames = 0;
+uint32_t dmxFpsFrames = 0;
+unsigned long dmxFpsAt = 0;
+uint16_t dmxFps = 0;
+
+// AsyncUDP task: both ports land here, one at a time.
+void dmxOnPacket(AsyncUDPPacket &packet)
+{
+    sDmxPacket dmx;
+    if (!dmxParse(packet.localPort(), packet.data(), packet.length(), dmx))
+    {
+        dmxFrame.stats.ignored++;
+        return;
+    }
+    if (dmxHandle(dmxFrame, dmx, millis(), (uint8_t *)leds, gLeds, NUM_LEDS))
+    {
+        g_dmxFrameReady = true;
+        xTaskNotifyGive(dmxLoopTask);
+    }
+}
+
+void dmxBegin()
+{
+    getLtrTransform(gLeds, NUM_ROWS, NUM_COLS);
+    dmxFrameInit(dmxFrame, NUM_LEDS);
+    dmxLoopTask = xTaskGetCurrentTaskHandle(); // called on the loop task, see bootService()
+
+    IPAddress group(239, 255, (DMX_START_UNIVERSE >> 8) & 0xFF, DMX_START_UNIVERSE & 0xFF);
+    if (dmxE131.listenMulticast(group, E131_PORT))
+    {
+        dmxE131.onPacket(dmxOnPacket);
+    }
+    if (dmxArtnet.listen(ARTNET_PORT))
+    {
+        dmxArtnet.onPacket(dmxOnPacket);
+    }
+    Serial.printf("DMX: sACN %u / Art-Net %u, universes %u-%u\n", E131_PORT, ARTNET_PORT, DMX_START_UNIVERSE,
+                  DMX_START_UNIVERSE + dmxFrame.universes - 1);
+}
+
+bool dmxActive()
+{
+    return dmxFrame.stats.packets != 0 && millis() - dmxFrame.lastPacketMs < DMX_ACTIVE_MS;
+}
+
+// Called from loop(), shows a frame once the receiver has one complete.
+void dmxService()
+{
+    if (g_dmxFrameReady)
+    {
+        g_dmxFrameReady = false;
+        ledShow();
+        dmxShownFrames++;
+    }
+
+    if (millis() - dmxFpsAt >= 1000)
+    {
+        dmxFps = dmxShownFrames - dmxFpsFrames;
+        dmxFpsFrames = dmxShownFrames;
+        dmxFpsAt = millis();
+    }
+}
+
+void handleDmx(AsyncWebServerRequest *request)
+{
+    const sDmxStats &stats = dmxFrame.stats;
+    AsyncResponseStream *response = request->beginResponseStream("application/json");
+    response->printf("{\"active\":%s,\"universes\":%u,\"sync\":%s,\"fps\":%u,\"packets\":%u,\"frames\":%u,"
+                     "\"shown\":%u,\"syncs\":%u,\"outOfOrder\":%u,\"ignored\":%u}",
+                     dmxActive() ? "true" : "false", dmxFrame.universes, dmxFrame.syncMode ? "true" : "false",
+                     dmxFps, stats.packets, stats.frames, dmxShownFrames, stats.syncs, stats.outOfOrder,
+                     stats.ignored);
+    request->send(response);
+}
+
+#else
+
+void dmxBegin() {}
+bool dmxActive() { return false; }
+void dmxService() {}
+void handleDmx(AsyncWebServerRequest *request) { request->send(404, "text/plain", "DMX input disabled"); }
+
+#endif
@@ -0,0 +1,253 @@
+/*+===================================================================
+  File:      effectCheck.h
+
+  Summary:   Frame-accurate regression run of the LEDController.h
+             effects, so optimisation work can show an effect still
+             looks the same and what it costs.
+
+             Each effect runs EFFECT_CHECK_FRAMES frames from the
+             same seed on a fake clock that moves EFFECT_CHECK_FRAME_MS
+             per frame (effectDelay() moves it too, without waiting).
+             leds[] is CRC'd after every frame; the running CRC is
+             kept at EFFECT_CHECK_POINTS checkpoints so a mismatch
+             can be narrowed down to a stretch of frames. Time per
+             frame is measured on the real clock and includes the
+             shows the frame sent (ledFlush(), as at the end of
+             loop()); showUs is one bare show(), shows per effect
+             how many went out against how many were asked for.
+
+             Effects keep static state (heat, palettes, EVERY_N
+             timers), so the run only means something from a cold
+             start: POST /api/effects/check marks the request in RTC
+             memory and restarts, and setup() runs the check before
+             anything else has drawn a frame. Effects run in table
+             order and the palettes carry over between them.
+
+                POST /api/effects/check[?frames=n]  restart and run
+                GET  /api/effects                   results
+
+             The same run puts every HSV value through hsvToRgbBatch()
+             and FastLED's hsv2rgb_rainbow() and counts where they
+             differ, timing both.
+
+             tools/effectcheck.py compares the results against a
+             golden file.
+
+  10/19/2026.
+===================================================================+*/
+
+#include <Arduino.h>
+#include <esp_rom_crc.h>
+#include <esp_timer.h>
+
+#define EFFECT_CHECK_MAGIC 0x4B434658 // "XFCK"
+#define EFFECT_CHECK_FRAMES 200
+#define EFFECT_CHECK_MAX_FRAMES 4000
+#define EFFECT_CHECK_FRAME_MS 10      // 1000 / FRAMES_PER_SECOND
+#define EFFECT_CHECK_POINTS 8
+#define EFFECT_CHECK_SEED 1337
+#define EFFECT_CHECK_EPOCH_MS 100000  // fake clock at frame 0 of every effect
+
+struct sEffect
+{
+    const char *name;
+    uint32_t effect; // EFX_* bit, see installProfile.h
+    void (*run)();
+};
+
+struct sEffectResult
+{
+    uint32_t crc;
+    uint32_t points[EFFECT_CHECK_POINTS];
+    uint32_t avgUs;
+    uint32_t maxUs;
+    uint32_t showsRequested;
+    uint32_t showsSent;
+};
+
+// externs
+extern CRGB leds[];
+extern int gLeds[];
+extern bool effectClockFake;
+extern uint32_t effectClockMs;
+
+// Effects the profile leaves out compile to empty entries, so nothing references them and the linker drops them.
+const sEffect effectTable[] = {
+    {"fireLED", EFX_FIRE_LED, [] { if (profileHasEffect(EFX_FIRE_LED)) fireLED(leds); }},
+    {"randomDots2", EFX_RANDOM_DOTS2, [] { if (profileHasEffect(EFX_RANDOM_DOTS2)) randomDots2(leds); }},
+    {"randomDots", EFX_RANDOM_DOTS, [] { if (profileHasEffect(EFX_RANDOM_DOTS)) randomDots(leds); }},
+    {"randomNoise", EFX_RANDOM_NOISE, [] { if (profileHasEffect(EFX_RANDOM_NOISE)) randomNoise(leds); }},
+    {"randomBlueJumper", EFX_RANDOM_BLUE_JUMPER, [] { if (profileHasEffect(EFX_RANDOM_BLUE_JUMPER)) randomBlueJumper(leds); }},
+    {"flashColor", EFX_FLASH_COLOR, [] { if (profileHasEffect(EFX_FLASH_COLOR)) flashColor(leds, 0); }},
+    {"starTwinkle", EFX_STAR_TWINKLE, [] { if (profileHasEffect(EFX_STAR_TWINKLE)) starTwinkle(leds); }},
+    {"beatWaver", EFX_BEAT_WAVER, [] { if (profileHasEffect(EFX_BEAT_WAVER)) beatWaver(leds); }},
+    {"dotScrollRandomColor", EFX_DOT_SCROLL, [] { if (profileHasEffect(EFX_DOT_SCROLL)) dotScrollRandomColor(leds, gLeds); }},
+    {"ltrDot", EFX_LTR_DOT, [] { if (profileHasEffect(EFX_LTR_DOT)) ltrDot(leds, gLeds); }},
+    {"Fire2012WithPalette", EFX_FIRE2012, [] { if (profileHasEffect(EFX_FIRE2012)) Fire2012WithPalette(leds); }},
+    {"inoise8_mover", EFX_NOISE_MOVER, [] { if (profileHasEffect(EFX_NOISE_MOVER)) inoise8_mover(); }},
+};
+
+#define EFFECT_COUNT ARRAY_LENGTH(effectTable)
+
+// locals
+RTC_NOINIT_ATTR uint32_t effectCheckRequest; // survives the restart, garbage after power on.
+RTC_NOINIT_ATTR uint32_t effectCheckRequestFrames;
+sEffectResult effectResults[EFFECT_COUNT];
+bool effectCheckRan = false;
+uint32_t effectCheckFrames = 0;
+uint32_t effectShowUs = 0;
+uint32_t effectHsvMismatches = 0;
+uint32_t effectHsvFastLedNs = 0; // per pixel
+uint32_t effectHsvBatchNs = 0;
+
+// All 2^24 HSV values through hsvConvert.h and through FastLED itself.
+void effectCheckHsv()
+{
+    CHSV hsv[256];
+    CRGB expected[256];
+    CRGB batch[256];
+    int64_t fastLedUs = 0;
+    int64_t batchUs = 0;
+    effectHsvMismatches = 0;
+    hsvTablesInit(hsvTables);
+    hsvTablesReady = true;
+    for (int sat = 0; sat < 256; sat++)
+    {
+        for (int val = 0; val < 256; val++)
+        {
+            for (int hue = 0; hue < 256; hue++)
+            {
+                hsv[hue] = CHSV(hue, sat, val);
+            }
+            int64_t t0 = esp_timer_get_time();
+            hsv2rgb_rainbow(hsv, expected, 256);
+            int64_t t1 = esp_timer_get_time();
+            hsvToRgbBatch(hsvTables, hsv[0].raw, (uint8_t *)batch, 256);
+            batchUs += esp_timer_get_time() - t1;
+            fastLedUs += t1 - t0;
+            for (int hue = 0; hue < 256; hue++)
+            {
+                effectHsvMismatches += expected[hue] != batch[hue];
+            }
+        }
+    }
+    effectHsvFastLedNs = fastLedUs * 1000 / (1 << 24);
+    effectHsvBatchNs = batchUs * 1000 / (1 << 24);
+    Serial.printf("Effect check: HSV batch %u mismatches, %u ns/pixel against FastLED's %u\n", effectHsvMismatches,
+                  effectHsvBatchNs, effectHsvFastLedNs);
+}
+
+void effectCheckRun(uint32_t frames)
+{
+    effectCheckFrames = frames;
+
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < 10; i++)
+    {
+        FastLED.show();
+    }
+    effectShowUs = (esp_timer_get_time() - start) / 10;
+
+    effectClockFake = true;
+    uint32_t pointEvery = frames / EFFECT_CHECK_POINTS;
+    for (size_t e = 0; e < EFFECT_COUNT; e++)
+    {
+        sEffectResult &result = effectResults[e];
+        memset(&result, 0, sizeof(result));
+        if (!profileHasEffect(effectTable[e].effect))
+        {
+            continue;
+        }
+        FastLED.clear();
+        random16_set_seed(EFFECT_CHECK_SEED);
+        effectClockMs = EFFECT_CHECK_EPOCH_MS;
+
+        uint64_t totalUs = 0;
+        sLedOutputStats before = ledStats;
+        for (uint32_t frame = 0; frame < frames; frame++)
+        {
+            int64_t t0 = esp_timer_get_time();
+            effectTable[e].run();
+            ledFlush();
+            uint32_t us = esp_timer_get_time() - t0;
+            totalUs += us;
+            result.maxUs = us > result.maxUs ? us : result.maxUs;
+            effectClockMs += EFFECT_CHECK_FRAME_MS;
+
+            result.crc = esp_rom_crc32_le(result.crc, (const uint8_t *)leds, NUM_LEDS * sizeof(CRGB));
+            if ((frame + 1) % pointEvery == 0 && (frame + 1) / pointEvery <= EFFECT_CHECK_POINTS)
+            {
+                result.points[(frame + 1) / pointEvery - 1] = result.crc;
+            }
+        }
+        result.avgUs = totalUs / frames;
+        result.showsRequested = ledStats.requested - before.requested;
+        result.showsSent = ledStats.sent - before.sent;
+        Serial.printf("Effect check: %-22s crc %08x  avg %6u us  max %6u us  shows %u/%u\n", effectTable[e].name,
+                      result.crc, result.avgUs, result.maxUs, result.showsSent, result.showsRequested);
+    }
+    effectClockFake = false;
+    effectCheckHsv();
+    effectCheckRan = true;
+    FastLED.clear(true);
+    ledOutputInvalidate();
+}
+
+// In setup() once FastLED is up, before anything draws: runs the check if one was requested.
+void effectCheckBoot()
+{
+    if (effectCheckRequest != EFFECT_CHECK_MAGIC)
+    {
+        return;
+    }
+    effectCheckRequest = 0;
+    uint32_t frames = effectCheckRequestFrames;
+    if (frames < EFFECT_CHECK_POINTS || frames > EFFECT_CHECK_MAX_FRAMES)
+    {
+        frames = EFFECT_CHECK_FRAMES;
+    }
+    effectCheckRun(frames);
+}
+
+void handleEffectCheck(AsyncWebServerRequest *request)
+{
+    effectCheckRequestFrames = EFFECT_CHECK_FRAMES;
+    if (request->hasParam("frames"))
+    {
+        effectCheckRequestFrames = request->getParam("frames")->value().toInt();
+    }
+    effectCheckRequest = EFFECT_CHECK_MAGIC;
+    scheduleRestart(1000);
+    request->send(200, "text/plain", "Effect check runs after the restart, see /api/effects");
+}
+
+void handleEffects(AsyncWebServerRequest *request)
+{
+    AsyncResponseStream *response = request->beginResponseStream("application/json");
+    response->printf("{\"ran\":%s,\"profile\":\"%s\",\"frames\":%u,\"frameMs\":%d,\"seed\":%d,\"numLeds\":%d,"
+                     "\"showUs\":%u,\"effects\":[",
+                     effectCheckRan ? "true" : "false", g_profile.name, effectCheckFrames, EFFECT_CHECK_FRAME_MS,
+                     EFFECT_CHECK_SEED, NUM_LEDS, effectShowUs);
+    bool first = true;
+    for (size_t e = 0; effectCheckRan && e < EFFECT_COUNT; e++)
+    {
+        if (!profileHasEffect(effectTable[e].effect))
+        {
+            continue;
+        }
+        const sEffectResult &result = effectResults[e];
+        response->printf("%s{\"name\":\"%s\",\"crc\":\"%08x\",\"avgUs\":%u,\"maxUs\":%u,\"showsRequested\":%u,\"showsSent\":%u,"
+                         "\"points\":[",
+                         first ? "" : ",", effectTable[e].name, result.crc, result.avgUs, result.maxUs,
+                         result.showsRequested, result.showsSent);
+        for (int p = 0; p < EFFECT_CHECK_POINTS; p++)
+        {
+            response->printf("%s\"%08x\"", p ? "," : "", result.points[p]);
+        }
+        response->print("]}");
+        first = false;
+    }
+    response->printf("],\"hsv\":{\"mismatches\":%u,\"batchNs\":%u,\"fastLedNs\":%u}}", effectHsvMismatches,
+                     effectHsvBatchNs, effectHsvFastLedNs);
+    request->send(response);
+}
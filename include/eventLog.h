@@ -0,0 +1,223 @@
+/*+===================================================================
+  File:      eventLog.h
+
+  Summary:   Binary event log in RTC memory. A record is a fixed 16
+             bytes: time since boot, boot number, event ID and two
+             integer arguments. logEvent() copies one in under a
+             spinlock and returns, no formatting and no Serial, so it
+             is cheap enough for the loop, the network callbacks and
+             ISRs. The ring keeps the last LOG_RECORDS events across
+             resets and watchdog panics, a power cycle clears it.
+
+             Text is made only when someone asks:
+
+                GET /api/log              formatted, oldest first
+                GET /api/log?format=bin   the raw dump, for
+                                          tools/logdecode.py
+
+             The events and their formats are the LOG_EVENTS table
+             below. tools/logdecode.py reads this file for it, so new
+             events only go here. Formats take %d, %u, %x and %I (an
+             IPv4 address as IPAddress stores it), one per argument.
+
+             Boot time messages stay on Serial, someone is watching
+             then. Define LOG_ECHO_SERIAL to also print each event's
+             raw numbers as it's logged (bench only, it isn't ISR
+             safe).
+
+  10/19/2026.
+===================================================================+*/
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include <esp_system.h>
+
+#define LOG_RECORDS 128
+#define LOG_MAGIC 0x474C5742 // "BWLG"
+#define LOG_VERSION 1
+#define LOG_TEXT_MAX 96
+
+// X(id, name, format)
+#define LOG_EVENTS(X)                                                       \
+    X(LOG_BOOT, "boot", "reset reason %u, boot %u")                         \
+    X(LOG_RESTART_SCHEDULED, "restart", "scheduled in %u ms")               \
+    X(LOG_RESTARTING, "restart", "restarting now")                          \
+    X(LOG_FIRE, "fire", "shell #%u")                                        \
+    X(LOG_WS_CONNECT, "ws", "client #%u connected from %I")                 \
+    X(LOG_WS_DISCONNECT, "ws", "client #%u disconnected")                   \
+    X(LOG_WS_ERROR, "ws", "client #%u error %u")                            \
+    X(LOG_WS_FULL, "ws", "client #%u refused, session table full")          \
+    X(LOG_STALL, "health", "subsystem %u stalled")                          \
+    X(LOG_STALL_END, "health", "subsystem %u recovered after %u ms")        \
+    X(LOG_WDT_STARVE, "health", "subsystem %u over budget, watchdog reset") \
+    X(LOG_MDNS_FAIL, "wifi", "mDNS failed, ip %I")                          \
+    X(LOG_WIFI_TIMEOUT, "wifi", "join timed out at %u ms, restarting")      \
+    X(LOG_OTA_DONE, "ota", "verified %u bytes")                             \
+    X(LOG_OTA_FAIL, "ota", "failed, image %u bytes")                        \
+    X(LOG_OTA_PUSH, "ota", "fan-out to %I, ok %u")                          \
+    X(LOG_CLIP_CAPTURED, "clip", "captured %u frames")                      \
+    X(LOG_CLIP_PLAY, "clip", "playing %u frames")                           \
+    X(LOG_CLIP_BAD, "clip", "bad or missing clip")                          \
+    X(LOG_ROSTER_ONLINE, "roster", "sub %I online, %u leds")                \
+    X(LOG_ROSTER_PUSH, "roster", "config to %I, ok %u")                     \
+    X(LOG_FIRE_CHANNEL, "fire", "channel %u, %u ms")                        \
+    X(LOG_FIRE_REFUSED, "fire", "channel %u refused, reason %u")            \
+    X(LOG_FIRE_ARM, "fire", "armed, continuity %x")                         \
+    X(LOG_FIRE_DISARM, "fire", "disarmed, reason %u, cut %x")
+
+#define LOG_ENUM(id, name, format) id,
+enum LogEvent
+{
+    LOG_EVENTS(LOG_ENUM) LOG_EVENT_COUNT
+};
+#undef LOG_ENUM
+
+struct sLogRecord
+{
+    uint32_t ms;
+    uint16_t boot;
+    uint16_t event;
+    int32_t a;
+    int32_t b;
+};
+
+struct sLogRtc
+{
+    uint32_t magic;
+    uint32_t boots;
+    uint32_t head; // records ever written, the next one goes to head % LOG_RECORDS
+    sLogRecord records[LOG_RECORDS];
+};
+
+// What ?format=bin sends ahead of the records, oldest record first.
+struct sLogDumpHeader
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t recordSize;
+    uint32_t boots;
+    uint32_t head;
+    uint32_t count;
+};
+
+// locals
+RTC_NOINIT_ATTR sLogRtc logRtc;
+portMUX_TYPE logLock = portMUX_INITIALIZER_UNLOCKED;
+
+#define LOG_NAME(id, name, format) name,
+const char *logNames[LOG_EVENT_COUNT] = {LOG_EVENTS(LOG_NAME)};
+#undef LOG_NAME
+#define LOG_FORMAT(id, name, format) format,
+const char *logFormats[LOG_EVENT_COUNT] = {LOG_EVENTS(LOG_FORMAT)};
+#undef LOG_FORMAT
+
+// Any task or ISR, constant time.
+void logEvent(LogEvent event, int32_t a = 0, int32_t b = 0)
+{
+    uint32_t ms = millis();
+    portENTER_CRITICAL_SAFE(&logLock);
+    sLogRecord &record = logRtc.records[logRtc.head % LOG_RECORDS];
+    record.ms = ms;
+    record.boot = logRtc.boots;
+    record.event = event;
+    record.a = a;
+    record.b = b;
+    logRtc.head++;
+    portEXIT_CRITICAL_SAFE(&logLock);
+#ifdef LOG_ECHO_SERIAL
+    Serial.printf("log %u %d %d\n", event, a, b);
+#endif
+}
+
+// Early in setup(), keeps what the last boot logged unless this is a power on.
+void logBegin()
+{
+    esp_reset_reason_t reason = esp_reset_reason();
+    if (logRtc.magic != LOG_MAGIC || reason == ESP_RST_POWERON)
+    {
+        memset(&logRtc, 0, sizeof(logRtc));
+        logRtc.magic = LOG_MAGIC;
+    }
+    logRtc.boots++;
+    logEvent(LOG_BOOT, reason, logRtc.boots);
+}
+
+// A record as text, the device side of what tools/logdecode.py does.
+void logFormat(const sLogRecord &record, char *text, size_t size)
+{
+    int used = snprintf(text, size, "boot %u %8u ms  %-7s ", record.boot, record.ms,
+                        record.event < LOG_EVENT_COUNT ? logNames[record.event] : "?");
+    const char *format = record.event < LOG_EVENT_COUNT ? logFormats[record.event] : "event %u";
+    int32_t args[2] = {record.a, record.b};
+    int arg = 0;
+    for (const char *c = format; *c && used < (int)size - 1; c++)
+    {
+        if (*c != '%' || c[1] == 0)
+        {
+            text[used++] = *c;
+            continue;
+        }
+        int32_t value = arg < 2 ? args[arg++] : 0;
+        switch (*++c)
+        {
+        case 'd':
+            used += snprintf(text + used, size - used, "%d", value);
+            break;
+        case 'x':
+            used += snprintf(text + used, size - used, "%x", (uint32_t)value);
+            break;
+        case 'I':
+            used += snprintf(text + used, size - used, "%u.%u.%u.%u", value & 0xFF, (value >> 8) & 0xFF,
+                             (value >> 16) & 0xFF, (uint32_t)value >> 24);
+            break;
+        default:
+            used += snprintf(text + used, size - used, "%u", (uint32_t)value);
+            break;
+        }
+    }
+    text[used < (int)size ? used : size - 1] = 0;
+}
+
+uint32_t logCount()
+{
+    return logRtc.head < LOG_RECORDS ? logRtc.head : LOG_RECORDS;
+}
+
+// Copy of the i'th oldest record, so a logEvent() in between can't tear it.
+sLogRecord logRecord(uint32_t i)
+{
+    portENTER_CRITICAL(&logLock);
+    sLogRecord record = logRtc.records[(logRtc.head - logCount() + i) % LOG_RECORDS];
+    portEXIT_CRITICAL(&logLock);
+    return record;
+}
+
+void handleLog(AsyncWebServerRequest *request)
+{
+    uint32_t count = logCount();
+    if (request->hasParam("format") && request->getParam("format")->value() == "bin")
+    {
+        AsyncResponseStream *response = request->beginResponseStream("application/octet-stream");
+        response->addHeader("Content-Disposition", "attachment; filename=\"bangworx-log.bin\"");
+        sLogDumpHeader header = {LOG_MAGIC, LOG_VERSION, sizeof(sLogRecord), logRtc.boots, logRtc.head, count};
+        response->write((const uint8_t *)&header, sizeof(header));
+        for (uint32_t i = 0; i < count; i++)
+        {
+            sLogRecord record = logRecord(i);
+            response->write((const uint8_t *)&record, sizeof(record));
+        }
+        request->send(response);
+        return;
+    }
+
+    AsyncResponseStream *response = request->beginResponseStream("text/plain");
+    response->printf("%u events logged, last %u, this is boot %u\n", logRtc.head, count, logRtc.boots);
+    char text[LOG_TEXT_MAX];
+    for (uint32_t i = 0; i < count; i++)
+    {
+        logFormat(logRecord(i), text, sizeof(text));
+        response->print(text);
+        response->print("\n");
+    }
+    request->send(response);
+}
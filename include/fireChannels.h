@@ -0,0 +1,414 @@
+/*+===================================================================
+  File:      fireChannels.h
+
+  Summary:   Firing channel driver for subs wired with igniters
+             (USE_FIRING, g_profile.channels > 0). fireControl.h
+             decides what may fire, this drives the hardware:
+
+                outputs      a 74HC595 chain, channel 1 on the first
+                             chip's QA. OE is held high (all off)
+                             whenever the controller is disarmed
+                continuity   a 74HC165 chain on the same clock, its
+                             inputs high where current flows through
+                             an igniter. Scanned every FIRE_SCAN_MS
+                             while no channel is on
+
+             Every command goes through the "fire" task: show cues
+             (executeCue), WebSocket text and the heartbeat only push
+             into the preallocated queue and wake it. A started pulse
+             is ended by its channel's esp_timer, which keeps
+             microsecond time and runs on the high priority timer
+             task, so the on-time doesn't depend on the loop or the
+             network. If the timer can't be started the channel is
+             cut and the controller disarms.
+
+             The heartbeat is the master's UDP sync beacon
+             (udpFastPath.h, every 250 ms), counted only when it
+             comes from the SoftAP we joined. The beacon also
+             carries the master's arm switch, that is how subs get
+             armed and disarmed in a show (fireBeacon in
+             fireControl.h).
+
+             On the master, "arm" and "disarm" over WebSocket flip
+             that switch (g_masterArmed) and the next beacon goes
+             out at once. Any client of the master's SoftAP may
+             flip it, that is the operator's control page.
+
+             WebSocket commands on a sub, arm and fire only from a
+             session with role:master (wsSessions.h). Anyone may
+             disarm:
+                arm, disarm
+                fire:<channel>[:<ms>]   pulse length defaults to
+                                        FIRE_PULSE_DEFAULT_MS
+
+             A FIRE_BENCH build, for a rig with no master, takes "hb"
+             from any client as the heartbeat and arm and fire from
+             any client too. Never ship one.
+
+             Cues from a running show fire channel cue.channel for
+             cue.param ms (0 for the default). Over UDP they carry
+             UDP_CUE_LIVE; anything else, like the demo loop, only
+             lights LEDs. GET /api/fire reports the state.
+
+  10/19/2026.
+===================================================================+*/
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include <fireControl.h>
+
+#define FIRE_SCAN_MS 500
+
+// externs
+extern bool g_isAccessPoint;
+
+// globals
+volatile bool g_masterArmed = false; // master only, goes out in every beacon
+
+// Master: the arm switch. True if text was one of its commands.
+bool fireMasterSwitch(AsyncWebSocketClient *client, const char *text)
+{
+    if (strcmp(text, "arm") != 0 && strcmp(text, "disarm") != 0)
+    {
+        return false;
+    }
+    g_masterArmed = text[0] == 'a';
+    if (g_masterArmed)
+    {
+        logEvent(LOG_FIRE_ARM);
+    }
+    else
+    {
+        logEvent(LOG_FIRE_DISARM, FIRE_DISARM_COMMAND);
+    }
+    client->text(g_masterArmed ? "Armed" : "Disarmed");
+    return true;
+}
+
+#if USE_FIRING
+#include <esp_timer.h>
+
+// locals
+sFireControl fire;
+sFireQueue fireQueue;
+portMUX_TYPE fireLock = portMUX_INITIALIZER_UNLOCKED;
+esp_timer_handle_t fireTimers[FIRE_CHANNELS_MAX];
+TaskHandle_t fireTaskHandle = nullptr;
+int fireBytes = 0; // chips in each chain
+
+void fireClock()
+{
+    digitalWrite(FIRE_CLK_PIN, HIGH);
+    digitalWrite(FIRE_CLK_PIN, LOW);
+}
+
+// Under fireLock, so a timer ending one pulse can't interleave with a task starting another.
+void fireShift()
+{
+    if (!fire.armed)
+    {
+        digitalWrite(FIRE_OE_PIN, HIGH); // cut first, then clear
+    }
+    for (int bit = fireBytes * 8 - 1; bit >= 0; bit--)
+    {
+        digitalWrite(FIRE_SER_PIN, (fire.outputs >> bit) & 1);
+        fireClock();
+    }
+    digitalWrite(FIRE_LATCH_PIN, HIGH);
+    digitalWrite(FIRE_LATCH_PIN, LOW);
+    if (fire.armed)
+    {
+        digitalWrite(FIRE_OE_PIN, LOW);
+    }
+}
+
+// Under fireLock. Clocking the 595s as well is harmless, they only change on a latch.
+uint32_t fireScan()
+{
+    digitalWrite(FIRE_LOAD_PIN, LOW);
+    delayMicroseconds(1);
+    digitalWrite(FIRE_LOAD_PIN, HIGH);
+    uint32_t present = 0;
+    for (int chip = 0; chip < fireBytes; chip++)
+    {
+        for (int bit = 7; bit >= 0; bit--) // H comes out first
+        {
+            present |= (uint32_t)digitalRead(FIRE_SENSE_PIN) << (chip * 8 + bit);
+            fireClock();
+        }
+    }
+    return present;
+}
+
+void fireStopTimers()
+{
+    for (int i = 0; i < fire.channels; i++)
+    {
+        esp_timer_stop(fireTimers[i]); // fails harmlessly when it isn't running
+    }
+}
+
+// esp_timer task: a pulse ran its time.
+void fireTimerDone(void *arg)
+{
+    uint32_t nowUs = (uint32_t)esp_timer_get_time();
+    portENTER_CRITICAL(&fireLock);
+    if (fireEnd(fire, (int)(intptr_t)arg, nowUs))
+    {
+        fireShift();
+    }
+    portEXIT_CRITICAL(&fireLock);
+}
+
+void fireRun(const sFireCommand &command)
+{
+    uint32_t pulseUs = 0;
+    uint32_t cut = 0;
+    FireResult result = FIRE_OK;
+    portENTER_CRITICAL(&fireLock);
+    bool wasArmed = fire.armed;
+    uint32_t continuity = fire.continuity;
+    if (command.kind == FIRE_CMD_ARM)
+    {
+        result = fireArm(fire, millis());
+    }
+    else if (command.kind == FIRE_CMD_DISARM)
+    {
+        cut = fireDisarm(fire, (uint32_t)esp_timer_get_time());
+    }
+    else
+    {
+        result = fireStart(fire, command.channel, command.pulseMs, millis(), (uint32_t)esp_timer_get_time(), pulseUs);
+    }
+    fireShift();
+    portEXIT_CRITICAL(&fireLock);
+
+    if (result != FIRE_OK)
+    {
+        logEvent(LOG_FIRE_REFUSED, command.channel, result);
+    }
+    else if (command.kind == FIRE_CMD_ARM && !wasArmed)
+    {
+        logEvent(LOG_FIRE_ARM, continuity);
+    }
+    else if (command.kind == FIRE_CMD_DISARM)
+    {
+        fireStopTimers();
+        logEvent(LOG_FIRE_DISARM, FIRE_DISARM_COMMAND, cut);
+    }
+    else if (command.kind == FIRE_CMD_FIRE)
+    {
+        esp_timer_handle_t timer = fireTimers[command.channel - 1];
+        esp_timer_stop(timer); // a pulse cut by a disarm may have left it running
+        if (esp_timer_start_once(timer, pulseUs) != ESP_OK)
+        {
+            portENTER_CRITICAL(&fireLock);
+            cut = fireDisarm(fire, (uint32_t)esp_timer_get_time());
+            fireShift();
+            portEXIT_CRITICAL(&fireLock);
+            fireStopTimers();
+            Serial.printf("Fire: no timer for channel %u, disarmed.\n", command.channel);
+        }
+        logEvent(LOG_FIRE_CHANNEL, command.channel, pulseUs / 1000);
+    }
+}
+
+void fireTask(void *param)
+{
+    sFireCommand command;
+    for (;;)
+    {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(FIRE_SCAN_MS));
+        for (;;)
+        {
+            portENTER_CRITICAL(&fireLock);
+            bool got = fireQueuePop(fireQueue, command);
+            portEXIT_CRITICAL(&fireLock);
+            if (!got)
+            {
+                break;
+            }
+            fireRun(command);
+        }
+
+        portENTER_CRITICAL(&fireLock);
+        uint32_t cut = fire.outputs;
+        bool disarmed = fireService(fire, millis(), (uint32_t)esp_timer_get_time());
+        if (disarmed)
+        {
+            fireShift();
+        }
+        if (fire.outputs == 0 && (!fire.continuityValid || millis() - fire.continuityMs >= FIRE_SCAN_MS))
+        {
+            fireContinuity(fire, fireScan(), millis());
+        }
+        portEXIT_CRITICAL(&fireLock);
+        if (disarmed)
+        {
+            fireStopTimers();
+            logEvent(LOG_FIRE_DISARM, FIRE_DISARM_HEARTBEAT, cut);
+        }
+    }
+}
+
+// Early in setup(): outputs off before anything else can run.
+void fireBegin()
+{
+    if (g_profile.channels == 0)
+    {
+        return;
+    }
+    pinMode(FIRE_OE_PIN, OUTPUT);
+    digitalWrite(FIRE_OE_PIN, HIGH);
+    pinMode(FIRE_SER_PIN, OUTPUT);
+    pinMode(FIRE_CLK_PIN, OUTPUT);
+    pinMode(FIRE_LATCH_PIN, OUTPUT);
+    pinMode(FIRE_LOAD_PIN, OUTPUT);
+    pinMode(FIRE_SENSE_PIN, INPUT);
+    digitalWrite(FIRE_CLK_PIN, LOW);
+    digitalWrite(FIRE_LATCH_PIN, LOW);
+    digitalWrite(FIRE_LOAD_PIN, HIGH);
+
+    fireInit(fire, g_profile.channels);
+    fireQueueInit(fireQueue);
+    fireBytes = (fire.channels + 7) / 8;
+    fireShift();
+    for (int i = 0; i < fire.channels; i++)
+    {
+        esp_timer_create_args_t args = {};
+        args.callback = fireTimerDone;
+        args.arg = (void *)(intptr_t)i;
+        args.name = "fire";
+        if (esp_timer_create(&args, &fireTimers[i]) != ESP_OK)
+        {
+            Serial.println("Fire: pulse timer failed, firing disabled.");
+            return;
+        }
+    }
+    xTaskCreatePinnedToCore(fireTask, "fire", 3072, nullptr, 10, &fireTaskHandle, 1);
+}
+
+// Any task. False if there's no driver or the queue is full.
+bool fireSubmit(uint8_t kind, uint8_t channel, uint16_t pulseMs)
+{
+    if (!fireTaskHandle)
+    {
+        return false;
+    }
+    sFireCommand command = {kind, channel, pulseMs};
+    portENTER_CRITICAL(&fireLock);
+    bool queued = fireQueuePush(fireQueue, command);
+    portEXIT_CRITICAL(&fireLock);
+    if (queued)
+    {
+        xTaskNotifyGive(fireTaskHandle);
+    }
+    return queued;
+}
+
+// A sync beacon from our master, armed is its arm switch.
+void fireMasterBeacon(bool armed)
+{
+    portENTER_CRITICAL(&fireLock);
+    int kind = fireBeacon(fire, armed, millis());
+    portEXIT_CRITICAL(&fireLock);
+    if (kind >= 0)
+    {
+        fireSubmit(kind, 0, 0);
+    }
+}
+
+// WebSocket text, true if it was a firing command. master: the session is role:master.
+bool fireCommand(AsyncWebSocketClient *client, const char *text, bool master)
+{
+    bool queued;
+    if (g_isAccessPoint)
+    {
+        return fireMasterSwitch(client, text);
+    }
+    if (strcmp(text, "hb") == 0)
+    {
+        if (FIRE_BENCH)
+        {
+            portENTER_CRITICAL(&fireLock);
+            fireHeartbeat(fire, millis());
+            portEXIT_CRITICAL(&fireLock);
+        }
+        return true; // no reply, it comes several times a second
+    }
+    else if (strcmp(text, "disarm") == 0)
+    {
+        queued = fireSubmit(FIRE_CMD_DISARM, 0, 0);
+    }
+    else if (!master && !FIRE_BENCH && (strcmp(text, "arm") == 0 || strncmp(text, "fire:", 5) == 0))
+    {
+        client->text("Master only");
+        return true;
+    }
+    else if (strcmp(text, "arm") == 0)
+    {
+        queued = fireSubmit(FIRE_CMD_ARM, 0, 0);
+    }
+    else if (strncmp(text, "fire:", 5) == 0)
+    {
+        char *end;
+        long channel = strtol(text + 5, &end, 10);
+        long pulseMs = *end == ':' ? strtol(end + 1, &end, 10) : 0;
+        if (*end || channel < 1 || channel > FIRE_CHANNELS_MAX || pulseMs < 0 || pulseMs > FIRE_PULSE_MAX_MS)
+        {
+            client->text("Bad fire command");
+            return true;
+        }
+        queued = fireSubmit(FIRE_CMD_FIRE, channel, pulseMs);
+    }
+    else
+    {
+        return false;
+    }
+    client->text(queued ? "OK" : fireTaskHandle ? "Fire queue full" : "No firing channels");
+    return true;
+}
+
+void handleFire(AsyncWebServerRequest *request)
+{
+    static sFireControl state; // too big for the async_tcp stack, only ever used from there
+    portENTER_CRITICAL(&fireLock);
+    state = fire;
+    uint32_t dropped = fireQueue.dropped;
+    portEXIT_CRITICAL(&fireLock);
+    uint32_t now = millis();
+
+    AsyncResponseStream *response = request->beginResponseStream("application/json");
+    response->printf("{\"channels\":%u,\"armed\":%s,\"armedForMs\":%u,\"heartbeatAgoMs\":%d,\"outputs\":%u,"
+                     "\"continuity\":%u,\"continuityAgoMs\":%d,\"autoDisarms\":%u,\"queueDropped\":%u,\"refused\":{",
+                     state.channels, state.armed ? "true" : "false", state.armed ? now - state.armedMs : 0,
+                     state.heartbeatSeen ? (int)(now - state.heartbeatMs) : -1, state.outputs, state.continuity,
+                     state.continuityValid ? (int)(now - state.continuityMs) : -1, state.autoDisarms, dropped);
+    for (int result = FIRE_BAD_CHANNEL; result < FIRE_QUEUE_FULL; result++)
+    {
+        response->printf("%s\"%s\":%u", result > FIRE_BAD_CHANNEL ? "," : "", fireResultName(result),
+                         state.refused[result]);
+    }
+    response->print("},\"channel\":[");
+    for (int i = 0; i < state.channels; i++)
+    {
+        const sFireChannel &channel = state.channel[i];
+        response->printf("%s{\"fires\":%u,\"requestedUs\":%u,\"onUs\":%u}", i ? "," : "", channel.fires,
+                         channel.requestedUs, channel.onUs);
+    }
+    response->print("]}");
+    request->send(response);
+}
+
+#else
+
+void fireBegin() {}
+bool fireSubmit(uint8_t kind, uint8_t channel, uint16_t pulseMs) { return false; }
+void fireMasterBeacon(bool armed) {}
+bool fireCommand(AsyncWebSocketClient *client, const char *text, bool master)
+{
+    return g_isAccessPoint && fireMasterSwitch(client, text);
+}
+void handleFire(AsyncWebServerRequest *request) { request->send(404, "text/plain", "Firing disabled"); }
+
+#endif
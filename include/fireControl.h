@@ -0,0 +1,314 @@
+/*+===================================================================
+  File:      fireControl.h
+
+  Summary:   Firing channel state and interlocks behind
+             fireChannels.h. This decides whether a channel may fire
+             and what the outputs should show. The driver shifts the
+             outputs out and times the pulses.
+
+             A fire is refused unless all of these hold, checked in
+             this order (FireResult):
+
+                channel      1..channels, the shell number cues and
+                             the UI use
+                armed        armed by an explicit command, disarmed
+                             by command or when the master goes quiet
+                heartbeat    a master beacon or "hb" in the last
+                             FIRE_HEARTBEAT_MS
+                continuity   the last scan saw an igniter on it
+                once         not fired since arming, so a repeated
+                             cue can't fire a channel twice
+                concurrency  at most FIRE_MAX_CONCURRENT pulses at
+                             once, the supply's limit
+
+             Without a heartbeat for FIRE_DISARM_MS the controller
+             disarms itself. Disarming cuts every output at once. A
+             pulse timer that runs out after that finds its channel
+             already off, or on again for a newer pulse that isn't
+             due yet, and does nothing. Getting the heartbeat back
+             does not re-arm.
+
+             On a sub the commands come from the master's beacon,
+             which carries the master's arm switch (fireBeacon):
+             the switch going on arms, the switch off disarms. A
+             sub that first hears the master with the switch
+             already on, after booting or going quiet, stays
+             disarmed until the switch is turned off and on again.
+
+             Commands reach the driver's task through sFireQueue, a
+             fixed ring allocated up front, so the WebSocket and UDP
+             paths never allocate or block. A full queue drops the
+             command and counts it.
+
+             No Arduino dependencies, tools/firesim.cpp runs it
+             against a simulated GPIO layer and pulse timer.
+
+  10/19/2026.
+===================================================================+*/
+
+#include <stdint.h>
+#include <string.h>
+
+#define FIRE_CHANNELS_MAX 16
+#define FIRE_QUEUE_SIZE 16
+#define FIRE_PULSE_DEFAULT_MS 250
+#define FIRE_PULSE_MIN_MS 20
+#define FIRE_PULSE_MAX_MS 2000
+#define FIRE_HEARTBEAT_MS 1000 // fires refused past this
+#define FIRE_DISARM_MS 5000    // disarmed past this
+#define FIRE_MAX_CONCURRENT 4
+#define FIRE_TIMER_SLACK_US 500 // a pulse timer that ends this much early belongs to an older pulse
+
+enum FireResult
+{
+    FIRE_OK = 0,
+    FIRE_BAD_CHANNEL,
+    FIRE_NOT_ARMED,
+    FIRE_NO_HEARTBEAT,
+    FIRE_NO_CONTINUITY,
+    FIRE_ALREADY_FIRED,
+    FIRE_BUSY,
+    FIRE_QUEUE_FULL,
+    FIRE_RESULTS
+};
+
+enum FireCommandKind
+{
+    FIRE_CMD_FIRE = 0,
+    FIRE_CMD_ARM = 1,
+    FIRE_CMD_DISARM = 2
+};
+
+enum FireDisarmReason
+{
+    FIRE_DISARM_COMMAND = 0,
+    FIRE_DISARM_HEARTBEAT = 1
+};
+
+struct sFireCommand
+{
+    uint8_t kind;     // FireCommandKind
+    uint8_t channel;  // 1-based
+    uint16_t pulseMs; // 0 for the default
+};
+
+struct sFireQueue
+{
+    sFireCommand slots[FIRE_QUEUE_SIZE];
+    uint8_t head; // next to pop
+    uint8_t count;
+    uint32_t dropped;
+};
+
+struct sFireChannel
+{
+    uint32_t startUs;     // this pulse, or the last one
+    uint32_t requestedUs;
+    uint32_t onUs;        // how long the last pulse was on, 0 until it ends
+    uint16_t fires;
+};
+
+struct sFireControl
+{
+    uint8_t channels;
+    bool armed;
+    bool heartbeatSeen;
+    uint32_t heartbeatMs;
+    uint32_t armedMs;
+    uint32_t outputs;    // bit per channel (bit 0 is channel 1), what the drivers should show
+    uint32_t fired;      // since arming
+    uint32_t continuity; // igniters present at the last scan
+    bool continuityValid;
+    uint32_t continuityMs;
+    uint32_t autoDisarms;
+    bool masterArmed;    // the master's arm switch at its last beacon
+    uint32_t refused[FIRE_RESULTS];
+    sFireChannel channel[FIRE_CHANNELS_MAX];
+};
+
+void fireInit(sFireControl &fire, uint8_t channels)
+{
+    memset(&fire, 0, sizeof(fire));
+    fire.channels = channels < FIRE_CHANNELS_MAX ? channels : FIRE_CHANNELS_MAX;
+    fire.masterArmed = true; // no arm until the switch has been seen off
+}
+
+void fireQueueInit(sFireQueue &queue)
+{
+    memset(&queue, 0, sizeof(queue));
+}
+
+bool fireQueuePush(sFireQueue &queue, const sFireCommand &command)
+{
+    if (queue.count == FIRE_QUEUE_SIZE)
+    {
+        queue.dropped++;
+        return false;
+    }
+    queue.slots[(queue.head + queue.count) % FIRE_QUEUE_SIZE] = command;
+    queue.count++;
+    return true;
+}
+
+bool fireQueuePop(sFireQueue &queue, sFireCommand &command)
+{
+    if (queue.count == 0)
+    {
+        return false;
+    }
+    command = queue.slots[queue.head];
+    queue.head = (queue.head + 1) % FIRE_QUEUE_SIZE;
+    queue.count--;
+    return true;
+}
+
+void fireHeartbeat(sFireControl &fire, uint32_t nowMs)
+{
+    fire.heartbeatSeen = true;
+    fire.heartbeatMs = nowMs;
+}
+
+bool fireHeartbeatOk(const sFireControl &fire, uint32_t nowMs, uint32_t limitMs = FIRE_HEARTBEAT_MS)
+{
+    return fire.heartbeatSeen && nowMs - fire.heartbeatMs <= limitMs;
+}
+
+// A beacon from our master: the heartbeat, plus the command its arm switch
+// calls for (FireCommandKind), -1 for none.
+int fireBeacon(sFireControl &fire, bool masterArmed, uint32_t nowMs)
+{
+    fireHeartbeat(fire, nowMs);
+    bool switchedOn = masterArmed && !fire.masterArmed;
+    fire.masterArmed = masterArmed;
+    if (switchedOn)
+    {
+        return FIRE_CMD_ARM;
+    }
+    return !masterArmed && fire.armed ? FIRE_CMD_DISARM : -1;
+}
+
+int fireActive(const sFireControl &fire)
+{
+    return __builtin_popcount(fire.outputs);
+}
+
+FireResult fireRefuse(sFireControl &fire, FireResult result)
+{
+    fire.refused[result]++;
+    return result;
+}
+
+FireResult fireArm(sFireControl &fire, uint32_t nowMs)
+{
+    if (!fireHeartbeatOk(fire, nowMs))
+    {
+        return fireRefuse(fire, FIRE_NO_HEARTBEAT);
+    }
+    if (!fire.armed)
+    {
+        fire.armed = true;
+        fire.armedMs = nowMs;
+        fire.fired = 0;
+    }
+    return FIRE_OK;
+}
+
+// Cuts every output. Returns the channels that were on.
+uint32_t fireDisarm(sFireControl &fire, uint32_t nowUs)
+{
+    uint32_t cut = fire.outputs;
+    for (int i = 0; i < fire.channels; i++)
+    {
+        if (cut & (1u << i))
+        {
+            fire.channel[i].onUs = nowUs - fire.channel[i].startUs;
+        }
+    }
+    fire.armed = false;
+    fire.outputs = 0;
+    return cut;
+}
+
+// Channel is 1-based. On FIRE_OK the output is on and the caller times the pulse: pulseUs.
+FireResult fireStart(sFireControl &fire, uint8_t channel, uint16_t pulseMs, uint32_t nowMs, uint32_t nowUs,
+                      uint32_t &pulseUs)
+{
+    if (channel < 1 || channel > fire.channels)
+    {
+        return fireRefuse(fire, FIRE_BAD_CHANNEL);
+    }
+    uint32_t bit = 1u << (channel - 1);
+    if (!fire.armed)
+    {
+        return fireRefuse(fire, FIRE_NOT_ARMED);
+    }
+    if (!fireHeartbeatOk(fire, nowMs))
+    {
+        return fireRefuse(fire, FIRE_NO_HEARTBEAT);
+    }
+    if (!fire.continuityValid || !(fire.continuity & bit))
+    {
+        return fireRefuse(fire, FIRE_NO_CONTINUITY);
+    }
+    if (fire.fired & bit)
+    {
+        return fireRefuse(fire, FIRE_ALREADY_FIRED);
+    }
+    if (fireActive(fire) >= FIRE_MAX_CONCURRENT)
+    {
+        return fireRefuse(fire, FIRE_BUSY);
+    }
+
+    pulseMs = pulseMs == 0 ? FIRE_PULSE_DEFAULT_MS : pulseMs;
+    pulseMs = pulseMs < FIRE_PULSE_MIN_MS ? FIRE_PULSE_MIN_MS : pulseMs > FIRE_PULSE_MAX_MS ? FIRE_PULSE_MAX_MS : pulseMs;
+    sFireChannel &state = fire.channel[channel - 1];
+    state.startUs = nowUs;
+    state.requestedUs = pulseMs * 1000u;
+    state.onUs = 0;
+    state.fires++;
+    fire.outputs |= bit;
+    fire.fired |= bit;
+    pulseUs = state.requestedUs;
+    return FIRE_OK;
+}
+
+// The pulse timer for a channel (0-based index) ran out. False if there was nothing to end.
+bool fireEnd(sFireControl &fire, int index, uint32_t nowUs)
+{
+    uint32_t bit = 1u << index;
+    sFireChannel &state = fire.channel[index];
+    if (!(fire.outputs & bit) || nowUs - state.startUs + FIRE_TIMER_SLACK_US < state.requestedUs)
+    {
+        return false;
+    }
+    fire.outputs &= ~bit;
+    state.onUs = nowUs - state.startUs;
+    return true;
+}
+
+// Periodically. True if the master went quiet and this disarmed.
+bool fireService(sFireControl &fire, uint32_t nowMs, uint32_t nowUs)
+{
+    if (fire.armed && !fireHeartbeatOk(fire, nowMs, FIRE_DISARM_MS))
+    {
+        fireDisarm(fire, nowUs);
+        fire.autoDisarms++;
+        return true;
+    }
+    return false;
+}
+
+// A continuity scan, bit per channel.
+void fireContinuity(sFireControl &fire, uint32_t present, uint32_t nowMs)
+{
+    fire.continuity = present & (fire.channels >= 32 ? 0xFFFFFFFFu : (1u << fire.channels) - 1);
+    fire.continuityValid = true;
+    fire.continuityMs = nowMs;
+}
+
+const char *fireResultName(int result)
+{
+    static const char *names[FIRE_RESULTS] = {"ok", "bad channel", "not armed", "no heartbeat",
+                                              "no continuity", "already fired", "busy", "queue full"};
+    return result >= 0 && result < FIRE_RESULTS ? names[result] : "?";
+}
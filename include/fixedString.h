@@ -0,0 +1,231 @@
+/*+===================================================================
+  File:      fixedString.h
+
+  Summary:   Fixed capacity string and number formatting for hot
+             paths (status, push notices, logging) so they don't
+             churn the heap the way String concatenation does.
+
+             FixedString<N> holds at most N - 1 chars inline, is
+             always null terminated and silently truncates (check
+             truncated() if it matters). Nothing here allocates
+             and nothing needs Arduino, so host tools can use it.
+             The uptime formats behind zUtils::getLongTime() and
+             friends live here too, taking the millis() value, and
+             tools/fixedbench.cpp counts their allocations.
+
+                FixedString<32> msg;
+                msg.append("Shell #").appendUInt(shell);
+                ws.textAll(msg.c_str());
+
+  10/19/2026.
+===================================================================+*/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+// Write v in decimal into buf (no terminator), zero padded to minDigits. Returns chars written.
+size_t formatUInt(char *buf, uint32_t v, uint8_t minDigits = 1)
+{
+    char digits[10];
+    size_t n = 0;
+    do
+    {
+        digits[n++] = '0' + (v % 10);
+        v /= 10;
+    } while (v != 0);
+    while (n < minDigits && n < sizeof(digits))
+    {
+        digits[n++] = '0';
+    }
+    for (size_t i = 0; i < n; i++)
+    {
+        buf[i] = digits[n - 1 - i];
+    }
+    return n;
+}
+
+template <size_t N>
+class FixedString
+{
+public:
+    FixedString() { clear(); }
+    FixedString(const char *s)
+    {
+        clear();
+        append(s);
+    }
+
+    void clear()
+    {
+        _len = 0;
+        _truncated = false;
+        _buf[0] = 0;
+    }
+
+    const char *c_str() const { return _buf; }
+    size_t length() const { return _len; }
+    size_t capacity() const { return N - 1; }
+    bool truncated() const { return _truncated; }
+
+    FixedString &append(const char *s)
+    {
+        while (*s)
+        {
+            if (_len >= N - 1)
+            {
+                _truncated = true;
+                break;
+            }
+            _buf[_len++] = *s++;
+        }
+        _buf[_len] = 0;
+        return *this;
+    }
+
+    FixedString &append(const char *s, size_t len)
+    {
+        size_t room = N - 1 - _len;
+        size_t take = len < room ? len : room;
+        memcpy(_buf + _len, s, take);
+        _len += take;
+        _truncated |= take < len;
+        _buf[_len] = 0;
+        return *this;
+    }
+
+    FixedString &append(char c)
+    {
+        return append(&c, 1);
+    }
+
+    FixedString &appendUInt(uint32_t v, uint8_t minDigits = 1)
+    {
+        char digits[10];
+        return append(digits, formatUInt(digits, v, minDigits));
+    }
+
+    FixedString &appendInt(int32_t v)
+    {
+        if (v < 0)
+        {
+            append('-');
+            return appendUInt((uint32_t)0 - (uint32_t)v);
+        }
+        return appendUInt((uint32_t)v);
+    }
+
+    FixedString &appendHex(uint32_t v, uint8_t minDigits = 1)
+    {
+        char digits[8];
+        size_t n = 0;
+        do
+        {
+            digits[n++] = "0123456789abcdef"[v & 0x0F];
+            v >>= 4;
+        } while (v != 0);
+        while (n < minDigits && n < sizeof(digits))
+        {
+            digits[n++] = '0';
+        }
+        while (n > 0)
+        {
+            append(digits[--n]);
+        }
+        return *this;
+    }
+
+    // Dotted quad from an lwIP/IPAddress style address (first octet in the low byte).
+    FixedString &appendIP(uint32_t ip)
+    {
+        for (int i = 0; i < 4; i++)
+        {
+            if (i > 0)
+            {
+                append('.');
+            }
+            appendUInt((ip >> (i * 8)) & 0xFF);
+        }
+        return *this;
+    }
+
+    // Fixed point value with the given number of decimals, e.g. (2345, 2) -> "23.45".
+    FixedString &appendFixed(int32_t value, uint8_t decimals)
+    {
+        uint32_t scale = 1;
+        for (uint8_t i = 0; i < decimals; i++)
+        {
+            scale *= 10;
+        }
+        uint32_t magnitude = (uint32_t)value;
+        if (value < 0)
+        {
+            append('-');
+            magnitude = (uint32_t)0 - magnitude;
+        }
+        appendUInt(magnitude / scale);
+        if (decimals > 0)
+        {
+            append('.');
+            appendUInt(magnitude % scale, decimals);
+        }
+        return *this;
+    }
+
+    FixedString &operator+=(const char *s) { return append(s); }
+    FixedString &operator+=(char c) { return append(c); }
+
+private:
+    char _buf[N];
+    size_t _len;
+    bool _truncated;
+};
+
+/*--------------------------------------------------------------------
+   Uptime formats (zUtils passes millis())
+---------------------------------------------------------------------*/
+
+typedef FixedString<32> TimeString;
+
+// "1d 2:3:4:567ms"
+TimeString formatLongTime(uint32_t ms)
+{
+    uint32_t seconds = ms / 1000;
+    uint32_t minutes = seconds / 60;
+    uint32_t hours = minutes / 60;
+    TimeString time;
+    time.appendUInt(hours / 24).append("d ").appendUInt(hours % 24).append(':').appendUInt(minutes % 60).append(':');
+    time.appendUInt(seconds % 60).append(':').appendUInt(ms % 1000).append("ms");
+    return time;
+}
+
+// "1d 2:3:4s "
+TimeString formatMidTime(uint32_t ms)
+{
+    uint32_t seconds = ms / 1000;
+    uint32_t minutes = seconds / 60;
+    uint32_t hours = minutes / 60;
+    TimeString time;
+    time.appendUInt(hours / 24).append("d ").appendUInt(hours % 24).append(':').appendUInt(minutes % 60).append(':');
+    time.appendUInt(seconds % 60).append("s ");
+    return time;
+}
+
+// "1d 2h 3 m"
+TimeString formatShortTime(uint32_t ms)
+{
+    uint32_t minutes = ms / 60000;
+    uint32_t hours = minutes / 60;
+    TimeString time;
+    time.appendUInt(hours / 24).append("d ").appendUInt(hours % 24).append("h ").appendUInt(minutes % 60).append(" m");
+    return time;
+}
+
+// "3m 4s ", minutes wrap at the hour.
+TimeString formatMinSec(uint32_t ms)
+{
+    uint32_t seconds = ms / 1000;
+    TimeString time;
+    time.appendUInt(seconds / 60 % 60).append("m ").appendUInt(seconds % 60).append("s ");
+    return time;
+}
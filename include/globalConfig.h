@@ -9,33 +9,70 @@
 
               [Pre-deloyment configuration & globals]
 
-1. Set DATA_PIN, NUM_ROWS and NUM_COLS -> Set ROWS=1 for single strip.
-2. Set MAX_CURRENT in milliamps and NUM_VOLTS (must match PSU used!).
-3. Set hostName and friendly name.
-4. Set ssid and password in secrets.h.
-5. Enable USE_HARDWARE_INPUT if using an analog brightness knob (GPIO35).
-6. Set NUM_LEDS to the number of LEDs in the strip/matrix.
+1. Pick or add the install's profile in installProfile.h: data pin,
+   rows/cols (rows=1 for a single strip), LED count, MAX_CURRENT in
+   milliamps and volts (must match PSU used!), hostname, friendly name.
+2. Set ssid and password in secrets.h.
+3. Set the USE_* flags for the install in its platformio.ini
+   environment, e.g. USE_HARDWARE_INPUT=1 for an analog brightness
+   knob (GPIO35). The defaults below apply where it doesn't.
+4. pio run -t upload -e <profile>
 ===================================================================+*/
 
+#include <installProfile.h>
+
+#ifndef USE_HARDWARE_INPUT
 #define USE_HARDWARE_INPUT 0     // Use installed hardware (knob, temp, buttons etc.)
+#endif
+#ifndef USE_TEMPERATURE_SENSOR
 #define USE_TEMPERATURE_SENSOR 0 // Use temperature sensor
+#endif
+#ifndef USE_AUDIO_INPUT
+#define USE_AUDIO_INPUT 0        // Use I2S microphone/line-in for audio reactive effects
+#endif
+#ifndef USE_UDP_FASTPATH
+#define USE_UDP_FASTPATH 1       // Broadcast cues and sync beacons to subs over UDP as well as WebSocket
+#endif
+#ifndef USE_DMX_INPUT
+#define USE_DMX_INPUT 1          // Let a lighting desk drive the strip over sACN (E1.31) / Art-Net
+#endif
+#ifndef USE_SUB_DISCOVERY
+#define USE_SUB_DISCOVERY 1      // Advertise over mDNS, the master keeps a roster of its subs
+#endif
+#ifndef USE_FIRING
+#define USE_FIRING 1             // Drive the profile's firing channels (fireChannels.h), needs channels > 0
+#endif
+#ifndef FIRE_BENCH
+#define FIRE_BENCH 0             // Bench rig without a master: "hb" over WebSocket is the heartbeat, any client may fire
+#endif
+#define USE_GET_MILLISECOND_TIMER // FastLED timing goes through get_millisecond_timer() (LEDController.h), before any FastLED include
 const int RND_PIN = 34;
 const int COLOR_SELECT_PIN = 16;
 const int BRITE_KNOB_PIN = 35;
-const int DATA_PIN = 5;
+const int DATA_PIN = g_profile.dataPin;
 const int TEMP_SCL_PIN = 22; // display and temperature sensors.
 const int TEMP_SDA_PIN = 21; // display and temperature sensors.
-const int NUM_ROWS = 1;
-const int NUM_COLS = 0;
-const int MAX_CURRENT = 2000; // mA
-const int NUM_VOLTS = 5;
+const int I2S_BCK_PIN = 26;  // audio input bit clock.
+const int I2S_WS_PIN = 14;   // audio input word select.
+const int I2S_SD_PIN = 32;   // audio input data.
+const int FAN_PIN = 33;      // PWM PSU fan, run by the thermal governor.
+const int FIRE_SER_PIN = 23;   // firing outputs, 74HC595 chain data.
+const int FIRE_CLK_PIN = 18;   // firing outputs and continuity, shared shift clock.
+const int FIRE_LATCH_PIN = 19; // firing outputs, 74HC595 latch.
+const int FIRE_OE_PIN = 17;    // firing outputs enable, active low, pulled up so they're off until armed.
+const int FIRE_SENSE_PIN = 27; // continuity, 74HC165 chain data.
+const int FIRE_LOAD_PIN = 13;  // continuity, 74HC165 parallel load, active low.
+const int NUM_ROWS = g_profile.numRows;
+const int NUM_COLS = g_profile.numCols;
+const int MAX_CURRENT = g_profile.maxCurrent; // mA
+const int NUM_VOLTS = g_profile.volts;
 
 // was in kanimations.h
-#define NUM_LEDS 25
+#define NUM_LEDS (g_profile.numLeds)
 
 // was in secrets.h
-String hostName = "bangworx-server";           // hostname as seen on network and home page
-String friendlyName = "BangWorx Server";       // friendly name for home page
+String hostName = g_profile.hostName;           // hostname as seen on network and home page
+String friendlyName = g_profile.friendlyName;   // friendly name for home page
 String softwareVersion = "8.18.22";             // used for about page
 String deviceFamily = "ESP32-ELOTA-Fireworks"; // used for about page
 String description = "Go bang!";               // used for about page
@@ -48,5 +85,6 @@ String globalIP = "";
 String g_temperature = "";
 String g_pageTitle = hostName + " | " + description; // home page title
 String g_friendlyName = friendlyName + " ¤";
-bool g_isAccessPoint = true;
-int g_total_clients = 0;
\ No newline at end of file
+bool g_isAccessPoint = g_profile.accessPoint;
+int g_total_clients = 0;              // stations on our SoftAP, kept by WiFi events
+volatile uint32_t g_statusVersion = 1; // bumped on every client-count change
\ No newline at end of file
@@ -0,0 +1,136 @@
+/*+===================================================================
+  File:      hardwareInput.h
+
+  Summary:   Brightness knob and colour button (USE_HARDWARE_INPUT),
+             conditioned by inputFilter.h off the loop.
+
+             An esp_timer samples the knob every INPUT_SAMPLE_MS,
+             runs the fixed point EMA and hysteresis and queues a
+             brightness event only when the level really moved. The
+             button pin interrupts on every edge; the same timer then
+             watches it until the bounce has settled and queues one
+             colour event per press.
+
+             loop() drains the queue in checkBriteKnob(), the only
+             place g_briteValue / g_chsvColor change from hardware,
+             and is woken early for it like a UDP cue.
+
+  10/19/2026.
+===================================================================+*/
+
+#include <Arduino.h>
+#include <inputFilter.h>
+
+#define INPUT_SAMPLE_MS 5 // 200 Hz, well inside the EMA's settling time
+
+// externs
+extern uint8_t g_briteValue;
+extern CHSV g_chsvColor;
+extern Mode g_mode;
+
+// locals
+uint8_t inputKnobLevel = 255; // brightness the knob asks for, full until it's read.
+
+#if USE_HARDWARE_INPUT
+#include <esp_timer.h>
+
+// locals
+esp_timer_handle_t inputTimer = nullptr;
+TaskHandle_t inputLoopTask = nullptr;
+sKnobFilter inputKnob;
+sDebounce inputButton;
+sInputQueue inputQueue;
+volatile bool inputButtonEdge = false;
+uint8_t inputPresses = 0;
+uint8_t inputColorIndex = 0;
+
+void IRAM_ATTR inputButtonIsr()
+{
+    inputButtonEdge = true;
+}
+
+void inputPublish(uint8_t type, uint8_t value)
+{
+    sInputEvent event = {type, value};
+    if (inputQueuePush(inputQueue, event))
+    {
+        xTaskNotifyGive(inputLoopTask);
+    }
+}
+
+// esp_timer task: the only producer on inputQueue.
+void inputSample(void *arg)
+{
+    int level = knobSample(inputKnob, analogRead(BRITE_KNOB_PIN));
+    if (level >= 0)
+    {
+        inputPublish(INPUT_BRIGHTNESS, level);
+    }
+
+    if (inputButtonEdge || debounceBusy(inputButton))
+    {
+        inputButtonEdge = false;
+        if (debounceSample(inputButton, digitalRead(COLOR_SELECT_PIN), millis()))
+        {
+            inputPublish(INPUT_COLOR_NEXT, ++inputPresses);
+        }
+    }
+}
+
+void inputBegin()
+{
+    knobInit(inputKnob);
+    inputQueueInit(inputQueue);
+    inputLoopTask = xTaskGetCurrentTaskHandle(); // setup() runs on the loop task
+
+    pinMode(BRITE_KNOB_PIN, INPUT);
+    pinMode(COLOR_SELECT_PIN, INPUT); // 10k pull-down, pressed = high
+    debounceInit(inputButton, digitalRead(COLOR_SELECT_PIN));
+    attachInterrupt(digitalPinToInterrupt(COLOR_SELECT_PIN), inputButtonIsr, CHANGE);
+
+    esp_timer_create_args_t args = {};
+    args.callback = inputSample;
+    args.name = "input";
+    if (esp_timer_create(&args, &inputTimer) != ESP_OK ||
+        esp_timer_start_periodic(inputTimer, INPUT_SAMPLE_MS * 1000) != ESP_OK)
+    {
+        Serial.println("Input: sampler timer failed.");
+    }
+}
+
+// Called from loop(), applies whatever the knob and button did since last time.
+void checkBriteKnob()
+{
+    sInputEvent event;
+    while (inputQueuePop(inputQueue, event))
+    {
+        switch (event.type)
+        {
+        case INPUT_BRIGHTNESS:
+            inputKnobLevel = event.value;
+            g_briteValue = event.value;
+            FastLED.setBrightness(g_briteValue);
+            break;
+        case INPUT_COLOR_NEXT:
+            inputColorIndex = (inputColorIndex + 1) % PRESET_COUNT;
+            g_chsvColor = CHSV(defaultSwatches[inputColorIndex][0], defaultSwatches[inputColorIndex][1],
+                               defaultSwatches[inputColorIndex][2]);
+            g_mode = SolidColor;
+            break;
+        }
+        presetTouch();
+    }
+}
+
+#else
+
+void inputBegin() {}
+void checkBriteKnob() {}
+
+#endif
+
+// Brightness ceiling from the knob, 255 without one.
+uint8_t getBrigtnessLimit()
+{
+    return inputKnobLevel;
+}
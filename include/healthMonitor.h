@@ -0,0 +1,376 @@
+/*+===================================================================
+  File:      healthMonitor.h
+
+  Summary:   Loop health with stall attribution. Each subsystem marks
+             the work it is doing, one task per subsystem:
+
+                render    loop(), one pass per iteration, labelled
+                          with the service it's in (HEALTH_CALL)
+                http      the AsyncTCP task: every HTTP route, the
+                          WebSocket handler and OTA upload bodies
+                input     the i2c task's sensor reads and display
+                          chunks
+                boot      the net task's boot stages
+                ota       the OTA writer task's flash erase, writes
+                          and image check
+
+             A small "health" task is the only one subscribed to the
+             task watchdog. It looks at the subsystems every
+             HEALTH_TICK_MS and feeds the watchdog only while none
+             of them has been in one piece of work longer than its
+             budget (HEALTH_BUDGET_MS unless the scope says
+             otherwise, the WiFi join gets longer). Past the budget
+             it stops feeding and the watchdog resets the board
+             HEALTH_WDT_S later, instead of the strip sitting frozen
+             until someone power cycles it. The watchdog is set to
+             panic, so the idle tasks it already watches reset the
+             board too if something starves a core.
+
+             Anything over HEALTH_STALL_MS is a stall: subsystem,
+             label, when and how long go into a small ring in RTC
+             memory, which survives everything but a power cycle.
+             A stall still open at the next boot is the one that
+             ended in the reset, it gets that boot's reset reason.
+
+                GET /api/health    subsystems now, stalls so far
+                /about             the last stall
+
+             A scope saves and restores the subsystem's previous
+             work so nesting on one task is fine. Two tasks in one
+             subsystem would overwrite each other's label and clock,
+             so a new task gets its own subsystem; an enter from a
+             task other than the one already in the slot is counted
+             as "shared" in /api/health to catch that.
+
+  10/19/2026.
+===================================================================+*/
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include <esp_system.h>
+#include <esp_task_wdt.h>
+
+#define HEALTH_RENDER 0
+#define HEALTH_HTTP 1
+#define HEALTH_INPUT 2
+#define HEALTH_BOOT 3
+#define HEALTH_OTA 4
+#define HEALTH_SUBSYSTEMS 5
+
+#define HEALTH_TICK_MS 250
+#define HEALTH_STALL_MS 1000
+#define HEALTH_BUDGET_MS 8000
+#define HEALTH_WDT_S 5
+#define HEALTH_STALLS 8
+#define HEALTH_LABEL_MAX 24
+#define HEALTH_RTC_MAGIC 0x48454C54
+
+// Mark the call about to run, then run it: HEALTH_CALL(HEALTH_RENDER, showService());
+#define HEALTH_CALL(sub, call)  \
+    do                          \
+    {                           \
+        healthMark(sub, #call); \
+        call;                   \
+    } while (0)
+
+struct sHealthSlot
+{
+    const char *volatile label;
+    volatile uint32_t sinceMs;
+    volatile uint32_t budgetMs;
+    volatile bool active;
+    TaskHandle_t task;   // the task in the slot
+    uint32_t shared;     // enters from another task while it was active
+    uint32_t worstMs;
+    const char *worstLabel;
+    int stall;         // open stall record, -1 for none
+    uint32_t stallSince;
+};
+
+struct sHealthStall
+{
+    uint32_t boot;
+    uint32_t atMs;       // since that boot
+    uint32_t durationMs;
+    uint8_t subsystem;
+    bool open;           // still going when last looked at
+    bool reset;          // it ended in a reset
+    uint8_t resetReason; // esp_reset_reason_t of that reset
+    char label[HEALTH_LABEL_MAX];
+};
+
+struct sHealthRtc
+{
+    uint32_t magic;
+    uint32_t boots;
+    uint32_t next;
+    uint32_t count;
+    sHealthStall stalls[HEALTH_STALLS];
+};
+
+// locals
+RTC_NOINIT_ATTR sHealthRtc healthRtc;
+sHealthSlot healthSlots[HEALTH_SUBSYSTEMS];
+const char *healthNames[HEALTH_SUBSYSTEMS] = {"render", "http", "input", "boot", "ota"};
+esp_reset_reason_t healthResetReason = ESP_RST_UNKNOWN;
+volatile bool healthStarving = false;
+
+void healthEnter(int sub, const char *label, uint32_t budgetMs = HEALTH_BUDGET_MS)
+{
+    sHealthSlot &slot = healthSlots[sub];
+    TaskHandle_t task = xTaskGetCurrentTaskHandle();
+    if (slot.active && slot.task != task)
+    {
+        slot.shared++;
+    }
+    slot.task = task;
+    slot.label = label;
+    slot.budgetMs = budgetMs;
+    slot.sinceMs = millis();
+    slot.active = true;
+}
+
+// Relabel the running work without restarting its clock.
+void healthMark(int sub, const char *label)
+{
+    healthSlots[sub].label = label;
+}
+
+void healthLeave(int sub)
+{
+    sHealthSlot &slot = healthSlots[sub];
+    uint32_t elapsed = millis() - slot.sinceMs;
+    slot.active = false;
+    if (elapsed > slot.worstMs)
+    {
+        slot.worstMs = elapsed;
+        slot.worstLabel = slot.label;
+    }
+}
+
+// Scoped healthEnter()/healthLeave(), puts back whatever the subsystem was doing before.
+struct sHealthScope
+{
+    int sub;
+    const char *label;
+    uint32_t sinceMs;
+    uint32_t budgetMs;
+    bool active;
+    TaskHandle_t task;
+
+    sHealthScope(int subsystem, const char *what, uint32_t budget = HEALTH_BUDGET_MS)
+    {
+        sHealthSlot &slot = healthSlots[subsystem];
+        sub = subsystem;
+        label = slot.label;
+        sinceMs = slot.sinceMs;
+        budgetMs = slot.budgetMs;
+        active = slot.active;
+        task = slot.task;
+        healthEnter(subsystem, what, budget);
+    }
+
+    ~sHealthScope()
+    {
+        healthLeave(sub);
+        if (active)
+        {
+            sHealthSlot &slot = healthSlots[sub];
+            slot.label = label;
+            slot.budgetMs = budgetMs;
+            slot.sinceMs = sinceMs;
+            slot.task = task;
+            slot.active = true;
+        }
+    }
+};
+
+const char *healthResetName(int reason)
+{
+    switch (reason)
+    {
+    case ESP_RST_POWERON:
+        return "power on";
+    case ESP_RST_EXT:
+        return "external";
+    case ESP_RST_SW:
+        return "software";
+    case ESP_RST_PANIC:
+        return "panic";
+    case ESP_RST_INT_WDT:
+        return "interrupt watchdog";
+    case ESP_RST_TASK_WDT:
+        return "task watchdog";
+    case ESP_RST_WDT:
+        return "watchdog";
+    case ESP_RST_DEEPSLEEP:
+        return "deep sleep";
+    case ESP_RST_BROWNOUT:
+        return "brownout";
+    default:
+        return "unknown";
+    }
+}
+
+// Open a stall record for the slot's current work, or update the one it has.
+void healthRecordStall(int sub, sHealthSlot &slot, uint32_t elapsed)
+{
+    if (slot.stall < 0 || slot.stallSince != slot.sinceMs)
+    {
+        if (slot.stall >= 0)
+        {
+            healthRtc.stalls[slot.stall].open = false; // that one ended, this is a new one
+        }
+        slot.stall = healthRtc.next;
+        slot.stallSince = slot.sinceMs;
+        healthRtc.next = (healthRtc.next + 1) % HEALTH_STALLS;
+        healthRtc.count++;
+        sHealthStall &stall = healthRtc.stalls[slot.stall];
+        stall.boot = healthRtc.boots;
+        stall.atMs = slot.sinceMs;
+        stall.subsystem = sub;
+        stall.open = true;
+        stall.reset = false;
+        stall.resetReason = 0;
+        strncpy(stall.label, slot.label ? slot.label : "?", HEALTH_LABEL_MAX - 1);
+        stall.label[HEALTH_LABEL_MAX - 1] = 0;
+        logEvent(LOG_STALL, sub);
+    }
+    healthRtc.stalls[slot.stall].durationMs = elapsed;
+}
+
+void healthCloseStall(int sub, sHealthSlot &slot)
+{
+    if (slot.stall >= 0)
+    {
+        sHealthStall &stall = healthRtc.stalls[slot.stall];
+        stall.open = false;
+        logEvent(LOG_STALL_END, sub, stall.durationMs);
+        slot.stall = -1;
+    }
+}
+
+void healthTask(void *param)
+{
+    esp_task_wdt_add(nullptr);
+    for (;;)
+    {
+        int over = -1; // a subsystem past its budget
+        for (int sub = 0; sub < HEALTH_SUBSYSTEMS; sub++)
+        {
+            sHealthSlot &slot = healthSlots[sub];
+            uint32_t since = slot.sinceMs;
+            uint32_t elapsed = millis() - since; // read after since, so never negative
+            if (slot.active && elapsed > HEALTH_STALL_MS)
+            {
+                healthRecordStall(sub, slot, elapsed);
+                over = elapsed > slot.budgetMs ? sub : over;
+            }
+            else if (slot.stall >= 0 && (!slot.active || slot.stallSince != since))
+            {
+                healthCloseStall(sub, slot);
+            }
+        }
+        if (over < 0)
+        {
+            esp_task_wdt_reset();
+        }
+        else if (!healthStarving)
+        {
+            logEvent(LOG_WDT_STARVE, over);
+            Serial.printf("Health: %s over budget, watchdog reset in %d s\n", healthNames[over], HEALTH_WDT_S);
+        }
+        healthStarving = over >= 0;
+        vTaskDelay(pdMS_TO_TICKS(HEALTH_TICK_MS));
+    }
+}
+
+// First thing in setup(): picks up last boot's stalls, then starts watching.
+void healthBegin()
+{
+    healthResetReason = esp_reset_reason();
+    if (healthRtc.magic != HEALTH_RTC_MAGIC || healthResetReason == ESP_RST_POWERON ||
+        healthRtc.next >= HEALTH_STALLS)
+    {
+        memset(&healthRtc, 0, sizeof(healthRtc));
+        healthRtc.magic = HEALTH_RTC_MAGIC;
+    }
+    healthRtc.boots++;
+    for (int i = 0; i < HEALTH_STALLS; i++)
+    {
+        sHealthStall &stall = healthRtc.stalls[i];
+        if (stall.open)
+        {
+            stall.open = false;
+            stall.reset = true;
+            stall.resetReason = healthResetReason;
+            Serial.printf("Health: last boot ended stalled in %s (%s) after %u ms, %s reset\n",
+                          healthNames[stall.subsystem % HEALTH_SUBSYSTEMS], stall.label, stall.durationMs,
+                          healthResetName(healthResetReason));
+        }
+    }
+    for (int sub = 0; sub < HEALTH_SUBSYSTEMS; sub++)
+    {
+        healthSlots[sub] = {nullptr, 0, HEALTH_BUDGET_MS, false, nullptr, 0, 0, nullptr, -1, 0};
+    }
+    esp_task_wdt_init(HEALTH_WDT_S, true);
+    xTaskCreatePinnedToCore(healthTask, "health", 3072, nullptr, 5, nullptr, 0);
+}
+
+const sHealthStall *healthLastStall()
+{
+    if (healthRtc.count == 0)
+    {
+        return nullptr;
+    }
+    return &healthRtc.stalls[(healthRtc.next + HEALTH_STALLS - 1) % HEALTH_STALLS];
+}
+
+// One line for the about page.
+String healthLastStallText()
+{
+    const sHealthStall *stall = healthLastStall();
+    if (stall == nullptr)
+    {
+        return "none";
+    }
+    char text[96];
+    snprintf(text, sizeof(text), "%s in %s, %u ms, %s%s%s", healthNames[stall->subsystem % HEALTH_SUBSYSTEMS],
+             stall->label, stall->durationMs, stall->boot == healthRtc.boots ? "this boot" : "earlier boot",
+             stall->reset ? ", reset: " : "", stall->reset ? healthResetName(stall->resetReason) : "");
+    return String(text);
+}
+
+void handleHealth(AsyncWebServerRequest *request)
+{
+    AsyncResponseStream *response = request->beginResponseStream("application/json");
+    response->printf("{\"boot\":%u,\"resetReason\":\"%s\",\"stallMs\":%d,\"watchdogS\":%d,\"starving\":%s,"
+                     "\"subsystems\":[",
+                     healthRtc.boots, healthResetName(healthResetReason), HEALTH_STALL_MS, HEALTH_WDT_S,
+                     healthStarving ? "true" : "false");
+    for (int sub = 0; sub < HEALTH_SUBSYSTEMS; sub++)
+    {
+        const sHealthSlot &slot = healthSlots[sub];
+        bool active = slot.active;
+        uint32_t since = slot.sinceMs;
+        response->printf("%s{\"name\":\"%s\",\"active\":%s,\"label\":\"%s\",\"ms\":%u,\"budgetMs\":%u,"
+                         "\"worstMs\":%u,\"worstLabel\":\"%s\",\"shared\":%u}",
+                         sub ? "," : "", healthNames[sub], active ? "true" : "false", slot.label ? slot.label : "",
+                         active ? millis() - since : 0, slot.budgetMs, slot.worstMs,
+                         slot.worstLabel ? slot.worstLabel : "", slot.shared);
+    }
+    response->printf("],\"stallCount\":%u,\"stalls\":[", healthRtc.count);
+    uint32_t shown = healthRtc.count < HEALTH_STALLS ? healthRtc.count : HEALTH_STALLS;
+    for (uint32_t i = 0; i < shown; i++)
+    {
+        // Newest first.
+        const sHealthStall &stall = healthRtc.stalls[(healthRtc.next + HEALTH_STALLS - 1 - i) % HEALTH_STALLS];
+        response->printf("%s{\"boot\":%u,\"subsystem\":\"%s\",\"label\":\"%s\",\"atMs\":%u,\"ms\":%u,\"open\":%s,"
+                         "\"reset\":%s,\"resetReason\":\"%s\"}",
+                         i ? "," : "", stall.boot, healthNames[stall.subsystem % HEALTH_SUBSYSTEMS], stall.label,
+                         stall.atMs, stall.durationMs, stall.open ? "true" : "false", stall.reset ? "true" : "false",
+                         stall.reset ? healthResetName(stall.resetReason) : "");
+    }
+    response->print("]}");
+    request->send(response);
+}
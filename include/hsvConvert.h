@@ -0,0 +1,203 @@
+/*+===================================================================
+  File:      hsvConvert.h
+
+  Summary:   Batch HSV to RGB with the exact output of FastLED's
+             hsv2rgb_rainbow(), for effects that draw into an HSV
+             canvas and convert the whole frame just before show().
+
+             hsv2rgb_rainbow() is three independent stages: the hue
+             picks a base colour, saturation scales it and adds a
+             floor, value scales the result. Its special cases (sat
+             or val of 0 or 255) land on the same numbers the general
+             formula gives, so with a table per stage a pixel is
+             three lookups and a few multiplies, no branches:
+
+                c = hue[h][ch]
+                c = (c * satMul[s] >> 8) + satAdd[s]
+                c =  c * valMul[v] >> 8
+
+             When saturation and value are fixed for a run of pixels
+             (solid colours, rainbows) hsvBuildHueLut() folds all of
+             it into 256 RGB entries and a pixel is one lookup.
+
+             hsvRainbowReference() is hsv2rgb_rainbow() as FastLED
+             3.5 builds it for the ESP32 (C path, SCALE8_FIXED,
+             yellow boost Y1, no green scaling). tools/hsvbench.cpp
+             checks the batch paths against it for every HSV value,
+             effectCheck.h checks them against the real thing on
+             the device.
+
+             Buffers are packed 3 bytes per pixel, the layout of
+             CHSV and CRGB. No Arduino dependencies.
+
+  10/19/2026.
+===================================================================+*/
+
+#include <stdint.h>
+#include <stddef.h>
+
+struct sHsvTables
+{
+    uint8_t hue[256][3];
+    uint16_t satMul[256]; // 256 - floor, i.e. FastLED's satscale + 1
+    uint8_t satAdd[256];  // the brightness floor
+    uint16_t valMul[256]; // scale8_video(v, v) + 1
+};
+
+struct sHsvHueLut
+{
+    uint8_t rgb[256][3];
+};
+
+uint8_t hsvScale8(uint8_t i, uint8_t scale)
+{
+    return (i * (scale + 1)) >> 8;
+}
+
+uint8_t hsvScale8Video(uint8_t i, uint8_t scale)
+{
+    return ((i * scale) >> 8) + ((i && scale) ? 1 : 0);
+}
+
+void hsvRainbowReference(uint8_t hue, uint8_t sat, uint8_t val, uint8_t *rgb)
+{
+    uint8_t offset8 = (hue & 0x1F) << 3;
+    uint8_t third = hsvScale8(offset8, 256 / 3);
+    uint8_t twothirds = hsvScale8(offset8, (256 * 2) / 3);
+    uint8_t r, g, b;
+
+    switch (hue >> 5)
+    {
+    case 0: // R -> O
+        r = 255 - third;
+        g = third;
+        b = 0;
+        break;
+    case 1: // O -> Y
+        r = 171;
+        g = 85 + third;
+        b = 0;
+        break;
+    case 2: // Y -> G
+        r = 171 - twothirds;
+        g = 170 + third;
+        b = 0;
+        break;
+    case 3: // G -> A
+        r = 0;
+        g = 255 - third;
+        b = third;
+        break;
+    case 4: // A -> B
+        r = 0;
+        g = 171 - twothirds;
+        b = 85 + twothirds;
+        break;
+    case 5: // B -> P
+        r = third;
+        g = 0;
+        b = 255 - third;
+        break;
+    case 6: // P -> K
+        r = 85 + third;
+        g = 0;
+        b = 171 - third;
+        break;
+    default: // K -> R
+        r = 170 + third;
+        g = 0;
+        b = 85 - third;
+        break;
+    }
+
+    if (sat != 255)
+    {
+        if (sat == 0)
+        {
+            r = 255;
+            g = 255;
+            b = 255;
+        }
+        else
+        {
+            uint8_t desat = 255 - sat;
+            desat = hsvScale8Video(desat, desat);
+            uint8_t satscale = 255 - desat;
+            r = hsvScale8(r, satscale) + desat;
+            g = hsvScale8(g, satscale) + desat;
+            b = hsvScale8(b, satscale) + desat;
+        }
+    }
+
+    if (val != 255)
+    {
+        val = hsvScale8Video(val, val);
+        if (val == 0)
+        {
+            r = 0;
+            g = 0;
+            b = 0;
+        }
+        else
+        {
+            r = hsvScale8(r, val);
+            g = hsvScale8(g, val);
+            b = hsvScale8(b, val);
+        }
+    }
+
+    rgb[0] = r;
+    rgb[1] = g;
+    rgb[2] = b;
+}
+
+void hsvTablesInit(sHsvTables &tables)
+{
+    for (int i = 0; i < 256; i++)
+    {
+        hsvRainbowReference(i, 255, 255, tables.hue[i]);
+        uint8_t desat = hsvScale8Video(255 - i, 255 - i);
+        tables.satMul[i] = 256 - desat;
+        tables.satAdd[i] = desat;
+        tables.valMul[i] = hsvScale8Video(i, i) + 1;
+    }
+}
+
+void hsvToRgbBatch(const sHsvTables &tables, const uint8_t *hsv, uint8_t *rgb, size_t count)
+{
+    for (size_t i = 0; i < count; i++, hsv += 3, rgb += 3)
+    {
+        const uint8_t *base = tables.hue[hsv[0]];
+        uint16_t satMul = tables.satMul[hsv[1]];
+        uint8_t satAdd = tables.satAdd[hsv[1]];
+        uint16_t valMul = tables.valMul[hsv[2]];
+        rgb[0] = (uint8_t)((base[0] * satMul >> 8) + satAdd) * valMul >> 8;
+        rgb[1] = (uint8_t)((base[1] * satMul >> 8) + satAdd) * valMul >> 8;
+        rgb[2] = (uint8_t)((base[2] * satMul >> 8) + satAdd) * valMul >> 8;
+    }
+}
+
+// Every hue at one saturation and value.
+void hsvBuildHueLut(const sHsvTables &tables, sHsvHueLut &lut, uint8_t sat, uint8_t val)
+{
+    uint8_t hsv[256 * 3];
+    for (int i = 0; i < 256; i++)
+    {
+        hsv[i * 3] = i;
+        hsv[i * 3 + 1] = sat;
+        hsv[i * 3 + 2] = val;
+    }
+    hsvToRgbBatch(tables, hsv, lut.rgb[0], 256);
+}
+
+// One hue byte per pixel in, RGB out, at the lut's saturation and value.
+void hsvHueToRgbBatch(const sHsvHueLut &lut, const uint8_t *hues, uint8_t *rgb, size_t count)
+{
+    for (size_t i = 0; i < count; i++, rgb += 3)
+    {
+        const uint8_t *entry = lut.rgb[hues[i]];
+        rgb[0] = entry[0];
+        rgb[1] = entry[1];
+        rgb[2] = entry[2];
+    }
+}
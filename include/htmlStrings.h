@@ -33,35 +33,46 @@ const String metaRedirect ="<html><head><meta http-equiv=\"refresh\"content=\"10
     <meta name="viewport" content="width=device-width, initial-scale=1.0">
     <title>{TITLE}</title>
     <script type=text/javascript>
-        function makeHttpObject()  {
-            try { return new XMLHttpRequest(); }
-            catch (error) { }
-            try { return new ActiveXObject("Msxml2.XMLHTTP"); }
-            catch (error) { }
-            try { return new ActiveXObject("Microsoft.XMLHTTP"); }
-            catch (error) { } 
+        // Changes queue up while a request is out and all go in the next one.
+        var pending = {};
+        var inFlight = false;
+
+        function sendChanges(changes){
+            Object.assign(pending, changes);
+            if(inFlight)
+            {
+                return;
+            }
+            var body = JSON.stringify(pending);
+            pending = {};
+            inFlight = true;
+            fetch('/api/v1/state', {method: 'POST', headers: {'Content-Type': 'application/json'}, body: body})
+                .then(function(response){ return response.json(); })
+                .then(function(state){
+                    if(state.ok)
+                    {
+                        console.log(state);
+                    }
+                    else
+                    {
+                        console.log("Error: " + state.error + " at byte " + state.at);
+                    }
+                })
+                .catch(function(error){
+                    console.error(error);
+                })
+                .finally(function(){
+                    inFlight = false;
+                    if(Object.keys(pending).length > 0)
+                    {
+                        sendChanges({});
+                    }
+                });
         }
 
         function setAnimation(value){
-          if(!request)
-          { 
-               request = makeHttpObject();
-          }
-            request.open("GET", '?animation=' + value, false);
-            request.onload = function(e){
-                if(request.status === 200)
-                {
-                    console.log(request.responseText);
-                }
-                else
-                {
-                    console.log("Error: " + request.statusText);
-                }
-            }
-            request.onerror = function(e){
-                console.error(request.statusText);
-            }
-            request.send();
+            delete pending.swat; // the last one clicked wins
+            sendChanges({animation: parseInt(value)});
         }
 
         function updateSliders(value)
@@ -76,26 +87,9 @@ const String metaRedirect ="<html><head><meta http-equiv=\"refresh\"content=\"10
         }
 
         function setSwatch(value){
-           updateSliders(value);
-           if(!request)
-           { 
-               request = makeHttpObject();
-           }
-            request.open("GET", '?swat=' + value, false);
-            request.onload = function(e){
-                if(request.status === 200)
-                {
-                    console.log(request.responseText);
-                }
-                else
-                {
-                    console.log("Error: " + request.statusText);
-                }
-            }
-            request.onerror = function(e){
-                console.error(request.statusText);
-            }
-            request.send();
+            updateSliders(value);
+            delete pending.animation;
+            sendChanges({swat: value.split(",").map(Number)});
         }
 
         function setColor(sliderId){
@@ -103,49 +97,38 @@ const String metaRedirect ="<html><head><meta http-equiv=\"refresh\"content=\"10
             var s = document.getElementById("sat").value;
             var v = document.getElementById("bri").value;    
 
-           if(!request)
-           { 
-               request = makeHttpObject();
-           }
-            var querystring;
-           
             if(sliderId==="bri") 
             { 
                 document.getElementById("bri-text").innerHTML = "Bri: " + v;
-                request.open("GET", '?bri=' + v, false); // brightness is global 
+                sendChanges({bri: parseInt(v)}); // brightness is global 
             }
             else if(sliderId==="sat")
             {
                 document.getElementById("sat-text").innerHTML = "Sat: " + s;
-                request.open("GET", '?sat=' + s, false); // saturation is global
+                sendChanges({sat: parseInt(s)}); // saturation is global
             }
             else if(sliderId==="hue")
             {
                 document.getElementById("hue-text").innerHTML = "Hue: " + h;
-                request.open("GET", '?hue=' + h, false); // hue is global
+                sendChanges({hue: parseInt(h)}); // hue is global
             }
             else
             {
                 console.log("Error: sliderId not recognized");
             }
-            request.onload = function(e){
-                if(request.status === 200)
-                {
-                    console.log(request.responseText);
-                }
-                else
-                {
-                    console.log("Error: " + request.statusText);
-                }
-            }
-            request.onerror = function(e){
-                console.error(request.statusText);
-            }
-            request.send();
         }
 
-        // entry point
-        var request = makeHttpObject();
+        // entry point: start the sliders where the device is.
+        window.addEventListener("load", function(){
+            fetch('/api/v1/state')
+                .then(function(response){ return response.json(); })
+                .then(function(state){
+                    updateSliders(state.hue + "," + state.sat + "," + state.bri);
+                })
+                .catch(function(error){
+                    console.error(error);
+                });
+        });
     </script>
     <style>
         body {
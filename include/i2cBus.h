@@ -0,0 +1,172 @@
+/*+===================================================================
+  File:      i2cBus.h
+
+  Summary:   Owner of the shared I2C bus (OLED and sensors). Only
+             the "i2c" task touches Wire after boot; everyone else
+             hands it work and carries on:
+
+                i2cRead()          queue a register read, poll the
+                                   sI2cResult later.
+                i2cDisplayPush()   diff a framebuffer against what
+                                   the panel has and queue the
+                                   changed chunks.
+
+             Ordering and fairness are in i2cSchedule.h. Chunks are
+             sent in SSD1306 page addressing mode, which the panel is
+             switched to once here, so the display drivers only draw
+             into their buffers and never push them themselves.
+
+                GET /api/i2c    queue, chunk and wait counters
+
+  10/19/2026.
+===================================================================+*/
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <i2cSchedule.h>
+
+#define I2C_CLOCK_HZ 400000
+#define I2C_OLED_ADDR 0x3C
+#define I2C_OLED_WIDTH 128
+
+#if defined(heltec_wifi_kit_32)
+#define I2C_OLED_BYTES (128 * 64 / 8)
+#else
+#define I2C_OLED_BYTES (128 * 32 / 8)
+#endif
+
+static_assert(I2C_OLED_BYTES / I2C_CHUNK_BYTES <= I2C_MAX_CHUNKS, "framebuffer has more chunks than the dirty mask");
+
+// locals
+sI2cSchedule i2cSched;
+portMUX_TYPE i2cLock = portMUX_INITIALIZER_UNLOCKED;
+TaskHandle_t i2cTaskHandle = nullptr;
+uint8_t i2cShadow[I2C_OLED_BYTES]; // what the panel shows, or is about to.
+uint32_t i2cErrors = 0;
+
+bool i2cCommand(const uint8_t *commands, size_t length)
+{
+    Wire.beginTransmission(I2C_OLED_ADDR);
+    Wire.write(0x00); // command stream
+    Wire.write(commands, length);
+    return Wire.endTransmission() == 0;
+}
+
+void i2cSendChunk(uint8_t chunk, const uint8_t *data)
+{
+    uint8_t page = chunk * I2C_CHUNK_BYTES / I2C_OLED_WIDTH;
+    uint8_t column = chunk * I2C_CHUNK_BYTES % I2C_OLED_WIDTH;
+    const uint8_t address[] = {(uint8_t)(0xB0 | page), (uint8_t)(column & 0x0F), (uint8_t)(0x10 | (column >> 4))};
+    bool ok = i2cCommand(address, sizeof(address));
+    Wire.beginTransmission(I2C_OLED_ADDR);
+    Wire.write(0x40); // data stream
+    Wire.write(data, I2C_CHUNK_BYTES);
+    if (!ok || Wire.endTransmission() != 0)
+    {
+        i2cErrors++;
+    }
+}
+
+void i2cRunRequest(const sI2cRequest &request)
+{
+    Wire.beginTransmission(request.addr);
+    Wire.write(request.write, request.writeLen);
+    bool ok;
+    if (request.readLen == 0)
+    {
+        ok = Wire.endTransmission() == 0;
+    }
+    else
+    {
+        ok = Wire.endTransmission(false) == 0 && Wire.requestFrom(request.addr, request.readLen) == request.readLen;
+        for (uint8_t i = 0; ok && i < request.readLen; i++)
+        {
+            request.result->data[i] = Wire.read();
+        }
+    }
+    if (!ok)
+    {
+        i2cErrors++;
+    }
+    request.result->state = ok ? I2C_DONE : I2C_FAILED;
+}
+
+void i2cTask(void *arg)
+{
+    uint8_t chunk[I2C_CHUNK_BYTES];
+    for (;;)
+    {
+        sI2cOp op;
+        portENTER_CRITICAL(&i2cLock);
+        bool work = i2cScheduleNext(i2cSched, millis(), op);
+        if (work && op.kind == I2C_OP_DISPLAY)
+        {
+            memcpy(chunk, i2cShadow + op.chunk * I2C_CHUNK_BYTES, I2C_CHUNK_BYTES);
+        }
+        portEXIT_CRITICAL(&i2cLock);
+
+        if (!work)
+        {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        }
+        else if (op.kind == I2C_OP_SENSOR)
+        {
+            sHealthScope health(HEALTH_INPUT, "i2cRunRequest");
+            i2cRunRequest(op.request);
+        }
+        else
+        {
+            sHealthScope health(HEALTH_INPUT, "i2cSendChunk");
+            i2cSendChunk(op.chunk, chunk);
+        }
+    }
+}
+
+// Right after the display driver's begin(): it brings Wire up, from here on the bus is ours.
+void i2cBusBegin()
+{
+    i2cScheduleInit(i2cSched);
+    memset(i2cShadow, 0, sizeof(i2cShadow));
+    Wire.setClock(I2C_CLOCK_HZ);
+    const uint8_t pageMode[] = {0x20, 0x02};
+    i2cCommand(pageMode, sizeof(pageMode));
+    xTaskCreatePinnedToCore(i2cTask, "i2c", 3072, nullptr, 2, &i2cTaskHandle, 0);
+}
+
+// Queue a register read. Returns false if the queue is full, otherwise poll result.state.
+bool i2cRead(uint8_t addr, uint8_t reg, uint8_t length, sI2cResult &result)
+{
+    sI2cRequest request = {addr, 1, {reg}, length, &result, 0};
+    portENTER_CRITICAL(&i2cLock);
+    bool queued = length <= I2C_MAX_READ && i2cScheduleSubmit(i2cSched, request, millis());
+    portEXIT_CRITICAL(&i2cLock);
+    if (queued)
+    {
+        xTaskNotifyGive(i2cTaskHandle);
+    }
+    return queued;
+}
+
+// Queue whatever changed in framebuffer (SSD1306 page layout). Never waits for the bus.
+void i2cDisplayPush(const uint8_t *framebuffer)
+{
+    portENTER_CRITICAL(&i2cLock);
+    uint32_t changed = i2cDiffChunks(i2cShadow, framebuffer, I2C_OLED_BYTES);
+    i2cScheduleDisplay(i2cSched, changed, millis());
+    portEXIT_CRITICAL(&i2cLock);
+    if (changed)
+    {
+        xTaskNotifyGive(i2cTaskHandle);
+    }
+}
+
+void handleI2c(AsyncWebServerRequest *request)
+{
+    const sI2cStats &stats = i2cSched.stats;
+    AsyncResponseStream *response = request->beginResponseStream("application/json");
+    response->printf("{\"sensorOps\":%u,\"sensorRejected\":%u,\"chunksSent\":%u,\"chunksCoalesced\":%u,"
+                     "\"chunksAged\":%u,\"maxSensorWaitMs\":%u,\"maxDisplayWaitMs\":%u,\"errors\":%u}",
+                     stats.sensorOps, stats.sensorRejected, stats.chunksSent, stats.chunksCoalesced,
+                     stats.chunksAged, stats.maxSensorWaitMs, stats.maxDisplayWaitMs, i2cErrors);
+    request->send(response);
+}
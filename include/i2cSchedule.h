@@ -0,0 +1,196 @@
+/*+===================================================================
+  File:      i2cSchedule.h
+
+  Summary:   Scheduling for the shared I2C bus (i2cBus.h): what the
+             bus task sends next.
+
+             Two kinds of work:
+
+                sensor   small register reads/writes, queued FIFO
+                         by callers that collect the result later.
+                display  the OLED framebuffer, split into chunks of
+                         I2C_CHUNK_BYTES (half a page). A push only
+                         marks the chunks that changed since the last
+                         one, and a chunk marked twice before it goes
+                         out is sent once, with the newer pixels.
+
+             Sensor work goes first, so it waits for at most the one
+             chunk already on the wire. A display that has waited
+             I2C_DISPLAY_MAX_WAIT_MS gets one chunk ahead of the
+             sensors, so a flood of reads can't starve the screen.
+
+             Not thread safe on its own, i2cBus.h holds a lock around
+             it. No Arduino dependencies so tools/i2cbench.cpp can run
+             it against a mock bus.
+
+  10/19/2026.
+===================================================================+*/
+
+#include <stdint.h>
+#include <string.h>
+
+#define I2C_QUEUE_SIZE 8
+#define I2C_MAX_WRITE 4
+#define I2C_MAX_READ 8
+#define I2C_CHUNK_BYTES 64           // Wire's buffer is 128, keep a chunk well under it
+#define I2C_MAX_CHUNKS 16            // 128x64 OLED, 8 pages of 2 chunks
+#define I2C_DISPLAY_MAX_WAIT_MS 50   // display chunk goes ahead of sensors after this
+
+enum I2cState
+{
+    I2C_IDLE = 0,
+    I2C_QUEUED = 1,
+    I2C_DONE = 2,
+    I2C_FAILED = 3
+};
+
+enum I2cOpKind
+{
+    I2C_OP_NONE = 0,
+    I2C_OP_SENSOR = 1,
+    I2C_OP_DISPLAY = 2
+};
+
+// Owned by the caller, filled in by the bus task.
+struct sI2cResult
+{
+    volatile uint8_t state; // I2cState.
+    uint8_t data[I2C_MAX_READ];
+};
+
+struct sI2cRequest
+{
+    uint8_t addr;
+    uint8_t writeLen;
+    uint8_t write[I2C_MAX_WRITE];
+    uint8_t readLen;
+    sI2cResult *result;
+    uint32_t queuedAt;
+};
+
+struct sI2cStats
+{
+    uint32_t sensorOps;
+    uint32_t sensorRejected; // queue full.
+    uint32_t chunksSent;
+    uint32_t chunksCoalesced; // marked again before they went out.
+    uint32_t chunksAged;      // sent ahead of waiting sensor work.
+    uint32_t maxSensorWaitMs;
+    uint32_t maxDisplayWaitMs;
+};
+
+struct sI2cSchedule
+{
+    sI2cRequest queue[I2C_QUEUE_SIZE];
+    uint8_t head;
+    uint8_t count;
+    uint32_t dirtyChunks; // bit n = chunk n waiting to go out.
+    uint32_t displayWaitingSince;
+    uint8_t nextChunk;    // round robin start, keeps chunks in screen order.
+    sI2cStats stats;
+};
+
+struct sI2cOp
+{
+    uint8_t kind; // I2cOpKind.
+    sI2cRequest request;
+    uint8_t chunk;
+};
+
+void i2cScheduleInit(sI2cSchedule &sched)
+{
+    memset(&sched, 0, sizeof(sched));
+}
+
+// Queue a sensor transaction. Returns false if the queue is full.
+bool i2cScheduleSubmit(sI2cSchedule &sched, const sI2cRequest &request, uint32_t nowMs)
+{
+    if (sched.count >= I2C_QUEUE_SIZE)
+    {
+        sched.stats.sensorRejected++;
+        return false;
+    }
+    sI2cRequest &slot = sched.queue[(sched.head + sched.count) % I2C_QUEUE_SIZE];
+    slot = request;
+    slot.queuedAt = nowMs;
+    slot.result->state = I2C_QUEUED;
+    sched.count++;
+    return true;
+}
+
+// Mark display chunks for sending.
+void i2cScheduleDisplay(sI2cSchedule &sched, uint32_t chunks, uint32_t nowMs)
+{
+    if (sched.dirtyChunks == 0 && chunks != 0)
+    {
+        sched.displayWaitingSince = nowMs;
+    }
+    sched.stats.chunksCoalesced += __builtin_popcount(sched.dirtyChunks & chunks);
+    sched.dirtyChunks |= chunks;
+}
+
+uint8_t i2cTakeChunk(sI2cSchedule &sched, uint32_t nowMs)
+{
+    // Lowest dirty chunk at or after nextChunk, wrapping, so a frame goes out top to bottom.
+    uint32_t ahead = sched.dirtyChunks & ~((1u << sched.nextChunk) - 1);
+    uint8_t chunk = __builtin_ctz(ahead ? ahead : sched.dirtyChunks);
+    sched.dirtyChunks &= ~(1u << chunk);
+    sched.nextChunk = (chunk + 1) % I2C_MAX_CHUNKS;
+    uint32_t waited = nowMs - sched.displayWaitingSince;
+    if (waited > sched.stats.maxDisplayWaitMs)
+    {
+        sched.stats.maxDisplayWaitMs = waited;
+    }
+    sched.displayWaitingSince = nowMs; // the rest of the frame waits from here
+    sched.stats.chunksSent++;
+    return chunk;
+}
+
+// Pick what goes on the bus next. Returns false when there's nothing to do.
+bool i2cScheduleNext(sI2cSchedule &sched, uint32_t nowMs, sI2cOp &op)
+{
+    bool displayDue = sched.dirtyChunks != 0 && nowMs - sched.displayWaitingSince >= I2C_DISPLAY_MAX_WAIT_MS;
+    if (sched.count > 0 && !displayDue)
+    {
+        op.kind = I2C_OP_SENSOR;
+        op.request = sched.queue[sched.head];
+        sched.head = (sched.head + 1) % I2C_QUEUE_SIZE;
+        sched.count--;
+        sched.stats.sensorOps++;
+        uint32_t waited = nowMs - op.request.queuedAt;
+        if (waited > sched.stats.maxSensorWaitMs)
+        {
+            sched.stats.maxSensorWaitMs = waited;
+        }
+        return true;
+    }
+    if (sched.dirtyChunks != 0)
+    {
+        if (sched.count > 0)
+        {
+            sched.stats.chunksAged++;
+        }
+        op.kind = I2C_OP_DISPLAY;
+        op.chunk = i2cTakeChunk(sched, nowMs);
+        return true;
+    }
+    op.kind = I2C_OP_NONE;
+    return false;
+}
+
+// Copy a new framebuffer over the shadow copy, returns the mask of chunks that changed.
+uint32_t i2cDiffChunks(uint8_t *shadow, const uint8_t *framebuffer, size_t bytes)
+{
+    uint32_t changed = 0;
+    size_t chunks = bytes / I2C_CHUNK_BYTES;
+    for (size_t chunk = 0; chunk < chunks && chunk < I2C_MAX_CHUNKS; chunk++)
+    {
+        size_t offset = chunk * I2C_CHUNK_BYTES;
+        if (memcmp(shadow + offset, framebuffer + offset, I2C_CHUNK_BYTES) != 0)
+        {
+            memcpy(shadow + offset, framebuffer + offset, I2C_CHUNK_BYTES);
+            changed |= 1u << chunk;
+        }
+    }
+    return changed;
+}
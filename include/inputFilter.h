@@ -0,0 +1,184 @@
+/*+===================================================================
+  File:      inputFilter.h
+
+  Summary:   Knob and button conditioning for hardwareInput.h, and
+             the queue that carries the results to loop().
+
+                median     of the last 3 readings, the ESP32 ADC
+                           throws single sample spikes the EMA
+                           would smear into a level change.
+                EMA        Q8 fixed point, alpha = 1 / 2^INPUT_EMA_SHIFT
+                           on the 12 bit median.
+                hysteresis a new 0-255 level is only reported once the
+                           filtered value leaves the current level's
+                           band by INPUT_HYSTERESIS counts, so a knob
+                           sitting between two steps doesn't chatter.
+                debounce   a button level counts once it has held for
+                           INPUT_DEBOUNCE_MS, presses are reported on
+                           the stable edge.
+                queue      single producer / single consumer ring,
+                           no locks: the sampler only moves head, the
+                           loop only moves tail.
+
+             No Arduino dependencies so tools/inputbench.cpp can run
+             synthetic ADC traces through it on the host.
+
+  10/19/2026.
+===================================================================+*/
+
+#include <stdint.h>
+#include <atomic>
+
+#define INPUT_ADC_MAX 4095
+#define INPUT_EMA_SHIFT 3    // ~8 samples to settle 63%
+#define INPUT_HYSTERESIS 24  // ADC counts past a level's band, 1.5 levels
+#define INPUT_DEBOUNCE_MS 30
+#define INPUT_QUEUE_SIZE 16  // power of two
+
+enum InputEventType
+{
+    INPUT_BRIGHTNESS = 1, // value = 0-255 knob level
+    INPUT_COLOR_NEXT = 2  // value = press count since boot
+};
+
+struct sInputEvent
+{
+    uint8_t type; // InputEventType.
+    uint8_t value;
+};
+
+struct sKnobFilter
+{
+    uint16_t last[2]; // previous two readings for the median.
+    int32_t emaQ8;    // filtered ADC value << 8.
+    int16_t level;    // last reported 0-255 level, -1 = none yet.
+    bool primed;
+};
+
+struct sDebounce
+{
+    uint8_t stable; // debounced level.
+    uint8_t raw;    // last sampled level.
+    uint32_t changedAt;
+};
+
+struct sInputQueue
+{
+    sInputEvent events[INPUT_QUEUE_SIZE];
+    std::atomic<uint8_t> head; // written by the producer only.
+    std::atomic<uint8_t> tail; // written by the consumer only.
+    uint32_t dropped;          // producer side, queue was full.
+};
+
+static_assert((INPUT_QUEUE_SIZE & (INPUT_QUEUE_SIZE - 1)) == 0, "queue size must be a power of two");
+
+void knobInit(sKnobFilter &knob)
+{
+    knob.emaQ8 = 0;
+    knob.level = -1;
+    knob.primed = false;
+}
+
+// Feed one ADC sample. Returns the new 0-255 level, or -1 if it hasn't moved past the hysteresis band.
+int knobSample(sKnobFilter &knob, uint16_t adc)
+{
+    if (adc > INPUT_ADC_MAX)
+    {
+        adc = INPUT_ADC_MAX;
+    }
+    if (!knob.primed)
+    {
+        knob.last[0] = knob.last[1] = adc;
+        knob.emaQ8 = (int32_t)adc << 8; // start where the knob is instead of ramping up from 0
+        knob.primed = true;
+    }
+
+    uint16_t a = knob.last[0];
+    uint16_t b = knob.last[1];
+    uint16_t median = adc < a ? (a < b ? a : (adc < b ? b : adc)) : (adc < b ? adc : (a < b ? b : a));
+    knob.last[0] = knob.last[1];
+    knob.last[1] = adc;
+    knob.emaQ8 += (((int32_t)median << 8) - knob.emaQ8) >> INPUT_EMA_SHIFT;
+
+    int filtered = knob.emaQ8 >> 8;
+    int level = filtered >> 4;
+    if (knob.level >= 0 && level != 0 && level != 255) // the ends are always reachable
+    {
+        int low = knob.level * 16 - INPUT_HYSTERESIS;
+        int high = knob.level * 16 + 15 + INPUT_HYSTERESIS;
+        if (filtered >= low && filtered <= high)
+        {
+            return -1;
+        }
+    }
+    if (level == knob.level)
+    {
+        return -1;
+    }
+    knob.level = level;
+    return level;
+}
+
+void debounceInit(sDebounce &button, uint8_t level)
+{
+    button.stable = level;
+    button.raw = level;
+    button.changedAt = 0;
+}
+
+// Feed the current pin level. Returns true once per press (stable transition to 1).
+bool debounceSample(sDebounce &button, uint8_t level, uint32_t nowMs)
+{
+    if (level != button.raw)
+    {
+        button.raw = level;
+        button.changedAt = nowMs;
+        return false;
+    }
+    if (level == button.stable || nowMs - button.changedAt < INPUT_DEBOUNCE_MS)
+    {
+        return false;
+    }
+    button.stable = level;
+    return level == 1;
+}
+
+// True while a bounce is still settling, so the sampler knows to keep looking at the pin.
+bool debounceBusy(const sDebounce &button)
+{
+    return button.raw != button.stable;
+}
+
+void inputQueueInit(sInputQueue &queue)
+{
+    queue.head.store(0);
+    queue.tail.store(0);
+    queue.dropped = 0;
+}
+
+// Producer side. Returns false (and counts it) if the loop has fallen INPUT_QUEUE_SIZE events behind.
+bool inputQueuePush(sInputQueue &queue, const sInputEvent &event)
+{
+    uint8_t head = queue.head.load(std::memory_order_relaxed);
+    if ((uint8_t)(head - queue.tail.load(std::memory_order_acquire)) >= INPUT_QUEUE_SIZE)
+    {
+        queue.dropped++;
+        return false;
+    }
+    queue.events[head & (INPUT_QUEUE_SIZE - 1)] = event;
+    queue.head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+// Consumer side.
+bool inputQueuePop(sInputQueue &queue, sInputEvent &event)
+{
+    uint8_t tail = queue.tail.load(std::memory_order_relaxed);
+    if (tail == queue.head.load(std::memory_order_acquire))
+    {
+        return false;
+    }
+    event = queue.events[tail & (INPUT_QUEUE_SIZE - 1)];
+    queue.tail.store(tail + 1, std::memory_order_release);
+    return true;
+}
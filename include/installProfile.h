@@ -0,0 +1,96 @@
+/*+===================================================================
+  File:      installProfile.h
+
+  Summary:   One compile-time description per installation, picked
+             by the PROFILE_* flag of its platformio.ini environment
+             (pio run -e kitchen, -e studio_floor, ...). Replaces
+             hand-editing globalConfig.h before each archive build;
+             globalConfig.h takes its layout, power and naming from
+             g_profile.
+
+             Everything here is constexpr, so NUM_LEDS and the layout
+             are constants wherever they're used, and effects left
+             out of a profile's effects mask are never referenced by
+             animationStep() or the effect check, so the linker drops
+             them. fixedKernels picks the unrolled *Fixed fades in
+             pixelKernels.h over the general ones; set it only where
+             tools/profilereport.py shows them faster for that
+             strip, at 25 LEDs they were slower.
+
+             Feature switches that pull in libraries or tasks
+             (USE_DMX_INPUT, USE_AUDIO_INPUT, ...) stay preprocessor
+             flags, set per profile in platformio.ini.
+
+             Only bangworx_master carries the values the tree was
+             built with. The other entries are placeholders sized
+             for each install (strip length, matrix, ring, a sub with
+             firing channels) until they're measured on the fixture:
+             check the pin, PSU current and LED count before flashing.
+
+             No Arduino dependencies, tools/profilebench.cpp builds
+             against each profile on the host.
+
+  10/19/2026.
+===================================================================+*/
+
+#include <stdint.h>
+
+// Effect bits, one per LEDController.h effect.
+#define EFX_FIRE_LED (1u << 0)
+#define EFX_RANDOM_DOTS2 (1u << 1)
+#define EFX_RANDOM_DOTS (1u << 2)
+#define EFX_RANDOM_NOISE (1u << 3)
+#define EFX_RANDOM_BLUE_JUMPER (1u << 4)
+#define EFX_FLASH_COLOR (1u << 5)
+#define EFX_STAR_TWINKLE (1u << 6)
+#define EFX_BEAT_WAVER (1u << 7)
+#define EFX_DOT_SCROLL (1u << 8)
+#define EFX_LTR_DOT (1u << 9)
+#define EFX_FIRE2012 (1u << 10)
+#define EFX_NOISE_MOVER (1u << 11)
+#define EFX_ALL 0x0FFFu
+
+struct sInstallProfile
+{
+    const char *name;
+    const char *hostName;     // as seen on the network
+    const char *friendlyName; // home page
+    int numRows;              // 1 for a single strip
+    int numCols;
+    int numLeds;
+    int dataPin;
+    int maxCurrent;           // mA, must match the PSU
+    int volts;
+    bool accessPoint;         // runs its own SoftAP; a sub joins its master's
+    int channels;             // firing channels wired, 0 for none
+    uint32_t effects;         // EFX_* built in
+    bool fixedKernels;        // strip fades use pixelFadeFixed<NUM_LEDS>
+};
+
+#if defined(PROFILE_KITCHEN) // placeholder: under-cabinet strip, ambient effects only
+constexpr sInstallProfile g_profile = {"kitchen", "kitchen-cabs", "Kitchen Cabs", 1, 0, 150, 5, 6000, 5, true, 0,
+                                       EFX_RANDOM_NOISE | EFX_STAR_TWINKLE | EFX_BEAT_WAVER | EFX_FIRE2012 | EFX_NOISE_MOVER,
+                                       false};
+#elif defined(PROFILE_STUDIO_FLOOR) // placeholder: 8 x 32 floor matrix
+constexpr sInstallProfile g_profile = {"studio_floor", "studio-floor", "Studio Floor", 8, 32, 256, 13, 10000, 5, true, 0,
+                                       EFX_ALL & ~EFX_FIRE_LED, false};
+#elif defined(PROFILE_LEDMAN_CIRCLE) // placeholder: 60 pixel ring
+constexpr sInstallProfile g_profile = {"ledman_circle", "ledman-circle", "Ledman Circle", 1, 0, 60, 5, 3000, 5, true, 0,
+                                       EFX_FLASH_COLOR | EFX_STAR_TWINKLE | EFX_BEAT_WAVER | EFX_DOT_SCROLL | EFX_LTR_DOT,
+                                       false};
+#elif defined(PROFILE_BANGWORX_SUB) // placeholder: master's strip plus 8 firing channels
+constexpr sInstallProfile g_profile = {"bangworx_sub", "bangworx-sub", "BangWorx Sub", 1, 0, 25, 5, 2000, 5, false, 8,
+                                       EFX_FIRE_LED | EFX_FLASH_COLOR | EFX_FIRE2012, false};
+#else // PROFILE_BANGWORX_MASTER, and the plain board environments
+constexpr sInstallProfile g_profile = {"bangworx_master", "bangworx-server", "BangWorx Server", 1, 0, 25, 5, 2000, 5, true, 0,
+                                       EFX_ALL, false};
+#endif
+
+constexpr bool profileHasEffect(uint32_t effect)
+{
+    return (g_profile.effects & effect) != 0;
+}
+
+static_assert(g_profile.numLeds > 0, "profile needs LEDs");
+static_assert(g_profile.numRows <= 1 || g_profile.numRows * g_profile.numCols == g_profile.numLeds,
+              "a matrix profile's rows x cols must match its LED count");
@@ -0,0 +1,180 @@
+/*+===================================================================
+  File:      ledOutput.h
+
+  Summary:   The one place leds[] goes out to the strip. Code asks
+             for a frame with ledShow() and the data is only sent
+             at a frame boundary:
+
+                ledOutputService()  end of every loop()
+                effectDelay()       an effect waiting between frames
+                ledFlush()          anyone who needs it out now
+
+             ledShow() takes a copy of leds[], so an effect that
+             carries on drawing after asking (fade after show, clear
+             after show) still gets exactly the frame it asked for,
+             and the last copy before a boundary is what goes out:
+             everything asked for between two boundaries is one
+             show() (randomDots asks three times a tick). At a
+             boundary that copy is compared with the last frame sent;
+             if nothing changed, not even the brightness, the show is
+             skipped, except for one refresh every
+             LED_OUTPUT_REFRESH_MS in case a pixel latched noise. The
+             pixels that did change are kept as a first..last span
+             for the stats.
+
+             A brightness change, or ledOutputInvalidate() (the
+             thermal budget moved), sends the frame again even if
+             nobody asked.
+
+             Costs two extra frames of RAM (the copy and the frame
+             sent) and a memcpy per ledShow().
+
+                GET /api/output    requests, sends, savings per second
+
+  10/19/2026.
+===================================================================+*/
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include <ESPAsyncWebServer.h>
+
+#define LED_OUTPUT_REFRESH_MS 1000
+
+struct sLedOutputStats
+{
+    uint32_t requested;  // ledShow() calls.
+    uint32_t sent;       // FastLED.show() calls.
+    uint32_t coalesced;  // asked again before the frame went out.
+    uint32_t unchanged;  // frame identical to the last one sent.
+    uint32_t spanFirst;  // changed pixels in the last frame sent.
+    uint32_t spanLast;
+    uint32_t requestedPerSec;
+    uint32_t sentPerSec;
+};
+
+// externs
+extern CRGB leds[];
+
+// locals
+CRGB ledFrame[NUM_LEDS]; // last frame asked for.
+CRGB ledSent[NUM_LEDS];  // what the strip shows.
+uint8_t ledSentBrightness = 0;
+bool ledPending = false;
+bool ledForce = true; // nothing sent yet
+unsigned long ledSentAt = 0;
+sLedOutputStats ledStats;
+sLedOutputStats ledStatsAtSecond;
+unsigned long ledStatsSecondAt = 0;
+
+// Ask for leds[] to go out at the next frame boundary.
+void ledShow()
+{
+    ledStats.requested++;
+    if (ledPending)
+    {
+        ledStats.coalesced++;
+    }
+    memcpy(ledFrame, leds, sizeof(ledFrame));
+    ledPending = true;
+}
+
+// FastLED only sends leds[], so trade places with ledFrame around the show if they differ.
+void ledSwapFrame()
+{
+    uint8_t *a = (uint8_t *)leds;
+    uint8_t *b = (uint8_t *)ledFrame;
+    for (size_t i = 0; i < sizeof(ledFrame); i++)
+    {
+        uint8_t t = a[i];
+        a[i] = b[i];
+        b[i] = t;
+    }
+}
+
+// Send the frame even if it looks unchanged, e.g. after the power limit moved.
+void ledOutputInvalidate()
+{
+    ledForce = true;
+}
+
+// Frame boundary: send what was asked for, if it differs from what's out there.
+void ledFlush()
+{
+    uint8_t brightness = FastLED.getBrightness();
+    if (brightness != ledSentBrightness)
+    {
+        ledPending = true;
+        ledForce = true;
+    }
+    if (!ledPending)
+    {
+        return;
+    }
+    ledPending = false;
+
+    int first = 0;
+    int last = NUM_LEDS - 1;
+    while (first < NUM_LEDS && ledFrame[first] == ledSent[first])
+    {
+        first++;
+    }
+    if (first == NUM_LEDS)
+    {
+        if (!ledForce && millis() - ledSentAt < LED_OUTPUT_REFRESH_MS)
+        {
+            ledStats.unchanged++;
+            return;
+        }
+    }
+    else
+    {
+        while (ledFrame[last] == ledSent[last])
+        {
+            last--;
+        }
+        memcpy(&ledSent[first], &ledFrame[first], (last - first + 1) * sizeof(CRGB));
+        ledStats.spanFirst = first;
+        ledStats.spanLast = last;
+    }
+
+    bool drawnSince = memcmp(leds, ledFrame, sizeof(ledFrame)) != 0;
+    if (drawnSince)
+    {
+        ledSwapFrame();
+    }
+    FastLED.show();
+    if (drawnSince)
+    {
+        ledSwapFrame();
+    }
+    ledStats.sent++;
+    ledSentBrightness = brightness;
+    ledSentAt = millis();
+    ledForce = false;
+}
+
+// Called at the end of loop().
+void ledOutputService()
+{
+    ledFlush();
+
+    if (millis() - ledStatsSecondAt >= 1000)
+    {
+        ledStats.requestedPerSec = ledStats.requested - ledStatsAtSecond.requested;
+        ledStats.sentPerSec = ledStats.sent - ledStatsAtSecond.sent;
+        ledStatsAtSecond = ledStats;
+        ledStatsSecondAt = millis();
+    }
+}
+
+void handleOutput(AsyncWebServerRequest *request)
+{
+    AsyncResponseStream *response = request->beginResponseStream("application/json");
+    response->printf("{\"requested\":%u,\"sent\":%u,\"coalesced\":%u,\"unchanged\":%u,\"requestedPerSec\":%u,"
+                     "\"sentPerSec\":%u,\"savedPerSec\":%u,\"spanFirst\":%u,\"spanLast\":%u,\"numLeds\":%d}",
+                     ledStats.requested, ledStats.sent, ledStats.coalesced, ledStats.unchanged,
+                     ledStats.requestedPerSec, ledStats.sentPerSec,
+                     ledStats.requestedPerSec > ledStats.sentPerSec ? ledStats.requestedPerSec - ledStats.sentPerSec : 0,
+                     ledStats.spanFirst, ledStats.spanLast, NUM_LEDS);
+    request->send(response);
+}
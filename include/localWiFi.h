@@ -23,8 +23,17 @@ extern String globalIP;        // needed for about page
 extern String softap_ssid;
 extern String softap_password;
 
+// WiFi event task: keep the station count (master) or link state (sub) current so nobody polls it.
+void onStationEvent(arduino_event_id_t event)
+{
+    g_total_clients = WiFi.softAPgetStationNum();
+    g_statusVersion++;
+}
+
 void startSoftAP()
 {
+    WiFi.onEvent(onStationEvent, ARDUINO_EVENT_WIFI_AP_STACONNECTED);
+    WiFi.onEvent(onStationEvent, ARDUINO_EVENT_WIFI_AP_STADISCONNECTED);
     WiFi.softAP(softap_ssid.c_str(), softap_password.c_str());
     globalIP = WiFi.softAPIP().toString();
     Serial.println("SoftAP IP: " + globalIP);
@@ -47,6 +56,8 @@ void startWifi()
         // Connect to WiFi network
         Serial.print("SSID: ");
         Serial.println(ssid);
+        WiFi.onEvent(onStationEvent, ARDUINO_EVENT_WIFI_STA_GOT_IP);
+        WiFi.onEvent(onStationEvent, ARDUINO_EVENT_WIFI_STA_DISCONNECTED);
         WiFi.config(INADDR_NONE, INADDR_NONE, INADDR_NONE, INADDR_NONE);
         WiFi.setHostname(hostName.c_str());
         WiFi.begin(ssid.c_str(), password.c_str());
@@ -64,6 +75,7 @@ void startWifi()
             if (timeout == 0)
             {
                 Serial.println("");
+                logEvent(LOG_WIFI_TIMEOUT, millis());
                 Serial.println("WiFi connection timed out, restarting...");
                 Serial.println("");
                 ESP.restart();
@@ -111,11 +123,9 @@ void startWifi()
     // use mdns for host name resolution
     if (!MDNS.begin(hostName.c_str()))
     {
-        Serial.println("Error setting up MDNS responder!");
-        while (1)
-        {
-            delay(1000);
-        }
+        logEvent(LOG_MDNS_FAIL, (uint32_t)(g_isAccessPoint ? WiFi.softAPIP() : WiFi.localIP()));
+        Serial.println("Error setting up MDNS responder, reach us by IP: " + globalIP);
+        return; // used to park here forever, the strip and HTTP by IP still work without mDNS
     }
 
     Serial.println("mDNS responder started...");
@@ -136,5 +146,5 @@ bool isWiFiConnected()
 }
 
 int getConnectedClientCount(){
-    return WiFi.softAPgetStationNum();
+    return g_total_clients;
 }
\ No newline at end of file
@@ -0,0 +1,134 @@
+/*+===================================================================
+  File:      memStats.h
+
+  Summary:   Memory telemetry samples, the history ring they live
+             in and their JSON / compact encodings.
+
+             No Arduino dependencies (needs fixedString.h first) so
+             the same code runs on the device (memTelemetry.h) and
+             on the host under a tracking allocator
+             (tools/memsoak.cpp).
+
+             The failure we watch for is slow fragmentation: free
+             heap looks fine but the largest free block keeps
+             shrinking until a big allocation (a WebSocket frame,
+             a TLS buffer) fails. frag is 100 - largest * 100 / free.
+
+  10/19/2026.
+===================================================================+*/
+
+#include <stdint.h>
+#include <string.h>
+
+#define MEM_HISTORY 64      // samples kept
+#define MEM_TRACKED_TASKS 5 // stack high-water marks per sample
+
+struct sMemSample
+{
+    uint32_t uptimeS;
+    uint32_t freeHeap;
+    uint32_t largestBlock;                 // largest single allocation possible right now.
+    uint32_t minFreeHeap;                  // lowest free heap since boot.
+    uint16_t stackFree[MEM_TRACKED_TASKS]; // bytes never touched, 0xFFFF = task not running.
+    uint8_t wsClients;
+    uint8_t wsQueuesFull;                  // clients whose send queue is full right now.
+    uint16_t wsDropped;                    // broadcasts since boot that hit a full queue.
+};
+
+struct sMemRing
+{
+    sMemSample samples[MEM_HISTORY];
+    uint16_t head; // next slot to write.
+    uint16_t count;
+};
+
+void memRingInit(sMemRing &ring)
+{
+    memset(&ring, 0, sizeof(ring));
+}
+
+void memRingPush(sMemRing &ring, const sMemSample &sample)
+{
+    ring.samples[ring.head] = sample;
+    ring.head = (ring.head + 1) % MEM_HISTORY;
+    if (ring.count < MEM_HISTORY)
+    {
+        ring.count++;
+    }
+}
+
+// age 0 is the newest sample.
+const sMemSample &memRingAt(const sMemRing &ring, uint16_t age)
+{
+    return ring.samples[(ring.head + MEM_HISTORY - 1 - age) % MEM_HISTORY];
+}
+
+uint8_t memFragmentation(const sMemSample &sample)
+{
+    if (sample.freeHeap == 0 || sample.largestBlock >= sample.freeHeap)
+    {
+        return 0;
+    }
+    return 100 - (uint8_t)((uint64_t)sample.largestBlock * 100 / sample.freeHeap);
+}
+
+// Push format: mem:uptime,free,largest,minFree,frag,wsFull,wsDropped
+template <size_t N>
+void memFormatCompact(const sMemSample &sample, FixedString<N> &out)
+{
+    out.append("mem:").appendUInt(sample.uptimeS).append(',').appendUInt(sample.freeHeap);
+    out.append(',').appendUInt(sample.largestBlock).append(',').appendUInt(sample.minFreeHeap);
+    out.append(',').appendUInt(memFragmentation(sample)).append(',').appendUInt(sample.wsQueuesFull);
+    out.append(',').appendUInt(sample.wsDropped);
+}
+
+// Streams the newest sample in full plus the history, oldest first, to emit(const char *).
+template <typename Emit>
+void memWriteJson(const sMemRing &ring, const char *const taskNames[MEM_TRACKED_TASKS], Emit emit)
+{
+    if (ring.count == 0)
+    {
+        emit("{}");
+        return;
+    }
+
+    const sMemSample &now = memRingAt(ring, 0);
+    FixedString<192> part;
+    part.append("{\"uptime\":").appendUInt(now.uptimeS);
+    part.append(",\"free\":").appendUInt(now.freeHeap);
+    part.append(",\"largest\":").appendUInt(now.largestBlock);
+    part.append(",\"minFree\":").appendUInt(now.minFreeHeap);
+    part.append(",\"frag\":").appendUInt(memFragmentation(now));
+    part.append(",\"ws\":{\"clients\":").appendUInt(now.wsClients);
+    part.append(",\"full\":").appendUInt(now.wsQueuesFull);
+    part.append(",\"dropped\":").appendUInt(now.wsDropped).append("},\"stacks\":{");
+    emit(part.c_str());
+
+    for (int i = 0; i < MEM_TRACKED_TASKS; i++)
+    {
+        part.clear();
+        part.append(i > 0 ? ",\"" : "\"").append(taskNames[i]).append("\":");
+        if (now.stackFree[i] == 0xFFFF)
+        {
+            part.append("null");
+        }
+        else
+        {
+            part.appendUInt(now.stackFree[i]);
+        }
+        emit(part.c_str());
+    }
+
+    // History rows: [uptime,free,largest,minFree,wsFull]
+    emit("},\"history\":[");
+    for (int age = ring.count - 1; age >= 0; age--)
+    {
+        const sMemSample &s = memRingAt(ring, age);
+        part.clear();
+        part.append(age == ring.count - 1 ? "[" : ",[").appendUInt(s.uptimeS);
+        part.append(',').appendUInt(s.freeHeap).append(',').appendUInt(s.largestBlock);
+        part.append(',').appendUInt(s.minFreeHeap).append(',').appendUInt(s.wsQueuesFull).append(']');
+        emit(part.c_str());
+    }
+    emit("]}");
+}
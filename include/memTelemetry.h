@@ -0,0 +1,92 @@
+/*+===================================================================
+  File:      memTelemetry.h
+
+  Summary:   Samples heap, fragmentation, task stack high-water
+             marks and WebSocket queue pressure into a fixed ring
+             (memStats.h) every MEM_SAMPLE_MS.
+
+                GET /api/mem     current sample plus history as JSON
+                WebSocket push   "mem:..." on the telemetry topic
+
+             Sampling runs from loop() and allocates nothing, the
+             JSON is streamed straight into the response.
+
+  10/19/2026.
+===================================================================+*/
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include <esp_heap_caps.h>
+#include <memStats.h>
+
+#define MEM_SAMPLE_MS 10000 // 64 samples ~ the last 10 minutes
+
+// externs
+extern AsyncWebSocket ws;
+
+// locals
+sMemRing memRing;
+unsigned long memLastSampleAt = 0;
+
+// Tasks we watch, looked up by name at sample time since some come and go.
+const char *const memTaskNames[MEM_TRACKED_TASKS] = {"loopTask", "async_tcp", "audio", "clip", "ota"};
+
+void memSample(sMemSample &sample)
+{
+    sample.uptimeS = millis() / 1000;
+    sample.freeHeap = ESP.getFreeHeap();
+    sample.largestBlock = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+    sample.minFreeHeap = ESP.getMinFreeHeap();
+
+    for (int i = 0; i < MEM_TRACKED_TASKS; i++)
+    {
+        TaskHandle_t task = xTaskGetHandle(memTaskNames[i]);
+        sample.stackFree[i] = task ? min(uxTaskGetStackHighWaterMark(task), (UBaseType_t)0xFFFE) : 0xFFFF;
+    }
+
+    sample.wsClients = wsSessionCount;
+    sample.wsQueuesFull = 0;
+    for (int slot = 0; slot < WS_MAX_SESSIONS; slot++)
+    {
+        // By id: the AsyncTCP task frees a client the moment it disconnects, a gone id just reads as writable.
+        if (wsSessions[slot].open && !ws.availableForWrite(wsSessions[slot].id))
+        {
+            sample.wsQueuesFull++;
+        }
+    }
+    sample.wsDropped = g_wsDropped;
+}
+
+void memBegin()
+{
+    memRingInit(memRing);
+}
+
+// Called from loop().
+void memService()
+{
+    if (memRing.count > 0 && millis() - memLastSampleAt < MEM_SAMPLE_MS)
+    {
+        return;
+    }
+    memLastSampleAt = millis();
+
+    sMemSample sample;
+    memSample(sample);
+    memRingPush(memRing, sample);
+
+    if (wsTopicMask[TOPIC_TELEMETRY])
+    {
+        FixedString<96> push;
+        memFormatCompact(sample, push);
+        wsPublish(TOPIC_TELEMETRY, push.c_str());
+    }
+}
+
+void handleMem(AsyncWebServerRequest *request)
+{
+    AsyncResponseStream *response = request->beginResponseStream("application/json");
+    memWriteJson(memRing, memTaskNames, [response](const char *part)
+                 { response->print(part); });
+    request->send(response);
+}
@@ -0,0 +1,518 @@
+/*+===================================================================
+  File:      otaUpdate.h
+
+  Summary:   Streaming OTA that doesn't stop the show, plus
+             deferred restarts.
+
+             POST /api/ota?sha256=<hex> with the raw firmware .bin
+             as the body. The AsyncWebServer body callback only
+             copies into a small pool of preallocated chunks and
+             queues them; a writer task on core 0 feeds them to
+             esp_ota_write and the SHA-256 as they arrive. The
+             callback never waits: when the pool runs low it holds
+             back the TCP ack, which closes the sender's window, and
+             the connection's poll hands it back once the writer has
+             caught up. One upload at a time, tied to the request
+             that started it; other POSTs get 409.
+
+             The partition is erased a sector at a time as the
+             writes reach it (OTA_WITH_SEQUENTIAL_WRITES), not all at
+             once up front: an erase stops the flash cache on both
+             cores, and a whole partition's worth would freeze the
+             strip for seconds. A body bigger than the partition
+             is refused before anything is written.
+
+             The status message is written by the writer task and
+             read by the AsyncTCP task, so it's a fixed buffer
+             copied under otaMessageLock, never a String.
+
+             Restarts (after an update or from /restart) are never
+             done inline. scheduleRestart() sets a time and
+             restartService() in loop() only reboots at a safe
+             point: no show running, no clip capture, no fan-out.
+
+             Fan-out (?fanout=1 on the master) pushes the verified
+             image from the new partition to every station on the
+             SoftAP in parallel, one task per sub, using the same
+             endpoint, before the master itself restarts.
+
+  10/19/2026.
+===================================================================+*/
+
+#include <Arduino.h>
+#include <esp_ota_ops.h>
+#include <esp_wifi.h>
+#include <esp_netif.h>
+#include <mbedtls/sha256.h>
+#include <WiFi.h>
+#include <ESPAsyncWebServer.h>
+
+#define OTA_CHUNK_SIZE 4096
+#define OTA_CHUNK_COUNT 6            // 24K of buffering
+#define OTA_WINDOW_CHUNKS 2          // free chunks kept for data already in flight, one TCP window fits in two
+#define OTA_WRITER_POLL_MS 100       // how often an idle writer checks for an aborted upload
+#define OTA_RESTART_DELAY_MS 3000
+#define OTA_FANOUT_MAX 8
+#define OTA_FANOUT_PORT 80
+#define OTA_MESSAGE_MAX 48
+
+enum OtaState
+{
+    OTA_IDLE,
+    OTA_RECEIVING,
+    OTA_VERIFYING,
+    OTA_DONE,
+    OTA_FAILED
+};
+
+struct sOtaChunk
+{
+    uint8_t *data;
+    uint16_t len;
+    bool last;
+};
+
+// externs
+extern bool g_showRunning;
+extern bool g_clipCapturing;
+
+// globals
+volatile OtaState g_otaState = OTA_IDLE;
+volatile uint8_t g_otaFanOutActive = 0;
+
+// locals
+uint8_t *otaPool = nullptr;
+QueueHandle_t otaFreeChunks = nullptr;
+QueueHandle_t otaFullChunks = nullptr;
+sOtaChunk otaFilling;               // chunk the body callback is currently filling
+AsyncWebServerRequest *otaOwner = nullptr; // request whose body is being written, AsyncTCP task only
+bool otaAckDeferred = false;        // TCP acks held back for otaOwner
+uint8_t otaExpectedSha[32];
+bool otaFanOutRequested = false;
+volatile bool otaWriterRunning = false;
+const esp_partition_t *otaPartition = nullptr;
+uint32_t otaImageSize = 0;
+char otaShaHex[65];
+char otaMessage[OTA_MESSAGE_MAX] = "";
+portMUX_TYPE otaMessageLock = portMUX_INITIALIZER_UNLOCKED;
+
+portMUX_TYPE otaFanOutMux = portMUX_INITIALIZER_UNLOCKED;
+
+volatile bool restartPending = false;
+unsigned long restartAt = 0;
+
+/*--------------------------------------------------------------------
+   Deferred restart
+---------------------------------------------------------------------*/
+
+void scheduleRestart(uint32_t delayMs)
+{
+    restartAt = millis() + delayMs;
+    restartPending = true;
+    logEvent(LOG_RESTART_SCHEDULED, delayMs);
+}
+
+bool isSafeToRestart()
+{
+    return !g_showRunning && !g_clipCapturing && g_otaFanOutActive == 0 &&
+           g_otaState != OTA_RECEIVING && g_otaState != OTA_VERIFYING;
+}
+
+// Called from loop().
+void restartService()
+{
+    if (restartPending && (long)(millis() - restartAt) >= 0 && isSafeToRestart())
+    {
+        logEvent(LOG_RESTARTING);
+        Serial.println("Restarting...");
+        ESP.restart();
+    }
+}
+
+/*--------------------------------------------------------------------
+   Writer task
+---------------------------------------------------------------------*/
+
+bool parseShaHex(const String &hex, uint8_t *out)
+{
+    if (hex.length() != 64)
+    {
+        return false;
+    }
+    for (int i = 0; i < 32; i++)
+    {
+        char pair[3] = {hex.charAt(i * 2), hex.charAt(i * 2 + 1), 0};
+        char *end;
+        out[i] = (uint8_t)strtoul(pair, &end, 16);
+        if (*end != 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Any task.
+void otaSetMessage(const char *message)
+{
+    portENTER_CRITICAL(&otaMessageLock);
+    strncpy(otaMessage, message, OTA_MESSAGE_MAX - 1);
+    otaMessage[OTA_MESSAGE_MAX - 1] = 0;
+    portEXIT_CRITICAL(&otaMessageLock);
+}
+
+// Any task, a copy that can't change underneath the caller.
+FixedString<OTA_MESSAGE_MAX> otaGetMessage()
+{
+    FixedString<OTA_MESSAGE_MAX> message;
+    portENTER_CRITICAL(&otaMessageLock);
+    message.append(otaMessage);
+    portEXIT_CRITICAL(&otaMessageLock);
+    return message;
+}
+
+void otaFail(const char *why)
+{
+    otaSetMessage(why);
+    g_otaState = OTA_FAILED;
+    logEvent(LOG_OTA_FAIL, otaImageSize);
+    Serial.println(String("OTA: ") + why);
+}
+
+void otaFanOut();
+
+// Checks the written image and points the next boot at it.
+bool otaFinish(esp_ota_handle_t handle)
+{
+    sHealthScope health(HEALTH_OTA, "esp_ota_end");
+    return esp_ota_end(handle) == ESP_OK && esp_ota_set_boot_partition(otaPartition) == ESP_OK;
+}
+
+void otaWriterTask(void *param)
+{
+    esp_ota_handle_t handle;
+    mbedtls_sha256_context sha;
+    mbedtls_sha256_init(&sha);
+    mbedtls_sha256_starts_ret(&sha, 0);
+
+    otaPartition = esp_ota_get_next_update_partition(nullptr);
+    healthEnter(HEALTH_OTA, "esp_ota_begin");
+    bool begun = otaPartition != nullptr && esp_ota_begin(otaPartition, OTA_WITH_SEQUENTIAL_WRITES, &handle) == ESP_OK;
+    healthLeave(HEALTH_OTA);
+    bool ok = begun;
+    if (!ok)
+    {
+        otaFail("unable to start update");
+    }
+    otaImageSize = 0;
+
+    for (;;)
+    {
+        sOtaChunk chunk;
+        if (xQueueReceive(otaFullChunks, &chunk, pdMS_TO_TICKS(OTA_WRITER_POLL_MS)) != pdTRUE)
+        {
+            // Upload failed or dropped on the AsyncTCP side, no tail is coming.
+            if (g_otaState == OTA_FAILED)
+            {
+                ok = false;
+                break;
+            }
+            continue;
+        }
+        if (ok && chunk.len > 0)
+        {
+            sHealthScope health(HEALTH_OTA, "esp_ota_write");
+            mbedtls_sha256_update_ret(&sha, chunk.data, chunk.len);
+            ok = esp_ota_write(handle, chunk.data, chunk.len) == ESP_OK;
+            otaImageSize += chunk.len;
+            if (!ok)
+            {
+                otaFail("flash write failed");
+            }
+        }
+        if (chunk.data != nullptr)
+        {
+            xQueueSend(otaFreeChunks, &chunk.data, portMAX_DELAY);
+        }
+        if (chunk.last)
+        {
+            break;
+        }
+    }
+
+    if (ok && g_otaState == OTA_RECEIVING)
+    {
+        g_otaState = OTA_VERIFYING;
+        uint8_t digest[32];
+        mbedtls_sha256_finish_ret(&sha, digest);
+        for (int i = 0; i < 32; i++)
+        {
+            sprintf(otaShaHex + i * 2, "%02x", digest[i]);
+        }
+
+        if (memcmp(digest, otaExpectedSha, sizeof(digest)) != 0)
+        {
+            esp_ota_abort(handle);
+            otaFail("SHA-256 mismatch");
+        }
+        else if (!otaFinish(handle))
+        {
+            otaFail("image rejected");
+        }
+        else
+        {
+            FixedString<OTA_MESSAGE_MAX> message;
+            message.append("verified ").appendUInt(otaImageSize).append(" bytes");
+            otaSetMessage(message.c_str());
+            g_otaState = OTA_DONE;
+            logEvent(LOG_OTA_DONE, otaImageSize);
+            Serial.printf("OTA: %s\n", message.c_str());
+            if (otaFanOutRequested)
+            {
+                otaFanOut();
+            }
+            scheduleRestart(OTA_RESTART_DELAY_MS);
+        }
+    }
+    else if (begun)
+    {
+        esp_ota_abort(handle);
+    }
+
+    mbedtls_sha256_free(&sha);
+    otaWriterRunning = false;
+    vTaskDelete(nullptr);
+}
+
+/*--------------------------------------------------------------------
+   Body callback side (runs on the AsyncTCP task)
+---------------------------------------------------------------------*/
+
+// Hands the TCP window back once the writer has freed enough chunks, or
+// straight away if the upload failed and the rest is just being drained.
+void otaAckIfRoom(AsyncClient *client)
+{
+    if (otaAckDeferred && (g_otaState != OTA_RECEIVING || uxQueueMessagesWaiting(otaFreeChunks) >= OTA_WINDOW_CHUNKS))
+    {
+        client->ack(UINT32_MAX); // AsyncClient caps this at what it held back
+        otaAckDeferred = false;
+    }
+}
+
+// Connection poll (~2 Hz) while the owner uploads. It replaces the request's
+// own poll handler, which only matters while a large response is streaming.
+void otaPoll(void *arg, AsyncClient *client)
+{
+    if (arg == otaOwner)
+    {
+        otaAckIfRoom(client);
+    }
+}
+
+// The owner went away mid-body: fail so the writer gives up and a retry can start.
+void otaDropped(AsyncWebServerRequest *request)
+{
+    if (request != otaOwner)
+    {
+        return;
+    }
+    otaOwner = nullptr;
+    if (g_otaState == OTA_RECEIVING)
+    {
+        otaFail("upload dropped");
+    }
+}
+
+// total is the body's Content-Length.
+bool otaBegin(AsyncWebServerRequest *request, size_t total)
+{
+    if (otaWriterRunning || g_otaFanOutActive)
+    {
+        return false;
+    }
+    if (!request->hasParam("sha256") || !parseShaHex(request->getParam("sha256")->value(), otaExpectedSha))
+    {
+        otaFail("missing or bad sha256 parameter");
+        return false;
+    }
+    const esp_partition_t *partition = esp_ota_get_next_update_partition(nullptr);
+    if (partition == nullptr || total > partition->size)
+    {
+        otaFail("image too large");
+        return false;
+    }
+
+    if (otaPool == nullptr)
+    {
+        otaPool = (uint8_t *)malloc(OTA_CHUNK_SIZE * OTA_CHUNK_COUNT);
+        otaFreeChunks = xQueueCreate(OTA_CHUNK_COUNT, sizeof(uint8_t *));
+        otaFullChunks = xQueueCreate(OTA_CHUNK_COUNT + 1, sizeof(sOtaChunk)); // + the end marker
+        if (otaPool == nullptr || otaFreeChunks == nullptr || otaFullChunks == nullptr)
+        {
+            otaFail("out of memory");
+            return false;
+        }
+    }
+    xQueueReset(otaFreeChunks);
+    xQueueReset(otaFullChunks);
+    for (int i = 0; i < OTA_CHUNK_COUNT; i++)
+    {
+        uint8_t *data = otaPool + i * OTA_CHUNK_SIZE;
+        xQueueSend(otaFreeChunks, &data, 0);
+    }
+
+    otaFanOutRequested = request->hasParam("fanout") && g_isAccessPoint;
+    otaFilling.data = nullptr;
+    otaOwner = request;
+    otaAckDeferred = false;
+    request->onDisconnect([request]() { otaDropped(request); });
+    request->client()->onPoll(otaPoll, request);
+    otaSetMessage("receiving");
+    g_otaState = OTA_RECEIVING;
+    otaWriterRunning = true;
+    xTaskCreatePinnedToCore(otaWriterTask, "ota", 6144, nullptr, 1, nullptr, 0);
+    return true;
+}
+
+// The full queue has a slot for every chunk plus the end marker, so this never waits.
+void otaQueueFilling(bool last)
+{
+    otaFilling.last = last;
+    xQueueSend(otaFullChunks, &otaFilling, 0);
+    otaFilling.data = nullptr;
+}
+
+void handleOtaBody(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total)
+{
+    sHealthScope health(HEALTH_HTTP, "/api/ota body");
+    if (index == 0 && !otaBegin(request, total))
+    {
+        return;
+    }
+    if (request != otaOwner || g_otaState != OTA_RECEIVING)
+    {
+        return;
+    }
+
+    while (len > 0)
+    {
+        if (otaFilling.data == nullptr)
+        {
+            if (xQueueReceive(otaFreeChunks, &otaFilling.data, 0) != pdTRUE)
+            {
+                otaFilling.data = nullptr;
+                otaFail("writer stalled");
+                return;
+            }
+            otaFilling.len = 0;
+        }
+
+        size_t take = min(len, (size_t)(OTA_CHUNK_SIZE - otaFilling.len));
+        memcpy(otaFilling.data + otaFilling.len, data, take);
+        otaFilling.len += take;
+        data += take;
+        len -= take;
+
+        if (otaFilling.len == OTA_CHUNK_SIZE)
+        {
+            otaQueueFilling(false);
+        }
+    }
+
+    // Low on chunks: leave this data unacked so the sender stops once the
+    // window is used up, otaPoll gives it back when the writer catches up.
+    if (uxQueueMessagesWaiting(otaFreeChunks) < OTA_WINDOW_CHUNKS)
+    {
+        request->client()->ackLater();
+        otaAckDeferred = true;
+    }
+    else
+    {
+        otaAckIfRoom(request->client());
+    }
+}
+
+// Called when the request completes; flushes the tail and hands back status.
+void handleOtaRequest(AsyncWebServerRequest *request)
+{
+    if (request != otaOwner)
+    {
+        bool busy = otaWriterRunning;
+        request->send(busy ? 409 : 400, "text/plain",
+                      busy ? "OTA already in progress" : g_otaState == OTA_FAILED ? otaGetMessage().c_str() : "no firmware in body");
+        return;
+    }
+    otaOwner = nullptr;
+
+    if (g_otaState == OTA_RECEIVING)
+    {
+        if (otaFilling.data == nullptr)
+        {
+            otaFilling.len = 0; // writer just gets the end marker
+        }
+        otaQueueFilling(true);
+    }
+
+    bool accepted = g_otaState == OTA_RECEIVING || g_otaState == OTA_VERIFYING || g_otaState == OTA_DONE;
+    request->send(accepted ? 202 : 400, "text/plain", accepted ? "Accepted, see GET /api/ota" : otaGetMessage().c_str());
+}
+
+String getOtaStatusJson()
+{
+    const char *states[] = {"idle", "receiving", "verifying", "done", "failed"};
+    return String("{\"state\":\"") + states[g_otaState] + "\",\"message\":\"" + otaGetMessage().c_str() +
+           "\",\"bytes\":" + String(otaImageSize) + ",\"sha256\":\"" + otaShaHex +
+           "\",\"fanout\":" + String(g_otaFanOutActive) + ",\"restartPending\":" + String(restartPending ? "true" : "false") + "}";
+}
+
+/*--------------------------------------------------------------------
+   Fan-out to sub-controllers
+---------------------------------------------------------------------*/
+
+void otaPushTask(void *param)
+{
+    IPAddress ip((uint32_t)(uintptr_t)param);
+    WiFiClient client;
+    uint8_t buffer[1024];
+    bool ok = client.connect(ip, OTA_FANOUT_PORT);
+
+    if (ok)
+    {
+        client.printf("POST /api/ota?sha256=%s HTTP/1.1\r\nHost: %s\r\nContent-Type: application/octet-stream\r\n"
+                      "Content-Length: %u\r\nConnection: close\r\n\r\n",
+                      otaShaHex, ip.toString().c_str(), otaImageSize);
+        for (uint32_t offset = 0; ok && offset < otaImageSize; offset += sizeof(buffer))
+        {
+            size_t len = min((uint32_t)sizeof(buffer), otaImageSize - offset);
+            ok = esp_partition_read(otaPartition, offset, buffer, len) == ESP_OK && client.write(buffer, len) == len;
+        }
+        String status = client.readStringUntil('\n');
+        ok = ok && status.indexOf(" 202") > 0;
+        client.stop();
+    }
+
+    logEvent(LOG_OTA_PUSH, (uint32_t)ip, ok);
+    Serial.println("OTA fan-out to " + ip.toString() + (ok ? " done." : " FAILED."));
+    portENTER_CRITICAL(&otaFanOutMux);
+    g_otaFanOutActive--;
+    portEXIT_CRITICAL(&otaFanOutMux);
+    vTaskDelete(nullptr);
+}
+
+void otaFanOut()
+{
+    wifi_sta_list_t stations;
+    esp_netif_sta_list_t netifStations;
+    if (esp_wifi_ap_get_sta_list(&stations) != ESP_OK || esp_netif_get_sta_list(&stations, &netifStations) != ESP_OK)
+    {
+        return;
+    }
+
+    int count = min(netifStations.num, OTA_FANOUT_MAX);
+    g_otaFanOutActive = count;
+    for (int i = 0; i < count; i++)
+    {
+        xTaskCreatePinnedToCore(otaPushTask, "otapush", 4096, (void *)(uintptr_t)netifStations.sta[i].ip.addr, 1, nullptr, 0);
+    }
+    Serial.printf("OTA: pushing image to %d subs.\n", count);
+}
@@ -0,0 +1,238 @@
+/*+===================================================================
+  File:      pixelKernels.h
+
+  Summary:   Bulk operations on packed RGB pixel buffers (leds[]
+             cast to uint8_t *), so effects stop looping over CRGB
+             one pixel at a time.
+
+                pixelFill     every pixel one colour
+                pixelScale    nscale8(): c * (scale + 1) >> 8
+                pixelFade     fadeToBlackBy()
+                pixelAdd      saturating add, CRGB +=
+                pixelShift    move pixels along, black fills in
+                pixelRotate   move pixels along, wrapping
+
+             pixelScaleFixed<N>/pixelFadeFixed<N> are scale and fade
+             for a compile-time count on a 4-aligned buffer, unrolled
+             for small strips.
+
+             Results are bit for bit what FastLED gives, so swapping
+             an effect over doesn't change how it looks (the CRCs
+             from effectCheck.h stay the same).
+
+             Channels don't interact, so scale and add run over the
+             buffer as plain bytes, 4 to a 32-bit word (SWAR) on the
+             ESP32. Builds with GCC vector extensions on a 64-bit
+             host run 16 at a time instead. Fill, shift and rotate
+             are memcpy/memmove.
+
+             No Arduino dependencies so tools/pixelbench.cpp can
+             check and time them on the host.
+
+  10/19/2026.
+===================================================================+*/
+
+#include <stdint.h>
+#include <string.h>
+
+#define PIXEL_ROTATE_CHUNK 64 // pixels, rotate's stack buffer
+#define PIXEL_UNROLL_MAX 64   // pixels, fixed sizes above this use the general kernels
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__aarch64__)) && !defined(PIXEL_NO_VECTOR)
+#define PIXEL_VECTOR 1
+typedef uint8_t pixelVec8 __attribute__((vector_size(16)));
+typedef uint16_t pixelVec16 __attribute__((vector_size(16)));
+#else
+#define PIXEL_VECTOR 0
+#endif
+
+// Bytes before p is 4-aligned, capped at bytes.
+size_t pixelHeadBytes(const uint8_t *p, size_t bytes)
+{
+    size_t head = (4 - ((uintptr_t)p & 3)) & 3;
+    return head < bytes ? head : bytes;
+}
+
+// Word access at a 4-aligned byte pointer, memcpy keeps it clear of aliasing rules.
+uint32_t pixelLoadWord(const uint8_t *p)
+{
+    uint32_t w;
+    memcpy(&w, __builtin_assume_aligned(p, 4), 4);
+    return w;
+}
+
+void pixelStoreWord(uint8_t *p, uint32_t w)
+{
+    memcpy(__builtin_assume_aligned(p, 4), &w, 4);
+}
+
+uint32_t pixelScaleWord(uint32_t w, uint32_t scaleFixed)
+{
+    uint32_t even = ((w & 0x00FF00FF) * scaleFixed >> 8) & 0x00FF00FF;
+    uint32_t odd = ((w >> 8) & 0x00FF00FF) * scaleFixed & 0xFF00FF00;
+    return even | odd;
+}
+
+uint32_t pixelAddWord(uint32_t a, uint32_t b)
+{
+    uint32_t sum = ((a & 0x7F7F7F7F) + (b & 0x7F7F7F7F)) ^ ((a ^ b) & 0x80808080);
+    uint32_t carry = ((a & b) | ((a | b) & ~sum)) & 0x80808080;
+    return sum | (carry >> 7) * 0xFF;
+}
+
+void pixelScale(uint8_t *rgb, size_t count, uint8_t scale)
+{
+    size_t bytes = count * 3;
+    uint32_t scaleFixed = scale + 1; // FASTLED_SCALE8_FIXED
+    size_t i = pixelHeadBytes(rgb, bytes);
+    for (size_t j = 0; j < i; j++)
+    {
+        rgb[j] = rgb[j] * scaleFixed >> 8;
+    }
+#if PIXEL_VECTOR
+    for (; i + 16 <= bytes; i += 16)
+    {
+        pixelVec16 v;
+        memcpy(&v, rgb + i, 16);
+        v = ((v & 0x00FF) * (uint16_t)scaleFixed >> 8) | (((v >> 8) * (uint16_t)scaleFixed) & 0xFF00);
+        memcpy(rgb + i, &v, 16);
+    }
+#endif
+    for (; i + 4 <= bytes; i += 4)
+    {
+        pixelStoreWord(rgb + i, pixelScaleWord(pixelLoadWord(rgb + i), scaleFixed));
+    }
+    for (; i < bytes; i++)
+    {
+        rgb[i] = rgb[i] * scaleFixed >> 8;
+    }
+}
+
+void pixelFade(uint8_t *rgb, size_t count, uint8_t fadeBy)
+{
+    pixelScale(rgb, count, 255 - fadeBy);
+}
+
+// dst += src per channel, clamped at 255.
+void pixelAdd(uint8_t *dst, const uint8_t *src, size_t count)
+{
+    size_t bytes = count * 3;
+    size_t i = 0;
+    // Words only when both buffers line up, otherwise bytes throughout.
+    if (((uintptr_t)dst & 3) == ((uintptr_t)src & 3))
+    {
+        for (size_t head = pixelHeadBytes(dst, bytes); i < head; i++)
+        {
+            unsigned t = dst[i] + src[i];
+            dst[i] = t > 255 ? 255 : t;
+        }
+#if PIXEL_VECTOR
+        for (; i + 16 <= bytes; i += 16)
+        {
+            pixelVec8 a, b;
+            memcpy(&a, dst + i, 16);
+            memcpy(&b, src + i, 16);
+            pixelVec8 sum = a + b;
+            sum |= (pixelVec8)(sum < a);
+            memcpy(dst + i, &sum, 16);
+        }
+#endif
+        for (; i + 4 <= bytes; i += 4)
+        {
+            pixelStoreWord(dst + i, pixelAddWord(pixelLoadWord(dst + i), pixelLoadWord(src + i)));
+        }
+    }
+    for (; i < bytes; i++)
+    {
+        unsigned t = dst[i] + src[i];
+        dst[i] = t > 255 ? 255 : t;
+    }
+}
+
+void pixelFill(uint8_t *rgb, size_t count, uint8_t r, uint8_t g, uint8_t b)
+{
+    if (count == 0)
+    {
+        return;
+    }
+    rgb[0] = r;
+    rgb[1] = g;
+    rgb[2] = b;
+    // Double what's filled until done, always whole pixels.
+    size_t bytes = count * 3;
+    for (size_t filled = 3; filled < bytes;)
+    {
+        size_t copy = filled < bytes - filled ? filled : bytes - filled;
+        memcpy(rgb + filled, rgb, copy);
+        filled += copy;
+    }
+}
+
+// Move pixels by towards the end of the buffer (negative: towards the start), black fills in behind.
+void pixelShift(uint8_t *rgb, size_t count, int by)
+{
+    size_t n = by < 0 ? -by : by;
+    if (n >= count)
+    {
+        memset(rgb, 0, count * 3);
+        return;
+    }
+    if (by > 0)
+    {
+        memmove(rgb + n * 3, rgb, (count - n) * 3);
+        memset(rgb, 0, n * 3);
+    }
+    else if (by < 0)
+    {
+        memmove(rgb, rgb + n * 3, (count - n) * 3);
+        memset(rgb + (count - n) * 3, 0, n * 3);
+    }
+}
+
+// pixelShift(), but what falls off one end comes back at the other.
+void pixelRotate(uint8_t *rgb, size_t count, int by)
+{
+    if (count == 0)
+    {
+        return;
+    }
+    long n = by % (long)count;
+    n = n < 0 ? n + count : n; // now towards the end, 0..count-1
+    uint8_t carry[PIXEL_ROTATE_CHUNK * 3];
+    while (n > 0)
+    {
+        size_t step = n < PIXEL_ROTATE_CHUNK ? n : PIXEL_ROTATE_CHUNK;
+        memcpy(carry, rgb + (count - step) * 3, step * 3);
+        memmove(rgb + step * 3, rgb, (count - step) * 3);
+        memcpy(rgb, carry, step * 3);
+        n -= step;
+    }
+}
+
+// pixelScale() for a count fixed at compile time (NUM_LEDS, from the install profile) on a 4-aligned buffer, which
+// leds[] is: no head to line up, a known tail, and up to PIXEL_UNROLL_MAX pixels the word loop fully unrolled.
+template <size_t N> void pixelScaleFixed(uint8_t *rgb, uint8_t scale)
+{
+    if (N > PIXEL_UNROLL_MAX)
+    {
+        pixelScale(rgb, N, scale);
+        return;
+    }
+    const size_t bytes = N * 3;
+    uint32_t scaleFixed = scale + 1;
+    uint8_t *p = (uint8_t *)__builtin_assume_aligned(rgb, 4);
+#pragma GCC unroll 48
+    for (size_t i = 0; i < bytes / 4 * 4; i += 4)
+    {
+        pixelStoreWord(p + i, pixelScaleWord(pixelLoadWord(p + i), scaleFixed));
+    }
+    for (size_t i = bytes / 4 * 4; i < bytes; i++)
+    {
+        p[i] = p[i] * scaleFixed >> 8;
+    }
+}
+
+template <size_t N> void pixelFadeFixed(uint8_t *rgb, uint8_t fadeBy)
+{
+    pixelScaleFixed<N>(rgb, 255 - fadeBy);
+}
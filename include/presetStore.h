@@ -0,0 +1,259 @@
+/*+===================================================================
+  File:      presetStore.h
+
+  Summary:   Persists the current scene (mode, animation, HSV color,
+             brightness and palette) plus a table of favourite
+             presets to NVS so they survive reboots and OTA updates.
+
+             Records are 8 byte binary blobs. NVS already wear
+             levels its pages, so on top of that we only debounce:
+             changes mark the scene dirty and it is committed once
+             things have been quiet for PRESET_COMMIT_DELAY_MS,
+             and only if it differs from what is already stored.
+             Slider drags therefore cost one write, not hundreds.
+
+             The preset table lives in RAM once loaded, so recall
+             is an array index and applies within one frame:
+             sceneService() in loop() draws whatever scene is live
+             (solid colour, animation or off) unless a baked clip or
+             DMX owns the strip. Records read back from NVS or a show
+             are range checked before they are applied.
+
+  10/19/2026.
+===================================================================+*/
+
+#include <Arduino.h>
+#include <Preferences.h>
+
+#define PRESET_COUNT 16              // preset slots, matches the swatch grid.
+#define PRESET_COMMIT_DELAY_MS 3000  // quiet time before a dirty scene is written.
+#define PRESET_NAMESPACE "bworx"     // NVS namespace.
+#define PRESET_VERSION 1             // bump if sScene changes layout.
+
+// Compact binary scene record, stored as-is in NVS.
+struct sScene
+{
+    uint8_t mode;       // Mode enum.
+    int8_t animation;   // animation ID as used by the web UI, -1 = off.
+    uint8_t hue;
+    uint8_t sat;
+    uint8_t val;
+    uint8_t brightness; // global FastLED brightness.
+    uint8_t palette;    // palette ID, 0 = effect default.
+    uint8_t flags;      // bit 0 = slot in use.
+};
+
+#define SCENE_IN_USE 0x01
+
+// externs
+extern uint8_t g_briteValue;
+extern CHSV g_chsvColor;
+extern Mode g_mode;
+extern int8_t g_animation;
+extern uint8_t g_paletteId;
+
+// prototypes
+bool dmxActive();
+
+// externs
+extern bool g_clipPlaying;
+
+// globals
+sScene g_presets[PRESET_COUNT]; // indexed preset table, loaded once at boot.
+
+// locals
+Preferences presetPrefs;
+sScene committedScene;                // last scene written to NVS.
+volatile bool sceneDirty = false;
+volatile unsigned long sceneDirtyAt = 0;
+volatile bool presetsDirty = false;
+
+// Defaults seeded from old-data/swatches.txt on first boot.
+const uint8_t defaultSwatches[PRESET_COUNT][3] = {
+    {72, 61, 137}, {72, 61, 85}, {72, 61, 255}, {72, 115, 130},   // whites
+    {29, 179, 255}, {29, 170, 216}, {29, 170, 149}, {29, 244, 88}, // ambers
+    {164, 4, 255}, {164, 4, 176}, {164, 4, 100}, {164, 4, 98},     // daylight
+    {192, 255, 93}, {0, 255, 93}, {21, 255, 255}, {167, 255, 166}  // colors
+};
+
+// Snapshot the live globals into a scene record.
+sScene captureScene()
+{
+    sScene scene;
+    scene.mode = (uint8_t)g_mode;
+    scene.animation = g_animation;
+    scene.hue = g_chsvColor.hue;
+    scene.sat = g_chsvColor.sat;
+    scene.val = g_chsvColor.val;
+    scene.brightness = g_briteValue;
+    scene.palette = g_paletteId;
+    scene.flags = SCENE_IN_USE;
+    return scene;
+}
+
+// A record from NVS or a show image may be from another build or just garbage.
+bool sceneValid(const sScene &scene)
+{
+    return scene.mode <= (uint8_t)Off && animationKnown(scene.animation);
+}
+
+// Push a scene into the live globals, sceneService() draws it on the next pass. False if the record is bad.
+bool applyScene(const sScene &scene)
+{
+    if (!sceneValid(scene))
+    {
+        return false;
+    }
+    g_mode = (Mode)scene.mode;
+    g_animation = scene.animation;
+    g_chsvColor = CHSV(scene.hue, scene.sat, scene.val);
+    g_briteValue = scene.brightness;
+    g_paletteId = scene.palette;
+    FastLED.setBrightness(g_briteValue);
+    return true;
+}
+
+// Call whenever a scene parameter changes, the write is debounced.
+void presetTouch()
+{
+    sceneDirtyAt = millis();
+    sceneDirty = true;
+}
+
+bool presetSave(int slot)
+{
+    if (slot < 0 || slot >= PRESET_COUNT)
+    {
+        return false;
+    }
+    g_presets[slot] = captureScene();
+    presetsDirty = true;
+    return true;
+}
+
+bool presetRecall(int slot)
+{
+    if (slot < 0 || slot >= PRESET_COUNT || !(g_presets[slot].flags & SCENE_IN_USE) || !applyScene(g_presets[slot]))
+    {
+        return false;
+    }
+    presetTouch();
+    return true;
+}
+
+// Bit per slot presetRecall() would accept.
+uint32_t presetUsable()
+{
+    uint32_t usable = 0;
+    for (int i = 0; i < PRESET_COUNT; i++)
+    {
+        if ((g_presets[i].flags & SCENE_IN_USE) && sceneValid(g_presets[i]))
+        {
+            usable |= 1u << i;
+        }
+    }
+    return usable;
+}
+
+void seedPresets()
+{
+    for (int i = 0; i < PRESET_COUNT; i++)
+    {
+        g_presets[i].mode = (uint8_t)SolidColor;
+        g_presets[i].animation = -1;
+        g_presets[i].hue = defaultSwatches[i][0];
+        g_presets[i].sat = defaultSwatches[i][1];
+        g_presets[i].val = defaultSwatches[i][2];
+        g_presets[i].brightness = 255;
+        g_presets[i].palette = 0;
+        g_presets[i].flags = SCENE_IN_USE;
+    }
+}
+
+// Load presets and the last scene, then apply it. Call after FastLED is set up.
+void presetBegin()
+{
+    presetPrefs.begin(PRESET_NAMESPACE, false);
+
+    if (presetPrefs.getUChar("ver", 0) != PRESET_VERSION ||
+        presetPrefs.getBytes("presets", g_presets, sizeof(g_presets)) != sizeof(g_presets))
+    {
+        Serial.println("Presets: none stored, seeding from swatches.");
+        seedPresets();
+        presetPrefs.putBytes("presets", g_presets, sizeof(g_presets));
+        presetPrefs.putUChar("ver", PRESET_VERSION);
+    }
+
+    // Out of range slots are dropped rather than recalled later.
+    for (int i = 0; i < PRESET_COUNT; i++)
+    {
+        if ((g_presets[i].flags & SCENE_IN_USE) && !sceneValid(g_presets[i]))
+        {
+            Serial.printf("Presets: slot %d is invalid, cleared.\n", i);
+            g_presets[i].flags = 0;
+        }
+    }
+
+    if (presetPrefs.getBytes("scene", &committedScene, sizeof(committedScene)) == sizeof(committedScene) &&
+        (committedScene.flags & SCENE_IN_USE) && applyScene(committedScene))
+    {
+        Serial.println("Presets: restored last scene.");
+    }
+    else
+    {
+        committedScene = captureScene();
+    }
+}
+
+// Called from loop(), commits pending changes once they have settled.
+void presetService()
+{
+    if (presetsDirty)
+    {
+        presetsDirty = false;
+        presetPrefs.putBytes("presets", g_presets, sizeof(g_presets));
+    }
+
+    if (!sceneDirty || millis() - sceneDirtyAt < PRESET_COMMIT_DELAY_MS)
+    {
+        return;
+    }
+
+    sceneDirty = false;
+    sScene scene = captureScene();
+    if (memcmp(&scene, &committedScene, sizeof(sScene)) != 0)
+    {
+        presetPrefs.putBytes("scene", &scene, sizeof(scene));
+        committedScene = scene;
+    }
+}
+
+// Called from loop(), draws the live scene. Solid colours and off are drawn
+// once per change, animations every pass. A running show's scene cues land
+// here too; clip playback and DMX write whole frames, so they own the strip.
+void sceneService()
+{
+    static sScene drawn; // flags == 0: redraw on the next pass
+    if (g_clipPlaying || dmxActive())
+    {
+        drawn.flags = 0;
+        return;
+    }
+
+    if (g_mode == Animation)
+    {
+        animationStep(g_animation);
+        drawn.flags = 0;
+        return;
+    }
+
+    sScene scene = captureScene();
+    if (drawn.flags != 0 && memcmp(&scene, &drawn, sizeof(sScene)) == 0)
+    {
+        return;
+    }
+    drawn = scene;
+    CRGB color = g_mode == Off ? CRGB(CRGB::Black) : CRGB(g_chsvColor);
+    pixelFill((uint8_t *)leds, NUM_LEDS, color.r, color.g, color.b);
+    ledShow();
+}
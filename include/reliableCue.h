@@ -0,0 +1,384 @@
+/*+===================================================================
+  File:      reliableCue.h
+
+  Summary:   Acknowledged cue delivery: sequence numbers, per-sub
+             acks, a bounded retransmit window on the sender and
+             duplicate suppression on the receiver, so each cue
+             runs exactly once on every sub that's listening.
+
+             Wire format (text):
+
+                cue:<hex epoch>:<seq>:<payload>   master -> sub
+                ack:<seq>[:<hex seen>]            sub -> master
+
+             The optional seen mask is the receiver's dedup bitmap
+             (bit n = seq - n received), so every ack repeats the
+             earlier ones and a lost ack rarely costs a resend.
+
+             Sender: every cue gets the next 16 bit seq and is kept
+             in a CUE_WINDOW ring until every attached sub has acked
+             it. Unacked cues are resent after 2 x the sub's smoothed
+             round trip (at least CUE_RETRY_MS), doubling up to
+             CUE_RETRY_MAX_MS, and given up on (expired) after
+             CUE_GIVE_UP_MS or when the ring wraps onto them.
+
+             Receiver: remembers the highest seq seen plus a bitmap
+             of the CUE_WINDOW below it. Always ack, only run a cue
+             the first time. The sender never has more than
+             CUE_WINDOW cues in flight, so a resend can't fall
+             outside the bitmap.
+
+             The epoch is random per sender boot. Seqs start over at
+             0 when the master restarts (after every OTA, say), so a
+             new epoch makes the receiver forget what it has seen
+             (cueEpoch) instead of taking the new cues for repeats.
+
+             No Arduino dependencies (needs fixedString.h first):
+             tools/cuesim.cpp runs this over a lossy link on the host.
+
+  10/19/2026.
+===================================================================+*/
+
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+
+#define CUE_WINDOW 64       // cues in flight, also the receiver's dedup window
+#define CUE_MAX_SUBS 8
+#define CUE_PAYLOAD 40
+#define CUE_RETRY_MS 20     // floor for the retry timeout
+#define CUE_RETRY_MAX_MS 100
+#define CUE_GIVE_UP_MS 3000
+
+typedef void (*CueSendFn)(uint8_t sub, const char *msg, void *ctx);
+
+struct sCueStats
+{
+    uint32_t sent;        // first transmissions.
+    uint32_t retransmits;
+    uint32_t acked;
+    uint32_t expired;     // given up on, the sub may have missed these.
+    uint32_t latencyAvgMs; // first send to ack, EMA 1/8.
+    uint32_t latencyMaxMs;
+};
+
+struct sCueSub
+{
+    uint64_t pending;                 // bit i = window slot i not acked yet.
+    uint64_t resent;                  // bit i = slot i was retransmitted (no RTT sample).
+    uint32_t firstSentMs[CUE_WINDOW];
+    uint32_t nextRetryMs[CUE_WINDOW];
+    uint16_t retryMs[CUE_WINDOW];     // current backoff.
+    uint16_t rttMs;                   // smoothed round trip, 0 = no sample yet.
+    sCueStats stats;
+};
+
+struct sCueSender
+{
+    uint32_t epoch;
+    uint16_t nextSeq;
+    uint16_t seqs[CUE_WINDOW];
+    char payloads[CUE_WINDOW][CUE_PAYLOAD];
+    uint8_t attached; // bit per sub.
+    sCueSub subs[CUE_MAX_SUBS];
+    CueSendFn send;
+    void *ctx;
+};
+
+struct sCueReceiver
+{
+    uint32_t epoch;   // sender boot the window below belongs to.
+    uint32_t restarts; // epoch changes seen.
+    bool started;
+    uint16_t highest; // newest seq seen.
+    uint64_t seen;    // bit n = highest - n seen.
+    uint32_t executed;
+    uint32_t duplicates;
+};
+
+/*--------------------------------------------------------------------
+   Wire format
+---------------------------------------------------------------------*/
+
+template <size_t N>
+void cueFormat(uint32_t epoch, uint16_t seq, const char *payload, FixedString<N> &out)
+{
+    out.append("cue:").appendHex(epoch).append(':').appendUInt(seq).append(':').append(payload);
+}
+
+// Parses "cue:<seq>:<payload>" or "ack:<seq>". payload may be null for acks.
+bool cueParse(const char *text, const char *prefix, uint16_t &seq, const char **payload)
+{
+    size_t len = strlen(prefix);
+    if (strncmp(text, prefix, len) != 0)
+    {
+        return false;
+    }
+    char *end;
+    unsigned long value = strtoul(text + len, &end, 10);
+    if (end == text + len || value > 0xFFFF)
+    {
+        return false;
+    }
+    seq = (uint16_t)value;
+    if (payload == nullptr)
+    {
+        return *end == 0;
+    }
+    if (*end != ':')
+    {
+        return false;
+    }
+    *payload = end + 1;
+    return true;
+}
+
+// Parses "cue:<hex epoch>:<seq>:<payload>".
+bool cueParseCue(const char *text, uint32_t &epoch, uint16_t &seq, const char **payload)
+{
+    if (strncmp(text, "cue:", 4) != 0)
+    {
+        return false;
+    }
+    char *end;
+    epoch = strtoul(text + 4, &end, 16);
+    return end != text + 4 && *end == ':' && cueParse(end + 1, "", seq, payload);
+}
+
+/*--------------------------------------------------------------------
+   Sender
+---------------------------------------------------------------------*/
+
+// epoch: random, different every boot.
+void cueSenderInit(sCueSender &s, CueSendFn send, void *ctx, uint32_t epoch)
+{
+    memset(&s, 0, sizeof(s));
+    s.send = send;
+    s.ctx = ctx;
+    s.epoch = epoch;
+}
+
+void cueSubAttach(sCueSender &s, uint8_t sub)
+{
+    memset(&s.subs[sub], 0, sizeof(sCueSub));
+    s.attached |= (1 << sub);
+}
+
+void cueSubDetach(sCueSender &s, uint8_t sub)
+{
+    s.attached &= ~(1 << sub);
+    s.subs[sub].pending = 0;
+}
+
+bool cuePending(const sCueSender &s)
+{
+    for (uint8_t sub = 0; sub < CUE_MAX_SUBS; sub++)
+    {
+        if (s.subs[sub].pending)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void cueTransmit(sCueSender &s, uint8_t sub, uint8_t slot)
+{
+    FixedString<CUE_PAYLOAD + 22> msg;
+    cueFormat(s.epoch, s.seqs[slot], s.payloads[slot], msg);
+    s.send(sub, msg.c_str(), s.ctx);
+}
+
+uint16_t cueRetryTimeout(const sCueSub &state)
+{
+    uint32_t timeout = state.rttMs * 2;
+    return timeout < CUE_RETRY_MS ? CUE_RETRY_MS : (timeout > CUE_RETRY_MAX_MS ? CUE_RETRY_MAX_MS : timeout);
+}
+
+// Queue a cue for every attached sub and send it. Returns its seq.
+uint16_t cueSend(sCueSender &s, const char *payload, uint32_t nowMs)
+{
+    uint16_t seq = s.nextSeq++;
+    uint8_t slot = seq % CUE_WINDOW;
+    s.seqs[slot] = seq;
+    strncpy(s.payloads[slot], payload, CUE_PAYLOAD - 1);
+    s.payloads[slot][CUE_PAYLOAD - 1] = 0;
+
+    for (uint8_t sub = 0; sub < CUE_MAX_SUBS; sub++)
+    {
+        if (!(s.attached & (1 << sub)))
+        {
+            continue;
+        }
+        sCueSub &state = s.subs[sub];
+        if (state.pending & (1ULL << slot))
+        {
+            state.stats.expired++; // window wrapped onto a cue this sub never acked.
+        }
+        state.pending |= (1ULL << slot);
+        state.resent &= ~(1ULL << slot);
+        state.firstSentMs[slot] = nowMs;
+        state.retryMs[slot] = cueRetryTimeout(state);
+        state.nextRetryMs[slot] = nowMs + state.retryMs[slot];
+        state.stats.sent++;
+        cueTransmit(s, sub, slot);
+    }
+    return seq;
+}
+
+void cueAckOne(sCueSub &state, const sCueSender &s, uint16_t seq, uint32_t nowMs)
+{
+    uint8_t slot = seq % CUE_WINDOW;
+    if (!(state.pending & (1ULL << slot)) || s.seqs[slot] != seq)
+    {
+        return; // duplicate or stale ack.
+    }
+    state.pending &= ~(1ULL << slot);
+
+    uint32_t latency = nowMs - state.firstSentMs[slot];
+    if (!(state.resent & (1ULL << slot)))
+    {
+        // Only clean round trips feed the estimate, a resent cue's ack could be for either copy.
+        state.rttMs = state.rttMs == 0 ? latency : (state.rttMs * 7 + latency) / 8;
+    }
+    state.stats.acked++;
+    state.stats.latencyAvgMs = state.stats.acked == 1 ? latency : (state.stats.latencyAvgMs * 7 + latency) / 8;
+    if (latency > state.stats.latencyMaxMs)
+    {
+        state.stats.latencyMaxMs = latency;
+    }
+}
+
+// seen bit n acknowledges seq - n, so one ack also covers any earlier acks that were lost.
+void cueOnAck(sCueSender &s, uint8_t sub, uint16_t seq, uint64_t seen, uint32_t nowMs)
+{
+    sCueSub &state = s.subs[sub];
+    while (seen)
+    {
+        uint8_t n = __builtin_ctzll(seen);
+        seen &= seen - 1;
+        cueAckOne(state, s, (uint16_t)(seq - n), nowMs);
+    }
+}
+
+// "ack:<seq>" or "ack:<seq>:<hex seen>" from a sub.
+bool cueOnAckText(sCueSender &s, uint8_t sub, const char *text, uint32_t nowMs)
+{
+    uint16_t seq;
+    const char *mask;
+    if (cueParse(text, "ack:", seq, &mask))
+    {
+        cueOnAck(s, sub, seq, strtoull(mask, nullptr, 16) | 1, nowMs);
+        return true;
+    }
+    if (cueParse(text, "ack:", seq, nullptr))
+    {
+        cueOnAck(s, sub, seq, 1, nowMs);
+        return true;
+    }
+    return false;
+}
+
+// Resend whatever is due, expire what has waited too long.
+void cueSenderService(sCueSender &s, uint32_t nowMs)
+{
+    for (uint8_t sub = 0; sub < CUE_MAX_SUBS; sub++)
+    {
+        sCueSub &state = s.subs[sub];
+        uint64_t pending = state.pending;
+        while (pending)
+        {
+            uint8_t slot = __builtin_ctzll(pending);
+            pending &= pending - 1;
+            if ((int32_t)(nowMs - state.nextRetryMs[slot]) < 0)
+            {
+                continue;
+            }
+            if (nowMs - state.firstSentMs[slot] >= CUE_GIVE_UP_MS)
+            {
+                state.pending &= ~(1ULL << slot);
+                state.stats.expired++;
+                continue;
+            }
+            state.retryMs[slot] = state.retryMs[slot] * 2 > CUE_RETRY_MAX_MS ? CUE_RETRY_MAX_MS : state.retryMs[slot] * 2;
+            state.nextRetryMs[slot] = nowMs + state.retryMs[slot];
+            state.resent |= (1ULL << slot);
+            state.stats.retransmits++;
+            cueTransmit(s, sub, slot);
+        }
+    }
+}
+
+/*--------------------------------------------------------------------
+   Receiver
+---------------------------------------------------------------------*/
+
+void cueReceiverInit(sCueReceiver &r)
+{
+    memset(&r, 0, sizeof(r));
+}
+
+// The sender's epoch, before cueReceive(). A new one starts the window over. True if it changed.
+bool cueEpoch(sCueReceiver &r, uint32_t epoch)
+{
+    if (epoch == r.epoch)
+    {
+        return false;
+    }
+    if (r.started)
+    {
+        r.restarts++;
+    }
+    r.epoch = epoch;
+    r.started = false;
+    r.seen = 0;
+    return true;
+}
+
+// Record seq as received. Returns true only the first time, i.e. when the cue should run.
+bool cueReceive(sCueReceiver &r, uint16_t seq)
+{
+    if (!r.started)
+    {
+        r.started = true;
+        r.highest = seq;
+        r.seen = 1;
+        r.executed++;
+        return true;
+    }
+
+    int16_t ahead = (int16_t)(seq - r.highest);
+    if (ahead > 0)
+    {
+        r.seen = ahead >= 64 ? 0 : r.seen << ahead;
+        r.seen |= 1;
+        r.highest = seq;
+        r.executed++;
+        return true;
+    }
+
+    uint16_t behind = (uint16_t)-ahead;
+    if (behind >= CUE_WINDOW || (r.seen & (1ULL << behind)))
+    {
+        r.duplicates++;
+        return false;
+    }
+    r.seen |= (1ULL << behind);
+    r.executed++;
+    return true;
+}
+
+// Selective ack for the receiver's current window: ack:<highest>:<hex seen>.
+template <size_t N>
+void cueFormatAck(const sCueReceiver &r, FixedString<N> &out)
+{
+    out.append("ack:").appendUInt(r.highest).append(':');
+    if (r.seen >> 32)
+    {
+        out.appendHex((uint32_t)(r.seen >> 32)).appendHex((uint32_t)r.seen, 8);
+    }
+    else
+    {
+        out.appendHex((uint32_t)r.seen);
+    }
+}
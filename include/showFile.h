@@ -0,0 +1,187 @@
+/*+===================================================================
+  File:      showFile.h
+
+  Summary:   Precompiled show timeline, read in place from the
+             "show" flash partition (see partitions.csv).
+
+             Layout (little endian, built by tools/showc.py) and
+             the header checks and seek are in showImage.h, which
+             tools/showbench.cpp runs on the host.
+
+             The partition is memory mapped with esp_partition_mmap
+             so nothing is parsed or copied into RAM. Seek/resume is
+             a binary search over the cue table, playback just walks
+             a cursor forward each loop.
+
+             Flash a compiled show with:
+                python tools/showc.py show.csv -o show.bin
+                parttool.py write_partition --partition-name=show --input=show.bin
+
+  10/19/2026.
+===================================================================+*/
+
+#include <Arduino.h>
+#include <esp_partition.h>
+#include <esp_rom_crc.h>
+#include <showImage.h>
+
+#define SHOW_PARTITION_NAME "show"
+#define SHOW_PARTITION_SUBTYPE 0x40
+
+static_assert(sizeof(sScene) == SHOW_SCENE_SIZE, "show scene layout");
+
+// prototypes
+void cueFire(const char *payload);
+void udpBroadcastCue(uint8_t type, uint8_t channel, uint16_t param, bool live);
+
+// globals
+bool g_showLoaded = false;
+bool g_showRunning = false;
+
+// locals
+const sShowHeader *showHeader = nullptr;
+const sShowCue *showCues = nullptr;
+const sScene *showScenes = nullptr;
+uint32_t showSceneCount = 0;
+uint32_t showCursor = 0;
+uint32_t showPausedAt = 0;
+unsigned long showStartedAt = 0;
+spi_flash_mmap_handle_t showMapHandle;
+
+// Map the show partition and validate it. Returns false if there is no usable show.
+bool showBegin()
+{
+    const esp_partition_t *part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                                           (esp_partition_subtype_t)SHOW_PARTITION_SUBTYPE,
+                                                           SHOW_PARTITION_NAME);
+    if (part == nullptr)
+    {
+        Serial.println("Show: no show partition.");
+        return false;
+    }
+
+    const void *mapped = nullptr;
+    if (esp_partition_mmap(part, 0, part->size, SPI_FLASH_MMAP_DATA, &mapped, &showMapHandle) != ESP_OK)
+    {
+        Serial.println("Show: mmap failed.");
+        return false;
+    }
+
+    const sShowHeader *header = (const sShowHeader *)mapped;
+    uint32_t bodySize = showImageBody(header, part->size);
+    if (bodySize == 0)
+    {
+        Serial.println("Show: no valid show loaded.");
+        spi_flash_munmap(showMapHandle);
+        return false;
+    }
+
+    if (esp_rom_crc32_le(0, (const uint8_t *)mapped + sizeof(sShowHeader), bodySize) != header->crc32)
+    {
+        Serial.println("Show: CRC mismatch, ignoring show.");
+        spi_flash_munmap(showMapHandle);
+        return false;
+    }
+
+    showHeader = header;
+    showCues = (const sShowCue *)((const uint8_t *)mapped + header->cueOffset);
+    showScenes = (const sScene *)((const uint8_t *)mapped + header->blobOffset);
+    showSceneCount = header->blobSize / sizeof(sScene);
+    g_showLoaded = true;
+    Serial.printf("Show: %u cues, %u ms.\n", header->cueCount, header->durationMs);
+    return true;
+}
+
+// Index of the first cue at or after timeMs.
+uint32_t showSeek(uint32_t timeMs)
+{
+    return showSeekCues(showCues, showHeader->cueCount, timeMs);
+}
+
+void showPlay(uint32_t fromMs)
+{
+    if (!g_showLoaded)
+    {
+        return;
+    }
+    showCursor = showSeek(fromMs);
+    showStartedAt = millis() - fromMs;
+    g_showRunning = true;
+}
+
+void showPause()
+{
+    if (g_showRunning)
+    {
+        showPausedAt = millis() - showStartedAt;
+        g_showRunning = false;
+    }
+}
+
+void showResume()
+{
+    showPlay(showPausedAt);
+}
+
+void showStop()
+{
+    g_showRunning = false;
+    showPausedAt = 0;
+}
+
+uint32_t showPosition()
+{
+    return g_showRunning ? millis() - showStartedAt : showPausedAt;
+}
+
+// live: the cue comes from a running show, here or on the master. Only those fire channels.
+void executeCue(const sShowCue &cue, bool live)
+{
+    udpBroadcastCue(cue.type, cue.channel, cue.param, live); // master only, subs mirror it
+    switch (cue.type)
+    {
+    case CUE_FIRE:
+    {
+        FixedString<32> payload("Fire: Shell #");
+        cueFire(payload.appendUInt(cue.channel).c_str());
+        leds[cue.channel % NUM_LEDS] = CRGB(240, 0, 0);
+        if (live)
+        {
+            fireSubmit(FIRE_CMD_FIRE, cue.channel, cue.param); // subs with channels, param is the pulse ms
+        }
+        break;
+    }
+    case CUE_SCENE:
+        if (cue.param < showSceneCount)
+        {
+            applyScene(showScenes[cue.param]);
+        }
+        break;
+    case CUE_PRESET:
+        presetRecall(cue.param);
+        break;
+    case CUE_END:
+        showStop();
+        break;
+    }
+}
+
+// Called from loop(), runs every cue that has come due.
+void showService()
+{
+    if (!g_showRunning)
+    {
+        return;
+    }
+
+    uint32_t now = millis() - showStartedAt;
+    while (g_showRunning && showCursor < showHeader->cueCount && showCues[showCursor].timeMs <= now)
+    {
+        executeCue(showCues[showCursor++], true);
+    }
+
+    if (showCursor >= showHeader->cueCount)
+    {
+        showStop();
+    }
+}
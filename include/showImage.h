@@ -0,0 +1,98 @@
+/*+===================================================================
+  File:      showImage.h
+
+  Summary:   Layout of a compiled show image (tools/showc.py) and
+             the checks and seek that run on it in place. showFile.h
+             maps the "show" partition and hands it to these.
+
+                sShowHeader   32 bytes
+                sShowCue[]    cueCount * 8 bytes, sorted by timeMs
+                param blob    sScene records referenced by cues
+
+             The CRC is the zlib/esp_rom_crc32_le one, the caller
+             supplies it so the ROM version is used on the device.
+
+             No Arduino dependencies so tools/showbench.cpp can map
+             a showc.py image on the host.
+
+  10/19/2026.
+===================================================================+*/
+
+#include <stdint.h>
+
+#define SHOW_MAGIC 0x48535742 // "BWSH"
+#define SHOW_VERSION 1
+#define SHOW_SCENE_SIZE 8     // sizeof(sScene) in presetStore.h
+
+enum CueType
+{
+    CUE_FIRE = 1,   // ignite channel
+    CUE_SCENE = 2,  // apply sScene at blob index param
+    CUE_PRESET = 3, // recall preset slot param
+    CUE_END = 0xFF  // end of show
+};
+
+struct sShowHeader
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t cueSize;    // sizeof(sShowCue), guards against mismatched tools.
+    uint32_t cueCount;
+    uint32_t cueOffset;  // from start of image.
+    uint32_t blobOffset; // from start of image.
+    uint32_t blobSize;
+    uint32_t durationMs;
+    uint32_t crc32;      // of everything after the header.
+};
+
+struct sShowCue
+{
+    uint32_t timeMs;  // from show start.
+    uint8_t type;     // CueType.
+    uint8_t channel;  // firing channel or sub-controller.
+    uint16_t param;   // blob index or preset slot.
+};
+
+static_assert(sizeof(sShowHeader) == 32, "show header layout");
+static_assert(sizeof(sShowCue) == 8, "show cue layout");
+
+// Header sanity against the mapped size. Returns the number of bytes the CRC
+// covers (everything after the header), 0 if the image is not a usable show.
+uint32_t showImageBody(const sShowHeader *header, uint32_t size)
+{
+    if (size < sizeof(sShowHeader) || header->magic != SHOW_MAGIC || header->version != SHOW_VERSION ||
+        header->cueSize != sizeof(sShowCue) || header->cueCount > size / sizeof(sShowCue))
+    {
+        return 0;
+    }
+    // Compare against what's left rather than adding, so a huge size can't wrap past the end.
+    if (header->cueOffset < sizeof(sShowHeader) || header->cueOffset > size ||
+        header->cueCount > (size - header->cueOffset) / sizeof(sShowCue) || header->blobOffset > size ||
+        header->blobSize > size - header->blobOffset)
+    {
+        return 0;
+    }
+    uint32_t cueEnd = header->cueOffset + header->cueCount * sizeof(sShowCue);
+    uint32_t blobEnd = header->blobOffset + header->blobSize;
+    return (cueEnd > blobEnd ? cueEnd : blobEnd) - sizeof(sShowHeader);
+}
+
+// Index of the first cue at or after timeMs.
+uint32_t showSeekCues(const sShowCue *cues, uint32_t count, uint32_t timeMs)
+{
+    uint32_t lo = 0;
+    uint32_t hi = count;
+    while (lo < hi)
+    {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (cues[mid].timeMs < timeMs)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return lo;
+}
@@ -0,0 +1,295 @@
+/*+===================================================================
+  File:      subDiscovery.h
+
+  Summary:   Master/sub discovery over mDNS (USE_SUB_DISCOVERY).
+
+             Every unit advertises _bangworx._tcp on port 80 with a
+             TXT record: role (master or sub), leds, fw (software
+             version), ch (firing channels) and profile.
+
+             The master keeps the roster (subRoster.h) on a "roster"
+             task. Every ROSTER_POLL_MS it reads the SoftAP station
+             list, which is local and free. It sends an mDNS query
+             (a blocking ~3 s call, hence the task) only while a
+             station is still unidentified. It then POSTs each online
+             sub's configuration to that sub's /api/v1/state.
+             Configurations are kept in NVS by host, so a sub gets
+             its own again after either side restarts.
+
+                GET  /api/roster           the roster
+                POST /api/roster/config    host=<sub host>&config=<JSON
+                                           for /api/v1/state>, empty
+                                           config clears it
+
+  10/19/2026.
+===================================================================+*/
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include <subRoster.h>
+
+// externs
+extern bool g_isAccessPoint;
+extern String softwareVersion;
+
+#if USE_SUB_DISCOVERY
+#include <ESPmDNS.h>
+#include <Preferences.h>
+#include <WiFiClient.h>
+#include <esp_netif.h>
+#include <esp_wifi.h>
+
+#define ROSTER_POLL_MS 2000
+#define ROSTER_PUSH_TIMEOUT_MS 3000
+#define ROSTER_NAMESPACE "roster"
+
+// locals
+sRoster roster;
+portMUX_TYPE rosterLock = portMUX_INITIALIZER_UNLOCKED;
+Preferences rosterPrefs;
+
+// NVS keys are 15 characters at most, so configs are stored under a hash of the host.
+void rosterKey(const char *host, char *key)
+{
+    uint32_t hash = 2166136261u;
+    for (const char *c = host; *c; c++)
+    {
+        hash = (hash ^ (uint8_t)*c) * 16777619u;
+    }
+    snprintf(key, 12, "c%08x", hash);
+}
+
+// From the net task, once mDNS is up.
+void discoveryAdvertise()
+{
+    MDNS.addService("bangworx", "tcp", 80);
+    MDNS.addServiceTxt("bangworx", "tcp", "role", g_isAccessPoint ? "master" : "sub");
+    MDNS.addServiceTxt("bangworx", "tcp", "leds", String(g_profile.numLeds).c_str());
+    MDNS.addServiceTxt("bangworx", "tcp", "fw", softwareVersion.c_str());
+    MDNS.addServiceTxt("bangworx", "tcp", "ch", String(g_profile.channels).c_str());
+    MDNS.addServiceTxt("bangworx", "tcp", "profile", g_profile.name);
+}
+
+int rosterReadStations(uint32_t *ips, int8_t *rssi)
+{
+    wifi_sta_list_t stations;
+    esp_netif_sta_list_t netifStations;
+    if (esp_wifi_ap_get_sta_list(&stations) != ESP_OK || esp_netif_get_sta_list(&stations, &netifStations) != ESP_OK)
+    {
+        return 0;
+    }
+    int count = min(netifStations.num, ROSTER_MAX);
+    for (int i = 0; i < count; i++)
+    {
+        ips[i] = netifStations.sta[i].ip.addr;
+        rssi[i] = stations.sta[i].rssi;
+    }
+    return count;
+}
+
+void rosterQuery()
+{
+    static sRosterAnswer answers[ROSTER_MAX];
+    int found = MDNS.queryService("bangworx", "tcp");
+    int count = 0;
+    for (int i = 0; i < found && count < ROSTER_MAX; i++)
+    {
+        sRosterAnswer &answer = answers[count];
+        memset(&answer, 0, sizeof(answer));
+        answer.ip = (uint32_t)MDNS.IP(i);
+        rosterCopy(answer.sub.host, MDNS.hostname(i).c_str(), sizeof(answer.sub.host));
+        const char *keys[] = {"role", "leds", "fw", "ch", "profile"};
+        for (const char *key : keys)
+        {
+            rosterTxt(answer.sub, key, MDNS.txt(i, key).c_str());
+        }
+        count += strcmp(answer.sub.role, "sub") == 0; // the master answers too
+    }
+
+    bool wasOnline[ROSTER_MAX];
+    portENTER_CRITICAL(&rosterLock);
+    for (int a = 0; a < count; a++)
+    {
+        int i = rosterFind(roster, answers[a].ip);
+        wasOnline[a] = i >= 0 && roster.entries[i].state == ROSTER_ONLINE;
+    }
+    rosterQueryResult(roster, answers, count, millis());
+    portEXIT_CRITICAL(&rosterLock);
+
+    // Subs seen for the first time since boot get their stored config back.
+    char config[ROSTER_CONFIG_MAX];
+    char key[12];
+    for (int a = 0; a < count; a++)
+    {
+        portENTER_CRITICAL(&rosterLock);
+        int i = rosterFind(roster, answers[a].ip);
+        bool load = i >= 0 && roster.entries[i].configSeq == 0;
+        portEXIT_CRITICAL(&rosterLock);
+        if (!wasOnline[a] && i >= 0)
+        {
+            logEvent(LOG_ROSTER_ONLINE, answers[a].ip, answers[a].sub.leds);
+        }
+        rosterKey(answers[a].sub.host, key);
+        size_t length = load ? rosterPrefs.getBytes(key, config, sizeof(config) - 1) : 0;
+        if (length > 0)
+        {
+            config[length] = 0;
+            portENTER_CRITICAL(&rosterLock);
+            rosterSetConfig(roster, answers[a].sub.host, config, millis());
+            portEXIT_CRITICAL(&rosterLock);
+        }
+    }
+}
+
+bool rosterPost(uint32_t ip, const char *config)
+{
+    WiFiClient client;
+    IPAddress address(ip);
+    if (!client.connect(address, 80, ROSTER_PUSH_TIMEOUT_MS))
+    {
+        return false;
+    }
+    client.printf("POST /api/v1/state HTTP/1.1\r\nHost: %s\r\nContent-Type: application/json\r\n"
+                  "Content-Length: %u\r\nConnection: close\r\n\r\n%s",
+                  address.toString().c_str(), strlen(config), config);
+    client.setTimeout(ROSTER_PUSH_TIMEOUT_MS / 1000);
+    String status = client.readStringUntil('\n');
+    client.stop();
+    return status.indexOf(" 200") > 0;
+}
+
+void rosterPush()
+{
+    char config[ROSTER_CONFIG_MAX];
+    portENTER_CRITICAL(&rosterLock);
+    int i = rosterPushDue(roster, millis());
+    uint32_t ip = i >= 0 ? roster.entries[i].ip : 0;
+    uint16_t seq = i >= 0 ? roster.entries[i].configSeq : 0;
+    if (i >= 0)
+    {
+        memcpy(config, roster.entries[i].config, sizeof(config));
+    }
+    portEXIT_CRITICAL(&rosterLock);
+    if (i < 0)
+    {
+        return;
+    }
+
+    bool ok = rosterPost(ip, config);
+    logEvent(LOG_ROSTER_PUSH, ip, ok);
+    portENTER_CRITICAL(&rosterLock);
+    i = rosterFind(roster, ip); // the roster may have moved on while we waited
+    if (i >= 0)
+    {
+        rosterPushDone(roster, i, seq, ok, millis());
+    }
+    portEXIT_CRITICAL(&rosterLock);
+}
+
+void rosterTask(void *param)
+{
+    uint32_t ips[ROSTER_MAX];
+    int8_t rssi[ROSTER_MAX];
+    for (;;)
+    {
+        int count = rosterReadStations(ips, rssi);
+        portENTER_CRITICAL(&rosterLock);
+        rosterStations(roster, ips, rssi, count, millis());
+        bool query = rosterQueryDue(roster, millis());
+        portEXIT_CRITICAL(&rosterLock);
+        if (query)
+        {
+            rosterQuery();
+        }
+        rosterPush();
+        vTaskDelay(pdMS_TO_TICKS(ROSTER_POLL_MS));
+    }
+}
+
+// Master only, once the network is up.
+void discoveryBegin()
+{
+    if (!g_isAccessPoint)
+    {
+        return;
+    }
+    rosterInit(roster);
+    rosterPrefs.begin(ROSTER_NAMESPACE, false);
+    xTaskCreatePinnedToCore(rosterTask, "roster", 4096, nullptr, 1, nullptr, 0);
+}
+
+void handleRoster(AsyncWebServerRequest *request)
+{
+    AsyncResponseStream *response = request->beginResponseStream("application/json");
+    portENTER_CRITICAL(&rosterLock);
+    int count = roster.count;
+    uint32_t queries = roster.queries;
+    uint32_t pushes = roster.pushes;
+    portEXIT_CRITICAL(&rosterLock);
+    response->printf("{\"queries\":%u,\"pushes\":%u,\"subs\":[", queries, pushes);
+    uint32_t now = millis();
+    for (int i = 0; i < count; i++)
+    {
+        sRosterEntry entry;
+        portENTER_CRITICAL(&rosterLock);
+        entry = roster.entries[i];
+        portEXIT_CRITICAL(&rosterLock);
+        response->printf("%s{\"ip\":\"%s\",\"state\":\"%s\",\"forMs\":%u,\"seenAgoMs\":%u,\"rssi\":%d,\"host\":\"%s\","
+                         "\"role\":\"%s\",\"leds\":%u,\"fw\":\"%s\",\"ch\":%u,\"profile\":\"%s\",\"config\":%s,"
+                         "\"configSent\":%s,\"pushFailures\":%u}",
+                         i ? "," : "", IPAddress(entry.ip).toString().c_str(), rosterStateName(entry.state),
+                         now - entry.changedMs, now - entry.seenMs, entry.rssi, entry.sub.host, entry.sub.role,
+                         entry.sub.leds, entry.sub.fw, entry.sub.channels, entry.sub.profile,
+                         entry.config[0] ? entry.config : "null",
+                         entry.config[0] && entry.pushedSeq == entry.configSeq ? "true" : "false", entry.pushFailures);
+    }
+    response->print("]}");
+    request->send(response);
+}
+
+void handleRosterConfig(AsyncWebServerRequest *request)
+{
+    if (!g_isAccessPoint || !request->hasParam("host", true) || !request->hasParam("config", true))
+    {
+        request->send(400, "text/plain", "host and config required, master only");
+        return;
+    }
+    String host = request->getParam("host", true)->value();
+    String config = request->getParam("config", true)->value();
+    sControlParser parser; // same parser the sub will run it through
+    controlParseBegin(parser);
+    if (config.length() > 0 && (!controlParse(parser, (const uint8_t *)config.c_str(), config.length()) ||
+                                !controlParseEnd(parser)))
+    {
+        request->send(400, "text/plain", String("config: ") + parser.error);
+        return;
+    }
+    portENTER_CRITICAL(&rosterLock);
+    bool ok = rosterSetConfig(roster, host.c_str(), config.c_str(), millis());
+    portEXIT_CRITICAL(&rosterLock);
+    if (!ok)
+    {
+        request->send(404, "text/plain", "unknown sub or config too long");
+        return;
+    }
+    char key[12];
+    rosterKey(host.c_str(), key);
+    if (config.length() > 0)
+    {
+        rosterPrefs.putBytes(key, config.c_str(), config.length());
+    }
+    else
+    {
+        rosterPrefs.remove(key);
+    }
+    request->send(202, "text/plain", "queued");
+}
+
+#else
+
+void discoveryAdvertise() {}
+void discoveryBegin() {}
+void handleRoster(AsyncWebServerRequest *request) { request->send(404, "text/plain", "Sub discovery disabled"); }
+void handleRosterConfig(AsyncWebServerRequest *request) { request->send(404, "text/plain", "Sub discovery disabled"); }
+
+#endif
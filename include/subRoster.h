@@ -0,0 +1,375 @@
+/*+===================================================================
+  File:      subRoster.h
+
+  Summary:   The master's roster of its subs: who is on the SoftAP,
+             what each one is (from its _bangworx._tcp mDNS TXT
+             record) and whether it has the configuration the master
+             holds for it.
+
+             The SoftAP station list is the cheap, local source: it
+             says who is associated right now, with their IP and
+             RSSI, and costs no airtime. mDNS is only asked about
+             stations the roster can't place yet:
+
+                pending   on the SoftAP, not identified. Queried
+                          ROSTER_QUERY_DELAY_MS after it shows up
+                          (its responder needs a moment), then with
+                          a doubling backoff
+                online    answered with a sub record
+                other     didn't answer ROSTER_QUERY_TRIES queries,
+                          a phone or a laptop, left alone
+                gone      left the SoftAP, kept for the roster page.
+                          Coming back makes it pending again, it may
+                          have rebooted into new firmware
+
+             So with everyone identified nothing is queried at all.
+
+             Configuration is a JSON body per sub host, sent to the
+             sub's POST /api/v1/state (controlApi.h) whenever it
+             changes and each time the sub comes back online.
+
+             No Arduino dependencies, subDiscovery.h does the mDNS
+             and HTTP, tools/rosterbench.cpp runs it against a fake
+             responder.
+
+  10/19/2026.
+===================================================================+*/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ROSTER_MAX 10 // the SoftAP's station limit
+#define ROSTER_TEXT_MAX 24
+#define ROSTER_CONFIG_MAX 192
+#define ROSTER_QUERY_DELAY_MS 2000
+#define ROSTER_QUERY_BACKOFF_MS 4000
+#define ROSTER_QUERY_TRIES 3
+#define ROSTER_PUSH_RETRY_MS 10000
+
+enum RosterState
+{
+    ROSTER_PENDING = 0,
+    ROSTER_ONLINE = 1,
+    ROSTER_OTHER = 2,
+    ROSTER_GONE = 3
+};
+
+// What a sub says about itself in its TXT record.
+struct sRosterSub
+{
+    char host[ROSTER_TEXT_MAX];
+    char role[8];
+    char fw[16];
+    char profile[ROSTER_TEXT_MAX];
+    uint16_t leds;
+    uint8_t channels;
+};
+
+struct sRosterEntry
+{
+    uint32_t ip;
+    uint8_t state; // RosterState
+    uint8_t tries; // mDNS queries it hasn't answered
+    int8_t rssi;
+    uint32_t seenMs;    // last time it was in the station list
+    uint32_t seenPass;
+    uint32_t changedMs; // last state change
+    uint32_t nextQueryMs;
+    sRosterSub sub;
+    char config[ROSTER_CONFIG_MAX]; // empty for none
+    uint16_t configSeq;             // bumped on every change, 0 is never pushed
+    uint16_t pushedSeq;
+    uint16_t pushFailures;
+    uint32_t nextPushMs;
+};
+
+struct sRoster
+{
+    sRosterEntry entries[ROSTER_MAX];
+    int count;
+    uint32_t pass;    // rosterStations() calls
+    uint32_t queries; // mDNS queries sent, for /api/roster
+    uint32_t pushes;
+};
+
+// One answer from an mDNS query.
+struct sRosterAnswer
+{
+    uint32_t ip;
+    sRosterSub sub;
+};
+
+bool rosterDue(uint32_t now, uint32_t at)
+{
+    return (int32_t)(now - at) >= 0;
+}
+
+void rosterCopy(char *to, const char *from, size_t size)
+{
+    strncpy(to, from ? from : "", size - 1);
+    to[size - 1] = 0;
+}
+
+void rosterInit(sRoster &roster)
+{
+    memset(&roster, 0, sizeof(roster));
+}
+
+int rosterFind(const sRoster &roster, uint32_t ip)
+{
+    for (int i = 0; i < roster.count; i++)
+    {
+        if (roster.entries[i].ip == ip)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int rosterFindHost(const sRoster &roster, const char *host)
+{
+    for (int i = 0; i < roster.count; i++)
+    {
+        if (roster.entries[i].sub.host[0] && strcmp(roster.entries[i].sub.host, host) == 0)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void rosterRemove(sRoster &roster, int i)
+{
+    roster.entries[i] = roster.entries[--roster.count];
+}
+
+void rosterSetState(sRosterEntry &entry, uint8_t state, uint32_t now)
+{
+    if (entry.state != state)
+    {
+        entry.state = state;
+        entry.changedMs = now;
+    }
+}
+
+// Apply one TXT key/value, false for a key we don't know.
+bool rosterTxt(sRosterSub &sub, const char *key, const char *value)
+{
+    if (strcmp(key, "role") == 0)
+    {
+        rosterCopy(sub.role, value, sizeof(sub.role));
+    }
+    else if (strcmp(key, "fw") == 0)
+    {
+        rosterCopy(sub.fw, value, sizeof(sub.fw));
+    }
+    else if (strcmp(key, "profile") == 0)
+    {
+        rosterCopy(sub.profile, value, sizeof(sub.profile));
+    }
+    else if (strcmp(key, "leds") == 0)
+    {
+        sub.leds = (uint16_t)atoi(value);
+    }
+    else if (strcmp(key, "ch") == 0)
+    {
+        sub.channels = (uint8_t)atoi(value);
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+// Make room by forgetting the station that left longest ago, -1 if everyone is here.
+int rosterEvict(sRoster &roster)
+{
+    int oldest = -1;
+    for (int i = 0; i < roster.count; i++)
+    {
+        const sRosterEntry &entry = roster.entries[i];
+        if (entry.state == ROSTER_GONE &&
+            (oldest < 0 || (int32_t)(entry.seenMs - roster.entries[oldest].seenMs) < 0))
+        {
+            oldest = i;
+        }
+    }
+    if (oldest >= 0)
+    {
+        rosterRemove(roster, oldest);
+    }
+    return oldest;
+}
+
+// The SoftAP's current stations. IP 0 (no DHCP lease yet) is skipped.
+void rosterStations(sRoster &roster, const uint32_t *ips, const int8_t *rssi, int n, uint32_t now)
+{
+    roster.pass++;
+    for (int s = 0; s < n; s++)
+    {
+        if (ips[s] == 0)
+        {
+            continue;
+        }
+        int i = rosterFind(roster, ips[s]);
+        if (i < 0)
+        {
+            if (roster.count == ROSTER_MAX && rosterEvict(roster) < 0)
+            {
+                continue;
+            }
+            i = roster.count++;
+            memset(&roster.entries[i], 0, sizeof(sRosterEntry));
+            roster.entries[i].ip = ips[s];
+            roster.entries[i].changedMs = now;
+            roster.entries[i].nextQueryMs = now + ROSTER_QUERY_DELAY_MS;
+        }
+        sRosterEntry &entry = roster.entries[i];
+        if (entry.state == ROSTER_GONE)
+        {
+            rosterSetState(entry, ROSTER_PENDING, now);
+            entry.tries = 0;
+            entry.nextQueryMs = now + ROSTER_QUERY_DELAY_MS;
+        }
+        entry.seenMs = now;
+        entry.seenPass = roster.pass;
+        entry.rssi = rssi ? rssi[s] : 0;
+    }
+
+    for (int i = 0; i < roster.count; i++)
+    {
+        sRosterEntry &entry = roster.entries[i];
+        if (entry.state != ROSTER_GONE && entry.seenPass != roster.pass)
+        {
+            rosterSetState(entry, ROSTER_GONE, now);
+        }
+    }
+}
+
+// Is there a station worth asking mDNS about?
+bool rosterQueryDue(const sRoster &roster, uint32_t now)
+{
+    for (int i = 0; i < roster.count; i++)
+    {
+        const sRosterEntry &entry = roster.entries[i];
+        if (entry.state == ROSTER_PENDING && rosterDue(now, entry.nextQueryMs))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Everything one query found. Answers from hosts not on the SoftAP are ignored.
+void rosterQueryResult(sRoster &roster, const sRosterAnswer *answers, int n, uint32_t now)
+{
+    roster.queries++;
+    for (int a = 0; a < n; a++)
+    {
+        const sRosterAnswer &answer = answers[a];
+        int i = rosterFind(roster, answer.ip);
+        if (i < 0 || roster.entries[i].state == ROSTER_GONE || !answer.sub.host[0])
+        {
+            continue;
+        }
+        int known = rosterFindHost(roster, answer.sub.host);
+        if (known >= 0 && known != i)
+        {
+            // Same sub on a new lease: keep its config, drop the old entry.
+            sRosterEntry &entry = roster.entries[i];
+            memcpy(entry.config, roster.entries[known].config, sizeof(entry.config));
+            entry.configSeq = roster.entries[known].configSeq;
+            rosterRemove(roster, known);
+            i = rosterFind(roster, answer.ip);
+        }
+        else if (known < 0 && roster.entries[i].sub.host[0])
+        {
+            // A different device on this IP, the old one's config isn't for it.
+            roster.entries[i].config[0] = 0;
+            roster.entries[i].configSeq = 0;
+        }
+        sRosterEntry &entry = roster.entries[i];
+        if (entry.state != ROSTER_ONLINE)
+        {
+            entry.pushedSeq = 0; // (re)joined, it gets its config again
+            entry.nextPushMs = now;
+        }
+        entry.sub = answer.sub;
+        entry.tries = 0;
+        rosterSetState(entry, ROSTER_ONLINE, now);
+    }
+
+    for (int i = 0; i < roster.count; i++)
+    {
+        sRosterEntry &entry = roster.entries[i];
+        if (entry.state == ROSTER_PENDING && rosterDue(now, entry.nextQueryMs))
+        {
+            entry.tries++;
+            if (entry.tries >= ROSTER_QUERY_TRIES)
+            {
+                rosterSetState(entry, ROSTER_OTHER, now);
+            }
+            else
+            {
+                entry.nextQueryMs = now + (ROSTER_QUERY_BACKOFF_MS << (entry.tries - 1));
+            }
+        }
+    }
+}
+
+// Set (or with "" clear) a sub's config, false if the host isn't known or it doesn't fit.
+bool rosterSetConfig(sRoster &roster, const char *host, const char *config, uint32_t now)
+{
+    int i = rosterFindHost(roster, host);
+    if (i < 0 || strlen(config) >= ROSTER_CONFIG_MAX)
+    {
+        return false;
+    }
+    sRosterEntry &entry = roster.entries[i];
+    rosterCopy(entry.config, config, sizeof(entry.config));
+    entry.configSeq = entry.configSeq == 0xFFFF ? 1 : entry.configSeq + 1;
+    entry.pushFailures = 0;
+    entry.nextPushMs = now;
+    return true;
+}
+
+// An online sub whose config hasn't reached it, -1 for none.
+int rosterPushDue(const sRoster &roster, uint32_t now)
+{
+    for (int i = 0; i < roster.count; i++)
+    {
+        const sRosterEntry &entry = roster.entries[i];
+        if (entry.state == ROSTER_ONLINE && entry.config[0] && entry.pushedSeq != entry.configSeq &&
+            rosterDue(now, entry.nextPushMs))
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// seq is the configSeq that was sent, the config may have changed again meanwhile.
+void rosterPushDone(sRoster &roster, int i, uint16_t seq, bool ok, uint32_t now)
+{
+    sRosterEntry &entry = roster.entries[i];
+    roster.pushes++;
+    if (ok)
+    {
+        entry.pushedSeq = seq;
+        entry.pushFailures = 0;
+    }
+    else
+    {
+        entry.pushFailures++;
+        entry.nextPushMs = now + ROSTER_PUSH_RETRY_MS;
+    }
+}
+
+const char *rosterStateName(uint8_t state)
+{
+    static const char *names[] = {"pending", "online", "other", "gone"};
+    return state <= ROSTER_GONE ? names[state] : "?";
+}
@@ -0,0 +1,149 @@
+/*+===================================================================
+  File:      thermalControl.h
+
+  Summary:   Power estimate and the PI loop behind thermalGovernor.h.
+
+             Current is estimated from the pixel buffer with the same
+             per-channel figures FastLED uses for its power limiter,
+             so the budget handed to setMaxPowerInVoltsAndMilliamps()
+             means the same thing here and there.
+
+             One PI output u in 0..2 drives both actuators in split
+             range: 0..1 spins the fan up, 1..2 derates the current
+             budget towards THERMAL_MIN_BUDGET of MAX_CURRENT. The
+             load (estimated current / MAX_CURRENT) is fed forward to
+             the fan so it starts before the heat shows up. The
+             integral only winds while the output isn't pinned.
+
+             Without a good reading for THERMAL_STALE_MS the fan goes
+             full and the budget drops to THERMAL_FAILSAFE_BUDGET.
+
+             No Arduino dependencies so tools/thermalsim.cpp can run
+             it against a thermal model on the host.
+
+  10/19/2026.
+===================================================================+*/
+
+#include <stdint.h>
+#include <math.h>
+
+#define THERMAL_SET_C 50.0f          // regulate the PSU / enclosure here
+#define THERMAL_KP 0.4f              // per degree C
+#define THERMAL_KI 0.02f             // per degree C per second
+#define THERMAL_FF 0.6f              // fan share fed forward from the load
+#define THERMAL_MIN_BUDGET 0.25f     // fully derated, of MAX_CURRENT
+#define THERMAL_FAILSAFE_BUDGET 0.5f // sensor gone, of MAX_CURRENT
+#define THERMAL_STALE_MS 5000
+
+// FastLED's power model, mA at full scale per channel and per dark pixel.
+#define POWER_RED_MA 16
+#define POWER_GREEN_MA 11
+#define POWER_BLUE_MA 15
+#define POWER_DARK_MA 1
+
+struct sPowerEstimate
+{
+    uint32_t idleMa;    // dark pixels.
+    uint32_t dynamicMa; // channel draw at brightness 255.
+};
+
+struct sThermalPi
+{
+    float integral;
+    float output; // u, 0..2.
+};
+
+struct sThermalOut
+{
+    uint8_t fanDuty;   // 0-255.
+    uint32_t budgetMa; // current budget for the strip.
+};
+
+// Sum the pixel buffer (packed RGB). Brightness isn't applied, see estimateMa().
+sPowerEstimate powerEstimate(const uint8_t *rgb, int numLeds)
+{
+    uint32_t red = 0;
+    uint32_t green = 0;
+    uint32_t blue = 0;
+    for (int i = 0; i < numLeds; i++)
+    {
+        red += rgb[0];
+        green += rgb[1];
+        blue += rgb[2];
+        rgb += 3;
+    }
+    sPowerEstimate estimate;
+    estimate.idleMa = numLeds * POWER_DARK_MA;
+    estimate.dynamicMa = (red * POWER_RED_MA + green * POWER_GREEN_MA + blue * POWER_BLUE_MA) / 255;
+    return estimate;
+}
+
+uint32_t estimateMa(const sPowerEstimate &estimate, uint8_t brightness)
+{
+    return estimate.idleMa + estimate.dynamicMa * brightness / 256;
+}
+
+// What FastLED's limiter does with a budget: the largest brightness up to requested that fits.
+uint8_t powerCapBrightness(const sPowerEstimate &estimate, uint8_t requested, uint32_t budgetMa)
+{
+    if (estimateMa(estimate, requested) <= budgetMa)
+    {
+        return requested;
+    }
+    if (budgetMa <= estimate.idleMa || estimate.dynamicMa == 0)
+    {
+        return 0;
+    }
+    uint32_t brightness = (budgetMa - estimate.idleMa) * 256 / estimate.dynamicMa;
+    return brightness > requested ? requested : brightness;
+}
+
+void thermalInit(sThermalPi &pi)
+{
+    pi.integral = 0;
+    pi.output = 0;
+}
+
+// One control step. tempC is NAN while there's no fresh reading.
+sThermalOut thermalStep(sThermalPi &pi, float tempC, uint32_t loadMa, uint32_t maxCurrentMa, float dtS)
+{
+    sThermalOut out;
+    if (isnan(tempC))
+    {
+        out.fanDuty = 255;
+        out.budgetMa = maxCurrentMa * THERMAL_FAILSAFE_BUDGET;
+        return out;
+    }
+
+    float error = tempC - THERMAL_SET_C;
+    float u = THERMAL_KP * error + pi.integral;
+    bool pinnedHigh = u >= 2.0f && error > 0;
+    bool pinnedLow = u <= 0.0f && error < 0;
+    if (!pinnedHigh && !pinnedLow)
+    {
+        pi.integral += THERMAL_KI * error * dtS;
+        pi.integral = pi.integral < 0 ? 0 : (pi.integral > 2.0f ? 2.0f : pi.integral);
+    }
+    u = u < 0 ? 0 : (u > 2.0f ? 2.0f : u);
+    pi.output = u;
+
+    float load = maxCurrentMa ? (float)loadMa / maxCurrentMa : 0;
+    float fan = u + THERMAL_FF * (load > 1.0f ? 1.0f : load);
+    float derate = u - 1.0f;
+    fan = fan > 1.0f ? 1.0f : fan;
+    derate = derate < 0 ? 0 : derate;
+
+    out.fanDuty = (uint8_t)(fan * 255.0f + 0.5f);
+    out.budgetMa = maxCurrentMa * (1.0f - derate * (1.0f - THERMAL_MIN_BUDGET));
+    return out;
+}
+
+// MLX90615 RAM word (0.02 K per count) to Celsius, NAN for the error flag.
+float mlxToCelsius(uint16_t raw)
+{
+    if (raw & 0x8000)
+    {
+        return NAN;
+    }
+    return raw * 0.02f - 273.15f;
+}
@@ -0,0 +1,153 @@
+/*+===================================================================
+  File:      thermalGovernor.h
+
+  Summary:   Keeps the PSU out of trouble on long bright runs
+             (USE_TEMPERATURE_SENSOR): an MLX90615 pointed at it, a
+             PWM fan on FAN_PIN and the PI loop in thermalControl.h.
+
+             loop() queues a sensor read on the shared bus (i2cBus.h)
+             once a second and picks the result up a tick later, so
+             it never waits on I2C. It runs the controller every
+             THERMAL_TICK_MS with a power estimate taken from
+             leds[], sets the fan and hands the current budget to
+             FastLED's power limiter, which enforces it on every
+             show() and never allows more than MAX_CURRENT.
+
+             Needs i2cBus.h first.
+
+                GET /api/thermal    temperature, fan, budget, load
+
+  10/19/2026.
+===================================================================+*/
+
+#include <Arduino.h>
+#include <thermalControl.h>
+
+#define THERMAL_TICK_MS 250
+#define THERMAL_READ_MS 1000
+#define MLX90615_ADDR 0x5B
+#define MLX90615_OBJECT 0x27 // RAM: object temperature
+#define THERMAL_FAN_CHANNEL 4 // LEDC
+#define THERMAL_FAN_HZ 25000  // above hearing, PC fan standard
+
+// externs
+extern CRGB leds[];
+extern String g_temperature;
+
+float celsiusToFahrenheit(float c)
+{
+    return c * 9.0f / 5.0f + 32.0f;
+}
+
+#if USE_TEMPERATURE_SENSOR
+
+// locals
+volatile float thermalReadingC = NAN;
+volatile uint32_t thermalReadAt = 0;
+uint32_t thermalReadErrors = 0;
+sI2cResult thermalRead = {};
+unsigned long thermalLastRead = 0;
+sThermalPi thermalPi;
+sThermalOut thermalOut = {0, MAX_CURRENT};
+uint32_t thermalLoadMa = 0;
+unsigned long thermalLastTick = 0;
+uint32_t thermalShownAt = 0; // reading last copied into g_temperature
+
+// Collect the last read if the bus task has finished it and queue the next one.
+void thermalPollSensor(unsigned long now)
+{
+    if (thermalRead.state == I2C_DONE)
+    {
+        float c = mlxToCelsius(thermalRead.data[0] | thermalRead.data[1] << 8); // data[2] is the PEC
+        if (isnan(c))
+        {
+            thermalReadErrors++;
+        }
+        else
+        {
+            thermalReadingC = c;
+            thermalReadAt = now;
+        }
+        thermalRead.state = I2C_IDLE;
+    }
+    else if (thermalRead.state == I2C_FAILED)
+    {
+        thermalReadErrors++;
+        thermalRead.state = I2C_IDLE;
+    }
+
+    if (thermalRead.state == I2C_IDLE && now - thermalLastRead >= THERMAL_READ_MS)
+    {
+        thermalLastRead = now;
+        i2cRead(MLX90615_ADDR, MLX90615_OBJECT, 3, thermalRead);
+    }
+}
+
+// After i2cBusBegin().
+void thermalBegin()
+{
+    thermalInit(thermalPi);
+    thermalRead.state = I2C_IDLE;
+    ledcSetup(THERMAL_FAN_CHANNEL, THERMAL_FAN_HZ, 8);
+    ledcAttachPin(FAN_PIN, THERMAL_FAN_CHANNEL);
+    ledcWrite(THERMAL_FAN_CHANNEL, 0);
+}
+
+// Called from loop().
+void thermalService()
+{
+    unsigned long now = millis();
+    if (now - thermalLastTick < THERMAL_TICK_MS)
+    {
+        return;
+    }
+    thermalLastTick = now;
+    thermalPollSensor(now);
+
+    sPowerEstimate estimate = powerEstimate((const uint8_t *)leds, NUM_LEDS);
+    thermalLoadMa = estimateMa(estimate, FastLED.getBrightness());
+    if (thermalLoadMa > thermalOut.budgetMa)
+    {
+        thermalLoadMa = thermalOut.budgetMa; // what the limiter lets through
+    }
+
+    uint32_t readAt = thermalReadAt;
+    float tempC = (readAt == 0 || now - readAt > THERMAL_STALE_MS) ? NAN : thermalReadingC;
+    uint32_t budget = thermalOut.budgetMa;
+    thermalOut = thermalStep(thermalPi, tempC, thermalLoadMa, MAX_CURRENT, THERMAL_TICK_MS / 1000.0f);
+    ledcWrite(THERMAL_FAN_CHANNEL, thermalOut.fanDuty);
+    if (thermalOut.budgetMa != budget)
+    {
+        FastLED.setMaxPowerInVoltsAndMilliamps(NUM_VOLTS, thermalOut.budgetMa);
+        ledOutputInvalidate();
+    }
+
+    if (readAt != thermalShownAt)
+    {
+        thermalShownAt = readAt;
+        FixedString<32> text;
+        text.appendFixed(lroundf(tempC * 10), 1).append(" C / ");
+        text.appendFixed(lroundf(celsiusToFahrenheit(tempC) * 10), 1).append(" F");
+        g_temperature = text.c_str();
+    }
+}
+
+void handleThermal(AsyncWebServerRequest *request)
+{
+    AsyncResponseStream *response = request->beginResponseStream("application/json");
+    response->printf("{\"tempC\":%.2f,\"setC\":%.1f,\"fresh\":%s,\"readErrors\":%u,\"fanDuty\":%u,"
+                     "\"budgetMa\":%u,\"loadMa\":%u,\"maxCurrentMa\":%d,\"output\":%.3f}",
+                     isnan(thermalReadingC) ? 0.0f : thermalReadingC, THERMAL_SET_C,
+                     millis() - thermalReadAt <= THERMAL_STALE_MS && thermalReadAt ? "true" : "false",
+                     thermalReadErrors, thermalOut.fanDuty, thermalOut.budgetMa, thermalLoadMa, MAX_CURRENT,
+                     thermalPi.output);
+    request->send(response);
+}
+
+#else
+
+void thermalBegin() {}
+void thermalService() {}
+void handleThermal(AsyncWebServerRequest *request) { request->send(404, "text/plain", "Temperature sensor disabled"); }
+
+#endif
@@ -0,0 +1,234 @@
+/*+===================================================================
+  File:      udpFastPath.h
+
+  Summary:   Optional UDP broadcast channel on the SoftAP for time
+             critical cues and sync beacons (USE_UDP_FASTPATH).
+
+             The master broadcasts every show cue once, as
+             UDP_COPIES spaced copies, so one slow station's TCP
+             retransmits can't hold up the others and N subs don't
+             mean N copies over the air. Subs drop the repeats, run
+             the cue and track master time from the beacons.
+
+             WebSocket stays for control, acks and bulk data; a sub
+             connected both ways dedups each path on its own.
+
+  10/19/2026.
+===================================================================+*/
+
+#include <Arduino.h>
+#include <udpProtocol.h>
+
+// externs
+extern bool g_isAccessPoint;
+extern volatile bool g_masterArmed;
+
+#if USE_UDP_FASTPATH
+#include <AsyncUDP.h>
+
+#define UDP_RX_QUEUE 16
+#define UDP_REPEAT_SLOTS 16 // copies waiting to go out
+
+struct sUdpRepeat
+{
+    uint8_t data[UDP_MAX_PACKET];
+    uint8_t length;
+    uint8_t copy;
+    uint32_t dueMs;
+};
+
+struct sUdpRx
+{
+    uint8_t data[UDP_MAX_PACKET];
+    uint8_t length;
+    uint32_t receivedMs;
+    uint32_t fromIp;
+};
+
+// globals
+int32_t g_masterOffsetMs = 0; // master millis() - ours, subs only.
+bool g_masterClockValid = false;
+
+// locals
+AsyncUDP udpFast;
+QueueHandle_t udpRxQueue = nullptr;
+TaskHandle_t udpLoopTask = nullptr; // woken when a packet arrives, see loop()
+sCueReceiver udpCueRx;
+sUdpClock udpClock;
+sUdpRepeat udpRepeats[UDP_REPEAT_SLOTS];
+uint16_t udpNextSeq = 0;
+uint32_t udpEpoch = 0; // ours on the master, see udpProtocol.h
+unsigned long udpLastSyncAt = 0;
+bool udpSentArmed = false;
+bool udpFastStarted = false; // no sends before the network is up, see bootSequencer.h
+
+void udpSend(const uint8_t *data, size_t length)
+{
+    if (!udpFastStarted)
+    {
+        return;
+    }
+    udpFast.broadcastTo((uint8_t *)data, length, UDP_FAST_PORT, TCPIP_ADAPTER_IF_AP);
+}
+
+void udpFastBegin()
+{
+    cueReceiverInit(udpCueRx);
+    memset(&udpClock, 0, sizeof(udpClock));
+    udpEpoch = esp_random();
+    udpFastStarted = true;
+    if (g_isAccessPoint)
+    {
+        return; // the master only sends.
+    }
+
+    udpRxQueue = xQueueCreate(UDP_RX_QUEUE, sizeof(sUdpRx));
+    udpLoopTask = xTaskGetCurrentTaskHandle(); // called on the loop task, see bootService()
+    if (udpFast.listen(UDP_FAST_PORT))
+    {
+        // lwIP task: copy out and let loop() deal with it.
+        udpFast.onPacket([](AsyncUDPPacket &packet)
+                         {
+            sUdpRx rx;
+            if (packet.length() > sizeof(rx.data))
+            {
+                return;
+            }
+            rx.length = packet.length();
+            rx.receivedMs = millis();
+            rx.fromIp = packet.remoteIP();
+            memcpy(rx.data, packet.data(), rx.length);
+            xQueueSend(udpRxQueue, &rx, 0);
+            xTaskNotifyGive(udpLoopTask); });
+        Serial.printf("UDP fast path listening on %u\n", UDP_FAST_PORT);
+    }
+}
+
+// Master: broadcast a cue now, the other copies follow from udpFastService().
+void udpBroadcastCue(uint8_t type, uint8_t channel, uint16_t param, bool live)
+{
+    if (!g_isAccessPoint)
+    {
+        return;
+    }
+
+    sUdpCue cue = {type, channel, param, (uint8_t)(live ? UDP_CUE_LIVE : 0)};
+    uint16_t seq = udpNextSeq++;
+    uint32_t now = millis();
+    uint8_t first[UDP_MAX_PACKET];
+    udpSend(first, udpBuild(first, UDP_CUE, udpEpoch, seq, 0, now, &cue, sizeof(cue)));
+
+    for (uint8_t copy = 1; copy < UDP_COPIES; copy++)
+    {
+        for (sUdpRepeat &repeat : udpRepeats)
+        {
+            if (repeat.length == 0)
+            {
+                repeat.length = udpBuild(repeat.data, UDP_CUE, udpEpoch, seq, copy, now, &cue, sizeof(cue));
+                repeat.copy = copy;
+                repeat.dueMs = now + copy * UDP_REPEAT_MS;
+                break;
+            }
+        }
+    }
+}
+
+bool udpFastBusy()
+{
+    for (const sUdpRepeat &repeat : udpRepeats)
+    {
+        if (repeat.length != 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Master time as seen from here, falls back to our own clock until a beacon arrives.
+uint32_t udpMasterMillis()
+{
+    return millis() + (g_masterClockValid ? g_masterOffsetMs : 0);
+}
+
+void udpHandlePacket(const sUdpRx &rx)
+{
+    sUdpHeader header;
+    const uint8_t *body;
+    if (!udpParse(rx.data, rx.length, header, &body))
+    {
+        return;
+    }
+    if (cueEpoch(udpCueRx, header.epoch))
+    {
+        memset(&udpClock, 0, sizeof(udpClock)); // the master restarted: new seqs, new millis()
+    }
+
+    if (header.type == UDP_CUE && header.length == sizeof(sUdpCue))
+    {
+        if (!cueReceive(udpCueRx, header.seq))
+        {
+            return; // a repeat.
+        }
+        sUdpCue cue;
+        memcpy(&cue, body, sizeof(cue));
+        sShowCue showCue = {0, cue.type, cue.channel, cue.param};
+        executeCue(showCue, cue.flags & UDP_CUE_LIVE);
+    }
+    else if (header.type == UDP_SYNC && header.length == sizeof(sUdpSync) && header.copy == 0)
+    {
+        g_masterOffsetMs = udpClockSample(udpClock, header.masterMs, rx.receivedMs);
+        g_masterClockValid = true;
+        if (rx.fromIp == (uint32_t)WiFi.gatewayIP())
+        {
+            sUdpSync sync;
+            memcpy(&sync, body, sizeof(sync));
+            fireMasterBeacon(sync.armed); // only our own master keeps the igniters live
+        }
+    }
+}
+
+// Called from loop(): master sends due copies and beacons, subs run what arrived.
+void udpFastService()
+{
+    if (!g_isAccessPoint)
+    {
+        sUdpRx rx;
+        while (udpRxQueue && xQueueReceive(udpRxQueue, &rx, 0) == pdTRUE)
+        {
+            udpHandlePacket(rx);
+        }
+        return;
+    }
+
+    uint32_t now = millis();
+    for (sUdpRepeat &repeat : udpRepeats)
+    {
+        if (repeat.length != 0 && (int32_t)(now - repeat.dueMs) >= 0)
+        {
+            udpSend(repeat.data, repeat.length);
+            repeat.length = 0;
+        }
+    }
+
+    // A flipped arm switch goes out straight away.
+    bool armed = g_masterArmed;
+    if (now - udpLastSyncAt >= UDP_SYNC_MS || armed != udpSentArmed)
+    {
+        udpLastSyncAt = now;
+        udpSentArmed = armed;
+        sUdpSync sync = {showPosition(), g_showRunning, armed};
+        uint8_t packet[UDP_MAX_PACKET];
+        udpSend(packet, udpBuild(packet, UDP_SYNC, udpEpoch, 0, 0, now, &sync, sizeof(sync)));
+    }
+}
+
+#else
+
+void udpFastBegin() {}
+void udpBroadcastCue(uint8_t type, uint8_t channel, uint16_t param, bool live) {}
+bool udpFastBusy() { return false; }
+uint32_t udpMasterMillis() { return millis(); }
+void udpFastService() {}
+
+#endif
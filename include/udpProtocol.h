@@ -0,0 +1,132 @@
+/*+===================================================================
+  File:      udpProtocol.h
+
+  Summary:   Packet format for the UDP fast path (udpFastPath.h):
+             one broadcast datagram reaches every sub on the SoftAP.
+
+                sUdpHeader  16 bytes
+                body        sUdpCue or sUdpSync
+
+             Cues are sent UDP_COPIES times a few ms apart instead of
+             being acked, every copy carries the same seq and the
+             receiver drops repeats with the same dedup window as the
+             WebSocket channel (sCueReceiver in reliableCue.h).
+
+             Every packet carries the master's epoch, random per
+             boot. Its seqs and millis() start over when it restarts,
+             so a sub that sees a new epoch resets its dedup window
+             and clock estimate.
+
+             Sync beacons carry the master's millis(), show position
+             and arm switch (fireChannels.h). Subs keep the largest master - local offset
+             seen over the last few beacons, the copy that spent the
+             least time in flight, as their estimate of master time.
+
+             No Arduino dependencies (needs reliableCue.h first) so
+             tools/udpbench.cpp can use it on the host.
+
+  10/19/2026.
+===================================================================+*/
+
+#include <stdint.h>
+#include <string.h>
+
+#define UDP_FAST_PORT 4210
+#define UDP_MAGIC 0x5742 // "BW" on the wire
+#define UDP_VERSION 4
+#define UDP_COPIES 3       // each cue is broadcast this many times
+#define UDP_REPEAT_MS 4    // gap between copies, spreads them past short bursts of loss
+#define UDP_SYNC_MS 250    // beacon interval
+#define UDP_CLOCK_SAMPLES 8
+#define UDP_MAX_PACKET 32
+#define UDP_CUE_LIVE 0x01  // sUdpCue.flags: from a running show, the only cues a sub may fire from
+
+enum UdpPacketType
+{
+    UDP_CUE = 1,
+    UDP_SYNC = 2
+};
+
+struct __attribute__((packed)) sUdpHeader
+{
+    uint16_t magic;
+    uint8_t version;
+    uint8_t type;      // UdpPacketType.
+    uint16_t seq;      // cue sequence, shared by all copies of one cue.
+    uint8_t copy;      // 0 .. UDP_COPIES - 1.
+    uint8_t length;    // body bytes.
+    uint32_t masterMs; // master millis() when the first copy went out.
+    uint32_t epoch;    // random per master boot.
+};
+
+// Same fields as sShowCue, minus the time: it's due now.
+struct __attribute__((packed)) sUdpCue
+{
+    uint8_t type; // CueType.
+    uint8_t channel;
+    uint16_t param;
+    uint8_t flags; // UDP_CUE_*
+};
+
+struct __attribute__((packed)) sUdpSync
+{
+    uint32_t showPositionMs;
+    uint8_t showRunning;
+    uint8_t armed; // the master's arm switch
+};
+
+struct sUdpClock
+{
+    int32_t offsets[UDP_CLOCK_SAMPLES]; // master - local, ms.
+    uint8_t count;
+    uint8_t next;
+};
+
+static_assert(sizeof(sUdpHeader) == 16, "udp header layout");
+
+// Build a packet into buf (at least UDP_MAX_PACKET bytes). Returns its length.
+size_t udpBuild(uint8_t *buf, uint8_t type, uint32_t epoch, uint16_t seq, uint8_t copy, uint32_t masterMs,
+                const void *body, uint8_t length)
+{
+    sUdpHeader header = {UDP_MAGIC, UDP_VERSION, type, seq, copy, length, masterMs, epoch};
+    memcpy(buf, &header, sizeof(header));
+    memcpy(buf + sizeof(header), body, length);
+    return sizeof(header) + length;
+}
+
+// Validate a received datagram. body points into data.
+bool udpParse(const uint8_t *data, size_t len, sUdpHeader &header, const uint8_t **body)
+{
+    if (len < sizeof(sUdpHeader))
+    {
+        return false;
+    }
+    memcpy(&header, data, sizeof(header));
+    if (header.magic != UDP_MAGIC || header.version != UDP_VERSION || sizeof(header) + header.length > len)
+    {
+        return false;
+    }
+    *body = data + sizeof(header);
+    return true;
+}
+
+// Record a beacon, returns the current master - local estimate.
+int32_t udpClockSample(sUdpClock &clock, uint32_t masterMs, uint32_t localMs)
+{
+    clock.offsets[clock.next] = (int32_t)(masterMs - localMs);
+    clock.next = (clock.next + 1) % UDP_CLOCK_SAMPLES;
+    if (clock.count < UDP_CLOCK_SAMPLES)
+    {
+        clock.count++;
+    }
+
+    int32_t best = clock.offsets[0];
+    for (uint8_t i = 1; i < clock.count; i++)
+    {
+        if (clock.offsets[i] > best)
+        {
+            best = clock.offsets[i];
+        }
+    }
+    return best;
+}
@@ -0,0 +1,283 @@
+/*+===================================================================
+  File:      wsSessions.h
+
+  Summary:   WebSocket session table. Each connected client has a
+             role and a set of subscribed topics, and wsPublish()
+             only sends a topic to its subscribers: one bitmask of
+             session slots per topic, so a publish walks the set
+             bits and nothing else.
+
+             Clients pick a role (which also sets default topics)
+             and adjust topics with text messages:
+
+                role:sub | role:ui | role:monitor | role:master
+                sub:status,cues      unsub:frames
+
+             Sessions keep the client's id, never its pointer: the
+             AsyncTCP task frees a client the moment it disconnects,
+             so anything sent from loop() goes through ws by id and
+             finds nothing for a client that has gone.
+
+             New clients start as UI with status and cues, which is
+             what the control page expects. Subs get fire cues on the
+             acknowledged channel in cueChannel.h instead.
+
+             role:master is only taken on a sub, from the address of
+             the SoftAP it joined. It's what fireChannels.h asks for
+             before it will arm or fire.
+
+  10/19/2026.
+===================================================================+*/
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include <WiFi.h>
+
+#define WS_MAX_SESSIONS 8 // AsyncWebSocket's own client limit on ESP32
+
+enum WsRole
+{
+    ROLE_UI = 0,  // phone / browser control page
+    ROLE_SUB = 1, // sub-controller
+    ROLE_MONITOR = 2,
+    ROLE_MASTER = 3 // our master, connected to a sub
+};
+
+enum WsTopic
+{
+    TOPIC_STATUS = 0,    // client counts, connectivity
+    TOPIC_FRAMES = 1,    // LED frame data for subs
+    TOPIC_CUES = 2,      // fire / cue notices
+    TOPIC_TELEMETRY = 3, // mem: and other periodic stats
+    TOPIC_COUNT
+};
+
+#define TOPIC_BIT(t) (1 << (t))
+
+struct sWsSession
+{
+    bool open; // false = free slot.
+    uint32_t id;
+    uint8_t role;
+    uint8_t topics;   // TOPIC_BIT mask.
+    uint16_t dropped; // messages skipped because its queue was full.
+    unsigned long connectedAt;
+};
+
+// Prototypes
+void cueChannelAttach(uint8_t slot, bool attach);
+bool cueChannelAck(uint8_t slot, const char *text);
+
+// externs
+extern bool g_isAccessPoint;
+extern AsyncWebSocket ws;
+extern int g_total_clients;
+extern volatile uint32_t g_statusVersion;
+
+// globals
+uint16_t g_wsDropped = 0;
+
+// locals
+sWsSession wsSessions[WS_MAX_SESSIONS];
+uint8_t wsTopicMask[TOPIC_COUNT]; // bit n = session slot n subscribed.
+uint8_t wsSessionCount = 0;
+uint32_t wsStatusSent = 0;
+portMUX_TYPE wsSessionLock = portMUX_INITIALIZER_UNLOCKED;
+
+const char *const wsTopicNames[TOPIC_COUNT] = {"status", "frames", "cues", "telemetry"};
+const char *const wsRoleNames[] = {"ui", "sub", "monitor", "master"};
+const uint8_t wsRoleTopics[] = {
+    TOPIC_BIT(TOPIC_STATUS) | TOPIC_BIT(TOPIC_CUES),
+    TOPIC_BIT(TOPIC_FRAMES), // subs get cues reliably through cueChannel.h
+    TOPIC_BIT(TOPIC_STATUS) | TOPIC_BIT(TOPIC_TELEMETRY),
+    TOPIC_BIT(TOPIC_STATUS)};
+
+int sessionFind(uint32_t id)
+{
+    for (int slot = 0; slot < WS_MAX_SESSIONS; slot++)
+    {
+        if (wsSessions[slot].open && wsSessions[slot].id == id)
+        {
+            return slot;
+        }
+    }
+    return -1;
+}
+
+// Rebuild the per-topic masks for one slot from its topic bits.
+void sessionSetTopics(int slot, uint8_t topics)
+{
+    portENTER_CRITICAL(&wsSessionLock);
+    wsSessions[slot].topics = topics;
+    for (int t = 0; t < TOPIC_COUNT; t++)
+    {
+        if (topics & TOPIC_BIT(t))
+        {
+            wsTopicMask[t] |= (1 << slot);
+        }
+        else
+        {
+            wsTopicMask[t] &= ~(1 << slot);
+        }
+    }
+    portEXIT_CRITICAL(&wsSessionLock);
+}
+
+void sessionOpen(AsyncWebSocketClient *client)
+{
+    for (int slot = 0; slot < WS_MAX_SESSIONS; slot++)
+    {
+        if (!wsSessions[slot].open)
+        {
+            wsSessions[slot].id = client->id();
+            wsSessions[slot].role = ROLE_UI;
+            wsSessions[slot].dropped = 0;
+            wsSessions[slot].connectedAt = millis();
+            wsSessions[slot].open = true;
+            sessionSetTopics(slot, wsRoleTopics[ROLE_UI]);
+            wsSessionCount++;
+            g_statusVersion++;
+            return;
+        }
+    }
+    logEvent(LOG_WS_FULL, client->id());
+}
+
+void sessionClose(uint32_t id)
+{
+    int slot = sessionFind(id);
+    if (slot < 0)
+    {
+        return;
+    }
+    sessionSetTopics(slot, 0);
+    if (wsSessions[slot].role == ROLE_SUB)
+    {
+        cueChannelAttach(slot, false);
+    }
+    wsSessions[slot].open = false;
+    wsSessionCount--;
+    g_statusVersion++;
+}
+
+// Comma separated topic names to a TOPIC_BIT mask.
+uint8_t sessionParseTopics(const char *list)
+{
+    uint8_t topics = 0;
+    while (*list)
+    {
+        for (int t = 0; t < TOPIC_COUNT; t++)
+        {
+            size_t len = strlen(wsTopicNames[t]);
+            if (strncmp(list, wsTopicNames[t], len) == 0 && (list[len] == ',' || list[len] == 0))
+            {
+                topics |= TOPIC_BIT(t);
+            }
+        }
+        const char *comma = strchr(list, ',');
+        list = comma ? comma + 1 : list + strlen(list);
+    }
+    return topics;
+}
+
+// Handles role:/sub:/unsub: and cue acks. Returns false if text isn't a session command.
+bool sessionCommand(AsyncWebSocketClient *client, const char *text)
+{
+    int slot = sessionFind(client->id());
+    if (slot < 0)
+    {
+        return false;
+    }
+
+    if (strncmp(text, "role:", 5) == 0)
+    {
+        for (uint8_t role = 0; role < ARRAY_LENGTH(wsRoleNames); role++)
+        {
+            if (strcmp(text + 5, wsRoleNames[role]) == 0)
+            {
+                if (role == ROLE_MASTER && (g_isAccessPoint || client->remoteIP() != WiFi.gatewayIP()))
+                {
+                    break; // only the AP we joined is our master
+                }
+                if ((role == ROLE_SUB) != (wsSessions[slot].role == ROLE_SUB))
+                {
+                    cueChannelAttach(slot, role == ROLE_SUB);
+                }
+                wsSessions[slot].role = role;
+                sessionSetTopics(slot, wsRoleTopics[role]);
+                client->text("OK");
+                return true;
+            }
+        }
+        client->text("Bad role");
+        return true;
+    }
+    if (wsSessions[slot].role == ROLE_SUB && cueChannelAck(slot, text))
+    {
+        return true;
+    }
+    if (strncmp(text, "sub:", 4) == 0)
+    {
+        sessionSetTopics(slot, wsSessions[slot].topics | sessionParseTopics(text + 4));
+        client->text("OK");
+        return true;
+    }
+    if (strncmp(text, "unsub:", 6) == 0)
+    {
+        sessionSetTopics(slot, wsSessions[slot].topics & ~sessionParseTopics(text + 6));
+        client->text("OK");
+        return true;
+    }
+    return false;
+}
+
+bool sessionIsMaster(uint32_t id)
+{
+    int slot = sessionFind(id);
+    return slot >= 0 && wsSessions[slot].role == ROLE_MASTER;
+}
+
+// Send msg to every session subscribed to topic, skipping any whose queue is full.
+void wsPublish(uint8_t topic, const char *msg)
+{
+    uint32_t ids[WS_MAX_SESSIONS];
+    uint8_t slots[WS_MAX_SESSIONS];
+    uint8_t count = 0;
+
+    portENTER_CRITICAL(&wsSessionLock);
+    uint8_t mask = wsTopicMask[topic];
+    while (mask)
+    {
+        uint8_t slot = __builtin_ctz(mask);
+        mask &= mask - 1;
+        slots[count] = slot;
+        ids[count++] = wsSessions[slot].id;
+    }
+    portEXIT_CRITICAL(&wsSessionLock);
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        if (!ws.availableForWrite(ids[i]))
+        {
+            wsSessions[slots[i]].dropped++;
+            g_wsDropped++;
+            continue;
+        }
+        ws.text(ids[i], msg); // a client gone since the lock was released is just not found
+    }
+}
+
+// Called from loop(), pushes a status line once per client-count change.
+void sessionService()
+{
+    uint32_t version = g_statusVersion;
+    if (version == wsStatusSent)
+    {
+        return;
+    }
+    wsStatusSent = version;
+
+    FixedString<48> status("status:stations=");
+    status.appendUInt(g_total_clients).append(",ws=").appendUInt(wsSessionCount);
+    wsPublish(TOPIC_STATUS, status.c_str());
+}
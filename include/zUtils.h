@@ -3,61 +3,25 @@
 namespace zUtils
 {
 
-    String getLongTime()
+    // Uptime strings are built in place, no heap (formats in fixedString.h).
+    TimeString getLongTime()
     {
-        unsigned long currentMillis = millis();
-        unsigned long seconds = currentMillis / 1000;
-        unsigned long minutes = seconds / 60;
-        unsigned long hours = minutes / 60;
-        unsigned long days = hours / 24;
-        currentMillis %= 1000;
-        seconds %= 60;
-        minutes %= 60;
-        hours %= 24;
-        String time = String(days) + "d " + String(hours) + ":" + String(minutes) + ":" + String(seconds) + ":" + String(currentMillis) + "ms";
-        return time;
+        return formatLongTime(millis());
     }
 
-    String getMidTime()
+    TimeString getMidTime()
     {
-        unsigned long currentMillis = millis();
-        unsigned long seconds = currentMillis / 1000;
-        unsigned long minutes = seconds / 60;
-        unsigned long hours = minutes / 60;
-        unsigned long days = hours / 24;
-        currentMillis %= 1000;
-        seconds %= 60;
-        minutes %= 60;
-        hours %= 24;
-        String time = String(days) + "d " + String(hours) + ":" + String(minutes) + ":" + String(seconds) + "s ";
-        return time;
+        return formatMidTime(millis());
     }
 
-    String getShortTime()
+    TimeString getShortTime()
     {
-        unsigned long currentMillis = millis();
-        unsigned long seconds = currentMillis / 1000;
-        unsigned long minutes = seconds / 60;
-        unsigned long hours = minutes / 60;
-        unsigned long days = hours / 24;
-        currentMillis %= 1000;
-        seconds %= 60;
-        minutes %= 60;
-        hours %= 24;
-        String time = String(days) + "d " + String(hours) + "h " + String(minutes) + " m";
-        return time;
+        return formatShortTime(millis());
     }
 
-    String getMinSec()
+    TimeString getMinSec()
     {
-        unsigned long currentMillis = millis();
-        unsigned long seconds = currentMillis / 1000;
-        unsigned long minutes = seconds / 60;
-        currentMillis %= 1000;
-        seconds %= 60;
-        minutes %= 60;
-        String time = String(minutes) + "m " + String(seconds) + "s ";
-        return time;
+        return formatMinSec(millis());
     }
 
     void getChipInfo()
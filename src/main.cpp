@@ -4,7 +4,7 @@
   
   Template: ESP32 Project template with builtin OTA,
             HTTP Server, WiFi connectivity and About page.
-            Only manual OTA updates (/update) are supported.
+            OTA updates are streamed to POST /api/ota.
 
             This is specifcally for the wide/skinny
             oled display as seen in readme.md.
@@ -62,6 +62,7 @@
                 pio run -t upload -e heltec_wifi_kit_32 --upload-port COM6
                 pio run -t upload -e fm-dev-kit
                 pio run -t upload -e fm-dev-kit --upload-port COM6
+                pio run -t upload -e kitchen      (install profiles, see installProfile.h)
 
              List targets: pio run --list-targets
 
@@ -82,12 +83,33 @@
 
 #define FASTLED_INTERNAL // Quiets build noise
 #include <globalConfig.h>
+#include <fixedString.h>
+#include <eventLog.h>
+#include <healthMonitor.h>
+#include <audioReactive.h>
 #include <LEDController.h>
+#include <presetStore.h>
+#include <hardwareInput.h>
+#include <fireChannels.h>
+#include <showFile.h>
+#include <bakedClip.h>
 #include <Arduino.h>
 #include "SPIFFS.h"
 #include <zUtils.h>
 #include <localWiFi.h>
+#include <otaUpdate.h>
+#include <wsSessions.h>
+#include <cueChannel.h>
+#include <udpFastPath.h>
+#include <dmxReceiver.h>
+#include <i2cBus.h>
+#include <thermalGovernor.h>
+#include <effectCheck.h>
+#include <controlApi.h>
+#include <subDiscovery.h>
+#include <bootSequencer.h>
 #include <asyncWebServer.h>
+#include <memTelemetry.h>
 #include <FastLED.h>
 #include <oled.h>
 
@@ -110,6 +132,9 @@ extern int g_lineHeight;
 // Prototypes
 String checkSPIFFS();
 void printDisplayMessage(String msg);
+void oledPush();
+void startNetwork();
+void finishNetwork();
 uint8_t getBrigtnessLimit();
 void checkBriteKnob();
 float celsiusToFahrenheit(float c);
@@ -117,81 +142,121 @@ float celsiusToFahrenheit(float c);
 // Locals
 const int activityLED = 25;
 unsigned long lastUpdate = 0;
-
-float EMA_a = 0.8; // Smoothing
-int EMA_S = 0;     // Smoothing
+uint32_t statusDrawn = 0; // g_statusVersion last shown on the display
 
 void setup()
 {
     /*--------------------------------------------------------------------
-     Boot, OLED and I/O initialization.
+     Boot, strip first. See bootSequencer.h for the order.
     ---------------------------------------------------------------------*/
     Serial.begin(115200);
     Serial.println();
     Serial.println("Booting...");
+    logBegin();
+    healthBegin(); // last boot's stalls, then the watchdog
+    fireBegin(); // firing outputs held off before anything slower
+
+    /*--------------------------------------------------------------------
+     LEDs and the last saved scene, first light.
+    ---------------------------------------------------------------------*/
+    int stage = bootBegin("leds");
+    FastLED.addLeds<WS2812B, DATA_PIN, GRB>(leds, NUM_LEDS);
+    FastLED.setMaxPowerInVoltsAndMilliamps(NUM_VOLTS, MAX_CURRENT);
+    FastLED.setBrightness(180);
+    FastLED.setCorrection(Halogen);
+    pinMode(RND_PIN, INPUT);
+    randomSeed(analogRead(RND_PIN));
+    FastLED.clear();
+    bootEnd(stage);
+    effectCheckBoot(); // before anything draws, effects must start cold
+    random16_add_entropy(random()); // effects draw from random16(), don't repeat every boot
+
+    stage = bootBegin("scene");
+    presetBegin(); // restore the last scene saved to NVS
+    ledShow();
+    ledFlush(); // now, not at the end of the first loop()
+    bootEnd(stage);
+    bootFirstLight();
 
     /*--------------------------------------------------------------------
      Choose display based on the built type.
     ---------------------------------------------------------------------*/
+    stage = bootBegin("display");
 #if defined(heltec_wifi_kit_32)
     g_OLED.begin();
     g_OLED.clear();
+    i2cBusBegin(); // the display's begin() brought Wire up, from here on only the bus task touches it
     g_OLED.setFont(u8g2_font_profont15_tf);
     g_lineHeight = g_OLED.getFontAscent() - g_OLED.getFontDescent();
     g_OLED.clearBuffer();
     g_OLED.setCursor(0, g_lineHeight);
     g_OLED.printf("Connecting to WiFi...");
-    g_OLED.sendBuffer();
+    oledPush();
 #else
     display.begin(SSD1306_SWITCHCAPVCC, OLED_ADDR);
+    i2cBusBegin(); // the display's begin() brought Wire up, from here on only the bus task touches it
+    printDisplayMessage("Wifi...");
 #endif
+    bootEnd(stage);
 
     /*--------------------------------------------------------------------
-    Update heltec oled every second
+     Local I/O and services, none of them need the network.
     ---------------------------------------------------------------------*/
-#if defined(heltec_wifi_kit_32)
-    g_OLED.clearBuffer();
-    g_OLED.setCursor(0, g_lineHeight);
-    g_OLED.printf("IP: %s", globalIP.c_str());
-    g_OLED.setCursor(0, g_lineHeight * 2);
-    g_OLED.printf("%s", hostName.c_str());
-    g_OLED.setCursor(0, g_lineHeight * 3);
-    g_OLED.printf("SSID: %s", ssid.c_str());
-    g_OLED.setCursor(0, g_lineHeight * 4);
-    g_OLED.printf("Connected: %s", String(isWiFiConnected()).c_str());
-    g_OLED.sendBuffer();
-    lastUpdate = millis();
-#else
-    printDisplayMessage("Boot...");
-#endif
-
-    zUtils::getChipInfo();
+    stage = bootBegin("local");
     pinMode(activityLED, OUTPUT);
     digitalWrite(activityLED, LOW);
+    showBegin();
+    audioBegin();
+    memBegin();
+    thermalBegin();
+    cueChannelBegin(); // before any client can attach as a sub
+    inputBegin(); // knob and colour button, sampled off the loop
+    bootEnd(stage);
 
     /*--------------------------------------------------------------------
-     Start WiFi & OTA HTTP update server
+     WiFi, mDNS, HTTP and WebSocket in the background.
     ---------------------------------------------------------------------*/
-    printDisplayMessage("Wifi...");
-    startWifi();
-    printDisplayMessage("Server...");
-    startWebServer();
-    startWebSocketServer();
+    bootNetworkStart(startNetwork, finishNetwork);
+}
 
-    /*--------------------------------------------------------------------
-     Project specific setup code
-    ---------------------------------------------------------------------*/
-    FastLED.addLeds<WS2812B, DATA_PIN, GRB>(leds, NUM_LEDS);
-    FastLED.setMaxPowerInVoltsAndMilliamps(NUM_VOLTS, MAX_CURRENT);
-    FastLED.setBrightness(180);
-    FastLED.setCorrection(Halogen);
-    pinMode(RND_PIN, INPUT);
-    randomSeed(analogRead(RND_PIN));
-    FastLED.clear();
-    FastLED.show();
+// On the net task, nothing here may hold up the strip.
+void startNetwork()
+{
+    int stage = bootBegin("chip info");
+    zUtils::getChipInfo();
+    bootEnd(stage);
+
+    stage = bootBegin("spiffs");
+    healthEnter(HEALTH_BOOT, "checkSPIFFS", 30000); // the first mount formats, that takes a while
+    Serial.println(checkSPIFFS()); // clips live on SPIFFS, nothing asks for one before HTTP is up
+    healthLeave(HEALTH_BOOT);
+    bootEnd(stage);
+
+    stage = bootBegin("wifi");
+    {
+        sHealthScope health(HEALTH_BOOT, "startWifi", 60000); // startWifi() restarts by itself after 45 s
+        startWifi();
+        discoveryAdvertise();
+    }
+    bootEnd(stage);
+
+    stage = bootBegin("http");
+    {
+        sHealthScope health(HEALTH_BOOT, "startWebServer");
+        startWebServer();
+        startWebSocketServer();
+    }
+    bootEnd(stage);
+}
 
-    // pot smoothing
-    EMA_S = analogRead(BRITE_KNOB_PIN);
+// Back on the loop task once the net task is done: the listeners that wake loop().
+void finishNetwork()
+{
+    int stage = bootBegin("udp");
+    udpFastBegin();
+    dmxBegin();
+    discoveryBegin();
+    bootEnd(stage);
 }
 
 void printDisplayMessage(String msg)
@@ -200,14 +265,24 @@ void printDisplayMessage(String msg)
     g_OLED.clearBuffer();
     g_OLED.setCursor(0, g_lineHeight);
     g_OLED.printf(msg.c_str());
-    g_OLED.sendBuffer();
+    oledPush();
 #else
     display.clearDisplay();
     display.setTextSize(2);
     display.setTextColor(WHITE);
     display.setCursor(0, 0);
     display.println(msg);
-    display.display();
+    oledPush();
+#endif
+}
+
+// Hand the framebuffer to the bus task, only the chunks that changed go out.
+void oledPush()
+{
+#if defined(heltec_wifi_kit_32)
+    i2cDisplayPush(g_OLED.getBufferPtr());
+#else
+    i2cDisplayPush(display.getBuffer());
 #endif
 }
 
@@ -217,6 +292,13 @@ void printDefaultStatusMessage()
     // If we are the master, show number of clients connected.
     // If we are a clieint, show whether we are connected or not (1/0).
     // simplify, this is dumb and messy
+    // Only redraws when g_statusVersion moves (WiFi/WebSocket events), at most once a second.
+    if (!bootNetworkUp() || g_statusVersion == statusDrawn || millis() - lastUpdate < 1000)
+    {
+        return;
+    }
+    statusDrawn = g_statusVersion;
+
     String connected;
     if (isWiFiConnected() && !g_isAccessPoint)
     {
@@ -244,20 +326,16 @@ void printDefaultStatusMessage()
     }
 
 #if defined(heltec_wifi_kit_32)
-    if (millis() - lastUpdate > 1000)
-    {
-        g_OLED.clearBuffer();
-        g_OLED.setCursor(0, g_lineHeight);
-        g_OLED.printf("IP: %s", globalIP.c_str());
-        g_OLED.setCursor(0, g_lineHeight * 2);
-        g_OLED.printf("%s", hostName.c_str());
-        g_OLED.setCursor(0, g_lineHeight * 3);
-        g_OLED.printf("SSID: %s", ssid.c_str());
-        g_OLED.setCursor(0, g_lineHeight * 4);
-        g_OLED.printf(connected.c_str());
-        g_OLED.sendBuffer();
-        lastUpdate = millis();
-    }
+    g_OLED.clearBuffer();
+    g_OLED.setCursor(0, g_lineHeight);
+    g_OLED.printf("IP: %s", globalIP.c_str());
+    g_OLED.setCursor(0, g_lineHeight * 2);
+    g_OLED.printf("%s", hostName.c_str());
+    g_OLED.setCursor(0, g_lineHeight * 3);
+    g_OLED.printf("SSID: %s", ssid.c_str());
+    g_OLED.setCursor(0, g_lineHeight * 4);
+    g_OLED.printf(connected.c_str());
+    oledPush();
 #else
     // untested in this bworx project
     display.clearDisplay();
@@ -270,28 +348,62 @@ void printDefaultStatusMessage()
     display.setCursor(4, 0);
     display.print("Connected = ");
     display.println(connected.c_str());
-    display.display();
+    oledPush();
 #endif
+    lastUpdate = millis();
 }
 
 void loop()
 {
-    printDefaultStatusMessage();
+    healthEnter(HEALTH_RENDER, "loop");
+    HEALTH_CALL(HEALTH_RENDER, bootService());
+    HEALTH_CALL(HEALTH_RENDER, printDefaultStatusMessage());
+    HEALTH_CALL(HEALTH_RENDER, checkBriteKnob());
+    HEALTH_CALL(HEALTH_RENDER, presetService());
+    HEALTH_CALL(HEALTH_RENDER, restartService());
+    HEALTH_CALL(HEALTH_RENDER, memService());
+    HEALTH_CALL(HEALTH_RENDER, sessionService());
+    HEALTH_CALL(HEALTH_RENDER, cueChannelService());
+    HEALTH_CALL(HEALTH_RENDER, udpFastService());
+    HEALTH_CALL(HEALTH_RENDER, dmxService());
+    HEALTH_CALL(HEALTH_RENDER, thermalService());
 
     /*--------------------------------------------------------------------
      Project specific loop code
      ---------------------------------------------------------------------*/
 
+    // Run the loaded show if there is one playing.
+    HEALTH_CALL(HEALTH_RENDER, showService());
+
+    // Capture or play back a baked clip.
+    HEALTH_CALL(HEALTH_RENDER, clipService());
+
+    // Draw the live scene: preset recall, control panel, show scene cues.
+    HEALTH_CALL(HEALTH_RENDER, sceneService());
+
     // Tests that we can push data without a request from the client.
     // For example, tell the client to ignite morter/cans in order for now.
-    // Also turns on the corresponding LED on the strip.
-    EVERY_N_MILLISECONDS(3000)
+    // Also turns on the corresponding LED on the strip. UI notice only, not a cue: the subs never see it.
+    // Only while no scene is up, so it doesn't draw over one.
+    if (!g_showLoaded && !dmxActive() && g_mode == Off)
     {
-        notifyClients("Push Notice: Fire: Shell #" + String(firedLEDCount + 1)); // do this another way instead of sucking firedLEDCount of a header
-        fireLED(leds);
+        EVERY_N_MILLISECONDS(3000)
+        {
+            FixedString<48> notice("Push Notice: Fire: Shell #");
+            wsPublish(TOPIC_CUES, notice.appendUInt(firedLEDCount + 1).c_str()); // do this another way instead of sucking firedLEDCount of a header
+            if (profileHasEffect(EFX_FIRE_LED))
+            {
+                HEALTH_CALL(HEALTH_RENDER, fireLED(leds));
+            }
+        }
     }
 
-    delay(100); //  inhale
+    // One show() for everything drawn this pass, none if nothing changed.
+    HEALTH_CALL(HEALTH_RENDER, ledOutputService());
+    healthLeave(HEALTH_RENDER); // waiting for work isn't a stall
+
+    bool realtime = g_showRunning || g_clipPlaying || g_clipCapturing || g_mode == Animation || cueChannelBusy() || udpFastBusy();
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(realtime ? 1 : 100)); //  inhale, but not while cues or frames are due (UDP cues, DMX frames and inputs wake us early)
 }
 
 /*--------------------------------------------------------------------
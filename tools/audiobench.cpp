@@ -0,0 +1,274 @@
+/*+===================================================================
+  File:      audiobench.cpp
+
+  Summary:   Host runner for audioAnalysis.h. Feeds a 16 bit PCM
+             WAV file through the same Goertzel bank and beat
+             detector the device uses, prints beats (or every
+             block with -v) and the analysis cost per block.
+
+             --selftest runs synthetic input instead, 16 kHz with a
+             little noise:
+
+                steady    10 s sine tones on and between bins, no
+                          beats after the tone starts
+                bursts    80 Hz bursts every 0.5 s, every onset
+                          found within two blocks, nothing else
+                kicks     decaying 55 Hz kicks with a click at
+                          120 BPM, same
+
+  Building:  g++ -O2 -Iinclude tools/audiobench.cpp -o audiobench
+             ./audiobench song.wav [-v]
+             ./audiobench --selftest
+
+             The file should be 16kHz, the device's rate; other
+             rates still run but band centres shift accordingly.
+             Stereo files are analysed from the left channel.
+
+  10/19/2026.
+===================================================================+*/
+
+#include <audioAnalysis.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#define TEST_SECONDS 10
+#define TEST_AMPLITUDE 8000
+#define TEST_NOISE 60
+#define TEST_PERIOD_MS 500
+
+static int failures = 0;
+
+static void report(const char *name, bool pass, const char *detail)
+{
+    printf("%-10s %-4s %s\n", name, pass ? "PASS" : "FAIL", detail);
+    failures += pass ? 0 : 1;
+}
+
+// Beat times in seconds, block start times like the file runner prints.
+static std::vector<double> beatsIn(const std::vector<int16_t> &samples)
+{
+    sAudioAnalyzer analyzer;
+    audioAnalyzerInit(analyzer);
+    std::vector<double> beats;
+    for (size_t b = 0; b < samples.size() / AUDIO_BLOCK_SIZE; b++)
+    {
+        if (audioAnalyzeBlock(analyzer, &samples[b * AUDIO_BLOCK_SIZE]))
+        {
+            beats.push_back((double)(b * AUDIO_BLOCK_SIZE) / AUDIO_SAMPLE_RATE);
+        }
+    }
+    return beats;
+}
+
+// envelope(t within the period) scales the tone, plus noise.
+template <typename Envelope>
+static std::vector<int16_t> synth(double hz, Envelope envelope, std::mt19937 &rng)
+{
+    std::vector<int16_t> samples(TEST_SECONDS * AUDIO_SAMPLE_RATE);
+    std::uniform_real_distribution<double> phase(0, 2 * M_PI);
+    double start = phase(rng);
+    for (size_t n = 0; n < samples.size(); n++)
+    {
+        double t = (double)n / AUDIO_SAMPLE_RATE;
+        double inPeriod = fmod(t, TEST_PERIOD_MS / 1000.0);
+        double v = envelope(inPeriod) * sin(2 * M_PI * hz * t + start) + (int)(rng() % (2 * TEST_NOISE + 1)) - TEST_NOISE;
+        samples[n] = (int16_t)(v > 32767 ? 32767 : v < -32768 ? -32768 : v);
+    }
+    return samples;
+}
+
+// Every onset (a multiple of the period) needs a beat within two blocks of
+// the block it falls in, and there must be no other beats.
+static void checkOnsets(const char *name, const std::vector<int16_t> &samples)
+{
+    std::vector<double> beats = beatsIn(samples);
+    double blockS = (double)AUDIO_BLOCK_SIZE / AUDIO_SAMPLE_RATE;
+    int onsets = TEST_SECONDS * 1000 / TEST_PERIOD_MS;
+    int hits = 0;
+    for (int i = 0; i < onsets; i++)
+    {
+        double onset = i * TEST_PERIOD_MS / 1000.0;
+        for (double beat : beats)
+        {
+            if (beat > onset - blockS && beat <= onset + 2 * blockS)
+            {
+                hits++;
+                break;
+            }
+        }
+    }
+    int extra = (int)beats.size() - hits;
+    char detail[128];
+    snprintf(detail, sizeof(detail), "%d of %d onsets found, %d other beats", hits, onsets, extra);
+    for (size_t i = 0; extra && i < beats.size(); i++)
+    {
+        double into = fmod(beats[i], TEST_PERIOD_MS / 1000.0);
+        if (into > 2 * blockS && into < TEST_PERIOD_MS / 1000.0 - blockS)
+        {
+            printf("  %s: beat at %.3f s\n", name, beats[i]);
+        }
+    }
+    report(name, hits == onsets && extra == 0, detail);
+}
+
+static int selfTest()
+{
+    std::mt19937 rng(28);
+    char detail[128];
+
+    static const double tones[] = {440, 97, 1000, 1234.5, 3210};
+    int beats = 0;
+    for (double hz : tones)
+    {
+        // The tone starting out of silence is an onset, anything after it isn't.
+        std::vector<double> found = beatsIn(synth(hz, [](double) { return (double)TEST_AMPLITUDE; }, rng));
+        int count = (int)std::count_if(found.begin(), found.end(), [](double t) { return t > 0.1; });
+        if (count)
+        {
+            printf("  %.1f Hz: %d beats\n", hz, count);
+        }
+        beats += count;
+    }
+    snprintf(detail, sizeof(detail), "%d beats over %d steady tones of %d s", beats, (int)(sizeof(tones) / sizeof(tones[0])),
+             TEST_SECONDS);
+    report("steady", beats == 0, detail);
+
+    // 150 ms bursts with 5 ms ramps.
+    checkOnsets("bursts", synth(80, [](double t) {
+                    double ramp = t < 0.005 ? t / 0.005 : t > 0.145 ? (0.15 - t) / 0.005 : 1.0;
+                    return t < 0.15 ? TEST_AMPLITUDE * ramp : 0.0;
+                }, rng));
+
+    // Kick: 55 Hz with a 60 ms decay, plus a short click on top.
+    std::vector<int16_t> kicks = synth(55, [](double t) { return TEST_AMPLITUDE * 2 * exp(-t / 0.06); }, rng);
+    for (size_t n = 0; n < kicks.size(); n++)
+    {
+        double t = fmod((double)n / AUDIO_SAMPLE_RATE, TEST_PERIOD_MS / 1000.0);
+        int click = t < 0.003 ? (int)(4000 * sin(2 * M_PI * 2500 * t)) : 0;
+        int v = kicks[n] + click;
+        kicks[n] = (int16_t)(v > 32767 ? 32767 : v < -32768 ? -32768 : v);
+    }
+    checkOnsets("kicks", kicks);
+    return failures ? 1 : 0;
+}
+
+struct sWavInfo
+{
+    uint16_t channels;
+    uint32_t sampleRate;
+    uint16_t bitsPerSample;
+};
+
+// Minimal RIFF walk: find "fmt " and "data", return the samples of channel 0.
+static bool readWav(const char *path, sWavInfo &info, std::vector<int16_t> &samples)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f)
+    {
+        return false;
+    }
+
+    char riff[12];
+    if (fread(riff, 1, 12, f) != 12 || memcmp(riff, "RIFF", 4) != 0 || memcmp(riff + 8, "WAVE", 4) != 0)
+    {
+        fclose(f);
+        return false;
+    }
+
+    bool haveFormat = false;
+    char id[4];
+    uint32_t size;
+    while (fread(id, 1, 4, f) == 4 && fread(&size, 4, 1, f) == 1)
+    {
+        if (memcmp(id, "fmt ", 4) == 0)
+        {
+            uint8_t fmt[16];
+            if (size < 16 || fread(fmt, 1, 16, f) != 16)
+            {
+                break;
+            }
+            memcpy(&info.channels, fmt + 2, 2);
+            memcpy(&info.sampleRate, fmt + 4, 4);
+            memcpy(&info.bitsPerSample, fmt + 14, 2);
+            fseek(f, size - 16 + (size & 1), SEEK_CUR);
+            haveFormat = true;
+        }
+        else if (memcmp(id, "data", 4) == 0 && haveFormat && info.bitsPerSample == 16)
+        {
+            std::vector<int16_t> interleaved(size / 2);
+            size_t got = fread(interleaved.data(), 2, interleaved.size(), f);
+            for (size_t i = 0; i < got; i += info.channels)
+            {
+                samples.push_back(interleaved[i]);
+            }
+            fclose(f);
+            return true;
+        }
+        else
+        {
+            fseek(f, size + (size & 1), SEEK_CUR);
+        }
+    }
+    fclose(f);
+    return false;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s file.wav [-v] | --selftest\n", argv[0]);
+        return 1;
+    }
+    if (strcmp(argv[1], "--selftest") == 0)
+    {
+        return selfTest();
+    }
+    bool verbose = argc > 2 && strcmp(argv[2], "-v") == 0;
+
+    sWavInfo info = {};
+    std::vector<int16_t> samples;
+    if (!readWav(argv[1], info, samples))
+    {
+        fprintf(stderr, "%s: not a 16 bit PCM wav file\n", argv[1]);
+        return 1;
+    }
+    if (info.sampleRate != AUDIO_SAMPLE_RATE)
+    {
+        fprintf(stderr, "warning: %u Hz input, analyser expects %u Hz\n", info.sampleRate, AUDIO_SAMPLE_RATE);
+    }
+
+    sAudioAnalyzer analyzer;
+    audioAnalyzerInit(analyzer);
+
+    size_t blocks = samples.size() / AUDIO_BLOCK_SIZE;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t b = 0; b < blocks; b++)
+    {
+        bool beat = audioAnalyzeBlock(analyzer, &samples[b * AUDIO_BLOCK_SIZE]);
+        double seconds = (double)(b * AUDIO_BLOCK_SIZE) / info.sampleRate;
+        if (verbose)
+        {
+            printf("%8.3f %c lvl %3u flux %3u |", seconds, beat ? '*' : ' ', analyzer.frame.level, analyzer.frame.flux);
+            for (int i = 0; i < AUDIO_BANDS; i++)
+            {
+                printf(" %3u", analyzer.frame.bands[i]);
+            }
+            printf("\n");
+        }
+        else if (beat)
+        {
+            printf("beat %u at %.3f s\n", analyzer.frame.beatCount, seconds);
+        }
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double audioSeconds = (double)samples.size() / info.sampleRate;
+    printf("%zu blocks, %u beats, %.2f us/block, %.0fx realtime\n", blocks, analyzer.frame.beatCount,
+           blocks ? elapsed * 1e6 / blocks : 0.0, elapsed > 0 ? audioSeconds / elapsed : 0.0);
+    return 0;
+}
@@ -0,0 +1,220 @@
+/*+===================================================================
+  File:      clipbench.cpp
+
+  Summary:   Round trip check of the baked clip codec (clipCodec.h).
+             Every frame must decode back to exactly what was
+             encoded and stay within CLIP_ENCODED_MAX(), the size
+             of the capture scratch buffer:
+
+                patterns   unchanged, all changed, alternating and
+                           other edge cases at awkward sizes
+                fuzz       random frames with random change runs
+                chain      a moving effect captured and played back
+                           the way bakedClip.h does, keyframes and
+                           deltas, looped
+                damaged    truncated records never write past the
+                           frame
+
+             Then times encode and decode of the chain frames and
+             reports the compression.
+
+  Building:  g++ -O2 -Wall -Iinclude tools/clipbench.cpp -o clipbench
+             ./clipbench [leds]
+
+  10/19/2026.
+===================================================================+*/
+
+#include <clipCodec.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#define BENCH_FUZZ 20000
+#define BENCH_FRAMES 500
+#define BENCH_KEYFRAME_EVERY 64 // CLIP_KEYFRAME_EVERY in bakedClip.h
+#define BENCH_GUARD 16
+
+static int failures = 0;
+
+static void report(const char *name, bool pass, const char *detail)
+{
+    printf("%-10s %-4s %s\n", name, pass ? "PASS" : "FAIL", detail);
+    failures += pass ? 0 : 1;
+}
+
+// Encode cur against ref, decode onto a copy of ref. True if it came back
+// unchanged and within bounds. Adds the encoded size to total when given.
+static bool roundTrip(const uint8_t *cur, const uint8_t *ref, size_t bytes, size_t *total = nullptr)
+{
+    std::vector<uint8_t> out(CLIP_ENCODED_MAX(bytes) + BENCH_GUARD, 0xA5);
+    size_t size = clipEncode(cur, ref, out.data(), bytes);
+    bool guardOk = true;
+    for (size_t k = CLIP_ENCODED_MAX(bytes); k < out.size(); k++)
+    {
+        guardOk = guardOk && out[k] == 0xA5;
+    }
+
+    std::vector<uint8_t> frame(ref, ref + bytes);
+    clipDecode(out.data(), size, frame.data(), bytes);
+    if (total)
+    {
+        *total += size;
+    }
+    return guardOk && size <= CLIP_ENCODED_MAX(bytes) && memcmp(frame.data(), cur, bytes) == 0;
+}
+
+// Frame whose byte k differs from ref where mask (repeated) has an 'x'.
+static bool patternCase(const char *mask, size_t bytes, std::mt19937 &rng)
+{
+    std::vector<uint8_t> ref(bytes);
+    std::vector<uint8_t> cur(bytes);
+    size_t maskLen = strlen(mask);
+    for (size_t k = 0; k < bytes; k++)
+    {
+        ref[k] = (uint8_t)rng();
+        cur[k] = mask[k % maskLen] == 'x' ? ref[k] ^ (uint8_t)(1 + rng() % 255) : ref[k];
+    }
+    return roundTrip(cur.data(), ref.data(), bytes);
+}
+
+// A few dots sweeping over a slow hue wash, like the effects that get baked.
+static void effectFrame(uint8_t *frame, size_t leds, uint32_t t)
+{
+    for (size_t i = 0; i < leds; i++)
+    {
+        bool dot = (i + t) % 37 == 0 || (i * 3 + t * 2) % 101 == 0;
+        uint8_t wash = (uint8_t)(t / 4 + i / 16);
+        frame[i * 3] = dot ? 255 : wash;
+        frame[i * 3 + 1] = dot ? 255 : 0;
+        frame[i * 3 + 2] = dot ? 255 : (uint8_t)(wash / 2);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    size_t leds = argc > 1 ? atoi(argv[1]) : 300;
+    size_t bytes = leds * 3;
+    std::mt19937 rng(29);
+    char detail[128];
+
+    // Masks around the token edges: single unchanged bytes inside literals,
+    // runs of exactly 2, 128 and 129, trailing single bytes.
+    static const char *masks[] = {".", "x", "x.", ".x", "x..", "xx.", "x.x..", "x..x.", "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx."};
+    static const size_t sizes[] = {1, 2, 3, 127, 128, 129, 130, 255, 256, 257, 385, 900};
+    int bad = 0;
+    int cases = 0;
+    for (const char *mask : masks)
+    {
+        for (size_t size : sizes)
+        {
+            cases++;
+            if (!patternCase(mask, size, rng) && bad++ == 0)
+            {
+                printf("  mask \"%s\" size %zu\n", mask, size);
+            }
+        }
+    }
+    snprintf(detail, sizeof(detail), "%d of %d mask/size cases differ", bad, cases);
+    report("patterns", bad == 0, detail);
+
+    // Random runs of changed and unchanged bytes of random length.
+    bad = 0;
+    std::vector<uint8_t> ref(bytes);
+    std::vector<uint8_t> cur(bytes);
+    size_t worst = 0;
+    for (int n = 0; n < BENCH_FUZZ; n++)
+    {
+        size_t size = 1 + rng() % bytes;
+        uint32_t maxRun = 1 + rng() % 200;
+        bool changed = rng() & 1;
+        size_t k = 0;
+        while (k < size)
+        {
+            size_t run = 1 + rng() % maxRun;
+            for (; run > 0 && k < size; run--, k++)
+            {
+                ref[k] = (uint8_t)rng();
+                cur[k] = changed ? ref[k] ^ (uint8_t)(1 + rng() % 255) : ref[k];
+            }
+            changed = !changed;
+        }
+        size_t total = 0;
+        if (!roundTrip(cur.data(), ref.data(), size, &total) && bad++ == 0)
+        {
+            printf("  fuzz case %d, %zu bytes\n", n, size);
+        }
+        worst = total > worst ? total : worst;
+    }
+    snprintf(detail, sizeof(detail), "%d of %d random frames differ, largest %zu bytes", bad, BENCH_FUZZ, worst);
+    report("fuzz", bad == 0, detail);
+
+    // Capture: each frame against the previous, black at keyframes. Playback:
+    // decode on top of the previous decoded frame, or black at keyframes.
+    std::vector<std::vector<uint8_t>> frames(BENCH_FRAMES, std::vector<uint8_t>(bytes));
+    std::vector<std::vector<uint8_t>> records(BENCH_FRAMES);
+    std::vector<uint8_t> previous(bytes);
+    std::vector<uint8_t> scratch(CLIP_ENCODED_MAX(bytes));
+    size_t encoded = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t f = 0; f < BENCH_FRAMES; f++)
+    {
+        effectFrame(frames[f].data(), leds, f);
+        if (f % BENCH_KEYFRAME_EVERY == 0)
+        {
+            memset(previous.data(), 0, bytes);
+        }
+        size_t size = clipEncode(frames[f].data(), previous.data(), scratch.data(), bytes);
+        records[f].assign(scratch.begin(), scratch.begin() + size);
+        previous = frames[f];
+        encoded += size;
+    }
+    double encodeNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+                      BENCH_FRAMES;
+
+    // Twice through, so the loop back to frame 0 is covered.
+    bad = 0;
+    std::vector<uint8_t> frame(bytes);
+    start = std::chrono::steady_clock::now();
+    for (uint32_t n = 0; n < 2 * BENCH_FRAMES; n++)
+    {
+        uint32_t f = n % BENCH_FRAMES;
+        if (f % BENCH_KEYFRAME_EVERY == 0)
+        {
+            memset(frame.data(), 0, bytes);
+        }
+        clipDecode(records[f].data(), records[f].size(), frame.data(), bytes);
+        if (memcmp(frame.data(), frames[f].data(), bytes) != 0 && bad++ == 0)
+        {
+            printf("  chain frame %u\n", f);
+        }
+    }
+    double decodeNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+                      (2 * BENCH_FRAMES);
+    snprintf(detail, sizeof(detail), "%d of %d frames differ, %zu of %zu bytes (%.1f%%)", bad, 2 * BENCH_FRAMES, encoded,
+             bytes * BENCH_FRAMES, 100.0 * encoded / (bytes * BENCH_FRAMES));
+    report("chain", bad == 0, detail);
+
+    // Every prefix of a record decodes without touching bytes past the frame.
+    bad = 0;
+    std::vector<uint8_t> guarded(bytes + BENCH_GUARD);
+    for (uint32_t f = 0; f < BENCH_FRAMES; f += 7)
+    {
+        for (size_t len = 0; len <= records[f].size(); len++)
+        {
+            memset(guarded.data(), 0, guarded.size());
+            clipDecode(records[f].data(), len, guarded.data(), bytes);
+            for (size_t k = bytes; k < guarded.size(); k++)
+            {
+                bad += guarded[k] != 0;
+            }
+        }
+    }
+    snprintf(detail, sizeof(detail), "%d guard bytes written by truncated records", bad);
+    report("damaged", bad == 0, detail);
+
+    printf("\n%zu LEDs: encode %.0f ns, decode %.0f ns per frame\n", leds, encodeNs, decodeNs);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,318 @@
+/*+===================================================================
+  File:      controlbench.cpp
+
+  Summary:   Host check and timing for controlRequest.h.
+
+                cases    small bodies, each key, repeats, unknown
+                         keys, and bodies that must fail at a given
+                         byte
+                batch    large random bodies (thousands of changes),
+                         fed whole, a byte at a time, in every chunk
+                         size up to 64 and in random pieces; every
+                         feed must give the same change as a plain
+                         last-value-wins model of the body
+                checks   controlCheck() refuses a bad preset slot,
+                         animation or save slot whatever else the
+                         body carries, and passes good ones
+                time     MB/s parsing a large body
+
+  Building:  g++ -O2 -Iinclude tools/controlbench.cpp -o controlbench
+             ./controlbench
+
+  10/19/2026.
+===================================================================+*/
+
+#include <controlRequest.h>
+#include <stdio.h>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+static std::mt19937 rng(44);
+static int failures = 0;
+
+static void result(bool pass, const char *name)
+{
+    printf("%-6s %s\n", name, pass ? "PASS" : "FAIL");
+    failures += pass ? 0 : 1;
+}
+
+static bool parseWhole(const std::string &body, sControlParser &parser)
+{
+    controlParseBegin(parser);
+    return controlParse(parser, (const uint8_t *)body.data(), body.size()) && controlParseEnd(parser);
+}
+
+static bool parseChunked(const std::string &body, sControlParser &parser, const std::vector<size_t> &cuts)
+{
+    controlParseBegin(parser);
+    size_t at = 0;
+    for (size_t cut : cuts)
+    {
+        if (!controlParse(parser, (const uint8_t *)body.data() + at, cut - at))
+        {
+            return false;
+        }
+        at = cut;
+    }
+    return controlParse(parser, (const uint8_t *)body.data() + at, body.size() - at) && controlParseEnd(parser);
+}
+
+static bool sameChange(const sControlChange &a, const sControlChange &b)
+{
+    if (a.set != b.set || a.fields != b.fields || a.ignored != b.ignored)
+    {
+        return false;
+    }
+    for (int k = 0; k < CK_SWAT; k++)
+    {
+        if (controlHas(a, (ControlKey)k) && a.value[k] != b.value[k])
+        {
+            return false;
+        }
+    }
+    return !controlHas(a, CK_SWAT) || memcmp(a.swat, b.swat, 3) == 0;
+}
+
+/*--------------------------------------------------------------------
+   Cases
+---------------------------------------------------------------------*/
+
+struct sGood
+{
+    const char *body;
+    uint32_t set;
+    int32_t value; // of the lowest key set
+};
+
+struct sBad
+{
+    const char *body;
+    uint32_t offset; // byte the parser stops at
+};
+
+static void testCases()
+{
+    const sGood good[] = {
+        {"{}", 0, 0},
+        {" { \"animation\" : 3 } \r\n", 1u << CK_ANIMATION, 3},
+        {"{\"animation\":-1}", 1u << CK_ANIMATION, -1},
+        {"{\"hue\":10,\"hue\":20}", 1u << CK_HUE, 20},
+        {"{\"bri\":0,\"palette\":255}", (1u << CK_BRI) | (1u << CK_PALETTE), 0},
+        {"{\"swat\":[29,170,216],\"save\":4}", (1u << CK_SAVE) | (1u << CK_SWAT), 4},
+        {"{\"futureKey\":7,\"other\":[1,2,3,4],\"empty\":[],\"sat\":9}", 1u << CK_SAT, 9},
+        {"{\"aVeryLongKeyNameIndeed\":1,\"val\":1}", 1u << CK_VAL, 1},
+    };
+    const sBad bad[] = {
+        {"", 0},
+        {"[1]", 0},
+        {"{\"hue\":\"red\"}", 7},
+        {"{\"hue\":1.5}", 8},
+        {"{\"hue\":256}", 10},
+        {"{\"animation\":-2}", 15},
+        {"{\"hue\":{\"a\":1}}", 7},
+        {"{\"swat\":7}", 9},
+        {"{\"swat\":[1,2]}", 12},
+        {"{\"hue\":[1]}", 9},
+        {"{\"hue\":1,}", 9},
+        {"{\"hue\":-}", 8},
+        {"{\"hue\":1}x", 9},
+        {"{\"h\\ue\":1}", 3},
+        {"{\"hue\":1", 8},
+    };
+
+    bool pass = true;
+    for (const sGood &g : good)
+    {
+        sControlParser parser;
+        bool ok = parseWhole(g.body, parser) && parser.change.set == g.set;
+        for (int k = 0; ok && k < CK_COUNT; k++)
+        {
+            if (g.set & (1u << k))
+            {
+                ok = k == CK_SWAT ? (parser.change.swat[0] == 29 && parser.change.swat[2] == 216)
+                                  : parser.change.value[k] == g.value;
+                break;
+            }
+        }
+        if (!ok)
+        {
+            printf("       good body failed: %s (%s)\n", g.body, parser.error ? parser.error : "wrong result");
+            pass = false;
+        }
+    }
+    for (const sBad &b : bad)
+    {
+        sControlParser parser;
+        if (parseWhole(b.body, parser) || parser.offset != b.offset)
+        {
+            printf("       bad body: %s, stopped at %u (%s), expected %u\n", b.body, parser.offset,
+                   parser.error ? parser.error : "accepted", b.offset);
+            pass = false;
+        }
+    }
+    result(pass, "cases");
+}
+
+/*--------------------------------------------------------------------
+   Large batches
+---------------------------------------------------------------------*/
+
+// A random batch of pairs and the change it should parse to.
+static std::string makeBatch(int pairs, sControlChange &expected)
+{
+    memset(&expected, 0, sizeof(expected));
+    std::string body = "{";
+    for (int p = 0; p < pairs; p++)
+    {
+        if (p)
+        {
+            body += rng() % 4 ? "," : " ,\n ";
+        }
+        int k = rng() % (CK_COUNT + 1);
+        char text[64];
+        if (k == CK_UNKNOWN)
+        {
+            snprintf(text, sizeof(text), "\"x%u\":[%d,%d]", (unsigned)(rng() % 1000), (int)(rng() % 99), -(int)(rng() % 99));
+            expected.ignored++;
+        }
+        else if (k == CK_SWAT)
+        {
+            uint8_t h = rng(), s = rng(), v = rng();
+            snprintf(text, sizeof(text), "\"swat\": [ %u, %u,%u ]", h, s, v);
+            expected.swat[0] = h;
+            expected.swat[1] = s;
+            expected.swat[2] = v;
+            expected.set |= 1u << k;
+        }
+        else
+        {
+            int range = controlKeys[k].max - controlKeys[k].min + 1;
+            int value = controlKeys[k].min + (int)(rng() % range);
+            snprintf(text, sizeof(text), "\"%s\":%s%d", controlKeys[k].name, rng() % 2 ? " " : "", value);
+            expected.value[k] = value;
+            expected.set |= 1u << k;
+        }
+        expected.fields++;
+        body += text;
+    }
+    body += "}";
+    return body;
+}
+
+static void testBatch()
+{
+    bool pass = true;
+    size_t largest = 0;
+    for (int pairs : {1, 10, 100, 1000, 5000, 20000})
+    {
+        sControlChange expected;
+        std::string body = makeBatch(pairs, expected);
+        largest = body.size() > largest ? body.size() : largest;
+        sControlParser parser;
+
+        pass = pass && parseWhole(body, parser) && sameChange(parser.change, expected);
+
+        for (size_t chunk = 1; chunk <= 64 && pass; chunk++)
+        {
+            std::vector<size_t> cuts;
+            for (size_t at = chunk; at < body.size(); at += chunk)
+            {
+                cuts.push_back(at);
+            }
+            pass = parseChunked(body, parser, cuts) && sameChange(parser.change, expected);
+        }
+
+        for (int round = 0; round < 20 && pass; round++)
+        {
+            std::vector<size_t> cuts;
+            for (size_t at = rng() % 1500 + 1; at < body.size(); at += rng() % 1500 + 1)
+            {
+                cuts.push_back(at);
+            }
+            pass = parseChunked(body, parser, cuts) && sameChange(parser.change, expected);
+        }
+
+        // The same body cut off anywhere must never be accepted.
+        if (pairs <= 100)
+        {
+            for (size_t len = 0; len < body.size() && pass; len++)
+            {
+                pass = !parseWhole(body.substr(0, len), parser);
+            }
+        }
+        if (!pass)
+        {
+            printf("       %d pairs: %s at byte %u\n", pairs, parser.error ? parser.error : "wrong result", parser.offset);
+        }
+    }
+    printf("       up to %zu byte bodies\n", largest);
+    result(pass, "batch");
+}
+
+static void testTime()
+{
+    sControlChange expected;
+    std::string body = makeBatch(20000, expected);
+    sControlParser parser;
+    double best = 1e30;
+    for (int round = 0; round < 20; round++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        parseWhole(body, parser);
+        double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        best = s < best ? s : best;
+    }
+    printf("       %zu bytes in %.1f us, %.0f MB/s, %.1f ns/change\n", body.size(), best * 1e6,
+           body.size() / best / 1e6, best * 1e9 / 20000);
+}
+
+// Animations 0..9 and off (-1), like a small build.
+static bool benchAnimationKnown(int id)
+{
+    return id >= -1 && id < 10;
+}
+
+static void testChecks()
+{
+    struct sCheck
+    {
+        const char *body;
+        const char *error;
+    };
+    // Slots 0..7 hold scenes, 8..15 are empty.
+    const sControlLimits limits = {16, 0x00FF, benchAnimationKnown};
+    const sCheck checks[] = {
+        {"{\"preset\":3,\"animation\":99}", "unknown animation"},
+        {"{\"bri\":10,\"save\":99}", "bad preset slot to save"},
+        {"{\"animation\":4,\"save\":16}", "bad preset slot to save"},
+        {"{\"preset\":12,\"hue\":5}", "empty or bad preset slot"},
+        {"{\"preset\":200}", "empty or bad preset slot"},
+        {"{\"preset\":7,\"animation\":4,\"bri\":10,\"save\":15}", nullptr},
+        {"{\"animation\":-1,\"save\":12}", nullptr},
+        {"{\"hue\":20,\"bri\":180}", nullptr},
+    };
+
+    bool pass = true;
+    for (const sCheck &c : checks)
+    {
+        sControlParser parser;
+        const char *error = parseWhole(c.body, parser) ? controlCheck(parser.change, limits) : "parse failed";
+        if (c.error ? (error == nullptr || strcmp(error, c.error) != 0) : error != nullptr)
+        {
+            printf("       check failed: %s (%s)\n", c.body, error ? error : "passed");
+            pass = false;
+        }
+    }
+    result(pass, "checks");
+}
+
+int main()
+{
+    testCases();
+    testBatch();
+    testChecks();
+    testTime();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,199 @@
+/*+===================================================================
+  File:      cuesim.cpp
+
+  Summary:   Host harness for reliableCue.h. A master and several
+             subs talk over an in-memory link that drops and delays
+             packets in both directions. Checks every sub ran every
+             cue exactly once and prints latency and retry stats.
+             Then the master restarts, its seqs starting over under
+             a new epoch, and every sub must run the new cues too.
+
+  Building:  g++ -O2 -Iinclude tools/cuesim.cpp -o cuesim
+             ./cuesim [lossPercent] [cues] [subs]
+
+             Defaults: 20% loss, 5000 cues, 4 subs. Exit code is
+             non zero if any cue ran zero or more than one time.
+
+  10/19/2026.
+===================================================================+*/
+
+#include <fixedString.h>
+#include <reliableCue.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#define LINK_MIN_DELAY_MS 2
+#define LINK_MAX_DELAY_MS 25
+
+struct sPacket
+{
+    uint32_t deliverAt;
+    uint8_t sub;
+    bool toSub; // false = ack back to the master.
+    std::string text;
+};
+
+static std::vector<sPacket> link;
+static uint32_t now = 0;
+static int lossPercent = 20;
+static uint64_t packetsSent = 0;
+static uint64_t packetsLost = 0;
+
+static void linkSend(uint8_t sub, bool toSub, const char *text)
+{
+    packetsSent++;
+    if (rand() % 100 < lossPercent)
+    {
+        packetsLost++;
+        return;
+    }
+    uint32_t delay = LINK_MIN_DELAY_MS + rand() % (LINK_MAX_DELAY_MS - LINK_MIN_DELAY_MS + 1);
+    link.push_back({now + delay, sub, toSub, text});
+}
+
+static void masterSend(uint8_t sub, const char *msg, void *)
+{
+    linkSend(sub, true, msg);
+}
+
+// After the restart: straight to the receiver, counting what runs.
+static std::vector<sCueReceiver> *rebootReceivers;
+static int rebootRuns = 0;
+
+static void rebootSend(uint8_t sub, const char *msg, void *)
+{
+    uint32_t epoch;
+    uint16_t seq;
+    const char *payload;
+    sCueReceiver &rx = (*rebootReceivers)[sub];
+    if (cueParseCue(msg, epoch, seq, &payload))
+    {
+        cueEpoch(rx, epoch);
+        rebootRuns += cueReceive(rx, seq);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    lossPercent = argc > 1 ? atoi(argv[1]) : 20;
+    int cueCount = argc > 2 ? atoi(argv[2]) : 5000;
+    int subCount = argc > 3 ? std::min(atoi(argv[3]), CUE_MAX_SUBS) : 4;
+    srand(1);
+
+    static sCueSender master;
+    cueSenderInit(master, masterSend, nullptr, 0xB0070001);
+    std::vector<sCueReceiver> receivers(subCount);
+    std::vector<std::vector<uint8_t>> runs(subCount, std::vector<uint8_t>(cueCount, 0));
+    for (int sub = 0; sub < subCount; sub++)
+    {
+        cueSubAttach(master, sub);
+        cueReceiverInit(receivers[sub]);
+    }
+
+    // Cues go out in bursts of 4 with 40-240 ms gaps, ~28 cues/s which is a busy finale.
+    // Anything much faster than CUE_WINDOW cues per CUE_GIVE_UP_MS starts to wrap the window.
+    std::vector<uint32_t> latencies;
+    std::vector<uint32_t> sentAt(cueCount);
+    int next = 0;
+    uint32_t nextCueAt = 0;
+    while (next < cueCount || cuePending(master) || !link.empty())
+    {
+        while (next < cueCount && now >= nextCueAt)
+        {
+            FixedString<CUE_PAYLOAD> payload("Fire: Shell #");
+            payload.appendUInt(next);
+            sentAt[next] = now;
+            cueSend(master, payload.c_str(), now);
+            next++;
+            nextCueAt = now + (next % 4 == 0 ? 40 + rand() % 200 : 0);
+        }
+
+        // Deliver everything that's due this millisecond.
+        for (size_t i = 0; i < link.size();)
+        {
+            if (link[i].deliverAt > now)
+            {
+                i++;
+                continue;
+            }
+            sPacket p = link[i];
+            link[i] = link.back();
+            link.pop_back();
+
+            uint32_t epoch;
+            uint16_t seq;
+            const char *payload;
+            if (p.toSub && cueParseCue(p.text.c_str(), epoch, seq, &payload))
+            {
+                cueEpoch(receivers[p.sub], epoch);
+                if (cueReceive(receivers[p.sub], seq))
+                {
+                    int index = atoi(strchr(payload, '#') + 1);
+                    runs[p.sub][index]++;
+                    latencies.push_back(now - sentAt[index]);
+                }
+                FixedString<32> ack;
+                cueFormatAck(receivers[p.sub], ack);
+                linkSend(p.sub, false, ack.c_str());
+            }
+            else if (!p.toSub)
+            {
+                cueOnAckText(master, p.sub, p.text.c_str(), now);
+            }
+        }
+
+        cueSenderService(master, now);
+        now++;
+    }
+
+    int missing = 0;
+    int repeated = 0;
+    for (int sub = 0; sub < subCount; sub++)
+    {
+        for (int i = 0; i < cueCount; i++)
+        {
+            missing += runs[sub][i] == 0;
+            repeated += runs[sub][i] > 1;
+        }
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    uint32_t p50 = latencies.empty() ? 0 : latencies[latencies.size() / 2];
+    uint32_t p99 = latencies.empty() ? 0 : latencies[latencies.size() * 99 / 100];
+    uint32_t worst = latencies.empty() ? 0 : latencies.back();
+
+    printf("%d cues x %d subs, %d%% loss each way, link %d-%d ms\n", cueCount, subCount, lossPercent,
+           LINK_MIN_DELAY_MS, LINK_MAX_DELAY_MS);
+    printf("%.1f cues/s, packets %llu, lost %llu\n", cueCount * 1000.0 / (sentAt[cueCount - 1] + 1),
+           (unsigned long long)packetsSent, (unsigned long long)packetsLost);
+    printf("run latency ms: p50 %u  p99 %u  max %u\n", p50, p99, worst);
+    for (int sub = 0; sub < subCount; sub++)
+    {
+        const sCueStats &st = master.subs[sub].stats;
+        printf("sub %d: sent %u  retransmits %u  acked %u  expired %u  ack latency avg %u max %u ms  dupes %u\n", sub,
+               st.sent, st.retransmits, st.acked, st.expired, st.latencyAvgMs, st.latencyMaxMs,
+               receivers[sub].duplicates);
+    }
+    printf("%s: %d missing, %d ran more than once\n", missing || repeated ? "FAIL" : "PASS", missing, repeated);
+
+    // The master restarts (after an OTA, say): its seqs start over at 0, far behind what the subs last saw.
+    static sCueSender rebooted;
+    cueSenderInit(rebooted, rebootSend, nullptr, 0xB0070002);
+    rebootReceivers = &receivers;
+    for (int sub = 0; sub < subCount; sub++)
+    {
+        cueSubAttach(rebooted, sub);
+    }
+    const int rebootCues = 10;
+    for (int i = 0; i < rebootCues; i++)
+    {
+        cueSend(rebooted, "Fire: Shell #1", now);
+    }
+    bool rebootOk = rebootRuns == rebootCues * subCount && receivers[0].restarts == 1;
+    printf("%s: after a master restart %d of %d cues ran\n", rebootOk ? "PASS" : "FAIL", rebootRuns,
+           rebootCues * subCount);
+    return missing || repeated || !rebootOk ? 1 : 0;
+}
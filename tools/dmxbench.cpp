@@ -0,0 +1,423 @@
+/*+===================================================================
+  File:      dmxbench.cpp
+
+  Summary:   Host test for dmxProtocol.h: sends sACN or Art-Net
+             frames through a local UDP socket into the same parser
+             and frame assembler the firmware runs, checks every
+             shown frame pixel for pixel through a serpentine layout
+             transform and reports the frame rate and the receive
+             cost per frame.
+
+             Synthetic frames are split over as many universes as
+             the pixel count needs and followed by a sync packet
+             (E1.31 universe sync / ArtSync) unless nosync is given.
+             A pcap capture (Ethernet or Linux cooked) of a real desk
+             can be replayed instead: its UDP payloads to 5568/6454
+             are sent with their original spacing and the frames it
+             produced are counted, there's no pattern to check.
+
+  Building:  g++ -O2 -pthread -Iinclude tools/dmxbench.cpp -o dmxbench
+             ./dmxbench [e131|artnet] [pixels] [frames] [fps] [nosync]
+             ./dmxbench replay capture.pcap [pixels]
+
+             fps 0 sends as fast as the socket takes it.
+
+  10/19/2026.
+===================================================================+*/
+
+#include <dmxProtocol.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#define BENCH_PORT_OFFSET 20000 // bench ports are the real ones plus this
+
+static int64_t nowUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+static uint8_t pattern(int frame, int pixel, int channel)
+{
+    return (uint8_t)(frame * 7 + pixel * 3 + channel * 85);
+}
+
+struct sBench
+{
+    int pixels;
+    std::vector<int> transform;
+    std::vector<uint8_t> rgb;
+    sDmxFrame frame;
+    uint32_t shown = 0;
+    uint32_t mismatched = 0;
+    int64_t handleUs = 0; // parse + write, summed.
+    int64_t firstShownUs = 0;
+    int64_t lastShownUs = 0;
+    bool check = true;
+};
+
+static std::atomic<bool> running(true);
+
+// Frame number a shown frame should hold, from the first pixel.
+static int frameOf(const sBench &bench)
+{
+    const uint8_t *first = &bench.rgb[bench.transform[0] * 3];
+    for (int f = 0; f < 256; f++)
+    {
+        if (pattern(f, 0, 0) == first[0])
+        {
+            return f;
+        }
+    }
+    return -1;
+}
+
+static void verify(sBench &bench)
+{
+    int f = frameOf(bench);
+    for (int p = 0; p < bench.pixels; p++)
+    {
+        const uint8_t *pixel = &bench.rgb[bench.transform[p] * 3];
+        for (int c = 0; c < 3; c++)
+        {
+            if (pixel[c] != pattern(f, p, c))
+            {
+                bench.mismatched++;
+                return;
+            }
+        }
+    }
+}
+
+static void receiver(sBench *bench, int e131, int artnet)
+{
+    uint8_t buf[DMX_MAX_PACKET];
+    pollfd fds[2] = {{e131, POLLIN, 0}, {artnet, POLLIN, 0}};
+    while (running)
+    {
+        if (poll(fds, 2, 20) <= 0)
+        {
+            continue;
+        }
+        for (int i = 0; i < 2; i++)
+        {
+            if (!(fds[i].revents & POLLIN))
+            {
+                continue;
+            }
+            ssize_t n = recv(fds[i].fd, buf, sizeof(buf), 0);
+            int64_t start = nowUs();
+            sDmxPacket packet;
+            bool ready = n > 0 && dmxParse(i == 0 ? E131_PORT : ARTNET_PORT, buf, n, packet) &&
+                         dmxHandle(bench->frame, packet, start / 1000, bench->rgb.data(), bench->transform.data(),
+                                   bench->pixels);
+            int64_t end = nowUs();
+            bench->handleUs += end - start;
+            if (ready)
+            {
+                if (bench->shown++ == 0)
+                {
+                    bench->firstShownUs = end;
+                }
+                bench->lastShownUs = end;
+                if (bench->check)
+                {
+                    verify(*bench);
+                }
+            }
+        }
+    }
+}
+
+static int openReceiver(uint16_t port)
+{
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    int size = 1 << 20;
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port + BENCH_PORT_OFFSET);
+    if (bind(fd, (sockaddr *)&addr, sizeof(addr)) != 0)
+    {
+        perror("bind");
+        exit(1);
+    }
+    return fd;
+}
+
+static size_t buildE131Data(uint8_t *buf, uint16_t universe, uint8_t seq, uint16_t syncUniverse,
+                            const uint8_t *slots, uint16_t count)
+{
+    static const uint8_t acnId[12] = {'A', 'S', 'C', '-', 'E', '1', '.', '1', '7', 0, 0, 0};
+    size_t len = E131_DATA_OFFSET + count;
+    memset(buf, 0, E131_DATA_OFFSET);
+    buf[1] = 0x10;
+    memcpy(buf + 4, acnId, sizeof(acnId));
+    buf[16] = 0x70 | ((len - 16) >> 8);
+    buf[17] = (len - 16) & 0xFF;
+    buf[21] = E131_ROOT_DATA;
+    buf[38] = 0x70 | ((len - 38) >> 8);
+    buf[39] = (len - 38) & 0xFF;
+    buf[43] = E131_FRAMING_DATA;
+    strcpy((char *)buf + 44, "dmxbench");
+    buf[108] = 100; // priority
+    buf[109] = syncUniverse >> 8;
+    buf[110] = syncUniverse & 0xFF;
+    buf[111] = seq;
+    buf[113] = universe >> 8;
+    buf[114] = universe & 0xFF;
+    buf[115] = 0x70 | ((len - 115) >> 8);
+    buf[116] = (len - 115) & 0xFF;
+    buf[117] = 0x02;
+    buf[118] = 0xA1;
+    buf[122] = 1;
+    buf[123] = (count + 1) >> 8;
+    buf[124] = (count + 1) & 0xFF;
+    memcpy(buf + E131_DATA_OFFSET, slots, count);
+    return len;
+}
+
+static size_t buildE131Sync(uint8_t *buf, uint8_t seq, uint16_t syncUniverse)
+{
+    uint8_t data[E131_DATA_OFFSET];
+    buildE131Data(data, 0, 0, 0, nullptr, 0);
+    memcpy(buf, data, 38); // same preamble and CID
+    buf[16] = 0x70;
+    buf[17] = E131_SYNC_LENGTH - 16;
+    buf[21] = E131_ROOT_EXTENDED;
+    buf[38] = 0x70;
+    buf[39] = E131_SYNC_LENGTH - 38;
+    memset(buf + 40, 0, E131_SYNC_LENGTH - 40);
+    buf[43] = E131_FRAMING_SYNC;
+    buf[44] = seq;
+    buf[45] = syncUniverse >> 8;
+    buf[46] = syncUniverse & 0xFF;
+    return E131_SYNC_LENGTH;
+}
+
+static size_t buildArtnet(uint8_t *buf, uint16_t opCode, uint16_t universe, uint8_t seq, const uint8_t *slots,
+                          uint16_t count)
+{
+    memcpy(buf, "Art-Net", 8);
+    buf[8] = opCode & 0xFF;
+    buf[9] = opCode >> 8;
+    buf[10] = 0;
+    buf[11] = ARTNET_PROTOCOL;
+    buf[12] = seq;
+    buf[13] = 0;
+    if (opCode == ARTNET_OP_SYNC)
+    {
+        buf[12] = buf[13] = 0;
+        return 14;
+    }
+    uint16_t portAddress = universe - 1;
+    buf[14] = portAddress & 0xFF;
+    buf[15] = portAddress >> 8;
+    buf[16] = count >> 8;
+    buf[17] = count & 0xFF;
+    memcpy(buf + ARTNET_DATA_OFFSET, slots, count);
+    return ARTNET_DATA_OFFSET + count;
+}
+
+static void sendTo(int fd, uint16_t port, const uint8_t *buf, size_t len)
+{
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port + BENCH_PORT_OFFSET);
+    while (sendto(fd, buf, len, 0, (sockaddr *)&addr, sizeof(addr)) < 0)
+    {
+        usleep(50); // socket buffer full at fps 0
+    }
+}
+
+static void sendSynthetic(int fd, bool artnet, int pixels, int frames, int fps, bool sync)
+{
+    int universes = (pixels + DMX_PIXELS_PER_UNIVERSE - 1) / DMX_PIXELS_PER_UNIVERSE;
+    uint16_t syncUniverse = sync ? 64000 : 0;
+    uint8_t slots[512];
+    uint8_t packet[DMX_MAX_PACKET];
+    uint8_t seq = 1;
+    int64_t start = nowUs();
+    for (int f = 0; f < frames; f++)
+    {
+        for (int u = 0; u < universes; u++)
+        {
+            int first = u * DMX_PIXELS_PER_UNIVERSE;
+            int count = std::min(DMX_PIXELS_PER_UNIVERSE, pixels - first);
+            for (int p = 0; p < count; p++)
+            {
+                for (int c = 0; c < 3; c++)
+                {
+                    slots[p * 3 + c] = pattern(f, first + p, c);
+                }
+            }
+            size_t len = artnet ? buildArtnet(packet, ARTNET_OP_DMX, DMX_START_UNIVERSE + u, seq, slots, count * 3)
+                                : buildE131Data(packet, DMX_START_UNIVERSE + u, seq, syncUniverse, slots, count * 3);
+            sendTo(fd, artnet ? ARTNET_PORT : E131_PORT, packet, len);
+        }
+        if (sync)
+        {
+            size_t len = artnet ? buildArtnet(packet, ARTNET_OP_SYNC, 0, 0, nullptr, 0)
+                                : buildE131Sync(packet, seq, syncUniverse);
+            sendTo(fd, artnet ? ARTNET_PORT : E131_PORT, packet, len);
+        }
+        seq = seq == 255 ? 1 : seq + 1;
+        if (fps > 0)
+        {
+            int64_t due = start + (int64_t)(f + 1) * 1000000 / fps;
+            int64_t wait = due - nowUs();
+            if (wait > 0)
+            {
+                usleep(wait);
+            }
+        }
+    }
+}
+
+// Classic pcap, UDP over IPv4 on Ethernet (linktype 1) or Linux cooked capture (113).
+static int replay(int fd, const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    uint8_t header[24];
+    if (!file || fread(header, 1, sizeof(header), file) != sizeof(header) || *(uint32_t *)header != 0xA1B2C3D4)
+    {
+        fprintf(stderr, "%s: not a little endian pcap file\n", path);
+        return -1;
+    }
+    uint32_t linkType = *(uint32_t *)(header + 20);
+    size_t linkBytes = linkType == 1 ? 14 : (linkType == 113 ? 16 : 0);
+    if (linkBytes == 0)
+    {
+        fprintf(stderr, "%s: link type %u not supported\n", path, linkType);
+        return -1;
+    }
+
+    int sent = 0;
+    int64_t firstAt = -1;
+    int64_t start = nowUs();
+    uint8_t record[16];
+    std::vector<uint8_t> frame(65536);
+    while (fread(record, 1, sizeof(record), file) == sizeof(record))
+    {
+        uint32_t seconds = *(uint32_t *)record;
+        uint32_t micros = *(uint32_t *)(record + 4);
+        uint32_t captured = *(uint32_t *)(record + 8);
+        if (captured > frame.size() || fread(frame.data(), 1, captured, file) != captured)
+        {
+            break;
+        }
+        const uint8_t *ip = frame.data() + linkBytes;
+        if (captured < linkBytes + 28 || (ip[0] >> 4) != 4 || ip[9] != 17)
+        {
+            continue;
+        }
+        const uint8_t *udp = ip + (ip[0] & 0x0F) * 4;
+        uint16_t port = dmxRead16(udp + 2);
+        size_t length = dmxRead16(udp + 4) - 8;
+        if ((port != E131_PORT && port != ARTNET_PORT) || udp + 8 + length > frame.data() + captured)
+        {
+            continue;
+        }
+
+        int64_t at = (int64_t)seconds * 1000000 + micros;
+        if (firstAt < 0)
+        {
+            firstAt = at;
+        }
+        int64_t wait = start + (at - firstAt) - nowUs();
+        if (wait > 0)
+        {
+            usleep(wait);
+        }
+        sendTo(fd, port, udp + 8, length);
+        sent++;
+    }
+    fclose(file);
+    return sent;
+}
+
+int main(int argc, char **argv)
+{
+    bool replaying = argc > 2 && strcmp(argv[1], "replay") == 0;
+    bool artnet = argc > 1 && strcmp(argv[1], "artnet") == 0;
+    int pixels = atoi(argc > (replaying ? 3 : 2) ? argv[replaying ? 3 : 2] : "1020");
+    int frames = argc > 3 && !replaying ? atoi(argv[3]) : 2000;
+    int fps = argc > 4 && !replaying ? atoi(argv[4]) : 44;
+    bool sync = !(argc > 5 && strcmp(argv[5], "nosync") == 0);
+    if (pixels < 1 || pixels > DMX_MAX_UNIVERSES * DMX_PIXELS_PER_UNIVERSE)
+    {
+        fprintf(stderr, "pixels must be 1..%d\n", DMX_MAX_UNIVERSES * DMX_PIXELS_PER_UNIVERSE);
+        return 1;
+    }
+
+    // Serpentine over 10 rows, like a column-major matrix, so a mapping bug can't hide behind identity.
+    sBench bench;
+    bench.pixels = pixels;
+    bench.check = !replaying;
+    bench.rgb.assign(pixels * 3, 0);
+    for (int p = 0; p < pixels; p++)
+    {
+        int column = p / 10;
+        int row = p % 10;
+        int mapped = column * 10 + (column & 1 ? 9 - row : row);
+        bench.transform.push_back(mapped < pixels ? mapped : p);
+    }
+    dmxFrameInit(bench.frame, pixels);
+
+    int e131 = openReceiver(E131_PORT);
+    int artnetFd = openReceiver(ARTNET_PORT);
+    std::thread rx(receiver, &bench, e131, artnetFd);
+
+    int out = socket(AF_INET, SOCK_DGRAM, 0);
+    int64_t sendStart = nowUs();
+    int sent = frames;
+    if (replaying)
+    {
+        sent = replay(out, argv[2]);
+        if (sent < 0)
+        {
+            running = false;
+            rx.join();
+            return 1;
+        }
+    }
+    else
+    {
+        sendSynthetic(out, artnet, pixels, frames, fps, sync);
+    }
+    int64_t sendUs = nowUs() - sendStart;
+
+    usleep(200000);
+    running = false;
+    rx.join();
+
+    const sDmxStats &stats = bench.frame.stats;
+    double seconds = (bench.lastShownUs - bench.firstShownUs) / 1e6;
+    printf("%s, %d pixels in %u universes, %s\n", replaying ? argv[2] : (artnet ? "Art-Net" : "sACN"), pixels,
+           bench.frame.universes, replaying ? "replayed" : (sync ? "synced" : "free running"));
+    printf("%s %d in %.2f s, shown %u frames, %.1f fps\n", replaying ? "packets" : "frames", sent, sendUs / 1e6,
+           bench.shown, bench.shown > 1 && seconds > 0 ? (bench.shown - 1) / seconds : 0.0);
+    printf("packets %u  syncs %u  out of order %u  ignored %u  receive cost %.1f us/frame\n", stats.packets,
+           stats.syncs, stats.outOfOrder, stats.ignored, bench.shown ? (double)bench.handleUs / bench.shown : 0.0);
+    if (bench.check)
+    {
+        // A lost universe shows as a frame mixing two frames' pixels, only a failure if nothing was lost.
+        uint32_t expected = frames * (bench.frame.universes + (sync ? 1 : 0));
+        bool pass = bench.shown > 0 && (bench.mismatched == 0 || stats.packets < expected);
+        printf("%s: %u of %u frames wrong, %u packets lost on loopback\n", pass ? "PASS" : "FAIL",
+               bench.mismatched, bench.shown, expected - stats.packets);
+        return pass ? 0 : 1;
+    }
+    return 0;
+}
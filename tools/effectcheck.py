@@ -0,0 +1,132 @@
+#!/usr/bin/env python3
+"""
+  File:      effectcheck.py
+
+  Summary:   Runs the on-device effect check (include/effectCheck.h)
+             and compares it against a golden file.
+
+             With --run the device is asked to restart and run the
+             check, then polled until the results are up. Each
+             effect passes if its CRC over every frame matches the
+             golden one; on a mismatch the first checkpoint that
+             differs says roughly which frames changed. Timing, and
+             shows sent against shows asked for, are printed for
+             reference and never fail a run. The device's HSV batch
+             conversion must match FastLED's for every value.
+
+             --record writes the results as the new golden file.
+             Goldens are only comparable for the same install
+             profile (NUM_LEDS, layout, effects built) and frame
+             count, so the default golden is per profile,
+             tools/effects.<profile>.golden.json; give --golden for
+             other frame counts.
+
+             The device is given BOOT_SECONDS to restart and run the
+             HSV check plus FRAME_SECONDS per frame for the effects,
+             or --timeout seconds.
+
+  Usage:     python tools/effectcheck.py 192.168.4.1 --run --record
+             python tools/effectcheck.py 192.168.4.1 --run
+             python tools/effectcheck.py 192.168.4.1 --frames 1000 --golden effects-1000.json
+
+  10/19/2026.
+"""
+
+import argparse
+import json
+import os
+import sys
+import time
+import urllib.request
+
+BOOT_SECONDS = 60
+FRAME_SECONDS = 0.3  # every effect's frame, with its shows
+
+
+def fetch(host):
+    with urllib.request.urlopen("http://%s/api/effects" % host, timeout=5) as response:
+        return json.load(response)
+
+
+def run_check(host, frames, timeout):
+    request = urllib.request.Request("http://%s/api/effects/check?frames=%d" % (host, frames), method="POST", data=b"")
+    urllib.request.urlopen(request, timeout=5).read()
+    time.sleep(3)  # let it go down before polling
+    deadline = time.time() + timeout
+    while time.time() < deadline:
+        try:
+            results = fetch(host)
+            if results["ran"]:
+                return results
+        except OSError:
+            pass  # still booting
+        time.sleep(2)
+    raise SystemExit("%s didn't come back with results in %d s" % (host, timeout))
+
+
+def compare(results, golden):
+    for key in ("profile", "frames", "frameMs", "seed", "numLeds"):
+        if results[key] != golden[key]:
+            print("golden was recorded with %s=%s, device has %s" % (key, golden[key], results[key]))
+            return 1
+
+    expected = {e["name"]: e for e in golden["effects"]}
+    points = len(golden["effects"][0]["points"]) if golden["effects"] else 1
+    failures = 0
+    print("%-22s %-8s %10s %10s %11s  %s" % ("effect", "crc", "avg us", "golden", "shows", ""))
+    for effect in results["effects"]:
+        want = expected.get(effect["name"])
+        if want is None:
+            status = "NEW"
+        elif effect["crc"] == want["crc"]:
+            status = "PASS"
+        else:
+            first = next(i for i, (a, b) in enumerate(zip(effect["points"], want["points"])) if a != b)
+            status = "FAIL (frames %d-%d)" % (first * results["frames"] // points,
+                                              (first + 1) * results["frames"] // points - 1)
+            failures += 1
+        shows = "%d/%d" % (effect.get("showsSent", 0), effect.get("showsRequested", 0))
+        print("%-22s %-8s %10d %10s %11s  %s" % (effect["name"], effect["crc"], effect["avgUs"],
+                                                 want["avgUs"] if want else "-", shows, status))
+    for name in expected.keys() - {e["name"] for e in results["effects"]}:
+        print("%-22s missing from the device" % name)
+        failures += 1
+    print("show() %d us, %d frames of %d ms" % (results["showUs"], results["frames"], results["frameMs"]))
+    hsv = results.get("hsv")
+    if hsv:
+        print("HSV batch %d ns/pixel, FastLED %d ns/pixel, %d mismatches  %s" %
+              (hsv["batchNs"], hsv["fastLedNs"], hsv["mismatches"], "PASS" if hsv["mismatches"] == 0 else "FAIL"))
+        failures += 1 if hsv["mismatches"] else 0
+    return 1 if failures else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Check BangWorx effects against golden frames.")
+    parser.add_argument("host", help="device address")
+    parser.add_argument("--run", action="store_true", help="restart the device and run the check first")
+    parser.add_argument("--frames", type=int, default=200)
+    parser.add_argument("--golden", help="golden file, default tools/effects.<profile>.golden.json")
+    parser.add_argument("--timeout", type=float, help="seconds to wait for --run, default scales with --frames")
+    parser.add_argument("--record", action="store_true", help="write the results as the golden file")
+    args = parser.parse_args()
+
+    timeout = args.timeout or BOOT_SECONDS + args.frames * FRAME_SECONDS
+    results = run_check(args.host, args.frames, timeout) if args.run else fetch(args.host)
+    if not results["ran"]:
+        print("no results on the device, use --run")
+        return 1
+    golden = args.golden or "tools/effects.%s.golden.json" % results["profile"]
+    if args.record:
+        with open(golden, "w") as f:
+            json.dump(results, f, indent=1)
+        print("%s: %d effects recorded" % (golden, len(results["effects"])))
+        return 0
+    if not os.path.exists(golden):
+        print("no golden file %s, record one with --run --record" % golden)
+        return 1
+    with open(golden) as f:
+        return compare(results, json.load(f))
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,516 @@
+/*+===================================================================
+  File:      firesim.cpp
+
+  Summary:   Host simulation for fireControl.h. The loop below plays
+             the "fire" task and the pulse timers from fireChannels.h
+             against a fake GPIO layer that timestamps every edge an
+             igniter would see (outputs gated by OE, so nothing while
+             disarmed) and a fake esp_timer that fires late by up to
+             TIMER_JITTER_US, never early.
+
+                timing    200 pulses of random length, each on-time
+                          within PULSE_TOLERANCE_US of the request,
+                          one rising edge per accepted fire
+                noheart   arming without a heartbeat is refused
+                lost      beacons stop: fires refused after
+                          FIRE_HEARTBEAT_MS, disarmed after
+                          FIRE_DISARM_MS, still disarmed when they
+                          come back
+                disarmed  firing while disarmed is refused
+                continuity  before the first scan and on an empty
+                          channel, refused
+                once      a channel fires once per arming
+                busy      six at once: four fire, two refused
+                queue     a full queue drops and counts
+                cut       disarm cuts a 2 s pulse at once, its timer
+                          running out later changes nothing, nor
+                          does an old timer during a newer pulse
+                master    the show path: beacons carry the master's
+                          arm switch (fireBeacon), switching it on
+                          arms and a fire goes out, off disarms. A
+                          switch already on at boot or when beacons
+                          come back doesn't arm until flipped
+
+  Building:  g++ -O2 -Iinclude tools/firesim.cpp -o firesim
+             ./firesim
+
+  10/19/2026.
+===================================================================+*/
+
+#include <fireControl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#define STEP_US 10
+#define TIMER_JITTER_US 150    // esp_timer task dispatch, worst seen under WiFi load
+#define PULSE_TOLERANCE_US 200
+#define BEACON_MS 250          // UDP_SYNC_MS
+#define SCAN_MS 500            // keep in step with FIRE_SCAN_MS in fireChannels.h
+#define CHANNELS 8
+
+static int failures = 0;
+
+struct sTimer
+{
+    uint64_t dueUs;
+    int index;
+};
+
+struct sSim
+{
+    sFireControl fire;
+    sFireQueue queue;
+    uint64_t nowUs = 0;
+    uint32_t present = 0xFF; // igniters fitted
+    bool beacons = true;
+    bool switched = false;     // beacons carry masterSwitch, as from udpFastPath.h
+    bool masterSwitch = false;
+    bool staleTimers = false; // a stop doesn't catch a callback already on its way
+    uint64_t nextBeaconUs = 0;
+    uint64_t nextWakeUs = 0;
+    std::vector<sTimer> timers;
+
+    // What the igniters see.
+    uint32_t driven = 0;
+    uint64_t risenUs[FIRE_CHANNELS_MAX] = {};
+    std::vector<uint32_t> pulses[FIRE_CHANNELS_MAX];
+    int rising = 0;
+    int maxDriven = 0;
+    int accepted = 0;
+    int results[FIRE_RESULTS] = {};
+
+    sSim()
+    {
+        fireInit(fire, CHANNELS);
+        fireQueueInit(queue);
+    }
+
+    uint32_t ms() const { return (uint32_t)(nowUs / 1000); }
+    uint32_t us() const { return (uint32_t)nowUs; }
+
+    // fireShift(): OE off unless armed.
+    void shift()
+    {
+        uint32_t now = fire.armed ? fire.outputs : 0;
+        for (int i = 0; i < FIRE_CHANNELS_MAX; i++)
+        {
+            uint32_t bit = 1u << i;
+            if ((now & bit) && !(driven & bit))
+            {
+                risenUs[i] = nowUs;
+                rising++;
+            }
+            else if (!(now & bit) && (driven & bit))
+            {
+                pulses[i].push_back((uint32_t)(nowUs - risenUs[i]));
+            }
+        }
+        driven = now;
+        maxDriven = __builtin_popcount(driven) > maxDriven ? __builtin_popcount(driven) : maxDriven;
+    }
+
+    void stopTimer(int index)
+    {
+        for (size_t t = 0; !staleTimers && t < timers.size(); t++)
+        {
+            if (timers[t].index == index)
+            {
+                timers.erase(timers.begin() + t--);
+            }
+        }
+    }
+
+    bool submit(uint8_t kind, uint8_t channel = 0, uint16_t pulseMs = 0)
+    {
+        sFireCommand command = {kind, channel, pulseMs};
+        bool queued = fireQueuePush(queue, command);
+        nextWakeUs = nowUs; // xTaskNotifyGive
+        return queued;
+    }
+
+    // fireRun()
+    void run(const sFireCommand &command)
+    {
+        uint32_t pulseUs = 0;
+        FireResult result = FIRE_OK;
+        if (command.kind == FIRE_CMD_ARM)
+        {
+            result = fireArm(fire, ms());
+        }
+        else if (command.kind == FIRE_CMD_DISARM)
+        {
+            fireDisarm(fire, us());
+        }
+        else
+        {
+            result = fireStart(fire, command.channel, command.pulseMs, ms(), us(), pulseUs);
+        }
+        shift();
+        results[result]++;
+        if (command.kind == FIRE_CMD_DISARM)
+        {
+            for (int i = 0; i < fire.channels; i++)
+            {
+                stopTimer(i);
+            }
+        }
+        else if (command.kind == FIRE_CMD_FIRE && result == FIRE_OK)
+        {
+            accepted++;
+            stopTimer(command.channel - 1);
+            timers.push_back({nowUs + pulseUs + rand() % (TIMER_JITTER_US + 1), command.channel - 1});
+        }
+    }
+
+    // fireTask(), one wake.
+    void task()
+    {
+        sFireCommand command;
+        while (fireQueuePop(queue, command))
+        {
+            run(command);
+        }
+        if (fireService(fire, ms(), us()))
+        {
+            shift();
+            for (int i = 0; i < fire.channels; i++)
+            {
+                stopTimer(i);
+            }
+        }
+        if (fire.outputs == 0 && (!fire.continuityValid || ms() - fire.continuityMs >= SCAN_MS))
+        {
+            fireContinuity(fire, present, ms());
+        }
+        nextWakeUs = nowUs + SCAN_MS * 1000;
+    }
+
+    void step()
+    {
+        nowUs += STEP_US;
+        for (size_t t = 0; t < timers.size(); t++)
+        {
+            if (timers[t].dueUs <= nowUs)
+            {
+                if (fireEnd(fire, timers[t].index, us()))
+                {
+                    shift();
+                }
+                timers.erase(timers.begin() + t--);
+            }
+        }
+        if (beacons && nowUs >= nextBeaconUs)
+        {
+            int kind = switched ? fireBeacon(fire, masterSwitch, ms()) : -1;
+            if (kind >= 0)
+            {
+                submit(kind); // fireMasterBeacon()
+            }
+            else if (!switched)
+            {
+                fireHeartbeat(fire, ms());
+            }
+            nextBeaconUs = nowUs + BEACON_MS * 1000;
+        }
+        if (nowUs >= nextWakeUs)
+        {
+            task();
+        }
+    }
+
+    void runMs(uint32_t msToRun)
+    {
+        for (uint64_t end = nowUs + msToRun * 1000ull; nowUs < end;)
+        {
+            step();
+        }
+    }
+
+    // Submit and give the task a step to take it.
+    int command(uint8_t kind, uint8_t channel = 0, uint16_t pulseMs = 0)
+    {
+        int before[FIRE_RESULTS];
+        memcpy(before, results, sizeof(before));
+        submit(kind, channel, pulseMs);
+        step();
+        for (int r = 0; r < FIRE_RESULTS; r++)
+        {
+            if (results[r] != before[r])
+            {
+                return r;
+            }
+        }
+        return -1;
+    }
+};
+
+static void report(const char *name, bool pass, const char *detail)
+{
+    printf("%-10s %-4s %s\n", name, pass ? "PASS" : "FAIL", detail);
+    failures += pass ? 0 : 1;
+}
+
+// A sim with beacons running and the first continuity scan done.
+static void ready(sSim &sim)
+{
+    sim.runMs(100);
+}
+
+static void checkTiming()
+{
+    sSim sim;
+    ready(sim);
+    std::vector<uint32_t> requested[FIRE_CHANNELS_MAX];
+    for (int round = 0; round < 25; round++)
+    {
+        sim.command(FIRE_CMD_ARM);
+        for (int channel = 1; channel <= CHANNELS; channel++)
+        {
+            uint16_t pulseMs = FIRE_PULSE_MIN_MS + rand() % 180;
+            if (sim.command(FIRE_CMD_FIRE, channel, pulseMs) == FIRE_OK)
+            {
+                requested[channel - 1].push_back(pulseMs * 1000u);
+            }
+            sim.runMs(channel % 2 ? 3 : 150); // up to four overlap
+        }
+        sim.runMs(600);
+        sim.command(FIRE_CMD_DISARM);
+        sim.runMs(SCAN_MS + 10);
+    }
+
+    uint32_t worstUs = 0;
+    int pulses = 0;
+    bool matched = true;
+    for (int i = 0; i < CHANNELS; i++)
+    {
+        matched = matched && sim.pulses[i].size() == requested[i].size();
+        for (size_t p = 0; p < sim.pulses[i].size() && p < requested[i].size(); p++)
+        {
+            uint32_t error = (uint32_t)abs((int)sim.pulses[i][p] - (int)requested[i][p]);
+            worstUs = error > worstUs ? error : worstUs;
+            pulses++;
+        }
+    }
+    char detail[96];
+    snprintf(detail, sizeof(detail), "%d pulses, worst %u us off, %d edges for %d fires", pulses, worstUs, sim.rising,
+             sim.accepted);
+    report("timing", matched && pulses == 200 && worstUs <= PULSE_TOLERANCE_US && sim.rising == sim.accepted, detail);
+}
+
+static void checkNoHeartbeat()
+{
+    sSim sim;
+    sim.beacons = false;
+    ready(sim);
+    int result = sim.command(FIRE_CMD_ARM);
+    report("noheart", result == FIRE_NO_HEARTBEAT && !sim.fire.armed, fireResultName(result));
+}
+
+static void checkLost()
+{
+    sSim sim;
+    ready(sim);
+    sim.command(FIRE_CMD_ARM);
+    sim.beacons = false;
+    sim.runMs(FIRE_HEARTBEAT_MS + 50);
+    int refused = sim.command(FIRE_CMD_FIRE, 1, 100);
+    bool armedAfterRefusal = sim.fire.armed;
+    sim.runMs(FIRE_DISARM_MS - FIRE_HEARTBEAT_MS - 300);
+    bool armedBefore = sim.fire.armed;
+    sim.runMs(300 + SCAN_MS + 50); // the task notices on its next wake
+    bool disarmed = !sim.fire.armed && sim.fire.autoDisarms == 1;
+    sim.beacons = true;
+    sim.runMs(1000);
+    int after = sim.command(FIRE_CMD_FIRE, 2, 100);
+    char detail[96];
+    snprintf(detail, sizeof(detail), "%s, then %s after beacons return", fireResultName(refused),
+             fireResultName(after));
+    report("lost",
+           refused == FIRE_NO_HEARTBEAT && armedAfterRefusal && armedBefore && disarmed && after == FIRE_NOT_ARMED &&
+               sim.rising == 0,
+           detail);
+}
+
+static void checkDisarmed()
+{
+    sSim sim;
+    ready(sim);
+    int result = sim.command(FIRE_CMD_FIRE, 1, 100);
+    report("disarmed", result == FIRE_NOT_ARMED && sim.rising == 0, fireResultName(result));
+}
+
+static void checkContinuity()
+{
+    sSim sim;
+    sim.present = 0xFB; // nothing on channel 3
+    fireHeartbeat(sim.fire, 0);
+    fireArm(sim.fire, 0);
+    sFireCommand command = {FIRE_CMD_FIRE, 1, 100};
+    sim.run(command); // ahead of the task's first scan
+    int unscanned = sim.fire.continuityValid ? -1 : sim.results[FIRE_NO_CONTINUITY];
+    sim.runMs(10);
+    int empty = sim.command(FIRE_CMD_FIRE, 3, 100);
+    int fitted = sim.command(FIRE_CMD_FIRE, 2, 100);
+    char detail[96];
+    snprintf(detail, sizeof(detail), "unscanned refused %d, empty %s, fitted %s", unscanned, fireResultName(empty),
+             fireResultName(fitted));
+    report("continuity", unscanned == 1 && empty == FIRE_NO_CONTINUITY && fitted == FIRE_OK, detail);
+}
+
+static void checkOnce()
+{
+    sSim sim;
+    ready(sim);
+    sim.command(FIRE_CMD_ARM);
+    int first = sim.command(FIRE_CMD_FIRE, 1, 50);
+    sim.runMs(100);
+    int again = sim.command(FIRE_CMD_FIRE, 1, 50);
+    sim.command(FIRE_CMD_ARM); // already armed, doesn't reset
+    int stillArmed = sim.command(FIRE_CMD_FIRE, 1, 50);
+    sim.command(FIRE_CMD_DISARM);
+    sim.command(FIRE_CMD_ARM);
+    int rearmed = sim.command(FIRE_CMD_FIRE, 1, 50);
+    sim.runMs(100);
+    char detail[96];
+    snprintf(detail, sizeof(detail), "%s, %s, %s, re-armed %s", fireResultName(first), fireResultName(again),
+             fireResultName(stillArmed), fireResultName(rearmed));
+    report("once",
+           first == FIRE_OK && again == FIRE_ALREADY_FIRED && stillArmed == FIRE_ALREADY_FIRED && rearmed == FIRE_OK &&
+               sim.pulses[0].size() == 2,
+           detail);
+}
+
+static void checkBusy()
+{
+    sSim sim;
+    ready(sim);
+    sim.command(FIRE_CMD_ARM);
+    for (int channel = 1; channel <= 6; channel++)
+    {
+        sim.submit(FIRE_CMD_FIRE, channel, 1000);
+    }
+    sim.step();
+    int ok = sim.results[FIRE_OK] - 1; // less the arm
+    int busy = sim.results[FIRE_BUSY];
+    sim.runMs(1100);
+    int later = sim.command(FIRE_CMD_FIRE, 5, 100);
+    char detail[96];
+    snprintf(detail, sizeof(detail), "%d fired, %d busy, at most %d on, channel 5 after %s", ok, busy, sim.maxDriven,
+             fireResultName(later));
+    report("busy", ok == FIRE_MAX_CONCURRENT && busy == 2 && sim.maxDriven == FIRE_MAX_CONCURRENT && later == FIRE_OK,
+           detail);
+}
+
+static void checkQueue()
+{
+    sSim sim;
+    int queued = 0;
+    for (int i = 0; i < FIRE_QUEUE_SIZE + 4; i++)
+    {
+        queued += sim.submit(FIRE_CMD_FIRE, 1, 100);
+    }
+    sFireCommand command;
+    int popped = 0;
+    while (fireQueuePop(sim.queue, command))
+    {
+        popped++;
+    }
+    bool again = sim.submit(FIRE_CMD_ARM);
+    char detail[96];
+    snprintf(detail, sizeof(detail), "%d queued, %u dropped", queued, sim.queue.dropped);
+    report("queue", queued == FIRE_QUEUE_SIZE && popped == FIRE_QUEUE_SIZE && sim.queue.dropped == 4 && again,
+           detail);
+}
+
+static void checkCut()
+{
+    sSim sim;
+    sim.staleTimers = true; // worst case, every stop is too late
+    ready(sim);
+    sim.command(FIRE_CMD_ARM);
+    sim.command(FIRE_CMD_FIRE, 1, FIRE_PULSE_MAX_MS);
+    sim.runMs(500);
+    sim.command(FIRE_CMD_DISARM);
+    uint32_t cutUs = sim.pulses[0].empty() ? 0 : sim.pulses[0][0];
+    bool cut = sim.driven == 0 && cutUs >= 500000 && cutUs < 501000 && sim.fire.channel[0].onUs == cutUs;
+    sim.runMs(FIRE_PULSE_MAX_MS); // the old timer runs out
+    bool quiet = sim.driven == 0 && sim.rising == 1;
+
+    // Re-arm and fire again before the first pulse's timer is due: it must not end the new one.
+    sim.command(FIRE_CMD_ARM);
+    sim.command(FIRE_CMD_FIRE, 2, FIRE_PULSE_MAX_MS);
+    sim.runMs(300);
+    sim.command(FIRE_CMD_DISARM);
+    sim.command(FIRE_CMD_ARM);
+    sim.command(FIRE_CMD_FIRE, 2, FIRE_PULSE_MAX_MS); // the first one's timer runs out 1.7 s into this
+    sim.runMs(FIRE_PULSE_MAX_MS + 100);
+    uint32_t secondUs = sim.pulses[1].size() == 2 ? sim.pulses[1][1] : 0;
+    bool kept = secondUs >= FIRE_PULSE_MAX_MS * 1000u && secondUs <= FIRE_PULSE_MAX_MS * 1000u + PULSE_TOLERANCE_US;
+    char detail[96];
+    snprintf(detail, sizeof(detail), "cut after %u us, %d edges, next pulse %u us", cutUs, sim.rising, secondUs);
+    report("cut", cut && quiet && kept, detail);
+}
+
+static void checkMaster()
+{
+    sSim sim;
+    sim.switched = true;
+    ready(sim);
+    int off = sim.command(FIRE_CMD_FIRE, 1, 100);
+    sim.masterSwitch = true;
+    sim.runMs(BEACON_MS + 10);
+    bool armed = sim.fire.armed;
+    int fired = sim.command(FIRE_CMD_FIRE, 1, 100);
+    sim.runMs(150);
+    bool pulsed = sim.pulses[0].size() == 1;
+    sim.masterSwitch = false;
+    sim.runMs(BEACON_MS + 10);
+    bool disarmed = !sim.fire.armed;
+    int after = sim.command(FIRE_CMD_FIRE, 2, 100);
+
+    // Beacons lost while armed, back with the switch still on: stays disarmed.
+    sim.masterSwitch = true;
+    sim.runMs(BEACON_MS + 10);
+    sim.beacons = false;
+    sim.runMs(FIRE_DISARM_MS + SCAN_MS + 50);
+    sim.beacons = true;
+    sim.runMs(1000);
+    bool notRearmed = !sim.fire.armed;
+
+    // Switch on before this sub hears the master: disarmed until flipped.
+    sSim late;
+    late.switched = true;
+    late.masterSwitch = true;
+    late.runMs(1000);
+    bool lateDisarmed = !late.fire.armed;
+    late.masterSwitch = false;
+    late.runMs(BEACON_MS + 10);
+    late.masterSwitch = true;
+    late.runMs(BEACON_MS + 10);
+    int lateFired = late.command(FIRE_CMD_FIRE, 3, 100);
+
+    char detail[128];
+    snprintf(detail, sizeof(detail), "off %s, on %s, off again %s, late sub %s after a flip", fireResultName(off),
+             fireResultName(fired), fireResultName(after), fireResultName(lateFired));
+    report("master",
+           off == FIRE_NOT_ARMED && armed && fired == FIRE_OK && pulsed && disarmed && after == FIRE_NOT_ARMED &&
+               notRearmed && lateDisarmed && lateFired == FIRE_OK && sim.rising == 1,
+           detail);
+}
+
+int main()
+{
+    srand(1);
+    checkTiming();
+    checkNoHeartbeat();
+    checkLost();
+    checkDisarmed();
+    checkContinuity();
+    checkOnce();
+    checkBusy();
+    checkQueue();
+    checkCut();
+    checkMaster();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,397 @@
+/*+===================================================================
+  File:      fixedbench.cpp
+
+  Summary:   Host check that the FixedString formatters really stay
+             off the heap. malloc/calloc/realloc and operator new are
+             wrapped with a counter, then every appender and the
+             uptime formats behind zUtils::getLongTime(), getMidTime(),
+             getShortTime() and getMinSec() run over a spread of
+             values. Each must allocate nothing, match snprintf, and
+             stop at N - 1 chars with the terminator in place and the
+             bytes after the buffer untouched.
+
+             Then ns/op for each against the String concatenation it
+             replaced. Arduino's String is stood in for by a small
+             class with the same growth (11 byte SSO, realloc to the
+             exact size on every append), so the allocation counts
+             are what the ESP32 would see.
+
+  Building:  g++ -O2 -Wall -Iinclude tools/fixedbench.cpp -o fixedbench
+             ./fixedbench [iterations]
+
+  10/19/2026.
+===================================================================+*/
+
+#include <fixedString.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <new>
+
+#define BENCH_ITERATIONS 200000
+#define GUARD_BYTE 0xA5
+
+/*--------------------------------------------------------------------
+   Counting allocator
+---------------------------------------------------------------------*/
+
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t count, size_t size);
+extern "C" void *__libc_realloc(void *p, size_t size);
+extern "C" void __libc_free(void *p);
+
+static volatile uint64_t allocations = 0;
+
+extern "C" void *malloc(size_t size)
+{
+    allocations = allocations + 1;
+    return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t count, size_t size)
+{
+    allocations = allocations + 1;
+    return __libc_calloc(count, size);
+}
+
+extern "C" void *realloc(void *p, size_t size)
+{
+    allocations = allocations + 1;
+    return __libc_realloc(p, size);
+}
+
+extern "C" void free(void *p)
+{
+    __libc_free(p);
+}
+
+void *operator new(size_t size)
+{
+    void *p = malloc(size);
+    if (p == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void *p, size_t) noexcept
+{
+    free(p);
+}
+
+/*--------------------------------------------------------------------
+   String stand-in: Arduino WString growth on the ESP32
+---------------------------------------------------------------------*/
+
+class WString
+{
+public:
+    WString() { _sso[0] = 0; }
+    WString(const char *s) : WString() { concat(s, strlen(s)); }
+    WString(uint32_t v, int base = 10) : WString()
+    {
+        char digits[12];
+        size_t n = sizeof(digits);
+        do
+        {
+            digits[--n] = "0123456789abcdef"[v % base];
+            v /= base;
+        } while (v != 0);
+        concat(digits + n, sizeof(digits) - n);
+    }
+    WString(const WString &other) : WString() { concat(other.c_str(), other._len); }
+    ~WString()
+    {
+        if (_heap != nullptr)
+        {
+            free(_heap);
+        }
+    }
+
+    const char *c_str() const { return _heap != nullptr ? _heap : _sso; }
+    size_t length() const { return _len; }
+
+    WString &concat(const char *s, size_t len)
+    {
+        size_t need = _len + len;
+        if (need >= sizeof(_sso))
+        {
+            bool wasSso = _heap == nullptr;
+            _heap = (char *)realloc(_heap, need + 1); // exact fit, like String::reserve()
+            if (wasSso)
+            {
+                memcpy(_heap, _sso, _len);
+            }
+        }
+        char *buf = _heap != nullptr ? _heap : _sso;
+        memcpy(buf + _len, s, len);
+        _len = need;
+        buf[_len] = 0;
+        return *this;
+    }
+
+    WString &operator+(const char *s) { return concat(s, strlen(s)); }
+    WString &operator+(const WString &s) { return concat(s.c_str(), s._len); }
+
+private:
+    char _sso[12] = {0}; // 11 chars + terminator
+    char *_heap = nullptr;
+    size_t _len = 0;
+};
+
+/*--------------------------------------------------------------------
+   The cases: FixedString vs the String code it replaced
+---------------------------------------------------------------------*/
+
+struct sCase
+{
+    const char *name;
+    size_t (*fixed)(uint32_t v, char *out); // copies the text to out if given, returns its length
+    void (*expect)(uint32_t v, char *ref);  // the same text from snprintf
+    size_t (*string)(uint32_t v);
+};
+
+template <size_t N>
+static size_t result(const FixedString<N> &s, char *out)
+{
+    if (out != nullptr)
+    {
+        strcpy(out, s.c_str());
+    }
+    return s.length();
+}
+
+// millis() split the way the String versions did it.
+struct sParts
+{
+    uint32_t d, h, m, s;
+    sParts(uint32_t ms) : d(ms / 86400000), h(ms / 3600000 % 24), m(ms / 60000 % 60), s(ms / 1000 % 60) {}
+};
+
+// Spreads the input over +-10000.00 for the two decimal case.
+static int32_t fixedValue(uint32_t v)
+{
+    return (int32_t)(v % 2000000) - 1000000;
+}
+
+static const sCase cases[] = {
+    {"appendUInt", [](uint32_t v, char *out) { return result(FixedString<16>().appendUInt(v), out); },
+     [](uint32_t v, char *ref) { snprintf(ref, 64, "%u", v); },
+     [](uint32_t v) { return WString(v).length(); }},
+    {"appendInt", [](uint32_t v, char *out) { return result(FixedString<16>().appendInt((int32_t)v), out); },
+     [](uint32_t v, char *ref) { snprintf(ref, 64, "%d", (int32_t)v); },
+     [](uint32_t v) { return (int32_t)v < 0 ? (WString("-") + WString(0 - v)).length() : WString(v).length(); }},
+    {"appendHex", [](uint32_t v, char *out) { return result(FixedString<16>().appendHex(v, 4), out); },
+     [](uint32_t v, char *ref) { snprintf(ref, 64, "%04x", v); },
+     [](uint32_t v) { return WString(v, 16).length(); }},
+    {"appendIP", [](uint32_t v, char *out) { return result(FixedString<16>().appendIP(v), out); },
+     [](uint32_t v, char *ref) { snprintf(ref, 64, "%u.%u.%u.%u", v & 0xFF, (v >> 8) & 0xFF, (v >> 16) & 0xFF, v >> 24); },
+     [](uint32_t v) {
+         return (WString(v & 0xFF) + "." + WString((v >> 8) & 0xFF) + "." + WString((v >> 16) & 0xFF) + "." +
+                 WString(v >> 24))
+             .length();
+     }},
+    {"appendFixed", [](uint32_t v, char *out) { return result(FixedString<16>().appendFixed(fixedValue(v), 2), out); },
+     [](uint32_t v, char *ref) {
+         int32_t value = fixedValue(v);
+         snprintf(ref, 64, "%s%d.%02d", value < 0 ? "-" : "", abs(value) / 100, abs(value) % 100);
+     },
+     [](uint32_t v) {
+         int32_t value = fixedValue(v);
+         uint32_t a = abs(value);
+         WString s(value < 0 ? "-" : "");
+         return (s + WString(a / 100) + "." + (a % 100 < 10 ? "0" : "") + WString(a % 100)).length();
+     }},
+    {"getLongTime", [](uint32_t v, char *out) { return result(formatLongTime(v), out); },
+     [](uint32_t v, char *ref) {
+         sParts p(v);
+         snprintf(ref, 64, "%ud %u:%u:%u:%ums", p.d, p.h, p.m, p.s, v % 1000);
+     },
+     [](uint32_t v) {
+         sParts p(v);
+         return (WString(p.d) + "d " + WString(p.h) + ":" + WString(p.m) + ":" + WString(p.s) + ":" + WString(v % 1000) +
+                 "ms")
+             .length();
+     }},
+    {"getMidTime", [](uint32_t v, char *out) { return result(formatMidTime(v), out); },
+     [](uint32_t v, char *ref) {
+         sParts p(v);
+         snprintf(ref, 64, "%ud %u:%u:%us ", p.d, p.h, p.m, p.s);
+     },
+     [](uint32_t v) {
+         sParts p(v);
+         return (WString(p.d) + "d " + WString(p.h) + ":" + WString(p.m) + ":" + WString(p.s) + "s ").length();
+     }},
+    {"getShortTime", [](uint32_t v, char *out) { return result(formatShortTime(v), out); },
+     [](uint32_t v, char *ref) {
+         sParts p(v);
+         snprintf(ref, 64, "%ud %uh %u m", p.d, p.h, p.m);
+     },
+     [](uint32_t v) {
+         sParts p(v);
+         return (WString(p.d) + "d " + WString(p.h) + "h " + WString(p.m) + " m").length();
+     }},
+    {"getMinSec", [](uint32_t v, char *out) { return result(formatMinSec(v), out); },
+     [](uint32_t v, char *ref) {
+         sParts p(v);
+         snprintf(ref, 64, "%um %us ", p.m, p.s);
+     },
+     [](uint32_t v) {
+         sParts p(v);
+         return (WString(p.m) + "m " + WString(p.s) + "s ").length();
+     }},
+};
+
+static int failures = 0;
+
+static void report(const char *name, bool pass, const char *detail)
+{
+    printf("%-12s %-4s %s\n", name, pass ? "PASS" : "FAIL", detail);
+    failures += pass ? 0 : 1;
+}
+
+// Spread of inputs: small, byte edges, sign edge, the largest millis().
+static uint32_t input(uint32_t i)
+{
+    static const uint32_t edges[] = {0, 9, 10, 255, 256, 65535, 86399999, 86400000, 0x7FFFFFFF, 0x80000000, 0xFFFFFFFF};
+    const uint32_t count = sizeof(edges) / sizeof(edges[0]);
+    return i < count ? edges[i] : (i - count) * 2654435761u;
+}
+
+/*--------------------------------------------------------------------
+   Truncation at N - 1
+---------------------------------------------------------------------*/
+
+template <size_t N>
+struct sGuarded
+{
+    FixedString<N> s;
+    uint8_t guard[16];
+};
+
+// Fills a FixedString<N> with (N - 1 - room) chars, applies op and checks it
+// kept exactly the first N - 1 chars of the full answer, terminator included.
+template <size_t N, typename Op>
+static bool truncates(size_t room, const char *full, Op op)
+{
+    sGuarded<N> g;
+    memset(g.guard, GUARD_BYTE, sizeof(g.guard));
+    for (size_t i = 0; i + 1 + room < N; i++)
+    {
+        g.s.append('x');
+    }
+    op(g.s);
+
+    size_t want = N - 1 - room + strlen(full);
+    bool cut = want > N - 1;
+    bool ok = g.s.length() == (cut ? N - 1 : want) && g.s.truncated() == cut && g.s.c_str()[g.s.length()] == 0;
+    ok = ok && strncmp(g.s.c_str() + (N - 1 - room), full, g.s.length() - (N - 1 - room)) == 0;
+    for (uint8_t b : g.guard)
+    {
+        ok = ok && b == GUARD_BYTE;
+    }
+    return ok;
+}
+
+static bool truncationChecks(uint32_t &checked)
+{
+    bool ok = true;
+    for (size_t room = 0; room <= 11; room++)
+    {
+        ok = ok && truncates<12>(room, "4294967295", [](FixedString<12> &s) { s.appendUInt(4294967295u); });
+        ok = ok && truncates<12>(room, "-2147483648", [](FixedString<12> &s) { s.appendInt(INT32_MIN); });
+        ok = ok && truncates<12>(room, "deadbeef", [](FixedString<12> &s) { s.appendHex(0xDEADBEEF); });
+        ok = ok && truncates<12>(room, "192.168.4.1", [](FixedString<12> &s) { s.appendIP(0x0104A8C0); });
+        ok = ok && truncates<12>(room, "-123.45", [](FixedString<12> &s) { s.appendFixed(-12345, 2); });
+        ok = ok && truncates<12>(room, "-21474836.48", [](FixedString<12> &s) { s.appendFixed(INT32_MIN, 2); });
+        ok = ok && truncates<12>(room, "abcdefghijklmnop", [](FixedString<12> &s) { s.append("abcdefghijklmnop"); });
+        checked += 7;
+    }
+
+    // The longest uptime still fits a TimeString, nothing is cut.
+    ok = ok && !formatLongTime(0xFFFFFFFF).truncated() && !formatMidTime(0xFFFFFFFF).truncated();
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t iterations = argc > 1 ? atoi(argv[1]) : BENCH_ITERATIONS;
+    const size_t caseCount = sizeof(cases) / sizeof(cases[0]);
+    char detail[160];
+    char ref[64];
+
+    for (size_t c = 0; c < caseCount; c++)
+    {
+        uint32_t mismatched = 0;
+        uint64_t fixedAllocs = 0;
+        for (uint32_t i = 0; i < 10000; i++)
+        {
+            char got[64];
+            uint64_t before = allocations;
+            cases[c].fixed(input(i), got);
+            fixedAllocs += allocations - before;
+            cases[c].expect(input(i), ref);
+            mismatched += strcmp(got, ref) != 0;
+        }
+
+        uint64_t before = allocations;        for (uint32_t i = 0; i < 10000; i++)
+        {
+            cases[c].string(input(i));
+        }
+        double stringAllocs = (allocations - before) / 10000.0;
+
+        snprintf(detail, sizeof(detail), "%llu allocations (String %.1f per call), %u of 10000 differ from snprintf",
+                 (unsigned long long)fixedAllocs, stringAllocs, mismatched);
+        report(cases[c].name, fixedAllocs == 0 && mismatched == 0, detail);
+    }
+
+    uint32_t checked = 0;
+    uint64_t before = allocations;
+    bool truncOk = truncationChecks(checked);
+    snprintf(detail, sizeof(detail), "%u cases at N - 1, guard bytes intact, %llu allocations", checked,
+             (unsigned long long)(allocations - before));
+    report("truncation", truncOk && allocations == before, detail);
+
+    printf("\n%-12s %10s %10s\n", "ns/op", "Fixed", "String");
+    for (size_t c = 0; c < caseCount; c++)
+    {
+        volatile size_t sink = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < iterations; i++)
+        {
+            sink = sink + cases[c].fixed(input(i), nullptr);
+        }
+        double fixedNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < iterations; i++)
+        {
+            sink = sink + cases[c].string(input(i));
+        }
+        double stringNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        printf("%-12s %10.1f %10.1f\n", cases[c].name, fixedNs / iterations, stringNs / iterations);
+    }
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,138 @@
+/*+===================================================================
+  File:      hsvbench.cpp
+
+  Summary:   Host check and timing for hsvConvert.h.
+
+                exact   hsvToRgbBatch() and the hue LUT against
+                        hsvRainbowReference() for all 2^24 HSV values
+                time    ns per pixel at 256 to 8192 pixels: per-pixel
+                        reference (what CRGB = CHSV costs), the batch
+                        pass, and the hue LUT
+
+             The reference is a port, so it's only as good as its
+             match to FastLED; effectCheck.h compares the batch path
+             with the library itself on the device.
+
+  Building:  g++ -O2 -Iinclude tools/hsvbench.cpp -o hsvbench
+             ./hsvbench
+
+  10/19/2026.
+===================================================================+*/
+
+#include <hsvConvert.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#define BENCH_REPEATS 200
+#define BENCH_ROUNDS 5
+
+static std::mt19937 rng(5);
+static int failures = 0;
+static sHsvTables tables;
+
+static void result(bool pass, const char *name)
+{
+    printf("%-6s %s\n", name, pass ? "PASS" : "FAIL");
+    failures += pass ? 0 : 1;
+}
+
+static void testExact()
+{
+    uint8_t hsv[256 * 3];
+    uint8_t batch[256 * 3];
+    uint8_t fromLut[256 * 3];
+    uint8_t hues[256];
+    sHsvHueLut lut;
+    uint32_t batchMismatches = 0;
+    uint32_t lutMismatches = 0;
+    for (int i = 0; i < 256; i++)
+    {
+        hues[i] = i;
+    }
+    for (int sat = 0; sat < 256; sat++)
+    {
+        for (int val = 0; val < 256; val++)
+        {
+            for (int hue = 0; hue < 256; hue++)
+            {
+                hsv[hue * 3] = hue;
+                hsv[hue * 3 + 1] = sat;
+                hsv[hue * 3 + 2] = val;
+            }
+            hsvToRgbBatch(tables, hsv, batch, 256);
+            hsvBuildHueLut(tables, lut, sat, val);
+            hsvHueToRgbBatch(lut, hues, fromLut, 256);
+            for (int hue = 0; hue < 256; hue++)
+            {
+                uint8_t expected[3];
+                hsvRainbowReference(hue, sat, val, expected);
+                batchMismatches += memcmp(expected, batch + hue * 3, 3) != 0;
+                lutMismatches += memcmp(expected, fromLut + hue * 3, 3) != 0;
+            }
+        }
+    }
+    printf("       16777216 values, batch mismatches %u, hue LUT mismatches %u\n", batchMismatches, lutMismatches);
+    result(batchMismatches == 0 && lutMismatches == 0, "exact");
+}
+
+template <typename Fn> static double nsPerPixel(size_t count, Fn fn)
+{
+    double best = 1e30;
+    for (int round = 0; round < BENCH_ROUNDS; round++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < BENCH_REPEATS; r++)
+        {
+            fn();
+        }
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        best = ns < best ? ns : best;
+    }
+    return best / BENCH_REPEATS / count;
+}
+
+static void testTime()
+{
+    printf("       ns/pixel  %10s %10s %10s\n", "per-pixel", "batch", "hue LUT");
+    sHsvHueLut lut;
+    hsvBuildHueLut(tables, lut, 255, 200);
+    for (size_t count : {256, 1024, 4096, 8192})
+    {
+        std::vector<uint8_t> hsv(count * 3), rgb(count * 3), hues(count);
+        for (uint8_t &b : hsv)
+        {
+            b = rng();
+        }
+        for (uint8_t &b : hues)
+        {
+            b = rng();
+        }
+        double single = nsPerPixel(count, [&] {
+            for (size_t i = 0; i < count; i++)
+            {
+                hsvRainbowReference(hsv[i * 3], hsv[i * 3 + 1], hsv[i * 3 + 2], &rgb[i * 3]);
+            }
+            __asm__ __volatile__("" : : "r"(rgb.data()) : "memory");
+        });
+        double batch = nsPerPixel(count, [&] {
+            hsvToRgbBatch(tables, hsv.data(), rgb.data(), count);
+            __asm__ __volatile__("" : : "r"(rgb.data()) : "memory");
+        });
+        double fromLut = nsPerPixel(count, [&] {
+            hsvHueToRgbBatch(lut, hues.data(), rgb.data(), count);
+            __asm__ __volatile__("" : : "r"(rgb.data()) : "memory");
+        });
+        printf("       %8zu  %10.2f %10.2f %10.2f\n", count, single, batch, fromLut);
+    }
+}
+
+int main()
+{
+    hsvTablesInit(tables);
+    testExact();
+    testTime();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,291 @@
+/*+===================================================================
+  File:      i2cbench.cpp
+
+  Summary:   Host test for i2cSchedule.h against a mock 400 kHz bus.
+             Transactions cost 9 bit times per byte plus start/stop,
+             and the loop below plays the i2c task from i2cBus.h:
+             take an op, copy the chunk from the shadow, spend its
+             bus time, repeat.
+
+                order     sensor reads come out FIFO and ahead of a
+                          fresh frame, chunks go out in screen order
+                latency   30 fps full frame redraws with a sensor
+                          read every 100 ms, worst sensor wait against
+                          pushing every frame synchronously
+                starve    sensor queue kept full, a frame still
+                          lands within the aging bound
+                partial   status screen where one line changes per
+                          redraw, bus time against full sendBuffer()
+
+             Every scenario also checks the mock panel ends up
+             showing the last frame pushed.
+
+  Building:  g++ -O2 -Iinclude tools/i2cbench.cpp -o i2cbench
+             ./i2cbench [frameBytes]
+
+  10/19/2026.
+===================================================================+*/
+
+#include <i2cSchedule.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <random>
+#include <vector>
+
+#define I2C_CLOCK_HZ 400000 // keep in step with i2cBus.h
+#define BUS_BYTE_US (9 * 1000000.0 / I2C_CLOCK_HZ)
+#define BUS_START_STOP_US 5.0
+
+static std::mt19937 rng(7);
+static int failures = 0;
+static size_t frameBytes = 1024;
+
+// A complete transaction of n bytes, address byte included.
+static double transactionUs(int bytes)
+{
+    return BUS_START_STOP_US + bytes * BUS_BYTE_US;
+}
+
+// Address/page command then the chunk data, as i2cSendChunk() does.
+static double chunkUs()
+{
+    return transactionUs(2 + 3) + transactionUs(2 + I2C_CHUNK_BYTES);
+}
+
+// Register write, repeated start, read.
+static double sensorUs(const sI2cRequest &request)
+{
+    return transactionUs(1 + request.writeLen) + transactionUs(1 + request.readLen);
+}
+
+struct sMockBus
+{
+    sI2cSchedule sched;
+    std::vector<uint8_t> shadow;
+    std::vector<uint8_t> panel;
+    double nowUs = 0;
+    double busyUs = 0;
+    std::vector<uint8_t> sensorLog; // addresses in the order they hit the bus.
+    std::vector<uint8_t> chunkLog;
+    double worstSensorUs = 0;
+
+    sMockBus() : shadow(frameBytes, 0), panel(frameBytes, 0)
+    {
+        i2cScheduleInit(sched);
+    }
+
+    uint32_t ms() const
+    {
+        return (uint32_t)(nowUs / 1000);
+    }
+
+    void push(const std::vector<uint8_t> &framebuffer)
+    {
+        i2cScheduleDisplay(sched, i2cDiffChunks(shadow.data(), framebuffer.data(), frameBytes), ms());
+    }
+
+    bool read(uint8_t addr, sI2cResult &result)
+    {
+        sI2cRequest request = {addr, 1, {0x27}, 3, &result, 0};
+        return i2cScheduleSubmit(sched, request, ms());
+    }
+
+    // One turn of the bus task, false when idle.
+    bool step()
+    {
+        sI2cOp op;
+        if (!i2cScheduleNext(sched, ms(), op))
+        {
+            return false;
+        }
+        double cost;
+        if (op.kind == I2C_OP_SENSOR)
+        {
+            cost = sensorUs(op.request);
+            sensorLog.push_back(op.request.addr);
+            for (uint8_t i = 0; i < op.request.readLen; i++)
+            {
+                op.request.result->data[i] = op.request.addr + i;
+            }
+            op.request.result->state = I2C_DONE;
+            double waited = nowUs + cost - op.request.queuedAt * 1000.0;
+            worstSensorUs = waited > worstSensorUs ? waited : worstSensorUs;
+        }
+        else
+        {
+            cost = chunkUs();
+            chunkLog.push_back(op.chunk);
+            size_t offset = op.chunk * I2C_CHUNK_BYTES;
+            memcpy(panel.data() + offset, shadow.data() + offset, I2C_CHUNK_BYTES);
+        }
+        nowUs += cost;
+        busyUs += cost;
+        return true;
+    }
+
+    // Run the bus until untilUs, idling forward when there's nothing queued.
+    void runUntil(double untilUs)
+    {
+        while (nowUs < untilUs)
+        {
+            if (!step())
+            {
+                nowUs = untilUs;
+            }
+        }
+    }
+
+    bool showing(const std::vector<uint8_t> &framebuffer) const
+    {
+        return panel == framebuffer;
+    }
+};
+
+static std::vector<uint8_t> randomFrame()
+{
+    std::vector<uint8_t> frame(frameBytes);
+    for (uint8_t &b : frame)
+    {
+        b = rng();
+    }
+    return frame;
+}
+
+static void result(bool pass, const char *name)
+{
+    printf("%-8s %s\n", name, pass ? "PASS" : "FAIL");
+    failures += pass ? 0 : 1;
+}
+
+static void testOrder()
+{
+    sMockBus bus;
+    std::vector<uint8_t> frame = randomFrame();
+    sI2cResult results[5];
+    bus.push(frame);
+    for (uint8_t i = 0; i < 5; i++)
+    {
+        bus.read(0x50 + i, results[i]);
+    }
+    bus.runUntil(100000);
+
+    bool fifo = bus.sensorLog.size() == 5;
+    for (size_t i = 0; fifo && i < 5; i++)
+    {
+        fifo = bus.sensorLog[i] == 0x50 + i && results[i].state == I2C_DONE && results[i].data[0] == 0x50 + i;
+    }
+    bool screenOrder = bus.chunkLog.size() == frameBytes / I2C_CHUNK_BYTES;
+    for (size_t i = 0; screenOrder && i < bus.chunkLog.size(); i++)
+    {
+        screenOrder = bus.chunkLog[i] == i;
+    }
+    printf("         sensors %zu FIFO %s, chunks %zu in screen order %s, sensors before first chunk\n",
+           bus.sensorLog.size(), fifo ? "yes" : "no", bus.chunkLog.size(), screenOrder ? "yes" : "no");
+    result(fifo && screenOrder && bus.showing(frame) && bus.sched.stats.chunksAged == 0, "order");
+}
+
+static void testLatency()
+{
+    sMockBus bus;
+    std::vector<uint8_t> frame;
+    sI2cResult sensor = {};
+    sensor.state = I2C_IDLE;
+    int reads = 0;
+    for (double t = 0; t < 10e6; t += 1000)
+    {
+        if ((int)t % 33000 == 0)
+        {
+            frame = randomFrame();
+            bus.push(frame);
+        }
+        if ((int)t % 100000 == 0 && sensor.state != I2C_QUEUED)
+        {
+            reads += bus.read(0x5B, sensor) ? 1 : 0;
+        }
+        bus.runUntil(t + 1000);
+    }
+    bus.runUntil(bus.nowUs + 100000);
+
+    // Synchronously a read can land just after a whole frame started going out.
+    double frameUs = chunkUs() * (frameBytes / I2C_CHUNK_BYTES);
+    double syncWorstUs = frameUs + sensorUs({0x5B, 1, {0}, 3, nullptr, 0});
+    // Timestamps are whole ms, so allow one ms of rounding on top of a chunk.
+    bool pass = bus.worstSensorUs <= chunkUs() + 2 * sensorUs({0x5B, 1, {0}, 3, nullptr, 0}) + 1000 &&
+                (int)bus.sensorLog.size() == reads && bus.showing(frame);
+    printf("         %d reads, worst sensor wait %.2f ms (synchronous %.2f ms), bus %.0f%% busy, "
+           "%u chunks coalesced\n",
+           reads, bus.worstSensorUs / 1000, syncWorstUs / 1000, 100 * bus.busyUs / bus.nowUs,
+           bus.sched.stats.chunksCoalesced);
+    result(pass, "latency");
+}
+
+static void testStarvation()
+{
+    sMockBus bus;
+    sI2cResult results[I2C_QUEUE_SIZE];
+    std::vector<uint8_t> frame = randomFrame();
+    bus.push(frame);
+    double landedUs = -1;
+    size_t next = 0;
+    for (double t = 0; t < 5e6 && landedUs < 0; t += 100)
+    {
+        while (bus.sched.count < I2C_QUEUE_SIZE)
+        {
+            bus.read(0x5B, results[next++ % I2C_QUEUE_SIZE]);
+        }
+        bus.runUntil(t + 100);
+        if (bus.sched.dirtyChunks == 0 && bus.showing(frame))
+        {
+            landedUs = bus.nowUs;
+        }
+    }
+
+    int chunks = frameBytes / I2C_CHUNK_BYTES;
+    double boundUs = chunks * (I2C_DISPLAY_MAX_WAIT_MS * 1000.0 + 1000 + chunkUs() + sensorUs({0x5B, 1, {0}, 3, nullptr, 0}));
+    printf("         frame landed after %.0f ms under a full sensor queue (bound %.0f ms), %u sensor ops, "
+           "%u chunks aged\n",
+           landedUs / 1000, boundUs / 1000, bus.sched.stats.sensorOps, bus.sched.stats.chunksAged);
+    result(landedUs >= 0 && landedUs <= boundUs, "starve");
+}
+
+static void testPartial()
+{
+    sMockBus bus;
+    std::vector<uint8_t> frame = randomFrame();
+    bus.push(frame);
+    bus.runUntil(100000);
+    double startUs = bus.busyUs;
+    int redraws = 100;
+    for (int i = 0; i < redraws; i++)
+    {
+        // One text line: the last page's worth of bytes.
+        for (size_t b = frameBytes - 128; b < frameBytes; b++)
+        {
+            frame[b] = rng();
+        }
+        bus.push(frame);
+        bus.runUntil(bus.nowUs + 1000000);
+    }
+    double perRedrawUs = (bus.busyUs - startUs) / redraws;
+    double fullUs = transactionUs(2 + 6) + transactionUs(1 + frameBytes); // sendBuffer(): window, then the lot
+    printf("         one changed line costs %.2f ms of bus, a full sendBuffer() %.2f ms\n", perRedrawUs / 1000,
+           fullUs / 1000);
+    result(bus.showing(frame) && perRedrawUs < fullUs / 2, "partial");
+}
+
+int main(int argc, char **argv)
+{
+    frameBytes = argc > 1 ? atoi(argv[1]) : 1024;
+    if (frameBytes % I2C_CHUNK_BYTES || frameBytes / I2C_CHUNK_BYTES > I2C_MAX_CHUNKS || frameBytes < 256)
+    {
+        printf("frameBytes must be a multiple of %d, 256 to %d\n", I2C_CHUNK_BYTES, I2C_CHUNK_BYTES * I2C_MAX_CHUNKS);
+        return 2;
+    }
+    printf("%zu byte frame, %d byte chunks at %.2f ms each, %d kHz\n", frameBytes, I2C_CHUNK_BYTES, chunkUs() / 1000,
+           I2C_CLOCK_HZ / 1000);
+    testOrder();
+    testLatency();
+    testStarvation();
+    testPartial();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,202 @@
+/*+===================================================================
+  File:      inputbench.cpp
+
+  Summary:   Host test for inputFilter.h with synthetic ADC and
+             button traces, sampled at INPUT_SAMPLE_MS like the
+             firmware's timer:
+
+                noise    knob parked on a level boundary with ADC
+                         noise and the odd spike, counts the events
+                         that leak through (chatter)
+                step     knob snapped end to end, time until the
+                         level reaches 255 and back to 0
+                sweep    slow turn end to end, levels must be
+                         monotonic and hit both ends
+                button   presses with contact bounce, edges drive
+                         the sampler like the pin interrupt does
+                queue    producer and consumer threads through the
+                         SPSC ring, nothing lost or reordered
+
+  Building:  g++ -O2 -pthread -Iinclude tools/inputbench.cpp -o inputbench
+             ./inputbench [noiseSigma]
+
+  10/19/2026.
+===================================================================+*/
+
+#include <inputFilter.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <random>
+#include <thread>
+
+#define INPUT_SAMPLE_MS 5 // keep in step with hardwareInput.h
+
+static std::mt19937 rng(1234);
+static int failures = 0;
+
+static void result(bool pass, const char *name)
+{
+    printf("%-7s %s\n", name, pass ? "PASS" : "FAIL");
+    failures += pass ? 0 : 1;
+}
+
+static uint16_t adc(double value, double sigma)
+{
+    std::normal_distribution<double> noise(0, sigma);
+    double v = value + noise(rng);
+    if (std::uniform_int_distribution<int>(0, 99)(rng) == 0)
+    {
+        v += std::uniform_int_distribution<int>(-200, 200)(rng); // spike
+    }
+    return v < 0 ? 0 : (v > INPUT_ADC_MAX ? INPUT_ADC_MAX : (uint16_t)v);
+}
+
+static void testNoise(double sigma)
+{
+    int worst = 0;
+    for (int boundary = 16; boundary < INPUT_ADC_MAX; boundary += 16 * 17)
+    {
+        sKnobFilter knob;
+        knobInit(knob);
+        int events = 0;
+        for (int t = 0; t < 10000 / INPUT_SAMPLE_MS; t++)
+        {
+            events += knobSample(knob, adc(boundary, sigma)) >= 0 ? 1 : 0;
+        }
+        worst = events - 1 > worst ? events - 1 : worst; // the first event is the knob's starting level
+    }
+    printf("        sigma %.0f counts, worst chatter %d events in 10 s\n", sigma, worst);
+    result(worst <= 2, "noise");
+}
+
+static void testStep(double sigma)
+{
+    sKnobFilter knob;
+    knobInit(knob);
+    knobSample(knob, 0);
+    int upMs = -1;
+    int downMs = -1;
+    for (int t = 0; t < 400; t++)
+    {
+        if (knobSample(knob, adc(INPUT_ADC_MAX, sigma)) == 255 && upMs < 0)
+        {
+            upMs = (t + 1) * INPUT_SAMPLE_MS;
+        }
+    }
+    for (int t = 0; t < 400; t++)
+    {
+        if (knobSample(knob, adc(0, sigma)) == 0 && downMs < 0)
+        {
+            downMs = (t + 1) * INPUT_SAMPLE_MS;
+        }
+    }
+    printf("        0 -> 255 in %d ms, 255 -> 0 in %d ms\n", upMs, downMs);
+    result(upMs > 0 && upMs <= 250 && downMs > 0 && downMs <= 250, "step");
+}
+
+static void testSweep(double sigma)
+{
+    sKnobFilter knob;
+    knobInit(knob);
+    int last = -1;
+    int events = 0;
+    bool monotonic = true;
+    int steps = 2000 / INPUT_SAMPLE_MS;
+    for (int t = 0; t <= steps + 100; t++)
+    {
+        double value = t >= steps ? INPUT_ADC_MAX : (double)INPUT_ADC_MAX * t / steps;
+        int level = knobSample(knob, adc(value, sigma));
+        if (level >= 0)
+        {
+            monotonic = monotonic && level > last;
+            last = level;
+            events++;
+        }
+    }
+    printf("        2 s sweep: %d events, ends at %d\n", events, last);
+    result(monotonic && last == 255 && events > 100, "sweep");
+}
+
+static void testButton()
+{
+    sDebounce button;
+    debounceInit(button, 0);
+    std::uniform_int_distribution<int> coin(0, 1);
+    int presses = 0;
+    int expected = 20;
+    uint32_t now = 0;
+    uint8_t pin = 0;
+    bool edge = false;
+    for (int press = 0; press < expected; press++)
+    {
+        // 1 ms trace: 8 ms of bounce into the new level, hold, same on release.
+        for (int phase = 0; phase < 2; phase++)
+        {
+            uint8_t target = phase == 0 ? 1 : 0;
+            for (int ms = 0; ms < 150; ms++, now++)
+            {
+                uint8_t level = ms < 8 ? coin(rng) : target;
+                edge = edge || level != pin;
+                pin = level;
+                if (now % INPUT_SAMPLE_MS == 0 && (edge || debounceBusy(button)))
+                {
+                    edge = false;
+                    presses += debounceSample(button, pin, now) ? 1 : 0;
+                }
+            }
+        }
+    }
+    printf("        %d presses with bounce, %d reported\n", expected, presses);
+    result(presses == expected, "button");
+}
+
+static void testQueue()
+{
+    static sInputQueue queue;
+    inputQueueInit(queue);
+    const uint32_t count = 200000;
+    uint32_t received = 0;
+    bool ordered = true;
+    std::thread consumer([&]()
+                         {
+        uint8_t expect = 0;
+        bool first = true;
+        sInputEvent event;
+        while (received < count)
+        {
+            if (inputQueuePop(queue, event))
+            {
+                ordered = ordered && (first || event.value == (uint8_t)(expect + 1));
+                expect = event.value;
+                first = false;
+                received++;
+            }
+            else
+            {
+                std::this_thread::sleep_for(std::chrono::microseconds(1));
+            }
+        } });
+    for (uint32_t i = 0; i < count; i++)
+    {
+        sInputEvent event = {INPUT_BRIGHTNESS, (uint8_t)i};
+        while (!inputQueuePush(queue, event))
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(1)); // full, the firmware drops instead
+        }
+    }
+    consumer.join();
+    printf("        %u pushed, %u received in order, queue full %u times\n", count, received, queue.dropped);
+    result(ordered && received == count, "queue");
+}
+
+int main(int argc, char **argv)
+{
+    double sigma = argc > 1 ? atof(argv[1]) : 12;
+    testNoise(sigma);
+    testStep(sigma);
+    testSweep(sigma);
+    testButton();
+    testQueue();
+    return failures == 0 ? 0 : 1;
+}
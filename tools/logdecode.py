@@ -0,0 +1,140 @@
+#!/usr/bin/env python3
+"""
+  File:      logdecode.py
+
+  Summary:   Turns an event log dump (GET /api/log?format=bin, see
+             include/eventLog.h) into text. The event names and
+             formats are read from the LOG_EVENTS table in
+             eventLog.h, so the decoder always matches the firmware
+             it sits next to. Give it an older eventLog.h with
+             --events for a dump from an older build.
+
+             Reads a saved dump, or fetches one with --host (and
+             keeps it with --save). Times are ms since that boot.
+
+             --selftest decodes a dump built here and prints PASS or
+             FAIL.
+
+  Usage:     python tools/logdecode.py --host 192.168.4.1
+             python tools/logdecode.py --host 192.168.4.1 --save log.bin
+             python tools/logdecode.py log.bin
+             python tools/logdecode.py --selftest
+
+  10/19/2026.
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+import urllib.request
+
+HEADER = struct.Struct("<IHHIII")  # sLogDumpHeader
+RECORD = struct.Struct("<IHHii")   # sLogRecord
+MAGIC = 0x474C5742
+VERSION = 1
+DEFAULT_EVENTS = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "include", "eventLog.h")
+
+
+def load_events(path):
+    with open(path) as f:
+        text = f.read()
+    return [(name, fmt) for _, name, fmt in re.findall(r'X\((\w+),\s*"([^"]*)",\s*"([^"]*)"\)', text)]
+
+
+def format_args(fmt, args):
+    out = []
+    args = list(args)
+    i = 0
+    while i < len(fmt):
+        c = fmt[i]
+        if c != "%" or i + 1 == len(fmt):
+            out.append(c)
+            i += 1
+            continue
+        spec = fmt[i + 1]
+        value = args.pop(0) if args else 0
+        if spec == "d":
+            out.append("%d" % value)
+        elif spec == "x":
+            out.append("%x" % (value & 0xFFFFFFFF))
+        elif spec == "I":
+            value &= 0xFFFFFFFF
+            out.append("%d.%d.%d.%d" % (value & 0xFF, (value >> 8) & 0xFF, (value >> 16) & 0xFF, value >> 24))
+        else:
+            out.append("%u" % (value & 0xFFFFFFFF))
+        i += 2
+    return "".join(out)
+
+
+def decode(data, events):
+    if len(data) < HEADER.size:
+        raise ValueError("dump too short")
+    magic, version, record_size, boots, head, count = HEADER.unpack_from(data)
+    if magic != MAGIC or version != VERSION or record_size != RECORD.size:
+        raise ValueError("not an event log dump, or a version this decoder doesn't know")
+    lines = ["%u events logged, last %u, boot %u when dumped" % (head, count, boots)]
+    offset = HEADER.size
+    for _ in range(count):
+        if offset + RECORD.size > len(data):
+            raise ValueError("dump truncated")
+        ms, boot, event, a, b = RECORD.unpack_from(data, offset)
+        offset += RECORD.size
+        name, fmt = events[event] if event < len(events) else ("?", "event %u")
+        lines.append("boot %u %8u ms  %-7s %s" % (boot, ms, name, format_args(fmt, (a, b))))
+    return lines
+
+
+def selftest(events):
+    connect = next(i for i, (_, fmt) in enumerate(events) if "%I" in fmt)
+    records = [RECORD.pack(12, 3, 0, 12, 3), RECORD.pack(4500, 3, connect, 7, 0x0104A8C0)]  # boot, then 192.168.4.1
+    data = HEADER.pack(MAGIC, VERSION, RECORD.size, 3, 42, len(records)) + b"".join(records)
+    lines = decode(data, events)
+    ok = len(lines) == 3 and "42 events" in lines[0]
+    ok = ok and lines[1].startswith("boot 3       12 ms") and "reset reason 12, boot 3" in lines[1]
+    ok = ok and "192.168.4.1" in lines[2] and "#7" in lines[2]
+    try:
+        decode(data[:-4], events)
+        ok = False
+    except ValueError:
+        pass
+    print("\n".join(lines))
+    print("PASS" if ok else "FAIL")
+    return 0 if ok else 1
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode a BangWorx event log dump.")
+    parser.add_argument("dump", nargs="?", help="a saved /api/log?format=bin dump")
+    parser.add_argument("--host", help="fetch the dump from this device")
+    parser.add_argument("--save", help="also write the fetched dump here")
+    parser.add_argument("--events", default=DEFAULT_EVENTS, help="eventLog.h with the LOG_EVENTS table")
+    parser.add_argument("--selftest", action="store_true")
+    args = parser.parse_args()
+
+    events = load_events(args.events)
+    if args.selftest:
+        return selftest(events)
+    if args.host:
+        with urllib.request.urlopen("http://%s/api/log?format=bin" % args.host, timeout=5) as response:
+            data = response.read()
+        if args.save:
+            with open(args.save, "wb") as f:
+                f.write(data)
+    elif args.dump:
+        with open(args.dump, "rb") as f:
+            data = f.read()
+    else:
+        parser.error("give a dump file or --host")
+
+    try:
+        print("\n".join(decode(data, events)))
+    except ValueError as e:
+        print("logdecode: %s" % e, file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,219 @@
+/*+===================================================================
+  File:      memsoak.cpp
+
+  Summary:   Host soak test for memStats.h. All C++ allocations go
+             through a small first-fit arena the size of the ESP32
+             heap, so free / largest block / minimum free are real
+             numbers from a real (if simple) allocator. A loop then
+             imitates the firmware's message churn, samples into the
+             same ring the device uses and prints the same compact
+             pushes and /api/mem JSON.
+
+  Building:  g++ -O2 -Iinclude tools/memsoak.cpp -o memsoak
+             ./memsoak [string|fixed] [ticks]
+
+             "string" builds each push by concatenation and keeps a
+             few queued (like AsyncWebSocket does), "fixed" builds
+             them in a FixedString. Watch largest and frag.
+
+  10/19/2026.
+===================================================================+*/
+
+#include <fixedString.h>
+#include <memStats.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <deque>
+#include <new>
+#include <string>
+#include <vector>
+
+#define ARENA_SIZE (160 * 1024) // roughly what's left on the device after WiFi
+#define ARENA_ALIGN 8
+
+/*--------------------------------------------------------------------
+   Tracking allocator
+---------------------------------------------------------------------*/
+
+struct sBlock
+{
+    uint32_t size; // payload bytes, multiple of ARENA_ALIGN.
+    uint32_t used;
+};
+
+alignas(ARENA_ALIGN) static uint8_t arena[ARENA_SIZE];
+static bool arenaReady = false;
+static uint32_t arenaFree = 0;
+static uint32_t arenaMinFree = 0;
+
+static sBlock *arenaNext(sBlock *b)
+{
+    return (sBlock *)((uint8_t *)b + sizeof(sBlock) + b->size);
+}
+
+static bool arenaInRange(sBlock *b)
+{
+    return (uint8_t *)b < arena + ARENA_SIZE;
+}
+
+static void arenaInit()
+{
+    sBlock *b = (sBlock *)arena;
+    b->size = ARENA_SIZE - sizeof(sBlock);
+    b->used = 0;
+    arenaFree = arenaMinFree = b->size;
+    arenaReady = true;
+}
+
+static void *arenaAlloc(size_t size)
+{
+    if (!arenaReady)
+    {
+        arenaInit();
+    }
+    size = (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+    for (sBlock *b = (sBlock *)arena; arenaInRange(b); b = arenaNext(b))
+    {
+        if (b->used || b->size < size)
+        {
+            continue;
+        }
+        if (b->size >= size + sizeof(sBlock) + ARENA_ALIGN)
+        {
+            sBlock *rest = (sBlock *)((uint8_t *)b + sizeof(sBlock) + size);
+            rest->size = b->size - size - sizeof(sBlock);
+            rest->used = 0;
+            b->size = size;
+            arenaFree -= sizeof(sBlock);
+        }
+        b->used = 1;
+        arenaFree -= b->size;
+        arenaMinFree = arenaFree < arenaMinFree ? arenaFree : arenaMinFree;
+        return b + 1;
+    }
+    return nullptr;
+}
+
+static void arenaRelease(void *p)
+{
+    if (!p)
+    {
+        return;
+    }
+    sBlock *b = (sBlock *)p - 1;
+    b->used = 0;
+    arenaFree += b->size;
+
+    // Coalesce every run of free neighbours.
+    for (sBlock *c = (sBlock *)arena; arenaInRange(c); c = arenaNext(c))
+    {
+        while (!c->used && arenaInRange(arenaNext(c)) && !arenaNext(c)->used)
+        {
+            c->size += sizeof(sBlock) + arenaNext(c)->size;
+            arenaFree += sizeof(sBlock);
+        }
+    }
+}
+
+static uint32_t arenaLargestFree()
+{
+    uint32_t largest = 0;
+    for (sBlock *b = (sBlock *)arena; arenaInRange(b); b = arenaNext(b))
+    {
+        if (!b->used && b->size > largest)
+        {
+            largest = b->size;
+        }
+    }
+    return largest;
+}
+
+void *operator new(size_t size)
+{
+    void *p = arenaAlloc(size);
+    if (!p)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void *p) noexcept { arenaRelease(p); }
+void operator delete(void *p, size_t) noexcept { arenaRelease(p); }
+
+/*--------------------------------------------------------------------
+   Soak
+---------------------------------------------------------------------*/
+
+int main(int argc, char **argv)
+{
+    bool useString = !(argc > 1 && strcmp(argv[1], "fixed") == 0);
+    long ticks = argc > 2 ? atol(argv[2]) : 200000;
+    const char *const taskNames[MEM_TRACKED_TASKS] = {"loopTask", "async_tcp", "audio", "clip", "ota"};
+
+    static sMemRing ring;
+    memRingInit(ring);
+    srand(1);
+
+    std::deque<std::string> wsQueue;     // what AsyncWebSocket holds per client
+    std::vector<std::string *> keepers;  // long lived allocations (sessions, responses)
+    uint32_t sendLengthTotal = 0;
+
+    for (long tick = 0; tick < ticks; tick++)
+    {
+        if (useString)
+        {
+            std::string msg = "Push Notice: Fire: Shell #" + std::to_string(tick % 30);
+            msg += " at " + std::to_string(tick) + "ms";
+            wsQueue.push_back(msg);
+            if (wsQueue.size() > 8)
+            {
+                wsQueue.pop_front();
+            }
+        }
+        else
+        {
+            FixedString<64> msg("Push Notice: Fire: Shell #");
+            msg.appendUInt(tick % 30).append(" at ").appendUInt(tick).append("ms");
+            sendLengthTotal += msg.length();
+        }
+
+        // Now and then something long lived comes or goes.
+        if (rand() % 500 == 0)
+        {
+            keepers.push_back(new std::string(64 + rand() % 512, 'x'));
+        }
+        if (rand() % 700 == 0 && !keepers.empty())
+        {
+            size_t i = rand() % keepers.size();
+            delete keepers[i];
+            keepers.erase(keepers.begin() + i);
+        }
+
+        if (tick % (ticks / MEM_HISTORY + 1) == 0)
+        {
+            sMemSample sample = {};
+            sample.uptimeS = tick / 1000;
+            sample.freeHeap = arenaFree;
+            sample.largestBlock = arenaLargestFree();
+            sample.minFreeHeap = arenaMinFree;
+            for (int i = 0; i < MEM_TRACKED_TASKS; i++)
+            {
+                sample.stackFree[i] = 0xFFFF;
+            }
+            sample.wsClients = 1;
+            sample.wsQueuesFull = wsQueue.size() >= 8;
+            memRingPush(ring, sample);
+
+            FixedString<96> push;
+            memFormatCompact(sample, push);
+            printf("%s\n", push.c_str());
+        }
+    }
+
+    memWriteJson(ring, taskNames, [](const char *part)
+                 { fputs(part, stdout); });
+    printf("\n%s: %zu long lived, %u bytes formatted in place, final frag %u%%\n", useString ? "string" : "fixed",
+           keepers.size(), sendLengthTotal, memFragmentation(memRingAt(ring, 0)));
+    return 0;
+}
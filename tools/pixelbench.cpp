@@ -0,0 +1,242 @@
+/*+===================================================================
+  File:      pixelbench.cpp
+
+  Summary:   Host check and timing for pixelKernels.h against plain
+             per-pixel loops written the way FastLED does them
+             (nscale8x3 with FASTLED_SCALE8_FIXED, qadd8, a CRGB
+             copy loop for the shift).
+
+             Every kernel runs at 256 to 8192 pixels from each of
+             the four byte alignments leds[] can have, plus odd
+             lengths for the tails. Each result must match the
+             reference byte for byte. Times are ns per pixel, best of
+             several runs. pixelFadeFixed<N> is checked and timed
+             against pixelFade at a few profile-sized counts.
+
+             Builds use the 16-byte vector path where the host has
+             one. -DPIXEL_NO_VECTOR times the 32-bit word path the
+             ESP32 runs; add -fno-tree-vectorize too, or the host
+             compiler vectorises the reference loops, which the
+             ESP32 can't.
+
+  Building:  g++ -O2 -Iinclude tools/pixelbench.cpp -o pixelbench
+             g++ -O2 -fno-tree-vectorize -DPIXEL_NO_VECTOR -Iinclude tools/pixelbench.cpp -o pixelbench-swar
+             ./pixelbench
+
+  10/19/2026.
+===================================================================+*/
+
+#include <pixelKernels.h>
+#include <stdio.h>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#define BENCH_REPEATS 200
+#define BENCH_ROUNDS 5
+
+static std::mt19937 rng(99);
+static int failures = 0;
+
+/*--------------------------------------------------------------------
+   Reference loops
+---------------------------------------------------------------------*/
+
+static void refScale(uint8_t *rgb, size_t count, uint8_t scale)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        uint16_t scaleFixed = scale + 1;
+        uint8_t *p = rgb + i * 3;
+        p[0] = (p[0] * scaleFixed) >> 8;
+        p[1] = (p[1] * scaleFixed) >> 8;
+        p[2] = (p[2] * scaleFixed) >> 8;
+    }
+}
+
+static void refAdd(uint8_t *dst, const uint8_t *src, size_t count)
+{
+    for (size_t i = 0; i < count * 3; i++)
+    {
+        unsigned t = dst[i] + src[i];
+        dst[i] = t > 255 ? 255 : t;
+    }
+}
+
+static void refFill(uint8_t *rgb, size_t count, uint8_t r, uint8_t g, uint8_t b)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        rgb[i * 3] = r;
+        rgb[i * 3 + 1] = g;
+        rgb[i * 3 + 2] = b;
+    }
+}
+
+static void refShift(uint8_t *rgb, size_t count)
+{
+    for (size_t i = count - 1; i > 0; i--)
+    {
+        memcpy(rgb + i * 3, rgb + (i - 1) * 3, 3);
+    }
+    memset(rgb, 0, 3);
+}
+
+static void refRotate(uint8_t *rgb, size_t count, int by)
+{
+    std::vector<uint8_t> copy(rgb, rgb + count * 3);
+    for (size_t i = 0; i < count; i++)
+    {
+        memcpy(rgb + ((i + by) % count) * 3, copy.data() + i * 3, 3);
+    }
+}
+
+/*--------------------------------------------------------------------
+   Harness
+---------------------------------------------------------------------*/
+
+struct sCase
+{
+    const char *name;
+    void (*reference)(uint8_t *, const uint8_t *, size_t);
+    void (*kernel)(uint8_t *, const uint8_t *, size_t);
+};
+
+const sCase cases[] = {
+    {"fade 20", [](uint8_t *p, const uint8_t *, size_t n) { refScale(p, n, 235); },
+     [](uint8_t *p, const uint8_t *, size_t n) { pixelFade(p, n, 20); }},
+    {"scale 128", [](uint8_t *p, const uint8_t *, size_t n) { refScale(p, n, 128); },
+     [](uint8_t *p, const uint8_t *, size_t n) { pixelScale(p, n, 128); }},
+    {"add", [](uint8_t *p, const uint8_t *s, size_t n) { refAdd(p, s, n); },
+     [](uint8_t *p, const uint8_t *s, size_t n) { pixelAdd(p, s, n); }},
+    {"fill", [](uint8_t *p, const uint8_t *, size_t n) { refFill(p, n, 12, 200, 77); },
+     [](uint8_t *p, const uint8_t *, size_t n) { pixelFill(p, n, 12, 200, 77); }},
+    {"shift 1", [](uint8_t *p, const uint8_t *, size_t n) { refShift(p, n); },
+     [](uint8_t *p, const uint8_t *, size_t n) { pixelShift(p, n, 1); }},
+    {"rotate 100", [](uint8_t *p, const uint8_t *, size_t n) { refRotate(p, n, 100 % n); },
+     [](uint8_t *p, const uint8_t *, size_t n) { pixelRotate(p, n, 100); }},
+};
+
+static void randomise(std::vector<uint8_t> &buffer)
+{
+    for (uint8_t &b : buffer)
+    {
+        b = rng();
+    }
+}
+
+// Byte exact against the reference from every alignment.
+static bool check(const sCase &c, size_t count)
+{
+    for (size_t offset = 0; offset < 4; offset++)
+    {
+        std::vector<uint8_t> a(count * 3 + 4), b, src(count * 3 + 4);
+        randomise(a);
+        randomise(src);
+        b = a;
+        c.reference(a.data() + offset, src.data() + offset, count);
+        c.kernel(b.data() + offset, src.data() + offset, count);
+        if (a != b)
+        {
+            return false;
+        }
+    }
+    // Source and destination out of step, add falls back to bytes.
+    std::vector<uint8_t> a(count * 3 + 4), b, src(count * 3 + 4);
+    randomise(a);
+    randomise(src);
+    b = a;
+    c.reference(a.data() + 1, src.data() + 2, count);
+    c.kernel(b.data() + 1, src.data() + 2, count);
+    return a == b;
+}
+
+static double nsPerPixel(void (*fn)(uint8_t *, const uint8_t *, size_t), size_t count, size_t offset)
+{
+    std::vector<uint8_t> buffer(count * 3 + 4), src(count * 3 + 4);
+    randomise(buffer);
+    randomise(src);
+    double best = 1e30;
+    for (int round = 0; round < BENCH_ROUNDS; round++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < BENCH_REPEATS; r++)
+        {
+            fn(buffer.data() + offset, src.data() + offset, count);
+            __asm__ __volatile__("" : : "r"(buffer.data()) : "memory"); // keep the work
+        }
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        best = ns < best ? ns : best;
+    }
+    return best / BENCH_REPEATS / count;
+}
+
+// pixelFadeFixed<N> on a word-aligned buffer, as leds[] is, against the reference and the general kernel.
+template <size_t N> static bool checkFixed()
+{
+    std::vector<uint32_t> words((N * 3 + 3) / 4);
+    std::vector<uint8_t> expected(N * 3);
+    uint8_t *buffer = (uint8_t *)words.data();
+    randomise(expected);
+    memcpy(buffer, expected.data(), N * 3);
+    refScale(expected.data(), N, 235);
+    pixelFadeFixed<N>(buffer, 20);
+    bool pass = memcmp(buffer, expected.data(), N * 3) == 0;
+
+    double best[2] = {1e30, 1e30};
+    for (int round = 0; round < BENCH_ROUNDS; round++)
+    {
+        for (int which = 0; which < 2; which++)
+        {
+            auto start = std::chrono::steady_clock::now();
+            for (int r = 0; r < BENCH_REPEATS * 10; r++)
+            {
+                which ? pixelFadeFixed<N>(buffer, 1) : pixelFade(buffer, N, 1);
+                __asm__ __volatile__("" : : "r"(buffer) : "memory");
+            }
+            double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+            best[which] = ns < best[which] ? ns : best[which];
+        }
+    }
+    printf("fixed %-5zu  %6.2f / %6.2f ns/pixel (pixelFade / pixelFadeFixed)  %s\n", N,
+           best[0] / (BENCH_REPEATS * 10) / N, best[1] / (BENCH_REPEATS * 10) / N, pass ? "PASS" : "FAIL");
+    failures += pass ? 0 : 1;
+    return pass;
+}
+
+int main()
+{
+    printf("%s path, ns/pixel (reference / kernel)\n", PIXEL_VECTOR ? "16-byte vector" : "32-bit word");
+    const size_t sizes[] = {256, 1024, 4096, 8192};
+    printf("%-11s", "");
+    for (size_t n : sizes)
+    {
+        printf("  %15zu", n);
+    }
+    printf("\n");
+
+    for (const sCase &c : cases)
+    {
+        bool pass = true;
+        for (size_t n : {1, 2, 3, 5, 7, 11, 255, 257})
+        {
+            pass = pass && check(c, n);
+        }
+        printf("%-11s", c.name);
+        for (size_t n : sizes)
+        {
+            pass = pass && check(c, n);
+            // leds[] from a CRGB array can sit at any byte alignment, time the awkward one.
+            printf("  %6.2f / %6.2f", nsPerPixel(c.reference, n, 1), nsPerPixel(c.kernel, n, 1));
+        }
+        printf("  %s\n", pass ? "PASS" : "FAIL");
+        failures += pass ? 0 : 1;
+    }
+
+    checkFixed<1>();
+    checkFixed<25>();
+    checkFixed<64>();
+    checkFixed<65>();
+    checkFixed<300>();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,82 @@
+/*+===================================================================
+  File:      profilebench.cpp
+
+  Summary:   Per-frame cost of the strip-wide kernels for one install
+             profile, built on the host with that profile's PROFILE_*
+             flag so NUM_LEDS is the install's: fade through the
+             general kernel and the fixed-size one, and a full HSV
+             canvas conversion, and which fade the profile uses
+             (fixedKernels). tools/profilereport.py builds and runs
+             it for every profile in platformio.ini.
+
+             Prints one line of key=value pairs.
+
+  Building:  g++ -O2 -DPROFILE_KITCHEN -Iinclude tools/profilebench.cpp -o profilebench
+             ./profilebench
+
+  10/19/2026.
+===================================================================+*/
+
+#include <installProfile.h>
+#include <pixelKernels.h>
+#include <hsvConvert.h>
+#include <stdio.h>
+#include <chrono>
+#include <vector>
+
+#define BENCH_REPEATS 2000
+#define BENCH_ROUNDS 5
+
+const size_t numLeds = g_profile.numLeds;
+
+template <typename Fn> static double nsPerFrame(Fn fn)
+{
+    double best = 1e30;
+    for (int round = 0; round < BENCH_ROUNDS; round++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < BENCH_REPEATS; r++)
+        {
+            fn();
+        }
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        best = ns < best ? ns : best;
+    }
+    return best / BENCH_REPEATS;
+}
+
+int main()
+{
+    std::vector<uint32_t> words((numLeds * 3 + 3) / 4); // word aligned, like leds[]
+    uint8_t *leds = (uint8_t *)words.data();
+    std::vector<uint8_t> hsv(numLeds * 3);
+    for (size_t i = 0; i < numLeds * 3; i++)
+    {
+        leds[i] = i * 7;
+        hsv[i] = i * 13;
+    }
+    static sHsvTables tables;
+    hsvTablesInit(tables);
+
+    double fade = nsPerFrame([&] {
+        pixelFade(leds, numLeds, 1);
+        __asm__ __volatile__("" : : "r"(leds) : "memory");
+    });
+    double fadeFixed = nsPerFrame([&] {
+        pixelFadeFixed<g_profile.numLeds>(leds, 1);
+        __asm__ __volatile__("" : : "r"(leds) : "memory");
+    });
+    double hsvFrame = nsPerFrame([&] {
+        hsvToRgbBatch(tables, hsv.data(), leds, numLeds);
+        __asm__ __volatile__("" : : "r"(leds) : "memory");
+    });
+
+    int effects = 0;
+    for (uint32_t bit = 1; bit & EFX_ALL; bit <<= 1)
+    {
+        effects += profileHasEffect(bit);
+    }
+    printf("profile=%s leds=%zu effects=%d fadeNs=%.0f fadeFixedNs=%.0f hsvNs=%.0f kernel=%s\n", g_profile.name, numLeds,
+           effects, fade, fadeFixed, hsvFrame, g_profile.fixedKernels ? "fixed" : "general");
+    return 0;
+}
@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+"""
+  File:      profilereport.py
+
+  Summary:   Size and speed per installation profile.
+
+             Every platformio.ini environment with a -D PROFILE_*
+             flag is a profile. For each one tools/profilebench.cpp
+             is built on the host with that flag and run. It uses
+             the 32-bit word kernels the ESP32 runs, not the host's
+             vector ones. The report shows the per-frame cost of a
+             fade through the general kernel and through the
+             fixed-size one, and of an HSV canvas conversion. "uses"
+             is the fade the profile builds with (fixedKernels in
+             installProfile.h); a "!" marks a profile whose choice
+             is more than 10% slower than the other here.
+
+             Flash and RAM come from the profile's firmware.elf in
+             .pio/build when there is one. With --build, pio builds
+             it first. Sizes are read with the toolchain's size tool:
+             flash is text + data, RAM is data + bss.
+
+  Usage:     python tools/profilereport.py
+             python tools/profilereport.py --build
+             python tools/profilereport.py --cxx clang++ --markdown report.md
+
+  10/19/2026.
+"""
+
+import argparse
+import configparser
+import glob
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+BENCH_FLAGS = ["-O2", "-fno-tree-vectorize", "-DPIXEL_NO_VECTOR", "-Iinclude"]
+
+
+def profiles(ini):
+    parser = configparser.ConfigParser(interpolation=None, strict=False)
+    parser.read(ini)
+    found = []
+    for section in parser.sections():
+        if not section.startswith("env:"):
+            continue
+        flags = parser[section].get("build_flags", "")
+        match = re.search(r"-D\s*(PROFILE_\w+)", flags)
+        if match:
+            found.append((section[4:], match.group(1)))
+    return found
+
+
+def bench(cxx, define, workdir):
+    exe = os.path.join(workdir, define.lower())
+    subprocess.run([cxx] + BENCH_FLAGS + ["-D" + define, "tools/profilebench.cpp", "-o", exe], check=True)
+    line = subprocess.run([exe], check=True, capture_output=True, text=True).stdout.strip()
+    return dict(pair.split("=", 1) for pair in line.split())
+
+
+def size_tool():
+    found = glob.glob(os.path.expanduser("~/.platformio/packages/toolchain-xtensa-esp32/bin/xtensa-esp32-elf-size"))
+    return found[0] if found else "xtensa-esp32-elf-size"
+
+
+def firmware_size(env, build):
+    if build:
+        subprocess.run(["pio", "run", "-e", env], check=True)
+    elf = os.path.join(".pio", "build", env, "firmware.elf")
+    if not os.path.exists(elf):
+        return None
+    try:
+        out = subprocess.run([size_tool(), "-B", elf], check=True, capture_output=True, text=True).stdout
+    except (OSError, subprocess.CalledProcessError):
+        return None
+    text, data, bss = (int(v) for v in out.splitlines()[1].split()[:3])
+    return text + data, data + bss
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Size and speed report per BangWorx install profile.")
+    parser.add_argument("--ini", default="platformio.ini")
+    parser.add_argument("--cxx", default="g++")
+    parser.add_argument("--build", action="store_true", help="pio run each profile first")
+    parser.add_argument("--markdown", help="also write the table to this file")
+    args = parser.parse_args()
+
+    rows = []
+    with tempfile.TemporaryDirectory() as workdir:
+        for env, define in profiles(args.ini):
+            result = bench(args.cxx, define, workdir)
+            size = firmware_size(env, args.build)
+            fade, fixed = float(result["fadeNs"]), float(result["fadeFixedNs"])
+            uses = result["kernel"]
+            chosen, other = (fixed, fade) if uses == "fixed" else (fade, fixed)
+            if chosen > other * 1.1:
+                uses += " !"
+            rows.append((env, result["leds"], result["effects"], result["fadeNs"], result["fadeFixedNs"], uses,
+                         result["hsvNs"], "%d" % size[0] if size else "-", "%d" % size[1] if size else "-"))
+
+    header = ("profile", "leds", "effects", "fade ns", "fixed ns", "uses", "hsv ns", "flash B", "ram B")
+    table = ["| " + " | ".join(header) + " |", "|" + "---|" * len(header)]
+    table += ["| " + " | ".join(row) + " |" for row in rows]
+    print("\n".join(table))
+    if args.markdown:
+        with open(args.markdown, "w") as f:
+            f.write("\n".join(table) + "\n")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,376 @@
+/*+===================================================================
+  File:      rosterbench.cpp
+
+  Summary:   Host test for subRoster.h. The loop below plays the
+             roster task from subDiscovery.h against a fake SoftAP
+             and a fake mDNS responder. The responder answers for
+             associated devices that advertise _bangworx._tcp, after
+             the boot delay each one has. A fake HTTP side takes the
+             config pushes.
+
+                join      two subs and a phone join: subs online,
+                          phone given up on after its tries
+                steady    an hour with everyone placed sends no
+                          queries and no pushes
+                rejoin    a sub drops off and comes back: gone,
+                          then online again with its config re-sent
+                config    a push that fails is retried, a change made
+                          while a push is out is sent after it
+                lease     a sub back on a new IP keeps its config,
+                          one entry
+                full      ten stations, the longest gone is evicted
+                txt       TXT keys parse, unknown ones are refused
+
+  Building:  g++ -O2 -Iinclude tools/rosterbench.cpp -o rosterbench
+             ./rosterbench
+
+  10/19/2026.
+===================================================================+*/
+
+#include <subRoster.h>
+#include <stdio.h>
+#include <vector>
+
+#define POLL_MS 2000 // keep in step with ROSTER_POLL_MS in subDiscovery.h
+
+static int failures = 0;
+
+struct sFakeDevice
+{
+    uint32_t ip;
+    const char *host;
+    const char *role; // nullptr for a phone, it doesn't advertise
+    uint16_t leds;
+    uint32_t responderDelayMs; // from joining until it answers mDNS
+    bool associated;
+    uint32_t joinedMs;
+    bool failNextPush;
+    int pushesTaken;
+    char lastConfig[ROSTER_CONFIG_MAX];
+};
+
+struct sFakeNet
+{
+    sRoster roster;
+    std::vector<sFakeDevice> devices;
+    uint32_t nowMs = 0;
+    uint32_t queries = 0;
+    uint32_t pushes = 0;
+
+    sFakeNet()
+    {
+        rosterInit(roster);
+        // The master answers its own query too, subDiscovery.h drops it by role.
+        devices.push_back({0x0104A8C0, "bangworx-server", "master", 25, 0, true, 0, false, 0, ""});
+    }
+
+    sFakeDevice &add(uint32_t ip, const char *host, const char *role, uint16_t leds, uint32_t delayMs)
+    {
+        devices.push_back({ip, host, role, leds, delayMs, false, 0, false, 0, ""});
+        return devices.back();
+    }
+
+    sFakeDevice *find(const char *host)
+    {
+        for (sFakeDevice &device : devices)
+        {
+            if (strcmp(device.host, host) == 0)
+            {
+                return &device;
+            }
+        }
+        return nullptr;
+    }
+
+    void join(const char *host)
+    {
+        sFakeDevice *device = find(host);
+        device->associated = true;
+        device->joinedMs = nowMs;
+    }
+
+    void leave(const char *host)
+    {
+        find(host)->associated = false;
+    }
+
+    // The responder: who answers _bangworx._tcp right now.
+    int query(sRosterAnswer *answers)
+    {
+        queries++;
+        int count = 0;
+        for (const sFakeDevice &device : devices)
+        {
+            if (!device.associated || !device.role || nowMs - device.joinedMs < device.responderDelayMs ||
+                count == ROSTER_MAX)
+            {
+                continue;
+            }
+            sRosterAnswer &answer = answers[count];
+            memset(&answer, 0, sizeof(answer));
+            answer.ip = device.ip;
+            rosterCopy(answer.sub.host, device.host, sizeof(answer.sub.host));
+            char leds[8];
+            snprintf(leds, sizeof(leds), "%u", device.leds);
+            rosterTxt(answer.sub, "role", device.role);
+            rosterTxt(answer.sub, "leds", leds);
+            rosterTxt(answer.sub, "fw", "8.18.22");
+            rosterTxt(answer.sub, "ch", "8");
+            count += strcmp(answer.sub.role, "sub") == 0;
+        }
+        return count;
+    }
+
+    bool post(uint32_t ip, const char *config)
+    {
+        for (sFakeDevice &device : devices)
+        {
+            if (device.ip == ip && device.associated)
+            {
+                if (device.failNextPush)
+                {
+                    device.failNextPush = false;
+                    return false;
+                }
+                device.pushesTaken++;
+                rosterCopy(device.lastConfig, config, sizeof(device.lastConfig));
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // One pass of rosterTask().
+    void poll()
+    {
+        uint32_t ips[ROSTER_MAX];
+        int8_t rssi[ROSTER_MAX];
+        int count = 0;
+        for (const sFakeDevice &device : devices)
+        {
+            if (device.associated && device.ip != 0x0104A8C0 && count < ROSTER_MAX)
+            {
+                rssi[count] = -60;
+                ips[count++] = device.ip;
+            }
+        }
+        rosterStations(roster, ips, rssi, count, nowMs);
+        if (rosterQueryDue(roster, nowMs))
+        {
+            sRosterAnswer answers[ROSTER_MAX];
+            int found = query(answers);
+            rosterQueryResult(roster, answers, found, nowMs);
+        }
+        int i = rosterPushDue(roster, nowMs);
+        if (i >= 0)
+        {
+            pushes++;
+            uint16_t seq = roster.entries[i].configSeq;
+            rosterPushDone(roster, i, seq, post(roster.entries[i].ip, roster.entries[i].config), nowMs);
+        }
+    }
+
+    void run(uint32_t ms)
+    {
+        for (uint32_t end = nowMs + ms; nowMs < end; nowMs += POLL_MS)
+        {
+            poll();
+        }
+    }
+
+    int state(const char *host)
+    {
+        int i = rosterFindHost(roster, host);
+        return i < 0 ? -1 : roster.entries[i].state;
+    }
+
+    int stateOf(uint32_t ip)
+    {
+        int i = rosterFind(roster, ip);
+        return i < 0 ? -1 : roster.entries[i].state;
+    }
+};
+
+static void report(const char *name, bool pass, const char *detail)
+{
+    printf("%-8s %-4s %s\n", name, pass ? "PASS" : "FAIL", detail);
+    failures += pass ? 0 : 1;
+}
+
+// Two subs (one slow to answer) and a phone join a fresh master.
+static void setupThree(sFakeNet &net)
+{
+    net.add(0x0204A8C0, "bangworx-sub", "sub", 25, 500);
+    net.add(0x0304A8C0, "bangworx-sub2", "sub", 60, 7000);
+    net.add(0x0404A8C0, "phone", nullptr, 0, 0);
+    net.join("bangworx-sub");
+    net.join("bangworx-sub2");
+    net.join("phone");
+}
+
+static void checkJoin()
+{
+    sFakeNet net;
+    setupThree(net);
+    net.run(60000);
+    char detail[96];
+    snprintf(detail, sizeof(detail), "%u queries, phone %s", net.queries,
+             rosterStateName(net.stateOf(0x0404A8C0)));
+    int i = rosterFindHost(net.roster, "bangworx-sub2");
+    report("join",
+           net.state("bangworx-sub") == ROSTER_ONLINE && net.state("bangworx-sub2") == ROSTER_ONLINE &&
+               net.stateOf(0x0404A8C0) == ROSTER_OTHER && net.queries <= ROSTER_QUERY_TRIES + 1 &&
+               rosterFindHost(net.roster, "bangworx-server") < 0 && i >= 0 &&
+               net.roster.entries[i].sub.leds == 60 && net.roster.entries[i].sub.channels == 8,
+           detail);
+}
+
+static void checkSteady()
+{
+    sFakeNet net;
+    setupThree(net);
+    net.run(60000);
+    rosterSetConfig(net.roster, "bangworx-sub", "{\"bri\":120}", net.nowMs);
+    net.run(10000);
+    uint32_t queries = net.queries;
+    uint32_t pushes = net.pushes;
+    net.run(3600000);
+    char detail[96];
+    snprintf(detail, sizeof(detail), "%u queries, %u pushes in an hour", net.queries - queries, net.pushes - pushes);
+    report("steady", net.queries == queries && net.pushes == pushes, detail);
+}
+
+static void checkRejoin()
+{
+    sFakeNet net;
+    setupThree(net);
+    net.run(60000);
+    rosterSetConfig(net.roster, "bangworx-sub", "{\"bri\":120}", net.nowMs);
+    net.run(10000);
+    net.leave("bangworx-sub");
+    net.run(10000);
+    bool gone = net.state("bangworx-sub") == ROSTER_GONE;
+    uint32_t queries = net.queries;
+    net.join("bangworx-sub");
+    net.run(20000);
+    char detail[96];
+    snprintf(detail, sizeof(detail), "%u queries to place it again, config sent %d times", net.queries - queries,
+             net.find("bangworx-sub")->pushesTaken);
+    report("rejoin",
+           gone && net.state("bangworx-sub") == ROSTER_ONLINE && net.queries - queries == 1 &&
+               net.find("bangworx-sub")->pushesTaken == 2,
+           detail);
+}
+
+static void checkConfig()
+{
+    sFakeNet net;
+    setupThree(net);
+    net.run(60000);
+    sFakeDevice *sub = net.find("bangworx-sub2");
+    sub->failNextPush = true;
+    bool set = rosterSetConfig(net.roster, "bangworx-sub2", "{\"bri\":40}", net.nowMs);
+    net.run(POLL_MS);
+    bool failedFirst = sub->pushesTaken == 0;
+    net.run(ROSTER_PUSH_RETRY_MS + POLL_MS);
+    bool retried = sub->pushesTaken == 1 && strcmp(sub->lastConfig, "{\"bri\":40}") == 0;
+
+    // Changed between reading the config and the push finishing: the newer one still goes.
+    int i = rosterFindHost(net.roster, "bangworx-sub2");
+    uint16_t seq = net.roster.entries[i].configSeq;
+    rosterSetConfig(net.roster, "bangworx-sub2", "{\"bri\":50}", net.nowMs);
+    rosterPushDone(net.roster, i, seq, true, net.nowMs);
+    net.run(POLL_MS * 2);
+    bool newer = sub->pushesTaken == 2 && strcmp(sub->lastConfig, "{\"bri\":50}") == 0;
+
+    bool unknown = !rosterSetConfig(net.roster, "nobody", "{}", net.nowMs);
+    char big[ROSTER_CONFIG_MAX + 1];
+    memset(big, 'x', sizeof(big) - 1);
+    big[sizeof(big) - 1] = 0;
+    bool tooLong = !rosterSetConfig(net.roster, "bangworx-sub2", big, net.nowMs);
+    char detail[96];
+    snprintf(detail, sizeof(detail), "taken %d, last %.60s", sub->pushesTaken, sub->lastConfig);
+    report("config", set && failedFirst && retried && newer && unknown && tooLong, detail);
+}
+
+static void checkLease()
+{
+    sFakeNet net;
+    setupThree(net);
+    net.run(60000);
+    rosterSetConfig(net.roster, "bangworx-sub", "{\"bri\":120}", net.nowMs);
+    net.run(10000);
+    net.leave("bangworx-sub");
+    net.run(10000);
+    sFakeDevice *sub = net.find("bangworx-sub");
+    sub->ip = 0x0904A8C0;
+    net.join("bangworx-sub");
+    net.run(20000);
+    int entries = 0;
+    for (int i = 0; i < net.roster.count; i++)
+    {
+        entries += strcmp(net.roster.entries[i].sub.host, "bangworx-sub") == 0;
+    }
+    int i = rosterFindHost(net.roster, "bangworx-sub");
+    char detail[96];
+    snprintf(detail, sizeof(detail), "%d entries, config sent %d times", entries, sub->pushesTaken);
+    report("lease",
+           entries == 1 && i >= 0 && net.roster.entries[i].ip == 0x0904A8C0 &&
+               net.roster.entries[i].state == ROSTER_ONLINE && sub->pushesTaken == 2 &&
+               net.stateOf(0x0204A8C0) == -1,
+           detail);
+}
+
+static void checkFull()
+{
+    sFakeNet net;
+    char hosts[ROSTER_MAX + 1][16];
+    for (int i = 0; i <= ROSTER_MAX; i++)
+    {
+        snprintf(hosts[i], sizeof(hosts[i]), "sub%d", i);
+        net.add(0x0A04A8C0 + (i << 24), hosts[i], "sub", 25, 0);
+    }
+    for (int i = 0; i < ROSTER_MAX; i++)
+    {
+        net.join(hosts[i]);
+        net.run(POLL_MS);
+    }
+    net.run(10000);
+    net.leave(hosts[0]);
+    net.run(POLL_MS);
+    net.leave(hosts[1]);
+    net.run(POLL_MS);
+    net.join(hosts[ROSTER_MAX]);
+    net.run(10000);
+    char detail[96];
+    snprintf(detail, sizeof(detail), "%d entries, first gone evicted %s", net.roster.count,
+             net.state(hosts[0]) == -1 ? "yes" : "no");
+    report("full",
+           net.roster.count == ROSTER_MAX && net.state(hosts[0]) == -1 && net.state(hosts[1]) == ROSTER_GONE &&
+               net.state(hosts[ROSTER_MAX]) == ROSTER_ONLINE,
+           detail);
+}
+
+static void checkTxt()
+{
+    sRosterSub sub;
+    memset(&sub, 0, sizeof(sub));
+    bool known = rosterTxt(sub, "role", "sub") && rosterTxt(sub, "leds", "300") && rosterTxt(sub, "ch", "16") &&
+                 rosterTxt(sub, "fw", "8.18.22") && rosterTxt(sub, "profile", "a-very-long-profile-name-here");
+    bool unknown = !rosterTxt(sub, "colour", "red");
+    bool values = strcmp(sub.role, "sub") == 0 && sub.leds == 300 && sub.channels == 16 &&
+                  strlen(sub.profile) == ROSTER_TEXT_MAX - 1;
+    report("txt", known && unknown && values, "");
+}
+
+int main()
+{
+    checkJoin();
+    checkSteady();
+    checkRejoin();
+    checkConfig();
+    checkLease();
+    checkFull();
+    checkTxt();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,266 @@
+/*+===================================================================
+  File:      showbench.cpp
+
+  Summary:   End to end check of the show compiler against the
+             reader. Writes a 50k cue CSV, compiles it with
+             tools/showc.py, maps the image read-only the way
+             showBegin() maps the partition and runs the same
+             header checks and CRC (showImage.h). Every cue and
+             scene must come back as written, in stable time order,
+             and a damaged image must be refused, including
+             offsets and sizes that wrap around 32 bits.
+
+             Then times showSeekCues(), the binary search behind
+             seek/resume, after checking it agrees with
+             std::lower_bound over the table.
+
+  Building:  g++ -O2 -Wall -Iinclude tools/showbench.cpp -o showbench
+             ./showbench [path to showc.py] [cues]
+
+  10/19/2026.
+===================================================================+*/
+
+#include <showImage.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#define BENCH_CSV "/tmp/showbench.csv"
+#define BENCH_BIN "/tmp/showbench.bin"
+#define BENCH_SCENES 64
+#define BENCH_SEEKS 1000000
+
+struct sCue
+{
+    uint32_t timeMs;
+    uint8_t type;
+    uint8_t channel;
+    uint16_t param;  // preset slot, or scene spec index before compiling
+    uint32_t order;
+};
+
+struct sSpec
+{
+    int animation;
+    uint8_t hue, sat, val, bri;
+};
+
+static int failures = 0;
+
+static void report(const char *name, bool pass, const char *detail)
+{
+    printf("%-10s %-4s %s\n", name, pass ? "PASS" : "FAIL", detail);
+    failures += pass ? 0 : 1;
+}
+
+// zlib's CRC-32, which is what esp_rom_crc32_le(0, ...) computes.
+static uint32_t crc32(const uint8_t *data, size_t len)
+{
+    static uint32_t table[256];
+    if (table[1] == 0)
+    {
+        for (uint32_t i = 0; i < 256; i++)
+        {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++)
+            {
+                c = c & 1 ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+            }
+            table[i] = c;
+        }
+    }
+    uint32_t crc = 0xFFFFFFFF;
+    while (len--)
+    {
+        crc = table[(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFF;
+}
+
+// sScene as showc.py packs it: mode, animation, hue, sat, val, brightness, palette, flags.
+static void packScene(const sSpec &spec, uint8_t *out)
+{
+    out[0] = spec.animation >= 0 ? 1 : 2; // animation or solid
+    out[1] = (uint8_t)(int8_t)spec.animation;
+    out[2] = spec.hue;
+    out[3] = spec.sat;
+    out[4] = spec.val;
+    out[5] = spec.bri;
+    out[6] = 0;
+    out[7] = 0x01; // SCENE_IN_USE
+}
+
+static void writeCsv(const std::vector<sCue> &cues, const std::vector<sSpec> &specs)
+{
+    FILE *f = fopen(BENCH_CSV, "w");
+    fprintf(f, "time,type,channel,param\n");
+    for (const sCue &cue : cues)
+    {
+        // Half the times as m:ss.mmm so both forms get parsed.
+        char time[24];
+        if (cue.order & 1)
+        {
+            snprintf(time, sizeof(time), "%u:%02u.%03u", cue.timeMs / 60000, cue.timeMs / 1000 % 60, cue.timeMs % 1000);
+        }
+        else
+        {
+            snprintf(time, sizeof(time), "%u", cue.timeMs);
+        }
+
+        if (cue.type == CUE_SCENE)
+        {
+            const sSpec &s = specs[cue.param];
+            fprintf(f, "%s,scene,,\"hue=%u sat=%u val=%u bri=%u animation=%d\"\n", time, s.hue, s.sat, s.val, s.bri,
+                    s.animation);
+        }
+        else
+        {
+            fprintf(f, "%s,%s,%u,%u\n", time, cue.type == CUE_FIRE ? "fire" : "preset", cue.channel, cue.param);
+        }
+    }
+    fclose(f);
+}
+
+int main(int argc, char **argv)
+{
+    const char *showc = argc > 1 ? argv[1] : "tools/showc.py";
+    uint32_t count = argc > 2 ? atoi(argv[2]) : 50000;
+    std::mt19937 rng(27);
+
+    std::vector<sSpec> specs(BENCH_SCENES);
+    for (sSpec &s : specs)
+    {
+        s = {(int)(rng() % 12) - 1, (uint8_t)rng(), (uint8_t)rng(), (uint8_t)rng(), (uint8_t)rng()};
+    }
+
+    // Written out of order with plenty of equal times, so the stable sort matters.
+    std::vector<sCue> cues(count);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint8_t type = (uint8_t)(1 + rng() % 3);
+        uint16_t param = type == CUE_SCENE ? rng() % BENCH_SCENES : type == CUE_PRESET ? rng() % 16 : rng() % 500;
+        cues[i] = {(uint32_t)(rng() % (count * 20)) / 10 * 10, type, (uint8_t)(type == CUE_FIRE ? rng() : 0), param, i};
+    }
+    writeCsv(cues, specs);
+
+    std::string command = std::string("python3 ") + showc + " " BENCH_CSV " -o " BENCH_BIN " > /dev/null";
+    auto compileStart = std::chrono::steady_clock::now();
+    if (system(command.c_str()) != 0)
+    {
+        printf("showc.py failed: %s\n", command.c_str());
+        return 1;
+    }
+    double compileMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - compileStart).count();
+
+    int fd = open(BENCH_BIN, O_RDONLY);
+    struct stat st;
+    fstat(fd, &st);
+    uint32_t size = (uint32_t)st.st_size;
+    const uint8_t *image = (const uint8_t *)mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    char detail[128];
+    const sShowHeader *header = (const sShowHeader *)image;
+    uint32_t body = showImageBody(header, size);
+    bool crcOk = body > 0 && crc32(image + sizeof(sShowHeader), body) == header->crc32;
+    snprintf(detail, sizeof(detail), "%u bytes, %u cues, %u scenes, compiled in %.0f ms", size, header->cueCount,
+             header->blobSize / SHOW_SCENE_SIZE, compileMs);
+    report("header", crcOk && header->cueCount == count && header->blobSize % SHOW_SCENE_SIZE == 0, detail);
+
+    // What the reader should see: stable by time, scenes deduplicated in first use order.
+    std::vector<sCue> expected = cues;
+    std::stable_sort(expected.begin(), expected.end(), [](const sCue &a, const sCue &b) { return a.timeMs < b.timeMs; });
+    std::vector<int> blobIndex(BENCH_SCENES, -1);
+    int nextBlob = 0;
+    for (const sCue &cue : cues)
+    {
+        if (cue.type == CUE_SCENE && blobIndex[cue.param] < 0)
+        {
+            blobIndex[cue.param] = nextBlob++;
+        }
+    }
+
+    const sShowCue *table = (const sShowCue *)(image + header->cueOffset);
+    const uint8_t *blob = image + header->blobOffset;
+    uint32_t bad = 0;
+    for (uint32_t i = 0; crcOk && i < count; i++)
+    {
+        const sCue &want = expected[i];
+        const sShowCue &got = table[i];
+        bool same = got.timeMs == want.timeMs && got.type == want.type && got.channel == want.channel;
+        if (want.type == CUE_SCENE)
+        {
+            uint8_t packed[SHOW_SCENE_SIZE];
+            packScene(specs[want.param], packed);
+            same = same && got.param == blobIndex[want.param] &&
+                   memcmp(blob + got.param * SHOW_SCENE_SIZE, packed, SHOW_SCENE_SIZE) == 0;
+        }
+        else
+        {
+            same = same && got.param == want.param;
+        }
+        if (!same && bad++ == 0)
+        {
+            printf("  cue %u: got %u %u %u %u, want %u %u %u %u\n", i, got.timeMs, got.type, got.channel, got.param,
+                   want.timeMs, want.type, want.channel, want.param);
+        }
+    }
+    snprintf(detail, sizeof(detail), "%u of %u cues differ, duration %u ms", bad, count, header->durationMs);
+    report("roundtrip", crcOk && bad == 0 && header->durationMs == expected.back().timeMs, detail);
+
+    // A flipped bit must fail the CRC, a short read must fail the header checks.
+    std::vector<uint8_t> damaged(image, image + size);
+    damaged[header->cueOffset + size / 2 % (count * sizeof(sShowCue))] ^= 0x10;
+    bool flipRefused = crc32(damaged.data() + sizeof(sShowHeader), body) != header->crc32;
+    bool shortRefused = showImageBody(header, size - 1) == 0 && showImageBody(header, 16) == 0;
+    damaged[0] ^= 0xFF;
+    bool magicRefused = showImageBody((const sShowHeader *)damaged.data(), size) == 0;
+
+    // Sizes that wrap a uint32 offset + size back inside the image.
+    sShowHeader wrapped = *header;
+    wrapped.blobSize = 0xFFFFFFFF - header->blobOffset + 2;
+    bool blobRefused = showImageBody(&wrapped, size) == 0;
+    wrapped = *header;
+    wrapped.cueOffset = size - 8;
+    wrapped.cueCount = 0xFFFFFFF0 / sizeof(sShowCue); // passes the count check, the end wraps
+    bool cueRefused = showImageBody(&wrapped, 0xFFFFFFF0) == 0;
+    report("damaged", flipRefused && shortRefused && magicRefused && blobRefused && cueRefused,
+           "flipped bit, short image, bad magic, wrapping blob and cue sizes");
+
+    // Seek: same answer as lower_bound everywhere, including past the end.
+    std::vector<uint32_t> times(BENCH_SEEKS);
+    for (uint32_t &t : times)
+    {
+        t = rng() % (header->durationMs + 100);
+    }
+    uint32_t wrong = 0;
+    for (uint32_t i = 0; i < 10000; i++)
+    {
+        uint32_t want = std::lower_bound(table, table + count, times[i], [](const sShowCue &c, uint32_t t) {
+                            return c.timeMs < t;
+                        }) - table;
+        wrong += showSeekCues(table, count, times[i]) != want;
+    }
+
+    volatile uint32_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t t : times)
+    {
+        sink = sink + showSeekCues(table, count, t);
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / BENCH_SEEKS;
+    snprintf(detail, sizeof(detail), "%.1f ns per seek over %u cues, %u of 10000 wrong", ns, count, wrong);
+    report("seek", wrong == 0, detail);
+
+    munmap((void *)image, size);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,206 @@
+#!/usr/bin/env python3
+"""
+  File:      showc.py
+
+  Summary:   Show compiler. Builds the binary show image read by
+             include/showFile.h from a CSV or JSON cue list.
+
+             CSV, one cue per line (header line optional):
+
+                time,type,channel,param
+                0:01.500,fire,3,
+                0:02.000,preset,,4
+                0:02.000,scene,,"hue=29 sat=170 val=216 bri=200"
+
+             JSON:
+
+                {"cues": [{"time": 1500, "type": "fire", "channel": 3},
+                          {"time": "0:02", "type": "scene", "scene": {"hue": 29, "bri": 200}}]}
+
+             time is milliseconds or m:ss.mmm. Scenes are deduplicated
+             into the parameter blob, cues are stable sorted by time.
+
+             --selftest compiles a small show built here, reads it
+             back and prints PASS or FAIL. tools/showbench.cpp checks
+             a 50k cue show against the C++ reader.
+
+  Usage:     python tools/showc.py show.csv -o show.bin
+             python tools/showc.py show.json -o show.bin --dump
+             python tools/showc.py --selftest
+
+  10/19/2026.
+"""
+
+import argparse
+import csv
+import json
+import os
+import struct
+import sys
+import tempfile
+import zlib
+
+SHOW_MAGIC = 0x48535742  # "BWSH"
+SHOW_VERSION = 1
+PARTITION_SIZE = 0x80000  # must match the show entry in partitions.csv
+
+HEADER = struct.Struct("<IHHIIIIII")  # sShowHeader, 32 bytes
+CUE = struct.Struct("<IBBH")          # sShowCue, 8 bytes
+SCENE = struct.Struct("<BbBBBBBB")    # sScene, 8 bytes
+
+CUE_TYPES = {"fire": 1, "scene": 2, "preset": 3, "end": 0xFF}
+MODES = {"bright": 0, "animation": 1, "solid": 2, "off": 3}  # Mode enum in LEDController.h
+SCENE_IN_USE = 0x01
+
+
+def parse_time(value):
+    value = str(value).strip()
+    if ":" not in value:
+        return int(float(value))
+    minutes, seconds = value.split(":", 1)
+    return int(minutes) * 60000 + int(round(float(seconds) * 1000))
+
+
+def parse_scene(spec):
+    """Accepts a dict or 'key=value key=value' string."""
+    if isinstance(spec, str):
+        spec = dict(pair.split("=", 1) for pair in spec.split())
+    animation = int(spec.get("animation", -1))
+    mode = spec.get("mode", "animation" if animation >= 0 else "solid")
+    mode = MODES[mode] if isinstance(mode, str) else int(mode)
+    return SCENE.pack(mode, animation,
+                      int(spec.get("hue", 0)), int(spec.get("sat", 255)), int(spec.get("val", 255)),
+                      int(spec.get("bri", 255)), int(spec.get("palette", 0)), SCENE_IN_USE)
+
+
+def load_cues(path):
+    if path.endswith(".json"):
+        with open(path) as f:
+            return json.load(f)["cues"]
+    cues = []
+    with open(path, newline="") as f:
+        for row in csv.reader(f):
+            if not row or row[0].startswith("#") or row[0].strip() == "time":
+                continue
+            row += [""] * (4 - len(row))
+            cue = {"time": row[0], "type": row[1].strip(), "channel": row[2] or 0}
+            if cue["type"] == "scene":
+                cue["scene"] = row[3]
+            else:
+                cue["param"] = row[3] or 0
+            cues.append(cue)
+    return cues
+
+
+def compile_show(cues):
+    scenes = []
+    scene_index = {}
+    table = []
+    for order, cue in enumerate(cues):
+        kind = CUE_TYPES[cue["type"]]
+        param = int(cue.get("param", 0) or 0)
+        if kind == CUE_TYPES["scene"]:
+            packed = parse_scene(cue["scene"])
+            if packed not in scene_index:
+                scene_index[packed] = len(scenes)
+                scenes.append(packed)
+            param = scene_index[packed]
+        if not 0 <= param <= 0xFFFF:
+            raise ValueError("cue %d: param out of range" % order)
+        table.append((parse_time(cue["time"]), order, kind, int(cue.get("channel", 0) or 0), param))
+
+    table.sort(key=lambda c: (c[0], c[1]))  # stable by time, input order breaks ties
+    body = b"".join(CUE.pack(t, kind, channel, param) for t, _, kind, channel, param in table)
+    cue_offset = HEADER.size
+    blob_offset = cue_offset + len(body)
+    blob = b"".join(scenes)
+    body += blob
+    duration = table[-1][0] if table else 0
+
+    header = HEADER.pack(SHOW_MAGIC, SHOW_VERSION, CUE.size, len(table), cue_offset,
+                         blob_offset, len(blob), duration, zlib.crc32(body) & 0xFFFFFFFF)
+    image = header + body
+    if len(image) > PARTITION_SIZE:
+        raise ValueError("show is %d bytes, partition holds %d" % (len(image), PARTITION_SIZE))
+    return image
+
+
+def dump(image):
+    magic, version, cue_size, count, cue_offset, blob_offset, blob_size, duration, crc = HEADER.unpack_from(image)
+    print("magic %08x version %d cues %d duration %d ms scenes %d crc %08x" %
+          (magic, version, count, duration, blob_size // SCENE.size, crc))
+    names = {v: k for k, v in CUE_TYPES.items()}
+    for i in range(count):
+        t, kind, channel, param = CUE.unpack_from(image, cue_offset + i * CUE.size)
+        print("%8d  %-6s ch %3d  param %d" % (t, names.get(kind, kind), channel, param))
+
+
+def read_cues(image):
+    count, cue_offset = HEADER.unpack_from(image)[3:5]
+    return [CUE.unpack_from(image, cue_offset + i * CUE.size) for i in range(count)]
+
+
+def selftest():
+    csv_text = ("time,type,channel,param\n"
+                "# comment line\n"
+                "0:02.000,preset,,4\n"
+                "1500,fire,3,\n"
+                "0:02.000,scene,,\"hue=29 sat=170 val=216 bri=200\"\n"
+                "0:02,fire,7,250\n"
+                "0:03.250,scene,,\"hue=29 sat=170 val=216 bri=200\"\n"
+                "1:00,end,,\n")
+    with tempfile.TemporaryDirectory() as folder:
+        path = os.path.join(folder, "show.csv")
+        with open(path, "w") as f:
+            f.write(csv_text)
+        image = compile_show(load_cues(path))
+
+    magic, version, cue_size, count, cue_offset, blob_offset, blob_size, duration, crc = HEADER.unpack_from(image)
+    ok = magic == SHOW_MAGIC and version == SHOW_VERSION and cue_size == CUE.size and count == 6
+    ok = ok and duration == 60000 and crc == zlib.crc32(image[HEADER.size:]) & 0xFFFFFFFF
+    # Stable by time, input order breaks the 2000 ms tie, both scenes share blob slot 0.
+    ok = ok and read_cues(image) == [(1500, 1, 3, 0), (2000, 3, 0, 4), (2000, 2, 0, 0), (2000, 1, 7, 250),
+                                     (3250, 2, 0, 0), (60000, 0xFF, 0, 0)]
+    ok = ok and blob_size == SCENE.size and image[blob_offset:] == SCENE.pack(2, -1, 29, 170, 216, 200, 0, SCENE_IN_USE)
+
+    json_cues = [{"time": "0:01", "type": "scene", "scene": {"animation": 5, "bri": 90}},
+                 {"time": 500, "type": "fire", "channel": 2}]
+    image = compile_show(json_cues)
+    ok = ok and read_cues(image) == [(500, 1, 2, 0), (1000, 2, 0, 0)]
+    ok = ok and image[HEADER.unpack_from(image)[5]:] == SCENE.pack(1, 5, 0, 255, 255, 90, 0, SCENE_IN_USE)
+
+    for bad in ([{"time": 0, "type": "preset", "param": 70000}],
+                [{"time": i, "type": "fire", "channel": 1} for i in range(PARTITION_SIZE // CUE.size)]):
+        try:
+            compile_show(bad)
+            ok = False
+        except ValueError:
+            pass
+
+    print("PASS" if ok else "FAIL")
+    return 0 if ok else 1
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compile a BangWorx show file.")
+    parser.add_argument("input", nargs="?", help="cue list (.csv or .json)")
+    parser.add_argument("-o", "--output", default="show.bin")
+    parser.add_argument("--dump", action="store_true", help="print the compiled cue table")
+    parser.add_argument("--selftest", action="store_true")
+    args = parser.parse_args()
+
+    if args.selftest:
+        return selftest()
+    if not args.input:
+        parser.error("give a cue list or --selftest")
+
+    image = compile_show(load_cues(args.input))
+    with open(args.output, "wb") as f:
+        f.write(image)
+    print("%s: %d bytes" % (args.output, len(image)))
+    if args.dump:
+        dump(image)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,149 @@
+/*+===================================================================
+  File:      thermalsim.cpp
+
+  Summary:   Host simulation of thermalControl.h against a first
+             order thermal model of the PSU, stepped at the
+             governor's tick:
+
+                rise      PSU temperature above ambient at full
+                          current with the fan off, settling with
+                          THERMAL_TAU_S; the fan triples the cooling.
+                sensor    read every second through a 5 s lag (IR
+                          sensor on the case), 0.02 C steps and a
+                          little noise.
+                strip     pixels at the requested colour, limited to
+                          the governor's budget the way FastLED does.
+
+             Scenarios: sustained white, white on a hot day, a
+             flashing load, and a sensor dropout. Each checks the
+             strip never draws more than MAX_CURRENT, the peak
+             temperature including the first warm-up, and that the
+             last half hour holds steady (no limit cycle).
+
+  Building:  g++ -O2 -Iinclude tools/thermalsim.cpp -o thermalsim
+             ./thermalsim [pixels] [maxCurrentMa] [riseC]
+
+  10/19/2026.
+===================================================================+*/
+
+#include <thermalControl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <random>
+#include <vector>
+
+#define THERMAL_TICK_MS 250 // keep in step with thermalGovernor.h
+#define THERMAL_READ_MS 1000
+#define THERMAL_TAU_S 600.0f
+#define SENSOR_LAG_S 5.0f
+#define SIM_SECONDS (3 * 3600)
+
+struct sScenario
+{
+    const char *name;
+    float ambientC;
+    bool flashing;    // 10 s on / 10 s off.
+    int dropoutFromS; // sensor returns nothing for 120 s from here, -1 = never.
+    float limitC;     // the peak must stay under this.
+};
+
+static int pixels = 1000;
+static uint32_t maxCurrentMa = 2000;
+static float riseC = 60.0f; // at MAX_CURRENT, fan off
+static int failures = 0;
+
+static bool run(const sScenario &scenario)
+{
+    std::mt19937 rng(42);
+    std::normal_distribution<float> noise(0, 0.05f);
+    std::vector<uint8_t> white(pixels * 3, 255);
+    std::vector<uint8_t> dark(pixels * 3, 0);
+    sPowerEstimate whiteEstimate = powerEstimate(white.data(), pixels);
+    sPowerEstimate darkEstimate = powerEstimate(dark.data(), pixels);
+
+    sThermalPi pi;
+    thermalInit(pi);
+    sThermalOut out = {0, maxCurrentMa};
+    float psuC = scenario.ambientC;
+    float sensedC = scenario.ambientC;
+    float readingC = NAN;
+    uint32_t readingAtMs = 0;
+    uint32_t worstMa = 0;
+    float peakC = 0;
+    float lateMin = 1000;
+    float lateMax = -1000;
+    float lateFan = 0;
+    float lateBudget = 0;
+    int lateTicks = 0;
+    float dt = THERMAL_TICK_MS / 1000.0f;
+
+    for (uint32_t ms = 0; ms < SIM_SECONDS * 1000u; ms += THERMAL_TICK_MS)
+    {
+        int s = ms / 1000;
+        bool lit = !scenario.flashing || (s / 10) % 2 == 0;
+        const sPowerEstimate &estimate = lit ? whiteEstimate : darkEstimate;
+        uint8_t brightness = powerCapBrightness(estimate, 255, out.budgetMa);
+        uint32_t drawMa = estimateMa(estimate, brightness);
+        worstMa = drawMa > worstMa ? drawMa : worstMa;
+
+        // Plant.
+        float fan = out.fanDuty / 255.0f;
+        float cooling = 1.0f + 2.0f * fan;
+        float targetC = scenario.ambientC + riseC * drawMa / maxCurrentMa / cooling;
+        psuC += (targetC - psuC) * dt * cooling / THERMAL_TAU_S;
+        sensedC += (psuC - sensedC) * dt / SENSOR_LAG_S;
+
+        bool dropped = scenario.dropoutFromS >= 0 && s >= scenario.dropoutFromS && s < scenario.dropoutFromS + 120;
+        if (ms % THERMAL_READ_MS == 0 && !dropped)
+        {
+            readingC = roundf((sensedC + noise(rng)) / 0.02f) * 0.02f;
+            readingAtMs = ms;
+        }
+        float tempC = ms - readingAtMs > THERMAL_STALE_MS ? NAN : readingC;
+        out = thermalStep(pi, tempC, drawMa, maxCurrentMa, dt);
+        if (out.budgetMa > maxCurrentMa)
+        {
+            worstMa = out.budgetMa; // flags the failure below
+        }
+
+        peakC = psuC > peakC ? psuC : peakC;
+        if (s >= SIM_SECONDS - 1800)
+        {
+            lateMin = psuC < lateMin ? psuC : lateMin;
+            lateMax = psuC > lateMax ? psuC : lateMax;
+            lateFan += fan;
+            lateBudget += out.budgetMa;
+            lateTicks++;
+        }
+    }
+
+    // Flashing loads ride a 20 s ripple of their own, judge them on the peak only.
+    float swing = lateMax - lateMin;
+    bool pass = worstMa <= maxCurrentMa && peakC <= scenario.limitC && (scenario.flashing || swing < 1.0f);
+    printf("%-10s ambient %2.0f C  peak %5.1f C  last 30 min %5.1f-%5.1f C  fan %3.0f%%  budget %4.0f mA  "
+           "worst draw %4u mA  %s\n",
+           scenario.name, scenario.ambientC, peakC, lateMin, lateMax, 100 * lateFan / lateTicks,
+           lateBudget / lateTicks, worstMa, pass ? "PASS" : "FAIL");
+    return pass;
+}
+
+int main(int argc, char **argv)
+{
+    pixels = argc > 1 ? atoi(argv[1]) : 1000;
+    maxCurrentMa = argc > 2 ? atoi(argv[2]) : 2000;
+    riseC = argc > 3 ? atof(argv[3]) : 60.0f;
+    printf("%d pixels, MAX_CURRENT %u mA, %.0f C rise at full current without the fan, set point %.0f C\n",
+           pixels, maxCurrentMa, riseC, THERMAL_SET_C);
+
+    const sScenario scenarios[] = {
+        {"white", 25, false, -1, THERMAL_SET_C + 2},
+        {"hot day", 40, false, -1, THERMAL_SET_C + 2},
+        {"flashing", 35, true, -1, THERMAL_SET_C + 2},
+        {"dropout", 35, false, 5400, THERMAL_SET_C + 2},
+    };
+    for (const sScenario &scenario : scenarios)
+    {
+        failures += run(scenario) ? 0 : 1;
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,265 @@
+/*+===================================================================
+  File:      udpbench.cpp
+
+  Summary:   Loopback comparison of the two ways a cue reaches the
+             subs: one UDP broadcast (udpProtocol.h packets, triple
+             send, receiver dedup) against one TCP stream per sub
+             written in turn, which is what the WebSocket path does.
+
+             Every sub is a thread with both sockets open. Each cue
+             is timestamped on send and on first arrival per sub,
+             so it reports per-sub latency and the time until the
+             last sub has it. Optional receive-side loss shows what
+             the extra copies buy.
+
+  Building:  g++ -O2 -pthread -Iinclude tools/udpbench.cpp -o udpbench
+             ./udpbench [subs] [cues] [lossPercent]
+
+             Loopback has no airtime, so this measures stack and
+             fan-out cost only; over WiFi the gap is larger since TCP
+             sends N copies and waits on each station's acks.
+
+  10/19/2026.
+===================================================================+*/
+
+#include <fixedString.h>
+#include <reliableCue.h>
+#include <udpProtocol.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#define BENCH_UDP_PORT (UDP_FAST_PORT + 20000)
+#define BENCH_TCP_PORT (UDP_FAST_PORT + 20001)
+#define BENCH_GAP_US 2000 // between cues
+
+static int64_t nowUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+struct sSub
+{
+    int udp;
+    int tcp;
+    std::vector<int64_t> udpArrived; // per cue, 0 = never.
+    std::vector<int64_t> tcpArrived;
+    uint32_t udpCopies;
+};
+
+static std::atomic<bool> running(true);
+static int lossPercent = 0;
+
+static void subThread(sSub *sub, unsigned seed)
+{
+    sCueReceiver rx;
+    cueReceiverInit(rx);
+    uint8_t buf[256];
+    size_t tcpHave = 0;
+    uint8_t tcpBuf[256];
+    pollfd fds[2] = {{sub->udp, POLLIN, 0}, {sub->tcp, POLLIN, 0}};
+
+    while (running)
+    {
+        if (poll(fds, 2, 20) <= 0)
+        {
+            continue;
+        }
+        if (fds[0].revents & POLLIN)
+        {
+            ssize_t n = recv(sub->udp, buf, sizeof(buf), 0);
+            sUdpHeader header;
+            const uint8_t *body;
+            if (n > 0 && (int)(rand_r(&seed) % 100) >= lossPercent && udpParse(buf, n, header, &body) &&
+                header.type == UDP_CUE)
+            {
+                sub->udpCopies++;
+                cueEpoch(rx, header.epoch);
+                if (cueReceive(rx, header.seq) && header.seq < sub->udpArrived.size())
+                {
+                    sub->udpArrived[header.seq] = nowUs();
+                }
+            }
+        }
+        if (fds[1].revents & POLLIN)
+        {
+            // Length prefixed frames, like a WebSocket text frame: [len][seq lo][seq hi][payload]
+            ssize_t n = recv(sub->tcp, tcpBuf + tcpHave, sizeof(tcpBuf) - tcpHave, 0);
+            if (n <= 0)
+            {
+                break;
+            }
+            tcpHave += n;
+            while (tcpHave > 0 && tcpHave >= (size_t)tcpBuf[0] + 1)
+            {
+                uint8_t len = tcpBuf[0];
+                uint16_t seq = tcpBuf[1] | (tcpBuf[2] << 8);
+                if (seq < sub->tcpArrived.size())
+                {
+                    sub->tcpArrived[seq] = nowUs();
+                }
+                memmove(tcpBuf, tcpBuf + len + 1, tcpHave - len - 1);
+                tcpHave -= len + 1;
+            }
+        }
+    }
+}
+
+static void report(const char *name, const std::vector<sSub> &subs, const std::vector<int64_t> &sentAt,
+                   bool udp)
+{
+    std::vector<int64_t> each;
+    std::vector<int64_t> all;
+    int missing = 0;
+    for (size_t cue = 0; cue < sentAt.size(); cue++)
+    {
+        int64_t last = 0;
+        bool complete = true;
+        for (const sSub &sub : subs)
+        {
+            int64_t at = udp ? sub.udpArrived[cue] : sub.tcpArrived[cue];
+            if (at == 0)
+            {
+                missing++;
+                complete = false;
+                continue;
+            }
+            each.push_back(at - sentAt[cue]);
+            last = std::max(last, at);
+        }
+        if (complete)
+        {
+            all.push_back(last - sentAt[cue]);
+        }
+    }
+    std::sort(each.begin(), each.end());
+    std::sort(all.begin(), all.end());
+    auto pct = [](const std::vector<int64_t> &v, int p)
+    { return v.empty() ? 0 : (long long)v[v.size() * p / 100]; };
+    printf("%-4s per sub us: p50 %5lld  p99 %5lld   all subs us: p50 %5lld  p99 %5lld   missing %d\n", name,
+           pct(each, 50), pct(each, 99), pct(all, 50), pct(all, 99), missing);
+}
+
+int main(int argc, char **argv)
+{
+    int subCount = argc > 1 ? atoi(argv[1]) : 6;
+    int cueCount = argc > 2 ? atoi(argv[2]) : 2000;
+    lossPercent = argc > 3 ? atoi(argv[3]) : 0;
+    if (cueCount > 65535)
+    {
+        cueCount = 65535;
+    }
+
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    int on = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(BENCH_TCP_PORT);
+    if (bind(listener, (sockaddr *)&addr, sizeof(addr)) != 0 || listen(listener, subCount) != 0)
+    {
+        perror("tcp listen");
+        return 1;
+    }
+
+    std::vector<sSub> subs(subCount);
+    std::vector<int> tcpToSub;
+    for (sSub &sub : subs)
+    {
+        sub.udp = socket(AF_INET, SOCK_DGRAM, 0);
+        setsockopt(sub.udp, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        setsockopt(sub.udp, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on));
+        sockaddr_in any = {};
+        any.sin_family = AF_INET;
+        any.sin_addr.s_addr = htonl(INADDR_ANY);
+        any.sin_port = htons(BENCH_UDP_PORT);
+        if (bind(sub.udp, (sockaddr *)&any, sizeof(any)) != 0)
+        {
+            perror("udp bind");
+            return 1;
+        }
+
+        sub.tcp = socket(AF_INET, SOCK_STREAM, 0);
+        setsockopt(sub.tcp, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+        if (connect(sub.tcp, (sockaddr *)&addr, sizeof(addr)) != 0)
+        {
+            perror("tcp connect");
+            return 1;
+        }
+        int accepted = accept(listener, nullptr, nullptr);
+        setsockopt(accepted, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+        tcpToSub.push_back(accepted);
+
+        sub.udpArrived.assign(cueCount, 0);
+        sub.tcpArrived.assign(cueCount, 0);
+        sub.udpCopies = 0;
+    }
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < subCount; i++)
+    {
+        threads.emplace_back(subThread, &subs[i], 1234u + i);
+    }
+
+    int udpOut = socket(AF_INET, SOCK_DGRAM, 0);
+    setsockopt(udpOut, SOL_SOCKET, SO_BROADCAST, &on, sizeof(on));
+    sockaddr_in broadcast = {};
+    broadcast.sin_family = AF_INET;
+    broadcast.sin_addr.s_addr = inet_addr("127.255.255.255");
+    broadcast.sin_port = htons(BENCH_UDP_PORT);
+
+    // UDP: all copies of a cue, then TCP: one frame per sub in turn. Same cue index both ways.
+    std::vector<int64_t> udpSentAt(cueCount);
+    std::vector<int64_t> tcpSentAt(cueCount);
+    for (int cue = 0; cue < cueCount; cue++)
+    {
+        sUdpCue body = {1, (uint8_t)(cue % 32), 0, UDP_CUE_LIVE};
+        uint8_t packet[UDP_MAX_PACKET];
+        udpSentAt[cue] = nowUs();
+        for (uint8_t copy = 0; copy < UDP_COPIES; copy++)
+        {
+            size_t len = udpBuild(packet, UDP_CUE, 0xB0070001, cue, copy, 0, &body, sizeof(body));
+            sendto(udpOut, packet, len, 0, (sockaddr *)&broadcast, sizeof(broadcast));
+        }
+        usleep(BENCH_GAP_US / 2);
+
+        FixedString<48> text("cue:");
+        text.appendUInt(cue).append(":Fire: Shell #").appendUInt(cue % 32);
+        uint8_t frame[64];
+        frame[0] = text.length() + 2;
+        frame[1] = cue & 0xFF;
+        frame[2] = cue >> 8;
+        memcpy(frame + 3, text.c_str(), text.length());
+        tcpSentAt[cue] = nowUs();
+        for (int fd : tcpToSub)
+        {
+            send(fd, frame, frame[0] + 1, 0);
+        }
+        usleep(BENCH_GAP_US / 2);
+    }
+
+    usleep(200000);
+    running = false;
+    for (std::thread &t : threads)
+    {
+        t.join();
+    }
+
+    printf("%d subs, %d cues, %d%% receive loss, %d UDP copies per cue\n", subCount, cueCount, lossPercent,
+           UDP_COPIES);
+    report("udp", subs, udpSentAt, true);
+    report("tcp", subs, tcpSentAt, false);
+    return 0;
+}